@@ -0,0 +1,321 @@
+#include "benchmark_runner.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/printer.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/main/database.hpp"
+#include "duckdb/parser/keyword_helper.hpp"
+#include "httpfs_timeout_retry_extension.hpp"
+#include "timeout_retry_metrics.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <thread>
+
+namespace duckdb {
+
+namespace {
+
+constexpr const char *BUCKET = "benchmark";
+constexpr const char *DATA_PREFIX = "data/";
+constexpr const char *DELETE_PREFIX = "delete/";
+
+constexpr BenchmarkOperation ALL_OPERATIONS[] = {BenchmarkOperation::OPEN, BenchmarkOperation::STAT,
+                                                 BenchmarkOperation::LIST, BenchmarkOperation::READ,
+                                                 BenchmarkOperation::DELETE};
+
+void ExecuteStatement(Connection &con, const string &statement) {
+	auto result = con.Query(statement);
+	if (result->HasError()) {
+		result->ThrowError();
+	}
+}
+
+// Point the S3 filesystem at the mock server; requests are signed with throwaway credentials the server ignores.
+void ConfigureS3(Connection &con, idx_t port) {
+	ExecuteStatement(con,
+	                 StringUtil::Format("SET s3_endpoint = '127.0.0.1:%llu'", static_cast<unsigned long long>(port)));
+	ExecuteStatement(con, "SET s3_url_style = 'path'");
+	ExecuteStatement(con, "SET s3_use_ssl = false");
+	ExecuteStatement(con, "SET s3_region = 'us-east-1'");
+	ExecuteStatement(con, "SET s3_access_key_id = 'benchmark'");
+	ExecuteStatement(con, "SET s3_secret_access_key = 'benchmark'");
+}
+
+// Get the [percentile] of sorted latencies, by nearest rank.
+double GetPercentile(const vector<double> &sorted_latencies, double percentile) {
+	if (sorted_latencies.empty()) {
+		return 0;
+	}
+	const auto rank = static_cast<idx_t>(std::ceil(percentile * static_cast<double>(sorted_latencies.size())));
+	return sorted_latencies[MaxValue<idx_t>(rank, 1) - 1];
+}
+
+bool IsSelected(const vector<string> &selected, const string &name) {
+	return selected.empty() || std::find(selected.begin(), selected.end(), name) != selected.end();
+}
+
+MockServerConfig MakeServerConfig(double median_ms, double sigma, uint64_t seed) {
+	MockServerConfig config;
+	config.latency_distribution = LatencyDistribution::LOGNORMAL;
+	config.latency_mean_ms = median_ms;
+	config.latency_sigma = sigma;
+	config.seed = seed;
+	return config;
+}
+
+// Set a per-operation setting to the same value for all operation types.
+void AddPerOperationSetting(vector<string> &statements, const string &setting_format, uint64_t value) {
+	for (const auto operation : {"file_operation", "list", "delete", "stat", "create_dir", "read", "write"}) {
+		statements.emplace_back(StringUtil::Format("SET " + setting_format + " = %llu", operation,
+		                                           static_cast<unsigned long long>(value)));
+	}
+}
+
+} // namespace
+
+string BenchmarkOperationToString(BenchmarkOperation operation) {
+	switch (operation) {
+	case BenchmarkOperation::OPEN:
+		return "open";
+	case BenchmarkOperation::STAT:
+		return "stat";
+	case BenchmarkOperation::LIST:
+		return "list";
+	case BenchmarkOperation::READ:
+		return "read";
+	case BenchmarkOperation::DELETE:
+		return "delete";
+	default:
+		throw InternalException("Unknown BenchmarkOperation in BenchmarkOperationToString: %d",
+		                        static_cast<int>(operation));
+	}
+}
+
+BenchmarkRunner::BenchmarkRunner(BenchmarkOptions options_p) : options(std::move(options_p)) {
+}
+
+vector<FaultProfile> BenchmarkRunner::GetFaultProfiles(uint64_t seed) {
+	vector<FaultProfile> profiles;
+	// Same-region object storage: a few milliseconds with a modest tail.
+	profiles.push_back({"healthy", MakeServerConfig(2, 0.5, seed)});
+	// Cross-region or overloaded endpoint: slower, with a long tail.
+	profiles.push_back({"slow", MakeServerConfig(20, 1, seed)});
+
+	auto flaky = MakeServerConfig(2, 0.5, seed);
+	flaky.error_rate = 0.05;
+	flaky.throttle_rate = 0.05;
+	profiles.push_back({"flaky", flaky});
+
+	auto stalling = MakeServerConfig(2, 0.5, seed);
+	stalling.stall_rate = 0.05;
+	stalling.stall_ms = 2000;
+	profiles.push_back({"stalling", stalling});
+	return profiles;
+}
+
+vector<SettingsProfile> BenchmarkRunner::GetSettingsProfiles() {
+	vector<SettingsProfile> profiles;
+	// Extension defaults, which fall back to http_timeout and http_retries.
+	profiles.push_back({"default", {}});
+
+	SettingsProfile tight {"tight", {}};
+	AddPerOperationSetting(tight.statements, "httpfs_timeout_%s_ms", 1000);
+	AddPerOperationSetting(tight.statements, "httpfs_retries_%s", 5);
+	AddPerOperationSetting(tight.statements, "httpfs_retry_wait_%s_ms", 10);
+	tight.statements.emplace_back("SET httpfs_retry_jitter = 'full'");
+	profiles.push_back(std::move(tight));
+
+	SettingsProfile conservative {"conservative", {}};
+	AddPerOperationSetting(conservative.statements, "httpfs_timeout_%s_ms", 10000);
+	AddPerOperationSetting(conservative.statements, "httpfs_retries_%s", 1);
+	profiles.push_back(std::move(conservative));
+	return profiles;
+}
+
+string BenchmarkRunner::GetDataPath(idx_t index) const {
+	return StringUtil::Format("s3://%s/%sfile_%llu.bin", BUCKET, DATA_PREFIX,
+	                          static_cast<unsigned long long>(index % options.object_count));
+}
+
+void BenchmarkRunner::SeedObjects(MockObjectServer &server, const string &prefix, idx_t count) {
+	const string data(options.object_size, 'x');
+	for (idx_t idx = 0; idx < count; ++idx) {
+		server.PutObject(BUCKET, StringUtil::Format("%sfile_%llu.bin", prefix, static_cast<unsigned long long>(idx)),
+		                 data);
+	}
+}
+
+vector<BenchmarkResult> BenchmarkRunner::Run() {
+	if (options.iterations == 0 || options.threads == 0 || options.object_count == 0) {
+		throw InvalidInputException("Benchmark iterations, threads and objects should be positive");
+	}
+	DuckDB db(nullptr);
+	db.LoadStaticExtension<HttpfsTimeoutRetryExtension>();
+	MockObjectServer server(MockServerConfig {});
+	server.Start();
+	SeedObjects(server, DATA_PREFIX, options.object_count);
+
+	vector<BenchmarkResult> results;
+	idx_t scenario_index = 0;
+	for (const auto &fault_profile : GetFaultProfiles(options.seed)) {
+		if (!IsSelected(options.fault_profiles, fault_profile.name)) {
+			continue;
+		}
+		for (const auto &settings_profile : GetSettingsProfiles()) {
+			if (!IsSelected(options.settings_profiles, settings_profile.name)) {
+				continue;
+			}
+			// A fresh connection per scenario, so settings of the previous one don't leak.
+			Connection con(db);
+			ConfigureS3(con, server.GetPort());
+			for (const auto &statement : settings_profile.statements) {
+				ExecuteStatement(con, statement);
+			}
+			server.Configure(fault_profile.server_config);
+			// Every scenario deletes files of its own.
+			const auto delete_prefix = StringUtil::Format("%s%llu/", DELETE_PREFIX,
+			                                              static_cast<unsigned long long>(scenario_index++));
+			SeedObjects(server, delete_prefix, options.iterations);
+
+			for (const auto operation : ALL_OPERATIONS) {
+				auto result = RunOperation(operation, con, server, delete_prefix);
+				result.fault_profile = fault_profile.name;
+				result.settings_profile = settings_profile.name;
+				results.emplace_back(std::move(result));
+			}
+		}
+	}
+	server.Stop();
+	return results;
+}
+
+void BenchmarkRunner::RunOnce(BenchmarkOperation operation, FileSystem &fs, idx_t index, const string &delete_prefix,
+                              vector<data_t> &buffer) {
+	switch (operation) {
+	case BenchmarkOperation::OPEN:
+		fs.OpenFile(GetDataPath(index), FileFlags::FILE_FLAGS_READ);
+		return;
+	case BenchmarkOperation::STAT:
+		fs.FileExists(GetDataPath(index));
+		return;
+	case BenchmarkOperation::LIST:
+		fs.Glob(StringUtil::Format("s3://%s/%s*.bin", BUCKET, DATA_PREFIX));
+		return;
+	case BenchmarkOperation::READ: {
+		auto handle = fs.OpenFile(GetDataPath(index), FileFlags::FILE_FLAGS_READ);
+		handle->Read(buffer.data(), buffer.size(), 0);
+		return;
+	}
+	case BenchmarkOperation::DELETE:
+		fs.RemoveFile(StringUtil::Format("s3://%s/%sfile_%llu.bin", BUCKET, delete_prefix,
+		                                 static_cast<unsigned long long>(index)));
+		return;
+	default:
+		throw InternalException("Unknown BenchmarkOperation in RunOnce: %d", static_cast<int>(operation));
+	}
+}
+
+BenchmarkResult BenchmarkRunner::RunOperation(BenchmarkOperation operation, Connection &con, MockObjectServer &server,
+                                              const string &delete_prefix) {
+	auto &fs = FileSystem::GetFileSystem(*con.context);
+	auto &metrics = TimeoutRetryMetrics::GetInstance();
+	metrics.Reset();
+	const auto stats_before = server.GetStats();
+
+	vector<vector<double>> thread_latencies(options.threads);
+	vector<idx_t> thread_failures(options.threads, 0);
+	vector<std::thread> threads;
+	const auto start = std::chrono::steady_clock::now();
+	for (idx_t thread_idx = 0; thread_idx < options.threads; ++thread_idx) {
+		threads.emplace_back([&, thread_idx]() {
+			vector<data_t> buffer(options.object_size);
+			for (idx_t idx = thread_idx; idx < options.iterations; idx += options.threads) {
+				const auto call_start = std::chrono::steady_clock::now();
+				try {
+					RunOnce(operation, fs, idx, delete_prefix, buffer);
+				} catch (std::exception &) {
+					++thread_failures[thread_idx];
+				}
+				const std::chrono::duration<double, std::milli> latency =
+				    std::chrono::steady_clock::now() - call_start;
+				thread_latencies[thread_idx].push_back(latency.count());
+			}
+		});
+	}
+	for (auto &thread : threads) {
+		thread.join();
+	}
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	BenchmarkResult result;
+	result.operation = operation;
+	vector<double> latencies;
+	for (idx_t thread_idx = 0; thread_idx < options.threads; ++thread_idx) {
+		latencies.insert(latencies.end(), thread_latencies[thread_idx].begin(), thread_latencies[thread_idx].end());
+		result.failures += thread_failures[thread_idx];
+	}
+	std::sort(latencies.begin(), latencies.end());
+	result.calls = latencies.size();
+	result.throughput_per_second = static_cast<double>(result.calls) / elapsed.count();
+	result.latency_p50_ms = GetPercentile(latencies, 0.5);
+	result.latency_p99_ms = GetPercentile(latencies, 0.99);
+
+	const auto stats_after = server.GetStats();
+	result.server_requests = stats_after.requests - stats_before.requests;
+	result.injected_errors = stats_after.injected_errors - stats_before.injected_errors;
+	result.injected_throttles = stats_after.injected_throttles - stats_before.injected_throttles;
+	result.injected_stalls = stats_after.injected_stalls - stats_before.injected_stalls;
+	for (const auto &snapshot : metrics.GetSnapshots()) {
+		result.retries += snapshot.retries;
+		result.timeouts += snapshot.timeouts;
+	}
+	return result;
+}
+
+void BenchmarkRunner::WriteResults(const vector<BenchmarkResult> &results, const string &path) {
+	std::ofstream output(path);
+	if (!output) {
+		throw IOException("Cannot open benchmark result file %s", path);
+	}
+	output << "fault_profile,settings_profile,operation,calls,failures,throughput_per_second,latency_p50_ms,"
+	          "latency_p99_ms,server_requests,injected_errors,injected_throttles,injected_stalls,retries,timeouts\n";
+	for (const auto &result : results) {
+		output << StringUtil::Format("%s,%s,%s,%llu,%llu,%.3f,%.3f,%.3f,%llu,%llu,%llu,%llu,%llu,%llu\n",
+		                             result.fault_profile, result.settings_profile,
+		                             BenchmarkOperationToString(result.operation),
+		                             static_cast<unsigned long long>(result.calls),
+		                             static_cast<unsigned long long>(result.failures), result.throughput_per_second,
+		                             result.latency_p50_ms, result.latency_p99_ms,
+		                             static_cast<unsigned long long>(result.server_requests),
+		                             static_cast<unsigned long long>(result.injected_errors),
+		                             static_cast<unsigned long long>(result.injected_throttles),
+		                             static_cast<unsigned long long>(result.injected_stalls),
+		                             static_cast<unsigned long long>(result.retries),
+		                             static_cast<unsigned long long>(result.timeouts));
+	}
+}
+
+void BenchmarkRunner::PrintComparison(const string &current_path, const string &baseline_path) {
+	DuckDB db(nullptr);
+	Connection con(db);
+	// Ratios above 1 mean the current run is slower (latency) or faster (throughput) than the baseline.
+	auto result = con.Query(StringUtil::Format(
+	    "SELECT fault_profile, settings_profile, operation, "
+	    "round(current.latency_p50_ms / nullif(baseline.latency_p50_ms, 0), 3) AS p50_ratio, "
+	    "round(current.latency_p99_ms / nullif(baseline.latency_p99_ms, 0), 3) AS p99_ratio, "
+	    "round(current.throughput_per_second / nullif(baseline.throughput_per_second, 0), 3) AS throughput_ratio, "
+	    "current.failures - baseline.failures AS failures_delta, "
+	    "current.server_requests - baseline.server_requests AS requests_delta "
+	    "FROM read_csv(%s) AS current JOIN read_csv(%s) AS baseline "
+	    "USING (fault_profile, settings_profile, operation) ORDER BY ALL",
+	    KeywordHelper::WriteQuoted(current_path), KeywordHelper::WriteQuoted(baseline_path)));
+	if (result->HasError()) {
+		result->ThrowError();
+	}
+	Printer::Print(result->ToString());
+}
+
+} // namespace duckdb
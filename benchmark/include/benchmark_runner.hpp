@@ -0,0 +1,98 @@
+#pragma once
+
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/vector.hpp"
+#include "duckdb/main/connection.hpp"
+#include "mock_object_server.hpp"
+
+namespace duckdb {
+
+// Operations measured by the benchmark, each issued through the DuckDB filesystem like queries do.
+// - OPEN: open a file for reading.
+// - STAT: check whether a file exists.
+// - LIST: glob all files under a prefix.
+// - READ: read a whole file from an open handle.
+// - DELETE: remove a file.
+enum class BenchmarkOperation : uint8_t { OPEN, STAT, LIST, READ, DELETE };
+
+string BenchmarkOperationToString(BenchmarkOperation operation);
+
+// Server behaviour of a scenario.
+struct FaultProfile {
+	string name;
+	MockServerConfig server_config;
+};
+
+// Extension settings of a scenario, as SET statements.
+struct SettingsProfile {
+	string name;
+	vector<string> statements;
+};
+
+struct BenchmarkOptions {
+	// Number of calls of each operation per scenario, spread over [threads].
+	idx_t iterations = 200;
+	idx_t threads = 4;
+	// Number and size of files which opens, stats, globs and reads go to.
+	idx_t object_count = 64;
+	idx_t object_size = 1024 * 1024;
+	uint64_t seed = 42;
+	// Names of the fault and settings profiles to run, empty means all.
+	vector<string> fault_profiles;
+	vector<string> settings_profiles;
+};
+
+// Measurements of one operation in one scenario.
+struct BenchmarkResult {
+	string fault_profile;
+	string settings_profile;
+	BenchmarkOperation operation;
+	idx_t calls = 0;
+	idx_t failures = 0;
+	double throughput_per_second = 0;
+	double latency_p50_ms = 0;
+	double latency_p99_ms = 0;
+	// Requests seen by the server, and faults it injected.
+	uint64_t server_requests = 0;
+	uint64_t injected_errors = 0;
+	uint64_t injected_throttles = 0;
+	uint64_t injected_stalls = 0;
+	// Retries and timeouts recorded by the extension.
+	uint64_t retries = 0;
+	uint64_t timeouts = 0;
+};
+
+// BenchmarkRunner runs every operation under each combination of fault profile and settings profile, against a mock
+// object server on localhost, so results don't depend on network or a real bucket.
+class BenchmarkRunner {
+public:
+	explicit BenchmarkRunner(BenchmarkOptions options_p);
+
+public:
+	vector<BenchmarkResult> Run();
+
+	static vector<FaultProfile> GetFaultProfiles(uint64_t seed);
+	static vector<SettingsProfile> GetSettingsProfiles();
+
+	// Write results as CSV, one row per scenario and operation.
+	static void WriteResults(const vector<BenchmarkResult> &results, const string &path);
+	// Print the change of latency and throughput of [current_path] against [baseline_path], both written by
+	// [WriteResults].
+	static void PrintComparison(const string &current_path, const string &baseline_path);
+
+private:
+	void SeedObjects(MockObjectServer &server, const string &prefix, idx_t count);
+	BenchmarkResult RunOperation(BenchmarkOperation operation, Connection &con, MockObjectServer &server,
+	                             const string &delete_prefix);
+	// Issue one call of the operation, [index] picks the file it goes to.
+	void RunOnce(BenchmarkOperation operation, FileSystem &fs, idx_t index, const string &delete_prefix,
+	             vector<data_t> &buffer);
+
+	string GetDataPath(idx_t index) const;
+
+private:
+	BenchmarkOptions options;
+};
+
+} // namespace duckdb
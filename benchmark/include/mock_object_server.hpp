@@ -0,0 +1,112 @@
+#pragma once
+
+#include "duckdb/common/atomic.hpp"
+#include "duckdb/common/map.hpp"
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/shared_ptr.hpp"
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/unique_ptr.hpp"
+
+#include <random>
+#include <thread>
+
+namespace duckdb_httplib {
+class Server;
+struct Request;
+struct Response;
+} // namespace duckdb_httplib
+
+namespace duckdb {
+
+// Distribution of the latency the server adds before responding.
+// - FIXED: always [mean_ms].
+// - UNIFORM: uniform in [0, 2 * mean_ms].
+// - EXPONENTIAL: exponential with mean [mean_ms].
+// - LOGNORMAL: log-normal with median [mean_ms] and shape [sigma], which has the long tail of object storage.
+enum class LatencyDistribution : uint8_t { FIXED, UNIFORM, EXPONENTIAL, LOGNORMAL };
+
+// Faults injected into responses, each request draws at most one of them.
+struct MockServerConfig {
+	LatencyDistribution latency_distribution = LatencyDistribution::FIXED;
+	double latency_mean_ms = 0;
+	double latency_sigma = 1;
+	// Fraction of requests failed with HTTP 500.
+	double error_rate = 0;
+	// Fraction of requests throttled with HTTP 503 SlowDown.
+	double throttle_rate = 0;
+	// Fraction of object reads which stall for [stall_ms] after sending half of the body.
+	double stall_rate = 0;
+	uint64_t stall_ms = 0;
+	uint64_t seed = 0;
+};
+
+// Point-in-time counters of the server.
+struct MockServerStats {
+	uint64_t requests = 0;
+	uint64_t injected_errors = 0;
+	uint64_t injected_throttles = 0;
+	uint64_t injected_stalls = 0;
+};
+
+// MockObjectServer is an in-memory, S3-compatible stand-in server on localhost, which serves path-style HEAD, ranged
+// GET, PUT, DELETE, ListObjectsV2 and multi-object delete requests, and ignores request signatures. Latency and faults
+// are drawn from a seeded random engine, so a run is reproducible up to thread scheduling.
+class MockObjectServer {
+public:
+	explicit MockObjectServer(MockServerConfig config_p);
+	~MockObjectServer();
+
+public:
+	// Start serving on an ephemeral port.
+	void Start();
+	void Stop();
+	idx_t GetPort() const {
+		return port;
+	}
+
+	// Replace fault injection config, i.e. between benchmark scenarios.
+	void Configure(MockServerConfig config_p);
+	// Store an object without going through a request.
+	void PutObject(const string &bucket, const string &key, string data);
+	idx_t GetObjectCount() const;
+
+	MockServerStats GetStats() const;
+
+private:
+	enum class InjectedFault : uint8_t { NONE, ERROR, THROTTLE, STALL };
+
+	// Sleep for the sampled latency and draw the fault of the request.
+	InjectedFault BeginRequest(bool can_stall);
+	// Sample latency from the distribution, requires [config_mutex] held.
+	double SampleLatencyMs();
+	// Respond with the injected error or throttling, return false if the request should be served.
+	static bool RespondWithFault(InjectedFault fault, duckdb_httplib::Response &res);
+
+	void HandleGet(const duckdb_httplib::Request &req, duckdb_httplib::Response &res);
+	void HandleList(const string &bucket, const duckdb_httplib::Request &req, duckdb_httplib::Response &res);
+	void HandlePut(const duckdb_httplib::Request &req, duckdb_httplib::Response &res);
+	void HandleDelete(const duckdb_httplib::Request &req, duckdb_httplib::Response &res);
+	void HandleBatchDelete(const duckdb_httplib::Request &req, duckdb_httplib::Response &res);
+
+	static string GetObjectPath(const string &bucket, const string &key);
+
+private:
+	unique_ptr<duckdb_httplib::Server> server;
+	std::thread server_thread;
+	idx_t port = 0;
+
+	mutable mutex config_mutex;
+	MockServerConfig config;
+	std::mt19937_64 random_engine;
+
+	mutable mutex objects_mutex;
+	// Objects keyed by "bucket/key", ordered so listings come out sorted like S3; shared with responses being sent.
+	map<string, shared_ptr<const string>> objects;
+
+	atomic<uint64_t> requests {0};
+	atomic<uint64_t> injected_errors {0};
+	atomic<uint64_t> injected_throttles {0};
+	atomic<uint64_t> injected_stalls {0};
+};
+
+} // namespace duckdb
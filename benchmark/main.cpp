@@ -0,0 +1,104 @@
+#include "benchmark_runner.hpp"
+#include "duckdb/common/error_data.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/printer.hpp"
+#include "duckdb/common/string_util.hpp"
+
+#include <cstdlib>
+#include <iostream>
+
+using namespace duckdb;
+
+namespace {
+
+void PrintUsage() {
+	std::cerr << "Usage: benchmark_httpfs_timeout_retry [options]\n"
+	             "  --iterations N         calls of each operation per scenario (default 200)\n"
+	             "  --threads N            concurrent callers (default 4)\n"
+	             "  --objects N            files read by open, stat, list and read (default 64)\n"
+	             "  --object-size BYTES    size of each file (default 1048576)\n"
+	             "  --seed N               seed of injected latency and faults (default 42)\n"
+	             "  --fault-profile NAME   only run the given fault profile, may be repeated\n"
+	             "  --settings-profile NAME  only run the given settings profile, may be repeated\n"
+	             "  --output PATH          write results as CSV to PATH\n"
+	             "  --baseline PATH        compare results against a CSV of an earlier run, requires --output\n";
+}
+
+idx_t ParseCount(const string &flag, const string &value) {
+	char *end = nullptr;
+	const auto result = std::strtoull(value.c_str(), &end, 10);
+	if (value.empty() || *end != '\0') {
+		throw InvalidInputException("%s should be a non-negative integer, got '%s'", flag, value);
+	}
+	return static_cast<idx_t>(result);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	BenchmarkOptions options;
+	string output_path;
+	string baseline_path;
+	try {
+		for (int idx = 1; idx < argc; ++idx) {
+			const string flag = argv[idx];
+			if (flag == "--help" || flag == "-h") {
+				PrintUsage();
+				return 0;
+			}
+			if (idx + 1 >= argc) {
+				throw InvalidInputException("Missing value for %s", flag);
+			}
+			const string value = argv[++idx];
+			if (flag == "--iterations") {
+				options.iterations = ParseCount(flag, value);
+			} else if (flag == "--threads") {
+				options.threads = ParseCount(flag, value);
+			} else if (flag == "--objects") {
+				options.object_count = ParseCount(flag, value);
+			} else if (flag == "--object-size") {
+				options.object_size = ParseCount(flag, value);
+			} else if (flag == "--seed") {
+				options.seed = ParseCount(flag, value);
+			} else if (flag == "--fault-profile") {
+				options.fault_profiles.push_back(value);
+			} else if (flag == "--settings-profile") {
+				options.settings_profiles.push_back(value);
+			} else if (flag == "--output") {
+				output_path = value;
+			} else if (flag == "--baseline") {
+				baseline_path = value;
+			} else {
+				throw InvalidInputException("Unknown option %s", flag);
+			}
+		}
+		if (!baseline_path.empty() && output_path.empty()) {
+			throw InvalidInputException("--baseline requires --output");
+		}
+
+		BenchmarkRunner runner(options);
+		const auto results = runner.Run();
+		for (const auto &result : results) {
+			Printer::Print(StringUtil::Format(
+			    "%-9s %-13s %-7s calls=%llu failures=%llu p50=%.2fms p99=%.2fms throughput=%.1f/s requests=%llu "
+			    "retries=%llu timeouts=%llu",
+			    result.fault_profile, result.settings_profile, BenchmarkOperationToString(result.operation),
+			    static_cast<unsigned long long>(result.calls), static_cast<unsigned long long>(result.failures),
+			    result.latency_p50_ms, result.latency_p99_ms, result.throughput_per_second,
+			    static_cast<unsigned long long>(result.server_requests),
+			    static_cast<unsigned long long>(result.retries), static_cast<unsigned long long>(result.timeouts)));
+		}
+		if (!output_path.empty()) {
+			BenchmarkRunner::WriteResults(results, output_path);
+		}
+		if (!baseline_path.empty()) {
+			BenchmarkRunner::PrintComparison(output_path, baseline_path);
+		}
+	} catch (std::exception &ex) {
+		ErrorData error(ex);
+		std::cerr << error.Message() << "\n";
+		PrintUsage();
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,396 @@
+#include "mock_object_server.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/helper.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/common/vector.hpp"
+#include "httplib.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <functional>
+
+namespace duckdb {
+
+namespace {
+
+constexpr const char *LOCALHOST = "127.0.0.1";
+constexpr const char *XML_CONTENT_TYPE = "application/xml";
+constexpr const char *OBJECT_CONTENT_TYPE = "application/octet-stream";
+constexpr const char *XML_HEADER = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>";
+// Objects have no real modification time; all of them report the same one.
+constexpr const char *LAST_MODIFIED_HTTP = "Mon, 01 Jan 2024 00:00:00 GMT";
+constexpr const char *LAST_MODIFIED_ISO = "2024-01-01T00:00:00.000Z";
+
+string GetETag(const string &data) {
+	return StringUtil::Format("\"%llx\"", static_cast<unsigned long long>(std::hash<string>()(data)));
+}
+
+string EscapeXml(const string &text) {
+	string result;
+	result.reserve(text.size());
+	for (const auto ch : text) {
+		switch (ch) {
+		case '&':
+			result += "&amp;";
+			break;
+		case '<':
+			result += "&lt;";
+			break;
+		case '>':
+			result += "&gt;";
+			break;
+		case '"':
+			result += "&quot;";
+			break;
+		default:
+			result += ch;
+		}
+	}
+	return result;
+}
+
+void SetS3Error(duckdb_httplib::Response &res, int status, const string &code, const string &message) {
+	res.status = status;
+	res.set_content(StringUtil::Format("%s<Error><Code>%s</Code><Message>%s</Message></Error>", XML_HEADER, code,
+	                                   message),
+	                XML_CONTENT_TYPE);
+}
+
+// Split a path-style request path into bucket and key; the key is empty for bucket-level requests.
+void ParsePath(const string &path, string &bucket, string &key) {
+	const auto start = path.find_first_not_of('/');
+	if (start == string::npos) {
+		return;
+	}
+	const auto separator = path.find('/', start);
+	if (separator == string::npos) {
+		bucket = path.substr(start);
+		return;
+	}
+	bucket = path.substr(start, separator - start);
+	key = path.substr(separator + 1);
+}
+
+// Get the values of all <Key> elements of a multi-object delete request.
+vector<string> ParseDeleteKeys(const string &body) {
+	static constexpr const char *KEY_OPEN = "<Key>";
+	static constexpr const char *KEY_CLOSE = "</Key>";
+	vector<string> keys;
+	idx_t position = 0;
+	while (true) {
+		const auto open = body.find(KEY_OPEN, position);
+		if (open == string::npos) {
+			break;
+		}
+		const auto start = open + strlen(KEY_OPEN);
+		const auto close = body.find(KEY_CLOSE, start);
+		if (close == string::npos) {
+			break;
+		}
+		keys.emplace_back(body.substr(start, close - start));
+		position = close + strlen(KEY_CLOSE);
+	}
+	return keys;
+}
+
+} // namespace
+
+MockObjectServer::MockObjectServer(MockServerConfig config_p)
+    : config(config_p), random_engine(config_p.seed) {
+}
+
+MockObjectServer::~MockObjectServer() {
+	Stop();
+}
+
+void MockObjectServer::Start() {
+	server = make_uniq<duckdb_httplib::Server>();
+	server->Get(R"(/.*)", [this](const duckdb_httplib::Request &req, duckdb_httplib::Response &res) {
+		HandleGet(req, res);
+	});
+	server->Put(R"(/.*)", [this](const duckdb_httplib::Request &req, duckdb_httplib::Response &res) {
+		HandlePut(req, res);
+	});
+	server->Delete(R"(/.*)", [this](const duckdb_httplib::Request &req, duckdb_httplib::Response &res) {
+		HandleDelete(req, res);
+	});
+	server->Post(R"(/.*)", [this](const duckdb_httplib::Request &req, duckdb_httplib::Response &res) {
+		HandleBatchDelete(req, res);
+	});
+	const auto bound_port = server->bind_to_any_port(LOCALHOST);
+	if (bound_port < 0) {
+		throw IOException("Mock object server failed to bind to a port on %s", LOCALHOST);
+	}
+	port = static_cast<idx_t>(bound_port);
+	// The socket already listens once bound, so clients could connect before the thread starts accepting.
+	server_thread = std::thread([this]() { server->listen_after_bind(); });
+}
+
+void MockObjectServer::Stop() {
+	if (server == nullptr) {
+		return;
+	}
+	server->stop();
+	if (server_thread.joinable()) {
+		server_thread.join();
+	}
+	server.reset();
+}
+
+void MockObjectServer::Configure(MockServerConfig config_p) {
+	lock_guard<mutex> lck(config_mutex);
+	config = config_p;
+	random_engine.seed(config_p.seed);
+}
+
+void MockObjectServer::PutObject(const string &bucket, const string &key, string data) {
+	auto object = make_shared_ptr<string>(std::move(data));
+	lock_guard<mutex> lck(objects_mutex);
+	objects[GetObjectPath(bucket, key)] = std::move(object);
+}
+
+idx_t MockObjectServer::GetObjectCount() const {
+	lock_guard<mutex> lck(objects_mutex);
+	return objects.size();
+}
+
+MockServerStats MockObjectServer::GetStats() const {
+	MockServerStats stats;
+	stats.requests = requests.load();
+	stats.injected_errors = injected_errors.load();
+	stats.injected_throttles = injected_throttles.load();
+	stats.injected_stalls = injected_stalls.load();
+	return stats;
+}
+
+string MockObjectServer::GetObjectPath(const string &bucket, const string &key) {
+	return bucket + "/" + key;
+}
+
+double MockObjectServer::SampleLatencyMs() {
+	const auto mean_ms = config.latency_mean_ms;
+	if (mean_ms <= 0) {
+		return 0;
+	}
+	switch (config.latency_distribution) {
+	case LatencyDistribution::FIXED:
+		return mean_ms;
+	case LatencyDistribution::UNIFORM:
+		return std::uniform_real_distribution<double>(0, 2 * mean_ms)(random_engine);
+	case LatencyDistribution::EXPONENTIAL:
+		return std::exponential_distribution<double>(1 / mean_ms)(random_engine);
+	case LatencyDistribution::LOGNORMAL:
+		return std::lognormal_distribution<double>(std::log(mean_ms), config.latency_sigma)(random_engine);
+	default:
+		throw InternalException("Unknown LatencyDistribution: %d", static_cast<int>(config.latency_distribution));
+	}
+}
+
+MockObjectServer::InjectedFault MockObjectServer::BeginRequest(bool can_stall) {
+	requests.fetch_add(1);
+	double latency_ms = 0;
+	uint64_t stall_ms = 0;
+	auto fault = InjectedFault::NONE;
+	{
+		lock_guard<mutex> lck(config_mutex);
+		latency_ms = SampleLatencyMs();
+		// One draw decides the fault, so the rates add up rather than overlap.
+		const auto draw = std::uniform_real_distribution<double>(0, 1)(random_engine);
+		if (draw < config.error_rate) {
+			fault = InjectedFault::ERROR;
+		} else if (draw < config.error_rate + config.throttle_rate) {
+			fault = InjectedFault::THROTTLE;
+		} else if (can_stall && draw < config.error_rate + config.throttle_rate + config.stall_rate) {
+			fault = InjectedFault::STALL;
+		}
+		stall_ms = config.stall_ms;
+	}
+	if (latency_ms > 0) {
+		std::this_thread::sleep_for(std::chrono::microseconds(static_cast<int64_t>(latency_ms * 1000)));
+	}
+	switch (fault) {
+	case InjectedFault::ERROR:
+		injected_errors.fetch_add(1);
+		break;
+	case InjectedFault::THROTTLE:
+		injected_throttles.fetch_add(1);
+		break;
+	case InjectedFault::STALL:
+		if (stall_ms > 0) {
+			injected_stalls.fetch_add(1);
+		} else {
+			fault = InjectedFault::NONE;
+		}
+		break;
+	default:
+		break;
+	}
+	return fault;
+}
+
+bool MockObjectServer::RespondWithFault(InjectedFault fault, duckdb_httplib::Response &res) {
+	if (fault == InjectedFault::ERROR) {
+		SetS3Error(res, 500, "InternalError", "Injected error");
+		return true;
+	}
+	if (fault == InjectedFault::THROTTLE) {
+		SetS3Error(res, 503, "SlowDown", "Please reduce your request rate.");
+		return true;
+	}
+	return false;
+}
+
+void MockObjectServer::HandleGet(const duckdb_httplib::Request &req, duckdb_httplib::Response &res) {
+	string bucket;
+	string key;
+	ParsePath(req.path, bucket, key);
+	// HEAD requests are served by GET handlers, without the body.
+	const auto fault = BeginRequest(/*can_stall=*/req.method == "GET" && !key.empty());
+	if (RespondWithFault(fault, res)) {
+		return;
+	}
+	if (key.empty()) {
+		HandleList(bucket, req, res);
+		return;
+	}
+
+	shared_ptr<const string> data;
+	{
+		lock_guard<mutex> lck(objects_mutex);
+		auto iter = objects.find(GetObjectPath(bucket, key));
+		if (iter != objects.end()) {
+			data = iter->second;
+		}
+	}
+	if (data == nullptr) {
+		SetS3Error(res, 404, "NoSuchKey", "The specified key does not exist.");
+		return;
+	}
+	res.set_header("ETag", GetETag(*data));
+	res.set_header("Last-Modified", LAST_MODIFIED_HTTP);
+	res.set_header("Accept-Ranges", "bytes");
+	if (fault != InjectedFault::STALL) {
+		// Ranged requests are answered with 206 and the requested slice by the server library.
+		res.set_content(*data, OBJECT_CONTENT_TYPE);
+		return;
+	}
+
+	uint64_t stall_ms = 0;
+	{
+		lock_guard<mutex> lck(config_mutex);
+		stall_ms = config.stall_ms;
+	}
+	res.set_content_provider(data->size(), OBJECT_CONTENT_TYPE,
+	                         [data, stall_ms](size_t offset, size_t length, duckdb_httplib::DataSink &sink) {
+		                         const auto first_half = length / 2;
+		                         if (!sink.write(data->data() + offset, first_half)) {
+			                         return false;
+		                         }
+		                         std::this_thread::sleep_for(std::chrono::milliseconds(stall_ms));
+		                         return sink.write(data->data() + offset + first_half, length - first_half);
+	                         });
+}
+
+void MockObjectServer::HandleList(const string &bucket, const duckdb_httplib::Request &req,
+                                  duckdb_httplib::Response &res) {
+	if (!req.has_param("list-type")) {
+		SetS3Error(res, 400, "InvalidRequest", "Only ListObjectsV2 is supported.");
+		return;
+	}
+	const auto prefix = req.get_param_value("prefix");
+	const auto delimiter = req.get_param_value("delimiter");
+	const auto bucket_prefix = GetObjectPath(bucket, "");
+
+	string contents;
+	string common_prefixes;
+	string last_common_prefix;
+	idx_t key_count = 0;
+	{
+		lock_guard<mutex> lck(objects_mutex);
+		for (auto iter = objects.lower_bound(bucket_prefix + prefix); iter != objects.end(); ++iter) {
+			if (!StringUtil::StartsWith(iter->first, bucket_prefix + prefix)) {
+				break;
+			}
+			const auto key = iter->first.substr(bucket_prefix.size());
+			const auto delimiter_pos = delimiter.empty() ? string::npos : key.find(delimiter, prefix.size());
+			if (delimiter_pos != string::npos) {
+				const auto common_prefix = key.substr(0, delimiter_pos + delimiter.size());
+				if (common_prefix != last_common_prefix) {
+					common_prefixes +=
+					    "<CommonPrefixes><Prefix>" + EscapeXml(common_prefix) + "</Prefix></CommonPrefixes>";
+					last_common_prefix = common_prefix;
+					++key_count;
+				}
+				continue;
+			}
+			contents += StringUtil::Format("<Contents><Key>%s</Key><LastModified>%s</LastModified><ETag>%s</ETag>"
+			                               "<Size>%llu</Size><StorageClass>STANDARD</StorageClass></Contents>",
+			                               EscapeXml(key), LAST_MODIFIED_ISO, EscapeXml(GetETag(*iter->second)),
+			                               static_cast<unsigned long long>(iter->second->size()));
+			++key_count;
+		}
+	}
+	const auto body = StringUtil::Format("%s<ListBucketResult><Name>%s</Name><Prefix>%s</Prefix>"
+	                                     "<KeyCount>%llu</KeyCount><IsTruncated>false</IsTruncated>%s%s"
+	                                     "</ListBucketResult>",
+	                                     XML_HEADER, EscapeXml(bucket), EscapeXml(prefix),
+	                                     static_cast<unsigned long long>(key_count), contents, common_prefixes);
+	res.set_content(body, XML_CONTENT_TYPE);
+}
+
+void MockObjectServer::HandlePut(const duckdb_httplib::Request &req, duckdb_httplib::Response &res) {
+	if (RespondWithFault(BeginRequest(/*can_stall=*/false), res)) {
+		return;
+	}
+	string bucket;
+	string key;
+	ParsePath(req.path, bucket, key);
+	if (key.empty()) {
+		SetS3Error(res, 400, "InvalidRequest", "Bucket-level PUT is not supported.");
+		return;
+	}
+	res.set_header("ETag", GetETag(req.body));
+	PutObject(bucket, key, req.body);
+	res.status = 200;
+}
+
+void MockObjectServer::HandleDelete(const duckdb_httplib::Request &req, duckdb_httplib::Response &res) {
+	if (RespondWithFault(BeginRequest(/*can_stall=*/false), res)) {
+		return;
+	}
+	string bucket;
+	string key;
+	ParsePath(req.path, bucket, key);
+	{
+		lock_guard<mutex> lck(objects_mutex);
+		objects.erase(GetObjectPath(bucket, key));
+	}
+	// Like S3, deleting a missing key succeeds.
+	res.status = 204;
+}
+
+void MockObjectServer::HandleBatchDelete(const duckdb_httplib::Request &req, duckdb_httplib::Response &res) {
+	if (RespondWithFault(BeginRequest(/*can_stall=*/false), res)) {
+		return;
+	}
+	if (!req.has_param("delete")) {
+		SetS3Error(res, 400, "InvalidRequest", "Only multi-object delete is supported.");
+		return;
+	}
+	string bucket;
+	string key;
+	ParsePath(req.path, bucket, key);
+	string deleted;
+	{
+		lock_guard<mutex> lck(objects_mutex);
+		for (const auto &delete_key : ParseDeleteKeys(req.body)) {
+			objects.erase(GetObjectPath(bucket, delete_key));
+			deleted += "<Deleted><Key>" + delete_key + "</Key></Deleted>";
+		}
+	}
+	res.set_content(StringUtil::Format("%s<DeleteResult>%s</DeleteResult>", XML_HEADER, deleted), XML_CONTENT_TYPE);
+}
+
+} // namespace duckdb
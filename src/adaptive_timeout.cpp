@@ -0,0 +1,107 @@
+#include "adaptive_timeout.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/limits.hpp"
+#include "httpfs_timeout_retry_settings.hpp"
+
+#include <cmath>
+
+namespace duckdb {
+
+namespace {
+
+// HTTP clients only take timeout in whole seconds, so a lower floor doesn't make requests fail faster.
+constexpr uint64_t DEFAULT_ADAPTIVE_TIMEOUT_MIN_MS = 1000;
+constexpr double MICROSECONDS_PER_MILLISECOND = 1000.0;
+
+} // namespace
+
+AdaptiveTimeoutEstimator::AdaptiveTimeoutEstimator() : recent_latencies(WINDOW_SIZE) {
+}
+
+void AdaptiveTimeoutEstimator::Record(uint64_t latency_us) {
+	recent_latencies.Record(latency_us);
+}
+
+bool AdaptiveTimeoutEstimator::TryGetTimeoutMs(const AdaptiveTimeoutConfig &config, uint64_t &timeout_ms) const {
+	return TryGetAdaptiveTimeoutMs(config, recent_latencies, timeout_ms);
+}
+
+AdaptiveTimeoutRegistry &AdaptiveTimeoutRegistry::GetInstance() {
+	static AdaptiveTimeoutRegistry registry;
+	return registry;
+}
+
+AdaptiveTimeoutEstimator &AdaptiveTimeoutRegistry::GetEstimator(HttpfsOperationType operation_type,
+                                                               const string &endpoint) {
+	return registry.GetOrCreate(GetOperationEndpointKey(operation_type, endpoint));
+}
+
+AdaptiveTimeoutConfig GetAdaptiveTimeoutConfig(FileOpener &opener) {
+	AdaptiveTimeoutConfig config;
+	Value value;
+	if (!FileOpener::TryGetCurrentSetting(&opener, HTTPFS_ADAPTIVE_TIMEOUT_MULTIPLIER, value) || value.IsNull()) {
+		return config;
+	}
+	config.multiplier = value.GetValue<double>();
+	if (config.multiplier <= 0) {
+		throw InvalidInputException("%s should be positive, but got %f", HTTPFS_ADAPTIVE_TIMEOUT_MULTIPLIER,
+		                            config.multiplier);
+	}
+	config.enabled = true;
+
+	config.min_timeout_ms = DEFAULT_ADAPTIVE_TIMEOUT_MIN_MS;
+	if (FileOpener::TryGetCurrentSetting(&opener, HTTPFS_ADAPTIVE_TIMEOUT_MIN_MS, value) && !value.IsNull()) {
+		config.min_timeout_ms = value.GetValue<uint64_t>();
+	}
+	// A timeout of zero means no timeout to HTTP clients.
+	config.min_timeout_ms = MaxValue<uint64_t>(config.min_timeout_ms, 1);
+	if (FileOpener::TryGetCurrentSetting(&opener, HTTPFS_ADAPTIVE_TIMEOUT_MAX_MS, value) && !value.IsNull()) {
+		config.has_max_timeout = true;
+		config.max_timeout_ms = MaxValue<uint64_t>(value.GetValue<uint64_t>(), config.min_timeout_ms);
+	}
+	return config;
+}
+
+AdaptiveTimeoutConfig GetAdaptiveTimeoutBounds(const AdaptiveTimeoutConfig &config, TimeoutRetryFileOpener &opener) {
+	auto bounds = config;
+	if (!bounds.has_max_timeout) {
+		if (opener.TryGetTimeoutMs(bounds.max_timeout_ms)) {
+			bounds.max_timeout_ms = MaxValue<uint64_t>(bounds.max_timeout_ms, bounds.min_timeout_ms);
+		} else {
+			bounds.max_timeout_ms = NumericLimits<uint64_t>::Maximum();
+		}
+	}
+	return bounds;
+}
+
+bool TryGetAdaptiveTimeoutMs(const AdaptiveTimeoutConfig &config, const LatencyTracker &latencies,
+                             uint64_t &timeout_ms) {
+	uint64_t latency_us = 0;
+	if (!latencies.TryGetPercentile(AdaptiveTimeoutEstimator::LATENCY_PERCENTILE, AdaptiveTimeoutEstimator::MIN_SAMPLES,
+	                                latency_us)) {
+		return false;
+	}
+	const double latency_ms = static_cast<double>(latency_us) / MICROSECONDS_PER_MILLISECOND;
+	timeout_ms = static_cast<uint64_t>(std::ceil(config.multiplier * latency_ms));
+	timeout_ms = MaxValue<uint64_t>(timeout_ms, config.min_timeout_ms);
+	timeout_ms = MinValue<uint64_t>(timeout_ms, config.max_timeout_ms);
+	return true;
+}
+
+optional_ptr<AdaptiveTimeoutEstimator> ApplyAdaptiveTimeout(const AdaptiveTimeoutConfig &config,
+                                                            TimeoutRetryFileOpener &opener, const string &endpoint) {
+	if (!config.enabled) {
+		return nullptr;
+	}
+	const auto bounds = GetAdaptiveTimeoutBounds(config, opener);
+	auto &estimator = AdaptiveTimeoutRegistry::GetInstance().GetEstimator(opener.GetOperationType(), endpoint);
+	uint64_t timeout_ms = 0;
+	// Without enough observations, fall back to the static per-operation timeout.
+	if (estimator.TryGetTimeoutMs(bounds, timeout_ms)) {
+		opener.SetTimeoutOverrideMs(timeout_ms);
+	}
+	return estimator;
+}
+
+} // namespace duckdb
@@ -0,0 +1,71 @@
+#include "block_cache.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/common/types/hash.hpp"
+#include "httpfs_timeout_retry_settings.hpp"
+
+#include <functional>
+
+namespace duckdb {
+
+namespace {
+
+constexpr idx_t DEFAULT_DISK_CACHE_MAX_SIZE_MB = 10 * 1024;
+constexpr idx_t DEFAULT_CACHE_BLOCK_SIZE = 1024 * 1024;
+constexpr idx_t BYTES_PER_MB = 1024 * 1024;
+
+} // namespace
+
+BlockCacheConfig GetBlockCacheConfig(FileOpener &opener) {
+	BlockCacheConfig config;
+	Value value;
+	if (FileOpener::TryGetCurrentSetting(&opener, HTTPFS_MEMORY_CACHE_MAX_SIZE_MB, value) && !value.IsNull()) {
+		config.memory_max_bytes = value.GetValue<uint64_t>() * BYTES_PER_MB;
+	}
+	if (FileOpener::TryGetCurrentSetting(&opener, HTTPFS_DISK_CACHE_DIRECTORY, value) && !value.IsNull()) {
+		config.disk_directory = value.ToString();
+	}
+	if (!config.IsEnabled()) {
+		return config;
+	}
+	config.disk_max_bytes = DEFAULT_DISK_CACHE_MAX_SIZE_MB * BYTES_PER_MB;
+	if (FileOpener::TryGetCurrentSetting(&opener, HTTPFS_DISK_CACHE_MAX_SIZE_MB, value) && !value.IsNull()) {
+		config.disk_max_bytes = value.GetValue<uint64_t>() * BYTES_PER_MB;
+	}
+	config.block_size = DEFAULT_CACHE_BLOCK_SIZE;
+	if (FileOpener::TryGetCurrentSetting(&opener, HTTPFS_CACHE_BLOCK_SIZE_BYTES, value) && !value.IsNull()) {
+		config.block_size = value.GetValue<uint64_t>();
+		if (config.block_size == 0) {
+			throw InvalidInputException("%s should be positive", HTTPFS_CACHE_BLOCK_SIZE_BYTES);
+		}
+	}
+	return config;
+}
+
+bool TryGetBlockCacheFileHashes(const string &path, const string &version_tag, idx_t block_size,
+                                BlockCacheFileHashes &result) {
+	// Without version tag, a modified file cannot be told apart from the cached one.
+	if (version_tag.empty()) {
+		return false;
+	}
+	const auto key = StringUtil::Format("%s\n%s\n%llu", path, version_tag, block_size);
+	// Two independent 64-bit hashes keep accidental collisions out of reach for any realistic cache size.
+	result.first = static_cast<uint64_t>(Hash(key.c_str(), key.size()));
+	result.second = static_cast<uint64_t>(std::hash<string>()(key));
+	return true;
+}
+
+string GetBlockCacheFileKey(const BlockCacheFileHashes &hashes) {
+	return StringUtil::Format("%016llx%016llx", hashes.first, hashes.second);
+}
+
+string GetBlockCacheFileKey(const string &path, const string &version_tag, idx_t block_size) {
+	BlockCacheFileHashes hashes;
+	if (!TryGetBlockCacheFileHashes(path, version_tag, block_size, hashes)) {
+		return string();
+	}
+	return GetBlockCacheFileKey(hashes);
+}
+
+} // namespace duckdb
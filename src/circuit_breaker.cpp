@@ -0,0 +1,84 @@
+#include "circuit_breaker.hpp"
+
+namespace duckdb {
+
+CircuitBreaker::CircuitBreaker(string endpoint_p) : endpoint(std::move(endpoint_p)) {
+}
+
+bool CircuitBreaker::TryAcquire(const CircuitBreakerConfig &config, std::chrono::steady_clock::time_point now) {
+	if (state.load(std::memory_order_relaxed) == State::CLOSED) {
+		return true;
+	}
+	lock_guard<mutex> lck(breaker_mutex);
+	switch (state.load(std::memory_order_relaxed)) {
+	case State::CLOSED:
+		return true;
+	case State::OPEN:
+		if (now - opened_at < std::chrono::milliseconds(config.cool_down_ms)) {
+			return false;
+		}
+		state.store(State::HALF_OPEN, std::memory_order_relaxed);
+		probe_in_flight = true;
+		return true;
+	case State::HALF_OPEN:
+		if (probe_in_flight) {
+			return false;
+		}
+		probe_in_flight = true;
+		return true;
+	default:
+		return false;
+	}
+}
+
+void CircuitBreaker::RecordSuccess() {
+	if (state.load(std::memory_order_relaxed) == State::CLOSED &&
+	    consecutive_failures.load(std::memory_order_relaxed) == 0) {
+		return;
+	}
+	lock_guard<mutex> lck(breaker_mutex);
+	consecutive_failures.store(0, std::memory_order_relaxed);
+	state.store(State::CLOSED, std::memory_order_relaxed);
+	probe_in_flight = false;
+}
+
+void CircuitBreaker::RecordFailure(const CircuitBreakerConfig &config, std::chrono::steady_clock::time_point now) {
+	lock_guard<mutex> lck(breaker_mutex);
+	const auto failures = consecutive_failures.fetch_add(1, std::memory_order_relaxed) + 1;
+	switch (state.load(std::memory_order_relaxed)) {
+	case State::CLOSED:
+		if (failures >= config.failure_threshold) {
+			state.store(State::OPEN, std::memory_order_relaxed);
+			opened_at = now;
+		}
+		break;
+	case State::HALF_OPEN:
+		// The probe failed, wait for another cool-down.
+		state.store(State::OPEN, std::memory_order_relaxed);
+		opened_at = now;
+		probe_in_flight = false;
+		break;
+	case State::OPEN:
+		// Requests let through before the breaker tripped.
+		break;
+	}
+}
+
+bool CircuitBreaker::TryAcquire(const CircuitBreakerConfig &config) {
+	return TryAcquire(config, std::chrono::steady_clock::now());
+}
+
+void CircuitBreaker::RecordFailure(const CircuitBreakerConfig &config) {
+	RecordFailure(config, std::chrono::steady_clock::now());
+}
+
+CircuitBreakerRegistry &CircuitBreakerRegistry::GetInstance() {
+	static CircuitBreakerRegistry registry;
+	return registry;
+}
+
+CircuitBreaker &CircuitBreakerRegistry::GetCircuitBreaker(const string &endpoint) {
+	return registry.GetOrCreate(endpoint, endpoint);
+}
+
+} // namespace duckdb
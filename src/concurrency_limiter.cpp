@@ -0,0 +1,116 @@
+#include "concurrency_limiter.hpp"
+
+#include "duckdb/common/helper.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+namespace duckdb {
+
+//===--------------------------------------------------------------------===//
+// ConcurrencyLimiter
+//===--------------------------------------------------------------------===//
+
+bool ConcurrencyLimiter::IsHighPriority(HttpfsOperationType operation_type) {
+	return operation_type != HttpfsOperationType::READ && operation_type != HttpfsOperationType::WRITE;
+}
+
+bool ConcurrencyLimiter::HasFreeSlot(HttpfsOperationType operation_type, const ConcurrencyLimitConfig &config) const {
+	if (in_flight_count >= config.max_requests) {
+		return false;
+	}
+	return config.max_requests_per_operation == 0 ||
+	       in_flight_per_operation[static_cast<idx_t>(operation_type)] < config.max_requests_per_operation;
+}
+
+void ConcurrencyLimiter::Enqueue(Waiter &waiter) {
+	auto position = waiters.end();
+	if (IsHighPriority(waiter.operation_type)) {
+		position = std::find_if(waiters.begin(), waiters.end(),
+		                        [](const Waiter *queued) { return !IsHighPriority(queued->operation_type); });
+	}
+	waiters.insert(position, &waiter);
+}
+
+void ConcurrencyLimiter::TakeSlot(HttpfsOperationType operation_type) {
+	++in_flight_count;
+	++in_flight_per_operation[static_cast<idx_t>(operation_type)];
+}
+
+void ConcurrencyLimiter::GrantSlots() {
+	auto iter = waiters.begin();
+	while (iter != waiters.end()) {
+		auto &waiter = **iter;
+		// Requests further down the queue cannot skip one held back by the total limit.
+		if (in_flight_count >= waiter.config->max_requests) {
+			return;
+		}
+		if (!HasFreeSlot(waiter.operation_type, *waiter.config)) {
+			++iter;
+			continue;
+		}
+		TakeSlot(waiter.operation_type);
+		waiter.granted = true;
+		waiter.slot_cv.notify_one();
+		iter = waiters.erase(iter);
+	}
+}
+
+uint64_t ConcurrencyLimiter::Acquire(HttpfsOperationType operation_type, const ConcurrencyLimitConfig &config) {
+	std::unique_lock<mutex> lck(limiter_mutex);
+	// Waiting requests never fit in the limits, so a free slot means none of them could take it.
+	if (HasFreeSlot(operation_type, config)) {
+		TakeSlot(operation_type);
+		return 0;
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+	Waiter waiter {operation_type, &config};
+	Enqueue(waiter);
+	waiter.slot_cv.wait(lck, [&waiter]() { return waiter.granted; });
+	const auto wait_us =
+	    std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+	return MaxValue<uint64_t>(static_cast<uint64_t>(wait_us), 1);
+}
+
+bool ConcurrencyLimiter::TryAcquire(HttpfsOperationType operation_type, const ConcurrencyLimitConfig &config) {
+	lock_guard<mutex> lck(limiter_mutex);
+	if (!HasFreeSlot(operation_type, config)) {
+		return false;
+	}
+	TakeSlot(operation_type);
+	return true;
+}
+
+void ConcurrencyLimiter::Release(HttpfsOperationType operation_type) {
+	lock_guard<mutex> lck(limiter_mutex);
+	D_ASSERT(in_flight_count > 0);
+	--in_flight_count;
+	--in_flight_per_operation[static_cast<idx_t>(operation_type)];
+	GrantSlots();
+}
+
+idx_t ConcurrencyLimiter::GetInFlightCount() const {
+	lock_guard<mutex> lck(limiter_mutex);
+	return in_flight_count;
+}
+
+idx_t ConcurrencyLimiter::GetWaitingCount() const {
+	lock_guard<mutex> lck(limiter_mutex);
+	return waiters.size();
+}
+
+//===--------------------------------------------------------------------===//
+// ConcurrencyLimiterRegistry
+//===--------------------------------------------------------------------===//
+
+ConcurrencyLimiterRegistry &ConcurrencyLimiterRegistry::GetInstance() {
+	static ConcurrencyLimiterRegistry registry;
+	return registry;
+}
+
+ConcurrencyLimiter &ConcurrencyLimiterRegistry::GetConcurrencyLimiter(const string &endpoint) {
+	return registry.GetOrCreate(endpoint);
+}
+
+} // namespace duckdb
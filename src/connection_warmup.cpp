@@ -0,0 +1,200 @@
+#include "connection_warmup.hpp"
+
+#include "duckdb/common/algorithm.hpp"
+#include "duckdb/common/atomic.hpp"
+#include "duckdb/common/error_data.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/common/types/data_chunk.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "duckdb/main/database.hpp"
+#include "endpoint_util.hpp"
+#include "httpfs_timeout_retry_settings.hpp"
+
+#include <chrono>
+#include <thread>
+
+namespace duckdb {
+
+namespace {
+
+// Max number of endpoints warmed up concurrently.
+constexpr idx_t MAX_WARMUP_PARALLELISM = 16;
+
+constexpr double MICROSECONDS_PER_MILLISECOND = 1000.0;
+
+// Whether requests sent by the current thread are warm-up requests.
+thread_local bool warmup_request_active = false;
+
+// Run [func] for each index below [count], on up to MAX_WARMUP_PARALLELISM threads, the calling thread included.
+template <class FUNC>
+void RunConcurrently(idx_t count, FUNC &&func) {
+	atomic<idx_t> next_index {0};
+	auto run_tasks = [&]() {
+		for (auto idx = next_index.fetch_add(1); idx < count; idx = next_index.fetch_add(1)) {
+			func(idx);
+		}
+	};
+	const auto thread_count = MinValue<idx_t>(MAX_WARMUP_PARALLELISM, count);
+	vector<std::thread> threads;
+	for (idx_t thread_index = 1; thread_index < thread_count; ++thread_index) {
+		threads.emplace_back(run_tasks);
+	}
+	run_tasks();
+	for (auto &thread : threads) {
+		thread.join();
+	}
+}
+
+WarmupResult WarmUpEndpoint(FileSystem &fs, const string &endpoint, optional_ptr<FileOpener> opener) {
+	WarmupResult result;
+	result.endpoint = endpoint;
+	const auto start = std::chrono::steady_clock::now();
+	WarmupRequestScope warmup_request_scope;
+	try {
+		// Opening the root issues a single HEAD request; a missing object is not an error.
+		fs.OpenFile(endpoint + "/", FileFlags::FILE_FLAGS_READ | FileFlags::FILE_FLAGS_NULL_IF_NOT_EXISTS, opener);
+		result.connected = true;
+	} catch (std::exception &ex) {
+		ErrorData error(ex);
+		// An error response means the connection is set up, only the root is not readable.
+		result.connected = error.Type() == ExceptionType::HTTP;
+		if (!result.connected) {
+			result.error = error.RawMessage();
+		}
+	}
+	result.latency_us = static_cast<uint64_t>(
+	    std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+	return result;
+}
+
+//===--------------------------------------------------------------------===//
+// httpfs_warmup table function
+//===--------------------------------------------------------------------===//
+
+struct WarmupBindData : public TableFunctionData {
+	vector<string> endpoints;
+};
+
+struct WarmupData : public GlobalTableFunctionState {
+	vector<WarmupResult> results;
+	// Index of the next result to emit.
+	idx_t offset = 0;
+};
+
+unique_ptr<FunctionData> WarmupBind(ClientContext &context, TableFunctionBindInput &input,
+                                    vector<LogicalType> &return_types, vector<string> &names) {
+	auto bind_data = make_uniq<WarmupBindData>();
+	if (!input.inputs[0].IsNull()) {
+		bind_data->endpoints = ParseWarmupEndpoints(input.inputs[0].ToString());
+	}
+	names.emplace_back("endpoint");
+	return_types.emplace_back(LogicalType::VARCHAR);
+	names.emplace_back("connected");
+	return_types.emplace_back(LogicalType::BOOLEAN);
+	names.emplace_back("latency_ms");
+	return_types.emplace_back(LogicalType::DOUBLE);
+	names.emplace_back("error");
+	return_types.emplace_back(LogicalType::VARCHAR);
+	return std::move(bind_data);
+}
+
+unique_ptr<GlobalTableFunctionState> WarmupInit(ClientContext &context, TableFunctionInitInput &input) {
+	auto &bind_data = input.bind_data->Cast<WarmupBindData>();
+	auto state = make_uniq<WarmupData>();
+	// The client filesystem sends requests with the settings and secrets of the connection.
+	state->results = WarmUpEndpoints(FileSystem::GetFileSystem(context), bind_data.endpoints, nullptr);
+	return std::move(state);
+}
+
+void WarmupFunc(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+	auto &state = data_p.global_state->Cast<WarmupData>();
+	idx_t count = 0;
+	while (state.offset < state.results.size() && count < STANDARD_VECTOR_SIZE) {
+		const auto &result = state.results[state.offset++];
+		idx_t col = 0;
+		output.SetValue(col++, count, Value(result.endpoint));
+		output.SetValue(col++, count, Value::BOOLEAN(result.connected));
+		output.SetValue(col++, count,
+		                Value::DOUBLE(static_cast<double>(result.latency_us) / MICROSECONDS_PER_MILLISECOND));
+		output.SetValue(col++, count, result.error.empty() ? Value() : Value(result.error));
+		++count;
+	}
+	output.SetCardinality(count);
+}
+
+} // namespace
+
+WarmupRequestScope::WarmupRequestScope() {
+	warmup_request_active = true;
+}
+
+WarmupRequestScope::~WarmupRequestScope() {
+	warmup_request_active = false;
+}
+
+bool WarmupRequestScope::IsActive() {
+	return warmup_request_active;
+}
+
+vector<string> ParseWarmupEndpoints(const string &endpoints) {
+	vector<string> result;
+	for (auto &entry : StringUtil::Split(endpoints, ',')) {
+		StringUtil::Trim(entry);
+		if (entry.empty()) {
+			continue;
+		}
+		const auto endpoint = GetEndpoint(entry);
+		if (endpoint.empty() || StringUtil::EndsWith(endpoint, "://")) {
+			throw InvalidInputException("%s should be a comma-separated list of endpoints with a scheme, i.e. "
+			                            "'s3://bucket,https://example.com', but got '%s'",
+			                            HTTPFS_WARMUP_ENDPOINTS, entry);
+		}
+		if (std::find(result.begin(), result.end(), endpoint) == result.end()) {
+			result.push_back(endpoint);
+		}
+	}
+	return result;
+}
+
+vector<WarmupResult> WarmUpEndpoints(FileSystem &fs, const vector<string> &endpoints, optional_ptr<FileOpener> opener) {
+	vector<WarmupResult> results(endpoints.size());
+	RunConcurrently(endpoints.size(), [&](idx_t idx) { results[idx] = WarmUpEndpoint(fs, endpoints[idx], opener); });
+	return results;
+}
+
+void StartBackgroundWarmup(weak_ptr<DatabaseInstance> db_instance, vector<string> endpoints) {
+	if (endpoints.empty()) {
+		return;
+	}
+	std::thread([db_instance, endpoints]() {
+		try {
+			RunConcurrently(endpoints.size(), [&](idx_t idx) {
+				// The database is only held while a request is in flight, so the warm-up doesn't keep a closed
+				// database alive; endpoints left once it's closed are skipped.
+				auto db = db_instance.lock();
+				if (!db) {
+					return;
+				}
+				// The database filesystem sends requests with database-wide settings and secrets.
+				WarmUpEndpoint(FileSystem::GetFileSystem(*db), endpoints[idx], nullptr);
+			});
+		} catch (...) {
+			// Warm-up is best effort, queries report their own errors.
+		}
+	}).detach();
+}
+
+void OnWarmupEndpointsChanged(ClientContext &context, SetScope scope, Value &parameter) {
+	if (parameter.IsNull()) {
+		return;
+	}
+	// Endpoints are validated synchronously, so invalid values fail the SET statement.
+	StartBackgroundWarmup(context.db, ParseWarmupEndpoints(parameter.ToString()));
+}
+
+TableFunction GetWarmupFunction() {
+	return TableFunction("httpfs_warmup", /*arguments=*/ {LogicalType::VARCHAR}, WarmupFunc, WarmupBind, WarmupInit);
+}
+
+} // namespace duckdb
@@ -0,0 +1,182 @@
+#include "disk_block_cache.hpp"
+
+#include "duckdb/common/helper.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/common/vector.hpp"
+
+#include <functional>
+#include <thread>
+
+namespace duckdb {
+
+namespace {
+
+constexpr const char *BLOCK_FILE_SUFFIX = ".block";
+// Suffix of temporary files, which are renamed to block files once fully written.
+constexpr const char *TEMP_FILE_SUFFIX = ".tmp";
+
+string GetBlockName(const string &file_key, idx_t block_index) {
+	return StringUtil::Format("%s-%llu%s", file_key, block_index, BLOCK_FILE_SUFFIX);
+}
+
+} // namespace
+
+//===--------------------------------------------------------------------===//
+// DiskBlockCache
+//===--------------------------------------------------------------------===//
+
+DiskBlockCache::DiskBlockCache(string directory_p)
+    : directory(std::move(directory_p)), local_filesystem(FileSystem::CreateLocal()) {
+	try {
+		if (!local_filesystem->DirectoryExists(directory)) {
+			local_filesystem->CreateDirectoriesRecursive(directory);
+		}
+		LoadExistingBlocks();
+	} catch (std::exception &) {
+		// Unusable directory, every lookup misses and every write fails silently.
+	}
+}
+
+string DiskBlockCache::GetBlockPath(const string &block_name) const {
+	return local_filesystem->JoinPath(directory, block_name);
+}
+
+void DiskBlockCache::LoadExistingBlocks() {
+	vector<string> block_names;
+	vector<string> temp_names;
+	local_filesystem->ListFiles(directory, [&](const string &name, bool is_directory) {
+		if (is_directory) {
+			return;
+		}
+		if (StringUtil::EndsWith(name, BLOCK_FILE_SUFFIX)) {
+			block_names.emplace_back(name);
+		} else if (StringUtil::Contains(name, TEMP_FILE_SUFFIX)) {
+			temp_names.emplace_back(name);
+		}
+	});
+	for (const auto &temp_name : temp_names) {
+		local_filesystem->TryRemoveFile(GetBlockPath(temp_name));
+	}
+	lock_guard<mutex> lck(cache_mutex);
+	for (auto &block_name : block_names) {
+		auto handle = local_filesystem->OpenFile(GetBlockPath(block_name),
+		                                         FileFlags::FILE_FLAGS_READ | FileFlags::FILE_FLAGS_NULL_IF_NOT_EXISTS);
+		if (handle == nullptr) {
+			continue;
+		}
+		const auto nr_bytes = static_cast<idx_t>(handle->GetFileSize());
+		lru_list.emplace_back(BlockEntry {block_name, nr_bytes});
+		entries[block_name] = std::prev(lru_list.end());
+		size_bytes += nr_bytes;
+	}
+}
+
+bool DiskBlockCache::Contains(const string &file_key, idx_t block_index) const {
+	lock_guard<mutex> lck(cache_mutex);
+	return entries.find(GetBlockName(file_key, block_index)) != entries.end();
+}
+
+bool DiskBlockCache::TryRead(const string &file_key, idx_t block_index, data_ptr_t buffer, idx_t nr_bytes) {
+	const auto block_name = GetBlockName(file_key, block_index);
+	{
+		lock_guard<mutex> lck(cache_mutex);
+		auto iter = entries.find(block_name);
+		if (iter == entries.end()) {
+			return false;
+		}
+		lru_list.splice(lru_list.begin(), lru_list, iter->second);
+	}
+	try {
+		auto handle = local_filesystem->OpenFile(GetBlockPath(block_name),
+		                                         FileFlags::FILE_FLAGS_READ | FileFlags::FILE_FLAGS_NULL_IF_NOT_EXISTS);
+		// Block could have been evicted by another process sharing the directory, or be truncated.
+		if (handle != nullptr && static_cast<idx_t>(handle->GetFileSize()) == nr_bytes) {
+			handle->Read(buffer, nr_bytes, 0);
+			return true;
+		}
+	} catch (std::exception &) {
+	}
+	{
+		lock_guard<mutex> lck(cache_mutex);
+		EraseEntry(block_name);
+	}
+	local_filesystem->TryRemoveFile(GetBlockPath(block_name));
+	return false;
+}
+
+void DiskBlockCache::Write(const string &file_key, idx_t block_index, const_data_ptr_t buffer, idx_t nr_bytes,
+                           idx_t max_bytes) {
+	if (nr_bytes > max_bytes) {
+		return;
+	}
+	const auto block_name = GetBlockName(file_key, block_index);
+	const auto block_path = GetBlockPath(block_name);
+	// Written to a temporary file first and renamed, so readers never see a partially written block.
+	const auto thread_hash = static_cast<uint64_t>(std::hash<std::thread::id>()(std::this_thread::get_id()));
+	const auto temp_path =
+	    StringUtil::Format("%s%s.%llu.%llu", block_path, TEMP_FILE_SUFFIX, thread_hash, write_counter.fetch_add(1));
+	try {
+		auto handle = local_filesystem->OpenFile(temp_path, FileFlags::FILE_FLAGS_WRITE |
+		                                                        FileFlags::FILE_FLAGS_FILE_CREATE_NEW);
+		handle->Write(const_cast<data_ptr_t>(buffer), nr_bytes, 0);
+		handle->Close();
+		local_filesystem->MoveFile(temp_path, block_path);
+	} catch (std::exception &) {
+		local_filesystem->TryRemoveFile(temp_path);
+		return;
+	}
+
+	vector<string> evicted_names;
+	{
+		lock_guard<mutex> lck(cache_mutex);
+		if (entries.find(block_name) != entries.end()) {
+			EraseEntry(block_name);
+		}
+		lru_list.emplace_front(BlockEntry {block_name, nr_bytes});
+		entries[block_name] = lru_list.begin();
+		size_bytes += nr_bytes;
+		while (size_bytes > max_bytes) {
+			const auto evicted_name = lru_list.back().block_name;
+			EraseEntry(evicted_name);
+			evicted_names.emplace_back(evicted_name);
+		}
+	}
+	for (const auto &evicted_name : evicted_names) {
+		local_filesystem->TryRemoveFile(GetBlockPath(evicted_name));
+	}
+}
+
+void DiskBlockCache::EraseEntry(const string &block_name) {
+	auto iter = entries.find(block_name);
+	if (iter == entries.end()) {
+		return;
+	}
+	size_bytes -= iter->second->nr_bytes;
+	lru_list.erase(iter->second);
+	entries.erase(iter);
+}
+
+idx_t DiskBlockCache::GetBlockCount() const {
+	lock_guard<mutex> lck(cache_mutex);
+	return entries.size();
+}
+
+idx_t DiskBlockCache::GetSizeBytes() const {
+	lock_guard<mutex> lck(cache_mutex);
+	return size_bytes;
+}
+
+//===--------------------------------------------------------------------===//
+// DiskBlockCacheRegistry
+//===--------------------------------------------------------------------===//
+
+DiskBlockCacheRegistry &DiskBlockCacheRegistry::GetInstance() {
+	static DiskBlockCacheRegistry registry;
+	return registry;
+}
+
+DiskBlockCache &DiskBlockCacheRegistry::GetDiskBlockCache(const string &directory) {
+	return registry.GetOrCreate(directory, directory);
+}
+
+} // namespace duckdb
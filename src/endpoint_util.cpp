@@ -0,0 +1,31 @@
+#include "endpoint_util.hpp"
+
+#include "duckdb/common/string_util.hpp"
+
+#include <cstring>
+
+namespace duckdb {
+
+namespace {
+
+constexpr const char *SCHEME_DELIMITER = "://";
+
+} // namespace
+
+string GetEndpoint(const string &path) {
+	const auto scheme_end = path.find(SCHEME_DELIMITER);
+	if (scheme_end == string::npos) {
+		return "";
+	}
+	const auto authority_start = scheme_end + strlen(SCHEME_DELIMITER);
+	auto authority_end = path.find_first_of("/?#", authority_start);
+	if (authority_end == string::npos) {
+		authority_end = path.size();
+	}
+	const auto scheme = StringUtil::Lower(path.substr(0, scheme_end));
+	// Host names are case insensitive.
+	const auto authority = StringUtil::Lower(path.substr(authority_start, authority_end - authority_start));
+	return scheme + SCHEME_DELIMITER + authority;
+}
+
+} // namespace duckdb
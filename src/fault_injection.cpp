@@ -0,0 +1,239 @@
+#include "fault_injection.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/common/types/hash.hpp"
+#include "httpfs_timeout_retry_settings.hpp"
+#include "partitioned_glob.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+namespace duckdb {
+
+namespace {
+
+// Max number of (operation type, path) pairs with a sequence, which bounds memory of long sessions; sequences restart
+// once it's reached.
+constexpr idx_t MAX_FAULT_SEQUENCES = 1 << 20;
+
+constexpr uint64_t GOLDEN_RATIO_64 = 0x9E3779B97F4A7C15ULL;
+constexpr double PI = 3.14159265358979323846;
+
+// Indices of the random numbers drawn for one request.
+constexpr uint64_t LATENCY_DRAW = 0;
+constexpr uint64_t LATENCY_SHAPE_DRAW = 1;
+constexpr uint64_t ERROR_DRAW = 2;
+constexpr uint64_t STALL_DRAW = 3;
+
+// Finalizer of splitmix64, which spreads every input bit over the output.
+uint64_t Mix(uint64_t value) {
+	value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+	return value ^ (value >> 31);
+}
+
+// Get the random number with index [draw] in [0, 1) of the request identified by [request_hash].
+double GetRandom(uint64_t request_hash, uint64_t draw) {
+	const auto bits = Mix(request_hash + (draw + 1) * GOLDEN_RATIO_64);
+	// Top 53 bits make a double with every value in [0, 1) equally likely.
+	return static_cast<double>(bits >> 11) * (1.0 / static_cast<double>(1ULL << 53));
+}
+
+string GetSequenceKey(HttpfsOperationType operation_type, const string &path) {
+	return HttpfsOperationTypeToString(operation_type) + " " + path;
+}
+
+// Distributions are sampled from uniform numbers by hand rather than with std distributions, whose algorithms differ
+// across standard libraries, so a seed injects the same faults on every platform.
+uint64_t SampleLatencyMs(const FaultInjectionConfig &config, uint64_t request_hash) {
+	const auto mean_ms = static_cast<double>(config.latency_ms);
+	if (mean_ms <= 0) {
+		return 0;
+	}
+	const auto random = GetRandom(request_hash, LATENCY_DRAW);
+	switch (config.latency_distribution) {
+	case FaultLatencyDistribution::FIXED:
+		return config.latency_ms;
+	case FaultLatencyDistribution::UNIFORM:
+		return static_cast<uint64_t>(random * 2 * mean_ms);
+	case FaultLatencyDistribution::EXPONENTIAL:
+		return static_cast<uint64_t>(-mean_ms * std::log1p(-random));
+	case FaultLatencyDistribution::LOGNORMAL: {
+		// Box-Muller transform of two uniform numbers into a standard normal one.
+		const auto shape_random = GetRandom(request_hash, LATENCY_SHAPE_DRAW);
+		const auto normal = std::sqrt(-2 * std::log1p(-random)) * std::cos(2 * PI * shape_random);
+		return static_cast<uint64_t>(mean_ms * std::exp(config.latency_sigma * normal));
+	}
+	default:
+		throw InternalException("Unknown FaultLatencyDistribution: %d", static_cast<int>(config.latency_distribution));
+	}
+}
+
+FaultLatencyDistribution GetLatencyDistribution(FileOpener &opener) {
+	Value value;
+	if (!FileOpener::TryGetCurrentSetting(&opener, HTTPFS_FAULT_LATENCY_DISTRIBUTION, value) || value.IsNull()) {
+		return FaultLatencyDistribution::FIXED;
+	}
+	const auto distribution = StringUtil::Lower(value.ToString());
+	if (distribution == "fixed") {
+		return FaultLatencyDistribution::FIXED;
+	}
+	if (distribution == "uniform") {
+		return FaultLatencyDistribution::UNIFORM;
+	}
+	if (distribution == "exponential") {
+		return FaultLatencyDistribution::EXPONENTIAL;
+	}
+	if (distribution == "lognormal") {
+		return FaultLatencyDistribution::LOGNORMAL;
+	}
+	throw InvalidInputException(
+	    "%s should be one of 'fixed', 'uniform', 'exponential' and 'lognormal', but got '%s'",
+	    HTTPFS_FAULT_LATENCY_DISTRIBUTION, value.ToString());
+}
+
+double GetRate(FileOpener &opener, const char *setting) {
+	Value value;
+	if (!FileOpener::TryGetCurrentSetting(&opener, setting, value) || value.IsNull()) {
+		return 0;
+	}
+	const auto rate = value.GetValue<double>();
+	if (rate < 0 || rate > 1) {
+		throw InvalidInputException("%s should be in range [0, 1], but got %f", setting, rate);
+	}
+	return rate;
+}
+
+void ParseOperations(const string &operations, FaultInjectionConfig &config) {
+	config.operations.fill(false);
+	for (auto &name : StringUtil::Split(operations, ',')) {
+		StringUtil::Trim(name);
+		name = StringUtil::Lower(name);
+		bool found = false;
+		for (idx_t idx = 0; idx < HTTPFS_OPERATION_TYPE_COUNT; ++idx) {
+			const auto operation_type = static_cast<HttpfsOperationType>(idx);
+			if (operation_type != HttpfsOperationType::WRITE && name == HttpfsOperationTypeToString(operation_type)) {
+				config.operations[idx] = true;
+				found = true;
+			}
+		}
+		if (!found) {
+			throw InvalidInputException(
+			    "%s should only contain 'open', 'list', 'delete', 'stat', 'create_dir' and 'read', but got '%s'",
+			    HTTPFS_FAULT_OPERATIONS, name);
+		}
+	}
+}
+
+// Sleep for [timeout_ms] and fail with a timeout if a fault of [fault_ms] reaches the request timeout.
+void FailIfTimedOut(HttpfsOperationType operation_type, const string &path, uint64_t fault_ms, uint64_t timeout_ms) {
+	if (timeout_ms == 0 || fault_ms < timeout_ms) {
+		return;
+	}
+	std::this_thread::sleep_for(std::chrono::milliseconds(timeout_ms));
+	throw IOException("Injected fault: %s of %s timed out after %llu ms", HttpfsOperationTypeToString(operation_type),
+	                  path, timeout_ms);
+}
+
+} // namespace
+
+bool FaultInjectionConfig::AppliesTo(HttpfsOperationType operation_type, const string &path) const {
+	return enabled && operations[static_cast<idx_t>(operation_type)] &&
+	       (path_pattern.empty() || MatchGlobSegment(path, path_pattern));
+}
+
+FaultInjectionConfig GetFaultInjectionConfig(FileOpener &opener) {
+	FaultInjectionConfig config;
+	Value value;
+	if (FileOpener::TryGetCurrentSetting(&opener, HTTPFS_FAULT_LATENCY_MS, value) && !value.IsNull()) {
+		config.latency_ms = value.GetValue<uint64_t>();
+	}
+	config.error_rate = GetRate(opener, HTTPFS_FAULT_ERROR_RATE);
+	config.stall_rate = GetRate(opener, HTTPFS_FAULT_STALL_RATE);
+	if (FileOpener::TryGetCurrentSetting(&opener, HTTPFS_FAULT_STALL_MS, value) && !value.IsNull()) {
+		config.stall_ms = value.GetValue<uint64_t>();
+	}
+	config.enabled = config.latency_ms > 0 || config.error_rate > 0 || (config.stall_rate > 0 && config.stall_ms > 0);
+	if (!config.enabled) {
+		return config;
+	}
+
+	config.latency_distribution = GetLatencyDistribution(opener);
+	if (FileOpener::TryGetCurrentSetting(&opener, HTTPFS_FAULT_LATENCY_SIGMA, value) && !value.IsNull()) {
+		config.latency_sigma = value.GetValue<double>();
+		if (config.latency_sigma < 0) {
+			throw InvalidInputException("%s should be non-negative, but got %f", HTTPFS_FAULT_LATENCY_SIGMA,
+			                            config.latency_sigma);
+		}
+	}
+	config.operations.fill(true);
+	config.operations[static_cast<idx_t>(HttpfsOperationType::WRITE)] = false;
+	if (FileOpener::TryGetCurrentSetting(&opener, HTTPFS_FAULT_OPERATIONS, value) && !value.IsNull()) {
+		ParseOperations(value.ToString(), config);
+	}
+	if (FileOpener::TryGetCurrentSetting(&opener, HTTPFS_FAULT_PATH_PATTERN, value) && !value.IsNull()) {
+		config.path_pattern = value.ToString();
+	}
+	if (FileOpener::TryGetCurrentSetting(&opener, HTTPFS_FAULT_SEED, value) && !value.IsNull()) {
+		config.seed = value.GetValue<uint64_t>();
+	}
+	return config;
+}
+
+//===--------------------------------------------------------------------===//
+// FaultInjector
+//===--------------------------------------------------------------------===//
+
+InjectedFault FaultInjector::Draw(const FaultInjectionConfig &config, HttpfsOperationType operation_type,
+                                  const string &path, uint64_t sequence) {
+	const auto key = GetSequenceKey(operation_type, path);
+	const auto request_hash = Mix(config.seed ^ Mix(Hash(key.c_str(), key.size()) ^ Mix(sequence)));
+	InjectedFault fault;
+	fault.latency_ms = SampleLatencyMs(config, request_hash);
+	fault.error = GetRandom(request_hash, ERROR_DRAW) < config.error_rate;
+	if (operation_type == HttpfsOperationType::READ && GetRandom(request_hash, STALL_DRAW) < config.stall_rate) {
+		fault.stall_ms = config.stall_ms;
+	}
+	return fault;
+}
+
+InjectedFault FaultInjector::Draw(const FaultInjectionConfig &config, HttpfsOperationType operation_type,
+                                  const string &path) {
+	uint64_t sequence = 0;
+	{
+		lock_guard<mutex> lck(sequence_mutex);
+		if (sequence_seed != config.seed || sequences.size() >= MAX_FAULT_SEQUENCES) {
+			sequence_seed = config.seed;
+			sequences.clear();
+		}
+		sequence = sequences[GetSequenceKey(operation_type, path)]++;
+	}
+	return Draw(config, operation_type, path, sequence);
+}
+
+uint64_t FaultInjector::Inject(const FaultInjectionConfig &config, HttpfsOperationType operation_type,
+                               const string &path, uint64_t timeout_ms) {
+	if (!config.AppliesTo(operation_type, path)) {
+		return 0;
+	}
+	const auto fault = Draw(config, operation_type, path);
+	FailIfTimedOut(operation_type, path, fault.latency_ms, timeout_ms);
+	if (fault.latency_ms > 0) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(fault.latency_ms));
+	}
+	if (fault.error) {
+		throw IOException("Injected fault: transient error on %s of %s", HttpfsOperationTypeToString(operation_type),
+		                  path);
+	}
+	return fault.stall_ms;
+}
+
+void FaultInjector::Stall(HttpfsOperationType operation_type, const string &path, uint64_t stall_ms,
+                          uint64_t timeout_ms) {
+	FailIfTimedOut(operation_type, path, stall_ms, timeout_ms);
+	std::this_thread::sleep_for(std::chrono::milliseconds(stall_ms));
+}
+
+} // namespace duckdb
@@ -1,64 +1,844 @@
 #include "file_system_timeout_retry_wrapper.hpp"
 
+#include "duckdb/common/algorithm.hpp"
+#include "duckdb/common/atomic.hpp"
+#include "duckdb/common/exception.hpp"
 #include "duckdb/common/file_system.hpp"
+#include "duckdb/common/helper.hpp"
+#include "duckdb/common/shared_ptr.hpp"
 #include "duckdb/common/string.hpp"
 #include "duckdb/common/string_util.hpp"
+#include "duckdb/common/types/hash.hpp"
+#include "duckdb/common/unordered_map.hpp"
 #include "duckdb/common/vector.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "duckdb/main/client_context_file_opener.hpp"
 #include "duckdb/main/database_file_opener.hpp"
+#include "adaptive_timeout.hpp"
+#include "block_cache.hpp"
+#include "connection_warmup.hpp"
+#include "endpoint_util.hpp"
+#include "http_state.hpp"
+#include "httpfs_timeout_retry_settings.hpp"
+#include "listing_cache.hpp"
+#include "metadata_cache.hpp"
+#include "partitioned_glob.hpp"
+#include "retry_policy.hpp"
+#include "s3fs.hpp"
+#include "task_executor.hpp"
 #include "timeout_retry_file_opener.hpp"
+#include "timeout_retry_metrics.hpp"
+#include "timeout_retry_policy.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <iterator>
+#include <thread>
+#include <utility>
 
 namespace duckdb {
 
+namespace {
+
+// Min number of read latency samples before a percentile-based hedging delay is trusted.
+constexpr idx_t HEDGE_MIN_LATENCY_SAMPLES = 32;
+
+constexpr uint64_t MILLISECONDS_PER_SECOND = 1000;
+
+// Positional reads are issued as one ranged request; once it fails, retries read in chunks of this size, so a retry
+// which fails again resumes from the last completed chunk instead of downloading the whole range again.
+constexpr int64_t READ_RESUME_CHUNK_SIZE = 8 * 1024 * 1024;
+
+// Uploader settings of the inner filesystem, and its default max number of parts of a multipart upload.
+constexpr const char *S3_UPLOADER_MAX_FILESIZE = "s3_uploader_max_filesize";
+constexpr const char *S3_UPLOADER_MAX_PARTS_PER_FILE = "s3_uploader_max_parts_per_file";
+constexpr const char *S3_UPLOADER_THREAD_LIMIT = "s3_uploader_thread_limit";
+constexpr uint64_t DEFAULT_UPLOADER_MAX_PARTS_PER_FILE = 10000;
+
+// Max number of keys of a multi-object delete request, which is the limit of S3 DeleteObjects.
+constexpr idx_t MAX_DELETE_BATCH_SIZE = 1000;
+// Max number of failed files listed in the error of a batched delete.
+constexpr idx_t MAX_REPORTED_DELETE_FAILURES = 20;
+
+// State shared between a foreground read and its background requests, which could outlive the foreground read if they
+// lose the race or miss the deadline.
+struct BackgroundReadState {
+	mutex state_mutex;
+	std::condition_variable state_cv;
+	// Buffer of the foreground read, which the first request to succeed copies its result into; only accessed while
+	// the foreground read waits, i.e. until [completed] or [abandoned] is set.
+	data_ptr_t target;
+	// Whether the first request has started running, and when; the hedge delay and deadline count from then, so time
+	// queued behind other background requests isn't charged to the read.
+	bool started = false;
+	std::chrono::steady_clock::time_point start;
+	// Number of requests still in flight.
+	idx_t pending_requests = 0;
+	// Whether any request has succeeded; the first one to succeed wins.
+	bool completed = false;
+	// Whether the foreground read gave up at its deadline.
+	bool abandoned = false;
+	// Error of the first failed request, only surfaced if all requests fail.
+	std::exception_ptr error;
+};
+
+// State shared between a stat operation and its check running in the background, which could outlive the operation if
+// it misses the deadline.
+struct BackgroundStatState {
+	mutex state_mutex;
+	std::condition_variable state_cv;
+	// Whether the check has started running, and when; the deadline counts from then.
+	bool started = false;
+	std::chrono::steady_clock::time_point start;
+	bool finished = false;
+	bool result = false;
+	std::exception_ptr error;
+};
+
+// Background read requests run on a process-wide pool; they never wait for other tasks, so the pool cannot deadlock.
+constexpr idx_t MAX_BACKGROUND_READ_THREADS = 64;
+
+TaskExecutor &GetBackgroundReadExecutor() {
+	static TaskExecutor executor(MAX_BACKGROUND_READ_THREADS);
+	return executor;
+}
+
+// State shared between a parallel read and the workers reading its parts. Workers only touch the read once they claim
+// a part, and the read waits for every part, so workers which find no part left never access a finished read.
+struct ParallelReadState {
+	// Index of the next part to claim.
+	atomic<idx_t> next_part {0};
+	mutex state_mutex;
+	std::condition_variable state_cv;
+	idx_t finished_parts = 0;
+	// First error of all parts, surfaced after every part finishes, since they all write into the caller's buffer.
+	std::exception_ptr error;
+};
+
+// Large reads are split into parts read by a process-wide pool, so the number of connections they open stays bounded
+// regardless of the number of concurrent reads; the calling thread of each read reads parts as well.
+constexpr idx_t MAX_PARALLEL_READ_THREADS = 32;
+
+TaskExecutor &GetParallelReadExecutor() {
+	static TaskExecutor executor(MAX_PARALLEL_READ_THREADS);
+	return executor;
+}
+
+// State shared between [RunTasksConcurrently] and the workers running its tasks. Workers only touch the tasks once they
+// claim one, and the caller waits for every claimed task, so workers which find no task left never access them.
+struct ConcurrentTasksState {
+	mutex state_mutex;
+	std::condition_variable state_cv;
+	// Index of the next task to claim.
+	idx_t next_task = 0;
+	idx_t running_tasks = 0;
+	// Whether a task asked to skip the remaining ones.
+	bool stopped = false;
+};
+
+// Concurrent list and delete requests (partition globs and batched deletes) run on a process-wide pool, so the number
+// of threads stays bounded regardless of the configured parallelism and the number of concurrent operations.
+constexpr idx_t MAX_CONCURRENT_TASK_THREADS = 32;
+
+TaskExecutor &GetConcurrentTaskExecutor() {
+	static TaskExecutor executor(MAX_CONCURRENT_TASK_THREADS);
+	return executor;
+}
+
+uint64_t GetElapsedMicros(std::chrono::steady_clock::time_point start) {
+	const auto now = std::chrono::steady_clock::now();
+	return std::chrono::duration_cast<std::chrono::microseconds>(now - start).count();
+}
+
+uint64_t RoundUpToWholeSeconds(uint64_t timeout_ms) {
+	return (timeout_ms + MILLISECONDS_PER_SECOND - 1) / MILLISECONDS_PER_SECOND * MILLISECONDS_PER_SECOND;
+}
+
+// Translate upload settings into the uploader settings of the inner filesystem, which uploads parts of files opened
+// for writing concurrently, and keeps at most as many parts buffered as it uploads concurrently.
+void ApplyUploadSettings(TimeoutRetryFileOpener &open_opener, const UploadConfig &upload_config) {
+	if (upload_config.part_size > 0) {
+		// The inner filesystem derives part size from the max file size it should be able to upload. Its max number of
+		// parts is an httpfs setting, which isn't part of the policy snapshot, so it's looked up here; only opens for
+		// writing with a part size configured pay for it.
+		auto &opener = open_opener.GetInnerOpener();
+		Value value;
+		uint64_t max_parts = DEFAULT_UPLOADER_MAX_PARTS_PER_FILE;
+		if (FileOpener::TryGetCurrentSetting(&opener, S3_UPLOADER_MAX_PARTS_PER_FILE, value) && !value.IsNull()) {
+			max_parts = value.GetValue<uint64_t>();
+		}
+		open_opener.SetSettingOverride(S3_UPLOADER_MAX_FILESIZE, Value::UBIGINT(upload_config.part_size * max_parts));
+	}
+	if (upload_config.concurrency > 0) {
+		open_opener.SetSettingOverride(S3_UPLOADER_THREAD_LIMIT, Value::UBIGINT(upload_config.concurrency));
+	}
+}
+
+// File handles keep the HTTP client timeout and retries resolved at open, so the open has to carry the read or write
+// settings. Once open, handles only send reads, or part uploads, so their client timeout is the read (or per-part, or
+// write) timeout, even if it's shorter than the open timeout; it applies to the metadata request of the open as well.
+// Return the timeout of HTTP clients created for the handle, 0 if unknown.
+uint64_t ApplyHandleSettings(TimeoutRetryFileOpener &open_opener, FileOpenFlags flags) {
+	D_ASSERT(open_opener.GetPolicies());
+	const auto &policies = *open_opener.GetPolicies();
+	const auto handle_operation_type = flags.OpenForWriting() ? HttpfsOperationType::WRITE : HttpfsOperationType::READ;
+	TimeoutRetryFileOpener handle_opener(open_opener.GetInnerOpener(), handle_operation_type,
+	                                     open_opener.GetPolicies(), open_opener.GetPath());
+	uint64_t handle_timeout_ms = 0;
+	bool has_handle_timeout = handle_opener.TryGetTimeoutMs(handle_timeout_ms);
+	// Writes are retried by the inner filesystem, reads by the wrapper.
+	uint64_t write_retries = 0;
+	bool has_write_retries = flags.OpenForWriting() && handle_opener.TryGetRetries(write_retries);
+	if (flags.OpenForWriting()) {
+		// Each part of a multipart upload is a request of its own, which takes per-part settings over write settings.
+		const auto &upload_config = policies.upload;
+		if (upload_config.has_part_timeout) {
+			has_handle_timeout = true;
+			handle_timeout_ms = upload_config.part_timeout_ms;
+		}
+		if (upload_config.has_part_retries) {
+			has_write_retries = true;
+			write_retries = upload_config.part_retries;
+		}
+		ApplyUploadSettings(open_opener, upload_config);
+	}
+	if (has_handle_timeout) {
+		open_opener.SetTimeoutOverrideMs(handle_timeout_ms);
+	}
+	if (has_write_retries) {
+		open_opener.SetInnerRetriesOverride(write_retries);
+	}
+	uint64_t client_timeout_ms = 0;
+	if (!open_opener.TryGetTimeoutMs(client_timeout_ms)) {
+		return 0;
+	}
+	return RoundUpToWholeSeconds(client_timeout_ms);
+}
+
+// Object storage takes multi-object delete requests, which the inner filesystem issues for batched removals.
+bool SupportsBatchDelete(const string &path) {
+	const auto lower_path = StringUtil::Lower(path);
+	for (const auto scheme : {"s3://", "s3a://", "s3n://", "gcs://", "gs://", "r2://"}) {
+		if (StringUtil::StartsWith(lower_path, scheme)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// Name of the inner filesystem of S3 compatible storage (S3, GCS and R2).
+constexpr const char *S3_FILESYSTEM_NAME = "S3FileSystem";
+
+// Object storage has no directories: the inner filesystem lists a directory by globbing every key under it, rather than
+// by a delimited listing of its children, so expanding partitions would list the whole table before globbing it again.
+// S3 compatible storage is listed by the wrapper instead (see [ListS3ChildPrefixes]), which leaves Azure.
+bool ListsDirectoryChildren(const string &path) {
+	const auto lower_path = StringUtil::Lower(path);
+	for (const auto scheme : {"az://", "azure://", "abfss://"}) {
+		if (StringUtil::StartsWith(lower_path, scheme)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// List the children of [directory] on S3 compatible storage with a listing delimited by "/", which returns one common
+// prefix per child directory (i.e. "t/year=2024/") rather than every key under the directory.
+vector<string> ListS3ChildPrefixes(const string &directory, FileOpener &opener) {
+	FileOpenerInfo info {directory};
+	auto s3_auth_params = S3AuthParams::ReadFrom(&opener, info);
+	auto http_util = HTTPFSUtil::GetHTTPUtil(&opener);
+	auto http_params = http_util->InitializeParameters(&opener, &info);
+	// Keys of the children start with the directory and its separator.
+	auto prefix_path = directory;
+	if (!StringUtil::EndsWith(prefix_path, "/")) {
+		prefix_path += "/";
+	}
+	vector<string> child_prefixes;
+	string continuation_token;
+	do {
+		auto response = AWSListObjectV2::Request(prefix_path, *http_params, s3_auth_params, continuation_token,
+		                                         HTTPState::TryGetState(&opener).get(), /*use_delimiter=*/true);
+		continuation_token = AWSListObjectV2::ParseContinuationToken(response);
+		for (auto &child_prefix : AWSListObjectV2::ParseCommonPrefix(response)) {
+			child_prefixes.emplace_back(std::move(child_prefix));
+		}
+	} while (!continuation_token.empty());
+	return child_prefixes;
+}
+
+// Get the single-flight key of an operation on [path]; [detail] tells apart calls of the same operation type which
+// cannot share results, i.e. the range of a read.
+string GetSingleFlightKey(HttpfsOperationType operation_type, const string &detail, const string &path) {
+	return HttpfsOperationTypeToString(operation_type) + " " + detail + " " + path;
+}
+
+// Identify the file content by path and version tag for single-flight reads, hashed once at open. Two independent
+// 64-bit hashes keep accidental collisions out of reach, like keys of the block cache.
+BlockCacheFileHashes GetContentHashes(const string &path, const string &version_tag) {
+	const auto key = path + "\n" + version_tag;
+	BlockCacheFileHashes result;
+	result.first = static_cast<uint64_t>(Hash(key.c_str(), key.size()));
+	result.second = static_cast<uint64_t>(std::hash<string>()(key));
+	return result;
+}
+
+// Followers of a single-flight call only count as deduplicated, the leader's request carries latency and outcome.
+void RecordDeduplicatedRequest(HttpfsOperationType operation_type, const string &path) {
+	auto &metrics = TimeoutRetryMetrics::GetInstance().GetOperationMetrics(operation_type, GetEndpoint(path));
+	metrics.RecordDeduplicatedRequest();
+}
+
+TimeoutRetryHandleConfig GetHandleConfig(FileOpener &opener, optional_ptr<const TimeoutRetryPolicySnapshot> policies,
+                                         const string &path, FileOpenFlags flags, uint64_t client_timeout_ms) {
+	D_ASSERT(policies);
+	if (flags.OpenForWriting()) {
+		// Writes cannot be abandoned at a deadline or repeated by the wrapper; the retry config only carries circuit
+		// breaker for them.
+		TimeoutRetryHandleConfig config;
+		TimeoutRetryFileOpener write_opener(opener, HttpfsOperationType::WRITE, policies, path);
+		config.write_retry = GetRetryConfig(write_opener);
+		config.write_retry.max_retries = 0;
+		return config;
+	}
+
+	// Read settings come with the snapshot; only timeouts and retries depend on the path.
+	auto config = policies->handle;
+	// HTTP clients only take timeout in whole seconds, which is rounded up from the millisecond setting; the wrapper
+	// enforces the precise deadline when the two don't match.
+	TimeoutRetryFileOpener read_opener(opener, HttpfsOperationType::READ, policies, path);
+	uint64_t timeout_ms = 0;
+	if (read_opener.TryGetTimeoutMs(timeout_ms) &&
+	    (timeout_ms % MILLISECONDS_PER_SECOND != 0 || (client_timeout_ms > 0 && timeout_ms < client_timeout_ms))) {
+		config.read_deadline_ms = timeout_ms;
+	}
+	if (policies->adaptive_timeout.enabled) {
+		config.read_adaptive_timeout = GetAdaptiveTimeoutBounds(policies->adaptive_timeout, read_opener);
+	}
+	config.read_retry = GetRetryConfig(read_opener);
+	config.client_timeout_ms = client_timeout_ms;
+	config.fault_injection = policies->fault_injection;
+	return config;
+}
+
+// Issuing concurrent requests on the same handle is only safe when the handle is opened for parallel access, otherwise
+// the inner filesystem could share read buffer and file offset between them.
+bool SupportsConcurrentRequests(const FileHandle &handle) {
+	return handle.flags.RequireParallelAccess() || handle.flags.DirectIO();
+}
+
+// Large positional reads are split into concurrent ranged reads, if the handle allows concurrent requests.
+bool ShouldReadInParallel(TimeoutRetryFileHandle &handle, int64_t nr_bytes) {
+	const auto &config = handle.GetConfig();
+	return config.parallel_read_threshold > 0 && config.parallel_read_parts > 1 && nr_bytes > 0 &&
+	       static_cast<idx_t>(nr_bytes) >= config.parallel_read_threshold &&
+	       SupportsConcurrentRequests(handle.GetInnerHandle());
+}
+
+bool IsTimeoutError(const std::exception &ex) {
+	const auto message = StringUtil::Lower(ex.what());
+	return StringUtil::Contains(message, "timed out") || StringUtil::Contains(message, "timeout");
+}
+
+// OperationRecorder records latency and outcome of one operation when it goes out of scope.
+class OperationRecorder {
+public:
+	explicit OperationRecorder(OperationMetrics &metrics_p)
+	    : metrics(metrics_p), start(std::chrono::steady_clock::now()) {
+	}
+	~OperationRecorder() {
+		const auto latency_us = GetElapsedMicros(start);
+		if (!failed && retry_budget && retry_budget_config.enabled) {
+			retry_budget->RecordSuccess(retry_budget_config);
+		}
+		if (failed) {
+			metrics.RecordError(latency_us, is_timeout);
+			return;
+		}
+		metrics.RecordSuccess(latency_us, bytes);
+	}
+
+	void Fail(bool is_timeout_p) {
+		failed = true;
+		is_timeout = is_timeout_p;
+	}
+	void SetBytes(idx_t bytes_p) {
+		bytes = bytes_p;
+	}
+	// Successful operations earn retry tokens for the endpoint.
+	void SetRetryBudget(RetryBudget &retry_budget_p, const RetryBudgetConfig &config) {
+		retry_budget = &retry_budget_p;
+		retry_budget_config = config;
+	}
+
+private:
+	OperationMetrics &metrics;
+	optional_ptr<RetryBudget> retry_budget;
+	RetryBudgetConfig retry_budget_config;
+	const std::chrono::steady_clock::time_point start;
+	bool failed = false;
+	bool is_timeout = false;
+	idx_t bytes = 0;
+};
+
+// AttemptObserver feeds latency of one request attempt to the adaptive timeout estimator when it goes out of scope.
+class AttemptObserver {
+public:
+	explicit AttemptObserver(optional_ptr<AdaptiveTimeoutEstimator> estimator_p)
+	    : estimator(estimator_p), start(std::chrono::steady_clock::now()) {
+	}
+	~AttemptObserver() {
+		// Timeouts are observed as well, so the adaptive timeout grows when the endpoint slows down.
+		if (estimator && (!failed || is_timeout)) {
+			estimator->Record(GetElapsedMicros(start));
+		}
+	}
+
+	void Fail(bool is_timeout_p) {
+		failed = true;
+		is_timeout = is_timeout_p;
+	}
+
+private:
+	optional_ptr<AdaptiveTimeoutEstimator> estimator;
+	const std::chrono::steady_clock::time_point start;
+	bool failed = false;
+	bool is_timeout = false;
+};
+
+// CircuitBreakerAttempt reports the outcome of one attempt admitted by the circuit breaker when it goes out of scope;
+// anything other than a transient failure proves the endpoint is reachable.
+class CircuitBreakerAttempt {
+public:
+	CircuitBreakerAttempt(CircuitBreaker &circuit_breaker_p, const CircuitBreakerConfig &config_p)
+	    : circuit_breaker(circuit_breaker_p), config(config_p) {
+	}
+	~CircuitBreakerAttempt() {
+		if (config.enabled && !failed) {
+			circuit_breaker.RecordSuccess();
+		}
+	}
+
+	void Fail() {
+		failed = true;
+		if (config.enabled) {
+			circuit_breaker.RecordFailure(config);
+		}
+	}
+
+private:
+	CircuitBreaker &circuit_breaker;
+	const CircuitBreakerConfig &config;
+	bool failed = false;
+};
+
+// ConcurrencySlot holds a slot of the endpoint concurrency limiter for one attempt or request, and returns it when it
+// goes out of scope. The slot is taken before the attempt starts, so time spent in the queue doesn't count against its
+// timeout.
+class ConcurrencySlot {
+public:
+	ConcurrencySlot(ConcurrencyLimiter &concurrency_limiter_p, const ConcurrencyLimitConfig &config,
+	                OperationMetrics &metrics)
+	    : concurrency_limiter(concurrency_limiter_p), operation_type(metrics.GetOperationType()),
+	      acquired(config.enabled) {
+		if (!acquired) {
+			return;
+		}
+		const auto wait_us = concurrency_limiter.Acquire(operation_type, config);
+		if (wait_us > 0) {
+			metrics.RecordQueueWait(wait_us);
+		}
+	}
+	// Take over the slot of [operation_type] already taken from the limiter, if [acquired_p].
+	ConcurrencySlot(ConcurrencyLimiter &concurrency_limiter_p, HttpfsOperationType operation_type_p, bool acquired_p)
+	    : concurrency_limiter(concurrency_limiter_p), operation_type(operation_type_p), acquired(acquired_p) {
+	}
+	~ConcurrencySlot() {
+		if (acquired) {
+			concurrency_limiter.Release(operation_type);
+		}
+	}
+
+private:
+	ConcurrencyLimiter &concurrency_limiter;
+	const HttpfsOperationType operation_type;
+	const bool acquired;
+};
+
+// Run [func], and retry on transient errors as long as the retry count, the endpoint retry budget and the endpoint
+// circuit breaker allow. Each attempt holds a slot of the endpoint concurrency limiter, which is returned before
+// waiting for the next retry.
+template <class FUNC>
+auto RunWithRetries(const RetryConfig &config, RetryBudget &retry_budget, CircuitBreaker &circuit_breaker,
+                    ConcurrencyLimiter &concurrency_limiter, OperationMetrics &metrics, FUNC &&func)
+    -> decltype(func()) {
+	if (config.circuit_breaker.enabled && !circuit_breaker.TryAcquire(config.circuit_breaker)) {
+		metrics.RecordCircuitBreakerRejected();
+		throw IOException("Circuit breaker for %s is open after consecutive failures, request is not sent",
+		                  circuit_breaker.GetEndpoint());
+	}
+	// Wait of the backoff, which jitter grows from; waits asked for by the server are kept apart.
+	uint64_t retry_wait_ms = config.retry_wait_ms;
+	for (idx_t retry_index = 0;; ++retry_index) {
+		uint64_t sleep_ms = 0;
+		CircuitBreakerAttempt attempt(circuit_breaker, config.circuit_breaker);
+		try {
+			ConcurrencySlot slot(concurrency_limiter, config.concurrency_limit, metrics);
+			return func();
+		} catch (std::exception &ex) {
+			const bool retryable = IsRetryableError(ex);
+			if (retryable) {
+				attempt.Fail();
+			}
+			if (retry_index >= config.max_retries || !retryable) {
+				throw;
+			}
+			// Servers asking for a longer wait know better than the backoff, though waits beyond the max retry wait
+			// are not worth blocking the query for.
+			uint64_t retry_after_ms = 0;
+			const bool has_retry_after = TryGetRetryAfterMs(ex, retry_after_ms);
+			if (has_retry_after && retry_after_ms > GetMaxRetryAfterMs(config)) {
+				throw;
+			}
+			// Fail fast instead of piling more requests onto an endpoint which is already failing.
+			if (config.budget.enabled && !retry_budget.TryAcquireRetry(config.budget)) {
+				metrics.RecordRetryBudgetExhausted();
+				throw;
+			}
+			if (config.circuit_breaker.enabled && !circuit_breaker.TryAcquire(config.circuit_breaker)) {
+				metrics.RecordCircuitBreakerRejected();
+				throw;
+			}
+			metrics.RecordRetry();
+			retry_wait_ms = GetRetryWaitMs(config, retry_index, retry_wait_ms);
+			sleep_ms = has_retry_after ? MaxValue<uint64_t>(retry_wait_ms, retry_after_ms) : retry_wait_ms;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(sleep_ms));
+	}
+}
+
+// Run [task] for each index in [0, task_count) on up to [parallelism] threads, the calling thread and workers of the
+// shared pool. [task] must not throw, and returns false to skip the remaining tasks; tasks already running still
+// complete. Tasks are claimed by whoever comes first, so the calling thread makes progress even if the pool is busy.
+template <class TASK>
+void RunTasksConcurrently(idx_t task_count, idx_t parallelism, TASK &&task) {
+	auto state = make_shared_ptr<ConcurrentTasksState>();
+	// Workers could start after every task is done and [task] is gone, so it's only accessed once a task is claimed.
+	auto *task_ptr = &task;
+	auto run_tasks = [state, task_count, task_ptr]() {
+		while (true) {
+			idx_t task_index;
+			{
+				lock_guard<mutex> lck(state->state_mutex);
+				if (state->stopped || state->next_task >= task_count) {
+					return;
+				}
+				task_index = state->next_task++;
+				++state->running_tasks;
+			}
+			const bool proceed = (*task_ptr)(task_index);
+			lock_guard<mutex> lck(state->state_mutex);
+			--state->running_tasks;
+			state->stopped = state->stopped || !proceed;
+			state->state_cv.notify_all();
+		}
+	};
+	auto &executor = GetConcurrentTaskExecutor();
+	const auto thread_count = MinValue<idx_t>(parallelism, task_count);
+	for (idx_t thread_index = 1; thread_index < thread_count; ++thread_index) {
+		executor.Schedule(run_tasks);
+	}
+	run_tasks();
+	// No task is claimed once the calling thread runs out of them.
+	unique_lock<mutex> lck(state->state_mutex);
+	state->state_cv.wait(lck, [&]() { return state->running_tasks == 0; });
+}
+
+// Run a handle-level write operation through the endpoint circuit breaker; retries are left to the inner filesystem.
+template <class FUNC>
+auto RunHandleWrite(TimeoutRetryFileHandle &handle, FUNC &&func) -> decltype(func()) {
+	return RunWithRetries(handle.GetConfig().write_retry, handle.GetRetryBudget(), handle.GetCircuitBreaker(),
+	                      handle.GetConcurrencyLimiter(), handle.GetWriteMetrics(), std::forward<FUNC>(func));
+}
+
+} // namespace
+
 FileSystemTimeoutRetryWrapper::FileSystemTimeoutRetryWrapper(unique_ptr<FileSystem> inner_filesystem,
                                                              DatabaseInstance &db)
-    : inner_filesystem(std::move(inner_filesystem)), db(db) {
+    : inner_filesystem(std::move(inner_filesystem)), db(db), database_opener(db) {
+}
+
+FileSystemTimeoutRetryWrapper::~FileSystemTimeoutRetryWrapper() {
+	unique_lock<mutex> lck(background_request_mutex);
+	background_request_cv.wait(lck, [this]() { return background_request_count == 0; });
+}
+
+void FileSystemTimeoutRetryWrapper::RegisterBackgroundRequest() {
+	lock_guard<mutex> lck(background_request_mutex);
+	++background_request_count;
+}
+
+void FileSystemTimeoutRetryWrapper::UnregisterBackgroundRequest() {
+	lock_guard<mutex> lck(background_request_mutex);
+	D_ASSERT(background_request_count > 0);
+	--background_request_count;
+	background_request_cv.notify_all();
 }
 
 //===--------------------------------------------------------------------===//
 // Wrap with timeout and retry opener logic
 //===--------------------------------------------------------------------===//
 
-bool FileSystemTimeoutRetryWrapper::DirectoryExists(const string &directory, optional_ptr<FileOpener> opener) {
+template <class FUNC>
+auto FileSystemTimeoutRetryWrapper::RunOperation(HttpfsOperationType operation_type, const string &path,
+                                                 optional_ptr<FileOpener> opener, FUNC &&func, bool retry_in_wrapper)
+    -> decltype(func(std::declval<TimeoutRetryFileOpener &>())) {
+	if (WarmupRequestScope::IsActive()) {
+		// Warm-up requests are sent once with the static timeout, and don't touch the circuit breaker, retry budget,
+		// adaptive timeout or metrics of the endpoint, so an unreachable endpoint can't trip them for queries.
+		FileOpener &base_opener = opener ? *opener : database_opener;
+		const auto policies = ResolvePolicies(base_opener);
+		TimeoutRetryFileOpener timeout_retry_opener(base_opener, operation_type, policies.get(), path);
+		timeout_retry_opener.DisableInnerRetries();
+		return func(timeout_retry_opener);
+	}
+	const auto endpoint = GetEndpoint(path);
+	auto &metrics = TimeoutRetryMetrics::GetInstance().GetOperationMetrics(operation_type, endpoint);
+	OperationRecorder recorder(metrics);
+	auto run_with_opener = [&](FileOpener &base_opener) {
+		const auto policies = ResolvePolicies(base_opener);
+		TimeoutRetryFileOpener timeout_retry_opener(base_opener, operation_type, policies.get(), path);
+		const auto estimator = ApplyAdaptiveTimeout(policies->adaptive_timeout, timeout_retry_opener, endpoint);
+		auto run_attempt = [&]() {
+			AttemptObserver observer(estimator);
+			try {
+				if (policies->fault_injection.AppliesTo(operation_type, path)) {
+					// Faults are subject to the timeout the HTTP client would apply, in whole seconds.
+					uint64_t timeout_ms = 0;
+					if (timeout_retry_opener.TryGetTimeoutMs(timeout_ms)) {
+						timeout_ms = RoundUpToWholeSeconds(timeout_ms);
+					}
+					fault_injector.Inject(policies->fault_injection, operation_type, path, timeout_ms);
+				}
+				return func(timeout_retry_opener);
+			} catch (std::exception &ex) {
+				observer.Fail(IsTimeoutError(ex));
+				throw;
+			}
+		};
+		auto retry_config = GetRetryConfig(timeout_retry_opener);
+		if (retry_in_wrapper) {
+			timeout_retry_opener.DisableInnerRetries();
+		} else {
+			retry_config.max_retries = 0;
+		}
+		auto &retry_budget = RetryBudgetRegistry::GetInstance().GetRetryBudget(endpoint);
+		auto &circuit_breaker = CircuitBreakerRegistry::GetInstance().GetCircuitBreaker(endpoint);
+		auto &concurrency_limiter = ConcurrencyLimiterRegistry::GetInstance().GetConcurrencyLimiter(endpoint);
+		recorder.SetRetryBudget(retry_budget, retry_config.budget);
+		return RunWithRetries(retry_config, retry_budget, circuit_breaker, concurrency_limiter, metrics, run_attempt);
+	};
+	try {
+		if (opener) {
+			return run_with_opener(*opener);
+		}
+		return run_with_opener(database_opener);
+	} catch (std::exception &ex) {
+		recorder.Fail(IsTimeoutError(ex));
+		throw;
+	}
+}
+
+bool FileSystemTimeoutRetryWrapper::RunStatOperation(const string &path, optional_ptr<FileOpener> opener,
+                                                     std::function<bool(FileOpener &)> check) {
+	return RunOperation(HttpfsOperationType::STAT, path, opener, [&](TimeoutRetryFileOpener &timeout_retry_opener) {
+		uint64_t timeout_ms = 0;
+		if (!timeout_retry_opener.TryGetTimeoutMs(timeout_ms) || timeout_ms % MILLISECONDS_PER_SECOND == 0) {
+			return check(timeout_retry_opener);
+		}
+		// The check could outlive the operation, so it keeps the client context alive and resolves settings from it;
+		// the database opener lives as long as the wrapper, which waits for background requests. Settings of other
+		// openers cannot be carried over, so their checks keep the rounded-up client timeout.
+		shared_ptr<ClientContext> context;
+		auto client_context = timeout_retry_opener.TryGetClientContext();
+		if (client_context) {
+			context = client_context->shared_from_this();
+		} else if (&timeout_retry_opener.GetInnerOpener() != &database_opener) {
+			return check(timeout_retry_opener);
+		}
+		// Timeout and retries are the only settings the opener changes, and they're carried over as overrides.
+		Value inner_retries;
+		if (!timeout_retry_opener.TryGetCurrentSetting("http_retries", inner_retries)) {
+			inner_retries = Value();
+		}
+
+		auto state = make_shared_ptr<BackgroundStatState>();
+		RegisterBackgroundRequest();
+		GetBackgroundReadExecutor().Schedule([this, state, context, check, path, timeout_ms, inner_retries]() {
+			{
+				lock_guard<mutex> lck(state->state_mutex);
+				state->started = true;
+				state->start = std::chrono::steady_clock::now();
+				state->state_cv.notify_all();
+			}
+			bool result = false;
+			std::exception_ptr error;
+			try {
+				unique_ptr<FileOpener> context_opener;
+				if (context) {
+					context_opener = make_uniq<ClientContextFileOpener>(*context);
+				}
+				TimeoutRetryFileOpener check_opener(context_opener ? *context_opener : database_opener,
+				                                    HttpfsOperationType::STAT, nullptr, path);
+				check_opener.SetTimeoutOverrideMs(timeout_ms);
+				if (!inner_retries.IsNull()) {
+					check_opener.SetInnerRetriesOverride(inner_retries.GetValue<uint64_t>());
+				}
+				result = check(check_opener);
+			} catch (...) {
+				error = std::current_exception();
+			}
+			{
+				lock_guard<mutex> lck(state->state_mutex);
+				state->finished = true;
+				state->result = result;
+				state->error = error;
+				state->state_cv.notify_all();
+			}
+			UnregisterBackgroundRequest();
+		});
+
+		unique_lock<mutex> lck(state->state_mutex);
+		state->state_cv.wait(lck, [&state]() { return state->started; });
+		if (!state->state_cv.wait_until(lck, state->start + std::chrono::milliseconds(timeout_ms),
+		                                [&state]() { return state->finished; })) {
+			// The check keeps running in the background, its result is discarded.
+			throw IOException("Stat of %s timed out after %llu ms", path, timeout_ms);
+		}
+		if (state->error != nullptr) {
+			std::rethrow_exception(state->error);
+		}
+		return state->result;
+	});
+}
+
+shared_ptr<const TimeoutRetryPolicySnapshot> FileSystemTimeoutRetryWrapper::ResolvePolicies(FileOpener &opener) {
+	auto context = opener.TryGetClientContext();
+	if (context) {
+		return GetClientPolicyCache(*context).Get(opener);
+	}
+	if (&opener == &database_opener) {
+		return database_policy_cache.Get(opener);
+	}
+	// Settings of other openers cannot be told apart, so they're resolved for each operation.
+	return ResolveTimeoutRetryPolicies(opener);
+}
+
+MetadataCacheConfig FileSystemTimeoutRetryWrapper::ResolveMetadataCacheConfig(optional_ptr<FileOpener> opener) {
 	if (opener) {
-		TimeoutRetryFileOpener timeout_retry_opener(*opener, HttpfsOperationType::STAT);
-		return inner_filesystem->DirectoryExists(directory, &timeout_retry_opener);
+		return ResolvePolicies(*opener)->metadata_cache;
 	}
-	DatabaseFileOpener database_opener(db);
-	TimeoutRetryFileOpener timeout_retry_opener(database_opener, HttpfsOperationType::STAT);
-	return inner_filesystem->DirectoryExists(directory, &timeout_retry_opener);
+	return ResolvePolicies(database_opener)->metadata_cache;
 }
 
-void FileSystemTimeoutRetryWrapper::CreateDirectory(const string &directory, optional_ptr<FileOpener> opener) {
+ListingCacheConfig FileSystemTimeoutRetryWrapper::ResolveListingCacheConfig(optional_ptr<FileOpener> opener) {
 	if (opener) {
-		TimeoutRetryFileOpener timeout_retry_opener(*opener, HttpfsOperationType::CREATE_DIR);
-		inner_filesystem->CreateDirectory(directory, &timeout_retry_opener);
-		return;
+		return ResolvePolicies(*opener)->listing_cache;
 	}
-	DatabaseFileOpener database_opener(db);
-	TimeoutRetryFileOpener timeout_retry_opener(database_opener, HttpfsOperationType::CREATE_DIR);
-	inner_filesystem->CreateDirectory(directory, &timeout_retry_opener);
+	return ResolvePolicies(database_opener)->listing_cache;
 }
 
-void FileSystemTimeoutRetryWrapper::CreateDirectoriesRecursive(const string &path, optional_ptr<FileOpener> opener) {
+bool FileSystemTimeoutRetryWrapper::ResolveSingleFlight(optional_ptr<FileOpener> opener) {
 	if (opener) {
-		TimeoutRetryFileOpener timeout_retry_opener(*opener, HttpfsOperationType::CREATE_DIR);
-		inner_filesystem->CreateDirectoriesRecursive(path, &timeout_retry_opener);
+		return ResolvePolicies(*opener)->single_flight;
+	}
+	return ResolvePolicies(database_opener)->single_flight;
+}
+
+BlockCacheConfig FileSystemTimeoutRetryWrapper::ResolveBlockCacheConfig(const TimeoutRetryPolicySnapshot &policies) {
+	auto config = policies.block_cache;
+	// The memory tier is shared by all connections, which would drop each other's blocks if each configured it from
+	// its own settings; handles with another block size skip it.
+	const auto database_config = ResolvePolicies(database_opener)->block_cache;
+	config.memory_max_bytes = 0;
+	if (database_config.memory_max_bytes == 0) {
+		return config;
+	}
+	if (database_config.memory_max_bytes < database_config.block_size) {
+		throw InvalidInputException("%s should hold at least one block of %s (%llu bytes)",
+		                            HTTPFS_MEMORY_CACHE_MAX_SIZE_MB, HTTPFS_CACHE_BLOCK_SIZE_BYTES,
+		                            database_config.block_size);
+	}
+	if (config.disk_directory.empty()) {
+		config.block_size = database_config.block_size;
+	}
+	if (config.block_size == database_config.block_size) {
+		config.memory_max_bytes = database_config.memory_max_bytes;
+	}
+	return config;
+}
+
+void FileSystemTimeoutRetryWrapper::InvalidateCachedPath(const string &path, bool recursive) {
+	if (recursive) {
+		metadata_cache.InvalidateRecursive(path);
+		listing_cache.InvalidateRecursive(path);
 		return;
 	}
-	DatabaseFileOpener database_opener(db);
-	TimeoutRetryFileOpener timeout_retry_opener(database_opener, HttpfsOperationType::CREATE_DIR);
-	inner_filesystem->CreateDirectoriesRecursive(path, &timeout_retry_opener);
+	metadata_cache.Invalidate(path);
+	listing_cache.Invalidate(path);
+}
+
+bool FileSystemTimeoutRetryWrapper::DirectoryExists(const string &directory, optional_ptr<FileOpener> opener) {
+	const auto cache_config = ResolveMetadataCacheConfig(opener);
+	bool exists = false;
+	if (cache_config.enabled && metadata_cache.TryGetDirectoryExists(directory, cache_config, exists)) {
+		return exists;
+	}
+	auto check_exists = [&]() {
+		return RunStatOperation(directory, opener, [this, directory](FileOpener &timeout_retry_opener) {
+			return inner_filesystem->DirectoryExists(directory, &timeout_retry_opener);
+		});
+	};
+	if (ResolveSingleFlight(opener)) {
+		bool shared = false;
+		exists = exists_flight.Do(GetSingleFlightKey(HttpfsOperationType::STAT, "directory", directory), check_exists,
+		                          shared);
+		if (shared) {
+			RecordDeduplicatedRequest(HttpfsOperationType::STAT, directory);
+		}
+	} else {
+		exists = check_exists();
+	}
+	if (cache_config.enabled) {
+		metadata_cache.PutDirectoryExists(directory, cache_config, exists);
+	}
+	return exists;
+}
+
+void FileSystemTimeoutRetryWrapper::CreateDirectory(const string &directory, optional_ptr<FileOpener> opener) {
+	InvalidateCachedPath(directory);
+	RunOperation(HttpfsOperationType::CREATE_DIR, directory, opener, [&](FileOpener &timeout_retry_opener) {
+		inner_filesystem->CreateDirectory(directory, &timeout_retry_opener);
+	});
+}
+
+void FileSystemTimeoutRetryWrapper::CreateDirectoriesRecursive(const string &path, optional_ptr<FileOpener> opener) {
+	InvalidateCachedPath(path);
+	RunOperation(HttpfsOperationType::CREATE_DIR, path, opener, [&](FileOpener &timeout_retry_opener) {
+		inner_filesystem->CreateDirectoriesRecursive(path, &timeout_retry_opener);
+	});
 }
 
 void FileSystemTimeoutRetryWrapper::RemoveDirectory(const string &directory, optional_ptr<FileOpener> opener) {
-	if (opener) {
-		TimeoutRetryFileOpener timeout_retry_opener(*opener, HttpfsOperationType::DELETE);
+	// Invalidate before and after, so neither a partially failed removal nor a lookup racing with it leaves stale
+	// entries behind.
+	InvalidateCachedPath(directory, /*recursive=*/true);
+	RunOperation(HttpfsOperationType::DELETE, directory, opener, [&](FileOpener &timeout_retry_opener) {
 		inner_filesystem->RemoveDirectory(directory, &timeout_retry_opener);
-		return;
-	}
-	DatabaseFileOpener database_opener(db);
-	TimeoutRetryFileOpener timeout_retry_opener(database_opener, HttpfsOperationType::DELETE);
-	inner_filesystem->RemoveDirectory(directory, &timeout_retry_opener);
+	});
+	InvalidateCachedPath(directory, /*recursive=*/true);
 }
 
 unique_ptr<FileHandle> FileSystemTimeoutRetryWrapper::OpenFile(const string &path, FileOpenFlags flags,
@@ -68,14 +848,157 @@ unique_ptr<FileHandle> FileSystemTimeoutRetryWrapper::OpenFile(const string &pat
 
 unique_ptr<FileHandle> FileSystemTimeoutRetryWrapper::OpenFileExtended(const OpenFileInfo &path, FileOpenFlags flags,
                                                                        optional_ptr<FileOpener> opener) {
-	HttpfsOperationType operation_type = HttpfsOperationType::OPEN;
-	if (opener) {
-		TimeoutRetryFileOpener wrapped_opener(*opener, operation_type);
-		return inner_filesystem->OpenFile(path, flags, &wrapped_opener);
+	const auto cache_config = ResolveMetadataCacheConfig(opener);
+	if (flags.OpenForWriting()) {
+		InvalidateCachedPath(path.path);
+	}
+	// Cached file info lets the inner filesystem skip its metadata request on open.
+	OpenFileInfo open_info = path;
+	if (cache_config.enabled && !flags.OpenForWriting()) {
+		CachedFileMetadata metadata;
+		if (metadata_cache.TryGetFile(path.path, cache_config, metadata) && !metadata.exists &&
+		    flags.ReturnNullIfNotExists()) {
+			return nullptr;
+		}
+		metadata_cache.TryAttachFileInfo(open_info, cache_config);
+	}
+
+	unique_ptr<FileHandle> file_handle;
+	if (!flags.OpenForWriting() && !open_info.extended_info && ResolveSingleFlight(opener)) {
+		// Concurrent opens of the same file share the metadata request: followers open with the file info fetched by
+		// the leader, which the inner filesystem takes instead of sending its own request.
+		const auto detail = flags.ReturnNullIfNotExists() ? "null_if_not_exists" : "";
+		bool shared = false;
+		const auto metadata = open_flight.Do(
+		    GetSingleFlightKey(HttpfsOperationType::OPEN, detail, path.path),
+		    [&]() {
+			    file_handle = OpenFileInternal(open_info, flags, opener);
+			    if (file_handle == nullptr) {
+				    return CachedFileMetadata();
+			    }
+			    return GetFileHandleMetadata(file_handle->Cast<TimeoutRetryFileHandle>().GetInnerHandle());
+		    },
+		    shared);
+		if (shared) {
+			RecordDeduplicatedRequest(HttpfsOperationType::OPEN, path.path);
+			// The leader only gets no handle when the file doesn't exist, and null is allowed by the shared key.
+			if (!metadata.exists) {
+				return nullptr;
+			}
+			AttachFileInfo(open_info, metadata);
+			file_handle = OpenFileInternal(open_info, flags, opener);
+		}
+	} else {
+		file_handle = OpenFileInternal(open_info, flags, opener);
+	}
+
+	if (!cache_config.enabled || flags.OpenForWriting()) {
+		return file_handle;
+	}
+	if (file_handle == nullptr) {
+		metadata_cache.PutFileExists(path.path, cache_config, /*exists=*/false);
+	} else {
+		metadata_cache.PutFileHandle(file_handle->Cast<TimeoutRetryFileHandle>().GetInnerHandle(), cache_config);
 	}
-	DatabaseFileOpener database_opener(db);
-	TimeoutRetryFileOpener wrapped_opener(database_opener, operation_type);
-	return inner_filesystem->OpenFile(path, flags, &wrapped_opener);
+	return file_handle;
+}
+
+unique_ptr<FileHandle> FileSystemTimeoutRetryWrapper::OpenFileInternal(const OpenFileInfo &info, FileOpenFlags flags,
+                                                                       optional_ptr<FileOpener> opener) {
+	// Handles capture retry settings at open; files opened for writing keep retries in the inner filesystem, since
+	// writes cannot be repeated by the wrapper.
+	return RunOperation(
+	    HttpfsOperationType::OPEN, info.path, opener,
+	    [&](TimeoutRetryFileOpener &timeout_retry_opener) {
+		    const auto client_timeout_ms = ApplyHandleSettings(timeout_retry_opener, flags);
+		    auto inner_handle = inner_filesystem->OpenFile(info, flags, &timeout_retry_opener);
+		    return WrapFileHandle(std::move(inner_handle), flags, timeout_retry_opener, client_timeout_ms);
+	    },
+	    /*retry_in_wrapper=*/!flags.OpenForWriting());
+}
+
+unique_ptr<FileHandle> FileSystemTimeoutRetryWrapper::WrapFileHandle(unique_ptr<FileHandle> inner_handle,
+                                                                     FileOpenFlags flags,
+                                                                     TimeoutRetryFileOpener &opener,
+                                                                     uint64_t client_timeout_ms) {
+	// Inner filesystem returns nullptr for non-existent files when opened with [FILE_FLAGS_NULL_IF_NOT_EXISTS].
+	if (inner_handle == nullptr) {
+		return nullptr;
+	}
+	// Resolve from the original opener, so the handle config doesn't pick up overrides applied to the open itself.
+	auto handle_config =
+	    GetHandleConfig(opener.GetInnerOpener(), opener.GetPolicies(), opener.GetPath(), flags, client_timeout_ms);
+	const auto endpoint = GetEndpoint(inner_handle->GetPath());
+	auto &metrics = TimeoutRetryMetrics::GetInstance();
+	auto &read_metrics = metrics.GetOperationMetrics(HttpfsOperationType::READ, endpoint);
+	auto &write_metrics = metrics.GetOperationMetrics(HttpfsOperationType::WRITE, endpoint);
+	auto &retry_budget = RetryBudgetRegistry::GetInstance().GetRetryBudget(endpoint);
+	auto &circuit_breaker = CircuitBreakerRegistry::GetInstance().GetCircuitBreaker(endpoint);
+	auto &concurrency_limiter = ConcurrencyLimiterRegistry::GetInstance().GetConcurrencyLimiter(endpoint);
+	auto &read_latency_trackers = ReadLatencyTrackerRegistry::GetInstance().GetReadLatencyTrackers(endpoint);
+	auto handle = make_uniq<TimeoutRetryFileHandle>(*this, std::move(inner_handle), flags, handle_config, read_metrics,
+	                                                write_metrics, retry_budget, circuit_breaker, concurrency_limiter,
+	                                                read_latency_trackers);
+	const auto block_cache_config =
+	    flags.OpenForWriting() ? BlockCacheConfig() : ResolveBlockCacheConfig(*opener.GetPolicies());
+	if (block_cache_config.IsEnabled()) {
+		// Blocks are only cached for files whose content can be identified by version tag.
+		auto &inner = handle->GetInnerHandle();
+		HandleBlockCache block_cache;
+		block_cache.block_size = block_cache_config.block_size;
+		if (TryGetBlockCacheFileHashes(inner.GetPath(), inner_filesystem->GetVersionTag(inner), block_cache.block_size,
+		                               block_cache.file_hashes)) {
+			block_cache.file_key = GetBlockCacheFileKey(block_cache.file_hashes);
+			if (block_cache_config.memory_max_bytes > 0) {
+				memory_block_cache.Configure(block_cache_config.block_size, block_cache_config.memory_max_bytes);
+				block_cache.memory_cache = &memory_block_cache;
+			}
+			if (!block_cache_config.disk_directory.empty()) {
+				auto &disk_cache =
+				    DiskBlockCacheRegistry::GetInstance().GetDiskBlockCache(block_cache_config.disk_directory);
+				block_cache.disk_cache = &disk_cache;
+				block_cache.disk_cache_max_bytes = block_cache_config.disk_max_bytes;
+			}
+			block_cache.file_size = static_cast<idx_t>(inner_filesystem->GetFileSize(inner));
+			handle->SetBlockCache(std::move(block_cache));
+		}
+	}
+	if (handle_config.single_flight && !flags.OpenForWriting()) {
+		// Reads of different versions of the file never share a request.
+		auto &inner = handle->GetInnerHandle();
+		handle->SetContentHashes(GetContentHashes(inner.GetPath(), inner_filesystem->GetVersionTag(inner)));
+	}
+	if (handle_config.read_ahead_max_bytes > 0 && !flags.OpenForWriting()) {
+		// Sequential reads track their own position, starting from where the inner handle is.
+		auto &inner = handle->GetInnerHandle();
+		const auto file_size = static_cast<idx_t>(inner_filesystem->GetFileSize(inner));
+		auto &timeout_retry_handle = *handle;
+		auto read_ahead = make_uniq<SequentialReadAhead>(
+		    handle_config.read_ahead_max_bytes, file_size, SupportsConcurrentRequests(inner),
+		    [this, &timeout_retry_handle](data_ptr_t buffer, idx_t nr_bytes, idx_t location) {
+			    ReadRange(timeout_retry_handle, buffer, static_cast<int64_t>(nr_bytes), location);
+		    });
+		read_ahead->Seek(inner_filesystem->SeekPosition(inner));
+		handle->SetReadAhead(std::move(read_ahead));
+	}
+	// Reads are only issued concurrently on handles opened for parallel access, there's nothing to coalesce otherwise.
+	if (handle_config.read_coalesce && !flags.OpenForWriting() &&
+	    SupportsConcurrentRequests(handle->GetInnerHandle())) {
+		const auto file_size = static_cast<idx_t>(inner_filesystem->GetFileSize(handle->GetInnerHandle()));
+		auto &timeout_retry_handle = *handle;
+		handle->SetReadCoalescer(make_uniq<ReadCoalescer>(
+		    handle_config.read_coalesce_max_gap_bytes, handle_config.read_coalesce_max_request_bytes,
+		    handle_config.read_coalesce_window_us, file_size,
+		    [this, &timeout_retry_handle](data_ptr_t buffer, idx_t nr_bytes, idx_t location) {
+			    FetchRange(timeout_retry_handle, buffer, static_cast<int64_t>(nr_bytes), location);
+		    }));
+	}
+	if (flags.OpenForWriting()) {
+		// Files written through the handle only become visible on close, which makes cached metadata stale.
+		const auto path = handle->GetPath();
+		handle->SetCloseCallback([this, path]() { InvalidateCachedPath(path); });
+	}
+	return std::move(handle);
 }
 
 bool FileSystemTimeoutRetryWrapper::SupportsOpenFileExtended() const {
@@ -95,13 +1018,39 @@ bool FileSystemTimeoutRetryWrapper::ListFiles(const string &directory,
 bool FileSystemTimeoutRetryWrapper::ListFilesExtended(const string &directory,
                                                       const std::function<void(OpenFileInfo &info)> &callback,
                                                       optional_ptr<FileOpener> opener) {
-	if (opener) {
-		TimeoutRetryFileOpener timeout_retry_opener(*opener, HttpfsOperationType::LIST);
-		return inner_filesystem->ListFiles(directory, callback, &timeout_retry_opener);
+	const auto listing_cache_config = ResolveListingCacheConfig(opener);
+	const auto cache_config = ResolveMetadataCacheConfig(opener);
+	vector<OpenFileInfo> entries;
+	if (listing_cache_config.enabled &&
+	    listing_cache.TryGet(ListingKind::LIST, directory, listing_cache_config, entries)) {
+		for (auto &entry : entries) {
+			callback(entry);
+		}
+		return true;
 	}
-	DatabaseFileOpener database_opener(db);
-	TimeoutRetryFileOpener timeout_retry_opener(database_opener, HttpfsOperationType::LIST);
-	return inner_filesystem->ListFiles(directory, callback, &timeout_retry_opener);
+
+	// Entries are buffered until the listing succeeds, so a retried listing doesn't report entries twice.
+	const std::function<void(OpenFileInfo &info)> collect_entry = [&entries](OpenFileInfo &info) {
+		entries.emplace_back(info);
+	};
+	const bool listed =
+	    RunOperation(HttpfsOperationType::LIST, directory, opener, [&](FileOpener &timeout_retry_opener) {
+		    entries.clear();
+		    return inner_filesystem->ListFiles(directory, collect_entry, &timeout_retry_opener);
+	    });
+	if (cache_config.enabled) {
+		for (const auto &entry : entries) {
+			metadata_cache.PutListingEntry(entry, cache_config);
+		}
+	}
+	// Listings of missing directories aren't cached.
+	if (listing_cache_config.enabled && listed) {
+		listing_cache.Put(ListingKind::LIST, directory, listing_cache_config, entries);
+	}
+	for (auto &entry : entries) {
+		callback(entry);
+	}
+	return listed;
 }
 
 bool FileSystemTimeoutRetryWrapper::SupportsListFilesExtended() const {
@@ -109,54 +1058,436 @@ bool FileSystemTimeoutRetryWrapper::SupportsListFilesExtended() const {
 }
 
 bool FileSystemTimeoutRetryWrapper::FileExists(const string &filename, optional_ptr<FileOpener> opener) {
-	if (opener) {
-		TimeoutRetryFileOpener timeout_retry_opener(*opener, HttpfsOperationType::STAT);
-		return inner_filesystem->FileExists(filename, &timeout_retry_opener);
+	const auto cache_config = ResolveMetadataCacheConfig(opener);
+	CachedFileMetadata metadata;
+	if (cache_config.enabled && metadata_cache.TryGetFile(filename, cache_config, metadata)) {
+		return metadata.exists;
+	}
+	auto check_exists = [&]() {
+		return RunStatOperation(filename, opener, [this, filename](FileOpener &timeout_retry_opener) {
+			return inner_filesystem->FileExists(filename, &timeout_retry_opener);
+		});
+	};
+	bool exists = false;
+	if (ResolveSingleFlight(opener)) {
+		bool shared = false;
+		exists =
+		    exists_flight.Do(GetSingleFlightKey(HttpfsOperationType::STAT, "file", filename), check_exists, shared);
+		if (shared) {
+			RecordDeduplicatedRequest(HttpfsOperationType::STAT, filename);
+		}
+	} else {
+		exists = check_exists();
 	}
-	DatabaseFileOpener database_opener(db);
-	TimeoutRetryFileOpener timeout_retry_opener(database_opener, HttpfsOperationType::STAT);
-	return inner_filesystem->FileExists(filename, &timeout_retry_opener);
+	if (cache_config.enabled) {
+		metadata_cache.PutFileExists(filename, cache_config, exists);
+	}
+	return exists;
 }
 
 bool FileSystemTimeoutRetryWrapper::IsPipe(const string &filename, optional_ptr<FileOpener> opener) {
-	if (opener) {
-		TimeoutRetryFileOpener timeout_retry_opener(*opener, HttpfsOperationType::STAT);
-		return inner_filesystem->IsPipe(filename, &timeout_retry_opener);
+	// Remote files are never pipes, a cached entry is as good as a lookup.
+	const auto cache_config = ResolveMetadataCacheConfig(opener);
+	CachedFileMetadata metadata;
+	if (cache_config.enabled && metadata_cache.TryGetFile(filename, cache_config, metadata)) {
+		return false;
 	}
-	DatabaseFileOpener database_opener(db);
-	TimeoutRetryFileOpener timeout_retry_opener(database_opener, HttpfsOperationType::STAT);
-	return inner_filesystem->IsPipe(filename, &timeout_retry_opener);
+	return RunStatOperation(filename, opener, [this, filename](FileOpener &timeout_retry_opener) {
+		return inner_filesystem->IsPipe(filename, &timeout_retry_opener);
+	});
 }
 
 void FileSystemTimeoutRetryWrapper::RemoveFile(const string &filename, optional_ptr<FileOpener> opener) {
-	if (opener) {
-		TimeoutRetryFileOpener timeout_retry_opener(*opener, HttpfsOperationType::DELETE);
+	InvalidateCachedPath(filename);
+	RunOperation(HttpfsOperationType::DELETE, filename, opener, [&](FileOpener &timeout_retry_opener) {
 		inner_filesystem->RemoveFile(filename, &timeout_retry_opener);
-		return;
-	}
-	DatabaseFileOpener database_opener(db);
-	TimeoutRetryFileOpener timeout_retry_opener(database_opener, HttpfsOperationType::DELETE);
-	inner_filesystem->RemoveFile(filename, &timeout_retry_opener);
+	});
+	InvalidateCachedPath(filename);
 }
 
 bool FileSystemTimeoutRetryWrapper::TryRemoveFile(const string &filename, optional_ptr<FileOpener> opener) {
+	InvalidateCachedPath(filename);
+	const bool removed =
+	    RunOperation(HttpfsOperationType::DELETE, filename, opener, [&](FileOpener &timeout_retry_opener) {
+		    return inner_filesystem->TryRemoveFile(filename, &timeout_retry_opener);
+	    });
+	InvalidateCachedPath(filename);
+	return removed;
+}
+
+void FileSystemTimeoutRetryWrapper::RemoveFiles(const vector<string> &filenames, optional_ptr<FileOpener> opener) {
+	for (const auto &filename : filenames) {
+		InvalidateCachedPath(filename);
+	}
+	const auto parallelism = ResolveDeleteParallelism(opener);
+	if (parallelism > 0) {
+		RemoveFilesInBatches(filenames, parallelism, opener);
+	} else if (!filenames.empty()) {
+		RunOperation(HttpfsOperationType::DELETE, filenames[0], opener, [&](FileOpener &timeout_retry_opener) {
+			inner_filesystem->RemoveFiles(filenames, &timeout_retry_opener);
+		});
+	}
+	for (const auto &filename : filenames) {
+		InvalidateCachedPath(filename);
+	}
+}
+
+idx_t FileSystemTimeoutRetryWrapper::ResolveDeleteParallelism(optional_ptr<FileOpener> opener) {
 	if (opener) {
-		TimeoutRetryFileOpener timeout_retry_opener(*opener, HttpfsOperationType::DELETE);
-		return inner_filesystem->TryRemoveFile(filename, &timeout_retry_opener);
+		return ResolvePolicies(*opener)->delete_parallelism;
 	}
-	DatabaseFileOpener database_opener(db);
-	TimeoutRetryFileOpener timeout_retry_opener(database_opener, HttpfsOperationType::DELETE);
-	return inner_filesystem->TryRemoveFile(filename, &timeout_retry_opener);
+	return ResolvePolicies(database_opener)->delete_parallelism;
+}
+
+void FileSystemTimeoutRetryWrapper::RemoveFilesInBatches(const vector<string> &filenames, idx_t parallelism,
+                                                         optional_ptr<FileOpener> opener) {
+	// Multi-object delete requests only take keys of the same bucket; files elsewhere are removed one by one.
+	vector<vector<string>> batches;
+	unordered_map<string, idx_t> open_batch_by_endpoint;
+	for (const auto &filename : filenames) {
+		if (!SupportsBatchDelete(filename)) {
+			batches.emplace_back(vector<string> {filename});
+			continue;
+		}
+		const auto endpoint = GetEndpoint(filename);
+		auto iter = open_batch_by_endpoint.find(endpoint);
+		if (iter == open_batch_by_endpoint.end() || batches[iter->second].size() >= MAX_DELETE_BATCH_SIZE) {
+			open_batch_by_endpoint[endpoint] = batches.size();
+			batches.emplace_back();
+		}
+		batches[open_batch_by_endpoint[endpoint]].emplace_back(filename);
+	}
+
+	// Each request applies the delete timeout and retries on its own; a failed request doesn't stop the others, so
+	// as many files as possible are removed.
+	mutex failure_mutex;
+	vector<std::pair<string, string>> failures;
+	vector<string> unconfirmed_files;
+	RunTasksConcurrently(batches.size(), parallelism, [&](idx_t batch_index) {
+		const auto &batch = batches[batch_index];
+		try {
+			RunOperation(HttpfsOperationType::DELETE, batch[0], opener, [&](FileOpener &timeout_retry_opener) {
+				if (SupportsBatchDelete(batch[0])) {
+					inner_filesystem->RemoveFiles(batch, &timeout_retry_opener);
+				} else {
+					inner_filesystem->RemoveFile(batch[0], &timeout_retry_opener);
+				}
+			});
+		} catch (std::exception &ex) {
+			lock_guard<mutex> lck(failure_mutex);
+			if (batch.size() == 1) {
+				failures.emplace_back(batch[0], ex.what());
+			} else {
+				unconfirmed_files.insert(unconfirmed_files.end(), batch.begin(), batch.end());
+			}
+		}
+		return true;
+	});
+
+	// The inner filesystem reports a failed multi-object delete as one error, which doesn't tell which of its keys were
+	// not removed or why; they are removed one by one instead, so each failure is reported with its own reason.
+	// Deleting a key which the batch already removed succeeds on object storage.
+	RunTasksConcurrently(unconfirmed_files.size(), parallelism, [&](idx_t file_index) {
+		const auto &filename = unconfirmed_files[file_index];
+		try {
+			RunOperation(HttpfsOperationType::DELETE, filename, opener, [&](FileOpener &timeout_retry_opener) {
+				inner_filesystem->RemoveFile(filename, &timeout_retry_opener);
+			});
+		} catch (std::exception &ex) {
+			lock_guard<mutex> lck(failure_mutex);
+			failures.emplace_back(filename, ex.what());
+		}
+		return true;
+	});
+	if (failures.empty()) {
+		return;
+	}
+
+	std::sort(failures.begin(), failures.end());
+	string failure_details;
+	const auto reported_count = MinValue<idx_t>(failures.size(), MAX_REPORTED_DELETE_FAILURES);
+	for (idx_t failure_index = 0; failure_index < reported_count; ++failure_index) {
+		const auto &failure = failures[failure_index];
+		failure_details += StringUtil::Format("\n%s: %s", failure.first, failure.second);
+	}
+	if (failures.size() > MAX_REPORTED_DELETE_FAILURES) {
+		failure_details += StringUtil::Format("\n... and %llu more", failures.size() - MAX_REPORTED_DELETE_FAILURES);
+	}
+	throw IOException("Failed to remove %llu of %llu files:%s", failures.size(), filenames.size(), failure_details);
 }
 
 vector<OpenFileInfo> FileSystemTimeoutRetryWrapper::Glob(const string &path, FileOpener *opener) {
+	const auto listing_cache_config = ResolveListingCacheConfig(opener);
+	vector<OpenFileInfo> result;
+	if (listing_cache_config.enabled && listing_cache.TryGet(ListingKind::GLOB, path, listing_cache_config, result)) {
+		return result;
+	}
+	const auto parallelism = ResolveGlobParallelism(opener);
+	if (parallelism == 0 || !TryGlobPartitioned(path, parallelism, opener, result)) {
+		result = GlobInternal(path, opener);
+	}
+	// Listed entries carry file info, which saves a metadata request for each file opened afterwards.
+	const auto cache_config = ResolveMetadataCacheConfig(opener);
+	if (cache_config.enabled) {
+		for (const auto &info : result) {
+			metadata_cache.PutListingEntry(info, cache_config);
+		}
+	}
+	if (listing_cache_config.enabled) {
+		listing_cache.Put(ListingKind::GLOB, path, listing_cache_config, result);
+	}
+	return result;
+}
+
+idx_t FileSystemTimeoutRetryWrapper::ResolveGlobParallelism(optional_ptr<FileOpener> opener) {
 	if (opener) {
-		TimeoutRetryFileOpener timeout_retry_opener(*opener, HttpfsOperationType::LIST);
+		return ResolvePolicies(*opener)->glob_parallelism;
+	}
+	return ResolvePolicies(database_opener)->glob_parallelism;
+}
+
+vector<OpenFileInfo> FileSystemTimeoutRetryWrapper::GlobInternal(const string &path, optional_ptr<FileOpener> opener) {
+	return RunOperation(HttpfsOperationType::LIST, path, opener, [&](FileOpener &timeout_retry_opener) {
 		return inner_filesystem->Glob(path, &timeout_retry_opener);
+	});
+}
+
+bool FileSystemTimeoutRetryWrapper::TryGlobPartitioned(const string &path, idx_t parallelism,
+                                                       optional_ptr<FileOpener> opener, vector<OpenFileInfo> &result) {
+	PartitionedGlob partitioned_glob;
+	if (!TrySplitPartitionedGlob(path, partitioned_glob)) {
+		return false;
+	}
+	const bool s3_listing = inner_filesystem->GetName() == S3_FILESYSTEM_NAME;
+	if (!s3_listing && !ListsDirectoryChildren(partitioned_glob.directory)) {
+		return false;
+	}
+	vector<string> partitions;
+	try {
+		const bool listed = RunOperation(
+		    HttpfsOperationType::LIST, partitioned_glob.directory, opener, [&](FileOpener &timeout_retry_opener) {
+			    partitions.clear();
+			    if (s3_listing) {
+				    const auto child_prefixes = ListS3ChildPrefixes(partitioned_glob.directory, timeout_retry_opener);
+				    for (const auto &child_prefix : child_prefixes) {
+					    const auto partition = GetListedName(child_prefix);
+					    if (MatchGlobSegment(partition, partitioned_glob.partition_pattern)) {
+						    partitions.emplace_back(partition);
+					    }
+				    }
+				    return true;
+			    }
+			    return inner_filesystem->ListFiles(
+			        partitioned_glob.directory,
+			        [&](const string &name, bool is_dir) {
+				        const auto partition = GetListedName(name);
+				        if ((is_dir || StringUtil::EndsWith(name, "/")) &&
+				            MatchGlobSegment(partition, partitioned_glob.partition_pattern)) {
+					        partitions.emplace_back(partition);
+				        }
+			        },
+			        &timeout_retry_opener);
+		    });
+		if (!listed) {
+			return false;
+		}
+	} catch (NotImplementedException &) {
+		// The inner filesystem cannot list directories.
+		return false;
+	}
+	// Filesystems which don't report directories in listings cannot be expanded either.
+	if (partitions.empty()) {
+		return false;
+	}
+
+	// Partitions are globbed by a bounded pool of threads, the calling thread included; each partition glob applies
+	// the list timeout and retries on its own.
+	vector<vector<OpenFileInfo>> partition_results(partitions.size());
+	mutex error_mutex;
+	std::exception_ptr error;
+	RunTasksConcurrently(partitions.size(), parallelism, [&](idx_t partition_index) {
+		try {
+			partition_results[partition_index] =
+			    GlobInternal(partitioned_glob.GetPartitionGlob(partitions[partition_index]), opener);
+			return true;
+		} catch (...) {
+			lock_guard<mutex> lck(error_mutex);
+			if (error == nullptr) {
+				error = std::current_exception();
+			}
+			// Skip the remaining partitions, the glob fails anyway.
+			return false;
+		}
+	});
+	if (error != nullptr) {
+		std::rethrow_exception(error);
+	}
+
+	result.clear();
+	for (auto &partition_result : partition_results) {
+		std::move(partition_result.begin(), partition_result.end(), std::back_inserter(result));
+	}
+	// Keep the order of a glob over the whole pattern, which lists keys in lexicographic order.
+	std::sort(result.begin(), result.end(),
+	          [](const OpenFileInfo &lhs, const OpenFileInfo &rhs) { return lhs.path < rhs.path; });
+	return true;
+}
+
+//===--------------------------------------------------------------------===//
+// Background read
+//===--------------------------------------------------------------------===//
+
+bool FileSystemTimeoutRetryWrapper::TryGetHedgeDelay(TimeoutRetryFileHandle &handle, idx_t nr_bytes,
+                                                     uint64_t &delay_us) const {
+	const auto &config = handle.GetConfig();
+	delay_us = config.hedge_delay_ms * 1000;
+	if (config.hedge_percentile == 0) {
+		return true;
+	}
+	// Compare against reads of similar size from the same endpoint only.
+	const auto &latency_tracker = handle.GetReadLatencyTrackers().GetTracker(nr_bytes);
+	uint64_t percentile_latency_us = 0;
+	if (latency_tracker.TryGetPercentile(config.hedge_percentile, HEDGE_MIN_LATENCY_SAMPLES, percentile_latency_us)) {
+		delay_us = MaxValue<uint64_t>(delay_us, percentile_latency_us);
+		return true;
+	}
+	// Without enough samples, only hedge if a fixed delay has been configured.
+	return config.hedge_delay_ms > 0;
+}
+
+bool FileSystemTimeoutRetryWrapper::TryAcquireHedge(TimeoutRetryFileHandle &handle) const {
+	const auto &read_retry = handle.GetConfig().read_retry;
+	auto &concurrency_limiter = handle.GetConcurrencyLimiter();
+	// Hedges never queue for a slot: once the limit is reached, the endpoint is busy enough without them.
+	if (read_retry.concurrency_limit.enabled &&
+	    !concurrency_limiter.TryAcquire(HttpfsOperationType::READ, read_retry.concurrency_limit)) {
+		return false;
+	}
+	// A hedge is an extra request like a retry, so it draws from the same budget, which caps hedging during an outage.
+	if (read_retry.budget.enabled && !handle.GetRetryBudget().TryAcquireRetry(read_retry.budget)) {
+		if (read_retry.concurrency_limit.enabled) {
+			concurrency_limiter.Release(HttpfsOperationType::READ);
+		}
+		return false;
+	}
+	return true;
+}
+
+void FileSystemTimeoutRetryWrapper::ReadInBackground(TimeoutRetryFileHandle &handle, void *buffer, int64_t nr_bytes,
+                                                     idx_t location, const BackgroundReadOptions &options) {
+	// Requests abandoned at deadline or losing the race keep running, which is only safe on handles that allow
+	// concurrent requests; others never read in the background, so nothing waits for abandoned requests.
+	D_ASSERT(SupportsConcurrentRequests(handle.GetInnerHandle()));
+
+	auto state = make_shared_ptr<BackgroundReadState>();
+	state->target = static_cast<data_ptr_t>(buffer);
+	// [slot_acquired] is set for requests which already hold a slot of the concurrency limiter.
+	auto launch_request = [this, &handle, state, nr_bytes, location](bool slot_acquired) {
+		{
+			lock_guard<mutex> lck(state->state_mutex);
+			++state->pending_requests;
+		}
+		RegisterBackgroundRequest();
+		// The request could outlive the handle, so it shares the inner handle and config; latency trackers, metrics and
+		// the concurrency limiter are process-wide.
+		auto inner_handle = handle.GetSharedInnerHandle();
+		auto config = handle.GetSharedConfig();
+		auto &latency_tracker = handle.GetReadLatencyTrackers().GetTracker(static_cast<idx_t>(nr_bytes));
+		auto &concurrency_limiter = handle.GetConcurrencyLimiter();
+		auto &read_metrics = handle.GetReadMetrics();
+		GetBackgroundReadExecutor().Schedule([this, inner_handle, config, &latency_tracker, &concurrency_limiter,
+		                                      &read_metrics, state, nr_bytes, location, slot_acquired]() {
+			// Every request holds a slot until it finishes, including those which lost the race or were abandoned.
+			unique_ptr<ConcurrencySlot> slot;
+			if (slot_acquired) {
+				slot = make_uniq<ConcurrencySlot>(concurrency_limiter, HttpfsOperationType::READ, true);
+			} else {
+				slot = make_uniq<ConcurrencySlot>(concurrency_limiter, config->read_retry.concurrency_limit,
+				                                  read_metrics);
+			}
+			const auto request_start = std::chrono::steady_clock::now();
+			bool send_request = true;
+			{
+				lock_guard<mutex> lck(state->state_mutex);
+				if (!state->started) {
+					state->started = true;
+					state->start = request_start;
+					state->state_cv.notify_all();
+				}
+				// Requests still queued once the read is settled (i.e. a hedge which lost the race before it was sent)
+				// are dropped; those already sent cannot be cancelled, since HTTP clients don't support it.
+				send_request = !state->completed && !state->abandoned;
+			}
+			// Requests could be abandoned while still receiving data, so each one reads into a buffer of its own.
+			unsafe_unique_array<data_t> request_buffer;
+			std::exception_ptr request_error;
+			if (send_request) {
+				request_buffer = make_unsafe_uniq_array_uninitialized<data_t>(static_cast<idx_t>(nr_bytes));
+				try {
+					ReadFromInner(*inner_handle, *config, request_buffer.get(), nr_bytes, location);
+				} catch (...) {
+					request_error = std::current_exception();
+				}
+				if (request_error == nullptr) {
+					latency_tracker.Record(GetElapsedMicros(request_start));
+				}
+			}
+			slot.reset();
+			{
+				lock_guard<mutex> lck(state->state_mutex);
+				--state->pending_requests;
+				if (send_request && request_error == nullptr && !state->completed && !state->abandoned) {
+					// The foreground read is still waiting, so its buffer is valid.
+					memcpy(state->target, request_buffer.get(), static_cast<idx_t>(nr_bytes));
+					state->completed = true;
+				} else if (request_error != nullptr && state->error == nullptr) {
+					state->error = request_error;
+				}
+				state->state_cv.notify_all();
+			}
+			UnregisterBackgroundRequest();
+		});
+	};
+
+	launch_request(false);
+	unique_lock<mutex> lck(state->state_mutex);
+	state->state_cv.wait(lck, [&state]() { return state->started; });
+	const auto start = state->start;
+	auto settled = [&state]() {
+		return state->completed || state->pending_requests == 0;
+	};
+	const bool has_deadline = options.deadline_ms > 0;
+	const auto deadline = start + std::chrono::milliseconds(options.deadline_ms);
+	if (options.hedge) {
+		auto hedge_time = start + std::chrono::microseconds(options.hedge_delay_us);
+		if (has_deadline) {
+			hedge_time = MinValue(hedge_time, deadline);
+		}
+		if (!state->state_cv.wait_until(lck, hedge_time, settled) && hedge_time != deadline) {
+			lck.unlock();
+			if (TryAcquireHedge(handle)) {
+				handle.GetReadMetrics().RecordHedgedRequest();
+				launch_request(handle.GetConfig().read_retry.concurrency_limit.enabled);
+			}
+			lck.lock();
+		}
+	}
+	if (has_deadline) {
+		if (!state->state_cv.wait_until(lck, deadline, settled)) {
+			// Requests still in flight must not touch the buffer once the read returns.
+			state->abandoned = true;
+			throw IOException("Read of %lld bytes at offset %llu from %s timed out after %llu ms", nr_bytes, location,
+			                  handle.GetPath(), options.deadline_ms);
+		}
+	} else {
+		state->state_cv.wait(lck, settled);
+	}
+
+	// Requests which lost the race keep running in the background; their results are discarded.
+	if (!state->completed) {
+		D_ASSERT(state->error != nullptr);
+		std::rethrow_exception(state->error);
 	}
-	DatabaseFileOpener database_opener(db);
-	TimeoutRetryFileOpener timeout_retry_opener(database_opener, HttpfsOperationType::LIST);
-	return inner_filesystem->Glob(path, &timeout_retry_opener);
 }
 
 //===--------------------------------------------------------------------===//
@@ -169,51 +1500,415 @@ string FileSystemTimeoutRetryWrapper::GetName() const {
 
 void FileSystemTimeoutRetryWrapper::MoveFile(const string &source, const string &target,
                                              optional_ptr<FileOpener> opener) {
+	InvalidateCachedPath(source);
+	InvalidateCachedPath(target);
 	inner_filesystem->MoveFile(source, target, opener);
+	InvalidateCachedPath(source);
+	InvalidateCachedPath(target);
 }
 
 void FileSystemTimeoutRetryWrapper::Read(FileHandle &handle, void *buffer, int64_t nr_bytes, idx_t location) {
-	inner_filesystem->Read(handle, buffer, nr_bytes, location);
+	auto &timeout_retry_handle = handle.Cast<TimeoutRetryFileHandle>();
+	OperationRecorder recorder(timeout_retry_handle.GetReadMetrics());
+	recorder.SetRetryBudget(timeout_retry_handle.GetRetryBudget(), timeout_retry_handle.GetConfig().read_retry.budget);
+	try {
+		ReadRange(timeout_retry_handle, buffer, nr_bytes, location);
+	} catch (std::exception &ex) {
+		recorder.Fail(IsTimeoutError(ex));
+		throw;
+	}
+	recorder.SetBytes(static_cast<idx_t>(MaxValue<int64_t>(nr_bytes, 0)));
+}
+
+void FileSystemTimeoutRetryWrapper::ReadRange(TimeoutRetryFileHandle &handle, void *buffer, int64_t nr_bytes,
+                                              idx_t location) {
+	const auto &block_cache = handle.GetBlockCache();
+	// Reads past end of file are left to the inner filesystem to report.
+	if (block_cache.IsEnabled() && nr_bytes > 0 && location + static_cast<idx_t>(nr_bytes) <= block_cache.file_size) {
+		ReadThroughBlockCache(handle, static_cast<data_ptr_t>(buffer), static_cast<idx_t>(nr_bytes), location);
+		return;
+	}
+	auto read_coalescer = handle.GetReadCoalescer();
+	if (read_coalescer && nr_bytes > 0 && read_coalescer->ShouldCoalesce(static_cast<idx_t>(nr_bytes), location)) {
+		read_coalescer->Read(static_cast<data_ptr_t>(buffer), static_cast<idx_t>(nr_bytes), location);
+		return;
+	}
+	FetchRange(handle, buffer, nr_bytes, location);
+}
+
+void FileSystemTimeoutRetryWrapper::FetchRange(TimeoutRetryFileHandle &handle, void *buffer, int64_t nr_bytes,
+                                               idx_t location) {
+	if (!handle.GetConfig().single_flight || nr_bytes <= 0) {
+		FetchRangeInternal(handle, buffer, nr_bytes, location);
+		return;
+	}
+	// The leader reads into its own buffer, which followers copy from before the leader returns.
+	ReadFlightKey key {handle.GetContentHashes(), location, static_cast<idx_t>(nr_bytes)};
+	bool shared = false;
+	read_flight.DoInPlace(
+	    key,
+	    [&]() {
+		    FetchRangeInternal(handle, buffer, nr_bytes, location);
+		    return static_cast<const_data_ptr_t>(buffer);
+	    },
+	    [&](const_data_ptr_t data) { memcpy(buffer, data, static_cast<idx_t>(nr_bytes)); }, shared);
+	if (shared) {
+		handle.GetReadMetrics().RecordDeduplicatedRequest();
+	}
+}
+
+size_t FileSystemTimeoutRetryWrapper::ReadFlightKeyHash::operator()(const ReadFlightKey &key) const {
+	// The content hashes are a hash already.
+	return static_cast<size_t>(
+	    CombineHash(key.content_hashes.first, CombineHash(Hash(key.location), Hash(key.nr_bytes))));
+}
+
+void FileSystemTimeoutRetryWrapper::FetchRangeInternal(TimeoutRetryFileHandle &handle, void *buffer, int64_t nr_bytes,
+                                                       idx_t location) {
+	if (ShouldReadInParallel(handle, nr_bytes)) {
+		ReadInParallel(handle, buffer, nr_bytes, location);
+		return;
+	}
+	ReadWithRetries(handle, buffer, nr_bytes, location);
+}
+
+void FileSystemTimeoutRetryWrapper::ReadThroughBlockCache(TimeoutRetryFileHandle &handle, data_ptr_t buffer,
+                                                          idx_t nr_bytes, idx_t location) {
+	const auto &block_cache = handle.GetBlockCache();
+	const auto &file_key = block_cache.file_key;
+	const auto &file_hashes = block_cache.file_hashes;
+	const auto block_size = block_cache.block_size;
+	const auto file_size = block_cache.file_size;
+	const auto read_end = location + nr_bytes;
+	// Copy the part of [block_data] (which starts at [block_start]) overlapping with the read into [buffer].
+	auto copy_overlap = [&](const_data_ptr_t block_data, idx_t block_start, idx_t block_end) {
+		const auto copy_start = MaxValue<idx_t>(block_start, location);
+		const auto copy_end = MinValue<idx_t>(block_end, read_end);
+		memcpy(buffer + (copy_start - location), block_data + (copy_start - block_start), copy_end - copy_start);
+	};
+	auto memory_cache = block_cache.memory_cache;
+	auto disk_cache = block_cache.disk_cache;
+	// Blocks from the disk tier are read whole, to be promoted to memory; only allocated if the read needs one.
+	unsafe_unique_array<data_t> block_buffer;
+	// Read the part of the block overlapping with the read from the memory tier, or the whole block from the disk tier
+	// and promote it to memory.
+	auto try_read_block = [&](idx_t block_index, idx_t block_start, idx_t block_end) {
+		const auto copy_start = MaxValue<idx_t>(block_start, location);
+		const auto copy_end = MinValue<idx_t>(block_end, read_end);
+		if (memory_cache && memory_cache->TryRead(file_hashes, block_index, block_end - block_start,
+		                                          copy_start - block_start, buffer + (copy_start - location),
+		                                          copy_end - copy_start)) {
+			return true;
+		}
+		if (!disk_cache) {
+			return false;
+		}
+		// Blocks which are entirely read are read in place.
+		const bool whole_block = copy_start == block_start && copy_end == block_end;
+		data_ptr_t block_data = buffer + (block_start - location);
+		if (!whole_block) {
+			if (!block_buffer) {
+				block_buffer = make_unsafe_uniq_array_uninitialized<data_t>(block_size);
+			}
+			block_data = block_buffer.get();
+		}
+		if (!disk_cache->TryRead(file_key, block_index, block_data, block_end - block_start)) {
+			return false;
+		}
+		if (memory_cache) {
+			memory_cache->Write(file_hashes, block_index, block_data, block_end - block_start);
+		}
+		if (!whole_block) {
+			copy_overlap(block_data, block_start, block_end);
+		}
+		return true;
+	};
+	auto is_block_cached = [&](idx_t block_index) {
+		return (memory_cache && memory_cache->Contains(file_hashes, block_index)) ||
+		       (disk_cache && disk_cache->Contains(file_key, block_index));
+	};
+
+	const auto last_block_index = (read_end - 1) / block_size;
+	idx_t block_index = location / block_size;
+	while (block_index <= last_block_index) {
+		const auto block_start = block_index * block_size;
+		const auto block_end = MinValue<idx_t>(block_start + block_size, file_size);
+		if (try_read_block(block_index, block_start, block_end)) {
+			++block_index;
+			continue;
+		}
+
+		// Consecutive missing blocks are fetched with one request, and cached block by block.
+		idx_t run_end_index = block_index + 1;
+		while (run_end_index <= last_block_index && !is_block_cached(run_end_index)) {
+			++run_end_index;
+		}
+		const auto run_end = MinValue<idx_t>(run_end_index * block_size, file_size);
+		const auto run_bytes = run_end - block_start;
+		// Runs within the read are fetched in place, only runs sticking out of it need a buffer of their own.
+		unsafe_unique_array<data_t> run_buffer;
+		data_ptr_t run_data = buffer + (block_start - location);
+		const bool within_read = block_start >= location && run_end <= read_end;
+		if (!within_read) {
+			run_buffer = make_unsafe_uniq_array_uninitialized<data_t>(run_bytes);
+			run_data = run_buffer.get();
+		}
+		FetchRange(handle, run_data, static_cast<int64_t>(run_bytes), block_start);
+		for (idx_t run_index = block_index; run_index < run_end_index; ++run_index) {
+			const auto offset = (run_index - block_index) * block_size;
+			const auto cached_bytes = MinValue<idx_t>(block_size, run_bytes - offset);
+			if (memory_cache) {
+				memory_cache->Write(file_hashes, run_index, run_data + offset, cached_bytes);
+			}
+			if (disk_cache) {
+				disk_cache->Write(file_key, run_index, run_data + offset, cached_bytes,
+				                  block_cache.disk_cache_max_bytes);
+			}
+		}
+		if (!within_read) {
+			copy_overlap(run_data, block_start, run_end);
+		}
+		block_index = run_end_index;
+	}
+}
+
+void FileSystemTimeoutRetryWrapper::ReadWithRetries(TimeoutRetryFileHandle &handle, void *buffer, int64_t nr_bytes,
+                                                    idx_t location) {
+	// Requests take their slot of the concurrency limiter themselves (see [ReadAtLocation]), since background requests
+	// keep theirs until they finish rather than until the attempt gives up.
+	auto retry_config = handle.GetConfig().read_retry;
+	retry_config.concurrency_limit.enabled = false;
+	// Bytes received so far, which are kept across retries.
+	int64_t bytes_received = 0;
+	bool is_retry = false;
+	auto read_remaining = [&]() {
+		if (nr_bytes <= 0) {
+			ReadAtLocation(handle, buffer, nr_bytes, location);
+			return;
+		}
+		// Only reads which failed before are chunked, the first attempt is a single request.
+		const auto chunk_size = is_retry ? READ_RESUME_CHUNK_SIZE : nr_bytes;
+		is_retry = true;
+		while (bytes_received < nr_bytes) {
+			const auto chunk_bytes = MinValue<int64_t>(nr_bytes - bytes_received, chunk_size);
+			ReadAtLocation(handle, static_cast<data_ptr_t>(buffer) + bytes_received, chunk_bytes,
+			               location + static_cast<idx_t>(bytes_received));
+			bytes_received += chunk_bytes;
+		}
+	};
+	RunWithRetries(retry_config, handle.GetRetryBudget(), handle.GetCircuitBreaker(), handle.GetConcurrencyLimiter(),
+	               handle.GetReadMetrics(), read_remaining);
+}
+
+void FileSystemTimeoutRetryWrapper::ReadInParallel(TimeoutRetryFileHandle &timeout_retry_handle, void *buffer,
+                                                   int64_t nr_bytes, idx_t location) {
+	const auto part_count = timeout_retry_handle.GetConfig().parallel_read_parts;
+	const auto part_size = (nr_bytes + static_cast<int64_t>(part_count) - 1) / static_cast<int64_t>(part_count);
+	auto state = make_shared_ptr<ParallelReadState>();
+	auto read_parts = [this, &timeout_retry_handle, buffer, nr_bytes, location, part_count, part_size, state]() {
+		while (true) {
+			const auto part_index = state->next_part.fetch_add(1);
+			if (part_index >= part_count) {
+				return;
+			}
+			std::exception_ptr part_error;
+			const auto part_offset = static_cast<int64_t>(part_index) * part_size;
+			if (part_offset < nr_bytes) {
+				try {
+					const auto part_bytes = MinValue<int64_t>(part_size, nr_bytes - part_offset);
+					ReadWithRetries(timeout_retry_handle, static_cast<data_ptr_t>(buffer) + part_offset, part_bytes,
+					                location + static_cast<idx_t>(part_offset));
+				} catch (...) {
+					part_error = std::current_exception();
+				}
+			}
+			lock_guard<mutex> lck(state->state_mutex);
+			if (part_error != nullptr && state->error == nullptr) {
+				state->error = part_error;
+			}
+			++state->finished_parts;
+			state->state_cv.notify_all();
+		}
+	};
+
+	// Parts are claimed by whoever comes first, so the read makes progress on the calling thread even if the pool is
+	// busy with other reads.
+	auto &executor = GetParallelReadExecutor();
+	for (idx_t worker_index = 1; worker_index < part_count; ++worker_index) {
+		executor.Schedule(read_parts);
+	}
+	read_parts();
+	unique_lock<mutex> lck(state->state_mutex);
+	state->state_cv.wait(lck, [&]() { return state->finished_parts == part_count; });
+	if (state->error != nullptr) {
+		std::rethrow_exception(state->error);
+	}
+}
+
+void FileSystemTimeoutRetryWrapper::ReadAtLocation(TimeoutRetryFileHandle &timeout_retry_handle, void *buffer,
+                                                   int64_t nr_bytes, idx_t location) {
+	auto &inner_handle = timeout_retry_handle.GetInnerHandle();
+	const auto &config = timeout_retry_handle.GetConfig();
+	if (nr_bytes <= 0) {
+		inner_filesystem->Read(inner_handle, buffer, nr_bytes, location);
+		return;
+	}
+
+	// Reads which miss the deadline are abandoned while their request keeps running, which other requests on the
+	// handle would have to wait for unless it allows concurrent requests; other handles rely on the client timeout.
+	const bool concurrent_requests = SupportsConcurrentRequests(inner_handle);
+	BackgroundReadOptions options;
+	options.deadline_ms = concurrent_requests ? config.read_deadline_ms : 0;
+	// Latency of reads of similar size from the endpoint decides both hedging and adaptive timeout.
+	const bool track_latency = concurrent_requests && (config.hedge_read || config.read_adaptive_timeout.enabled);
+	auto &latency_tracker = timeout_retry_handle.GetReadLatencyTrackers().GetTracker(static_cast<idx_t>(nr_bytes));
+	uint64_t adaptive_timeout_ms = 0;
+	if (concurrent_requests && config.read_adaptive_timeout.enabled &&
+	    TryGetAdaptiveTimeoutMs(config.read_adaptive_timeout, latency_tracker, adaptive_timeout_ms)) {
+		// The client timeout is fixed at open, in whole seconds, so the estimate is enforced as deadline instead.
+		options.deadline_ms = adaptive_timeout_ms;
+	}
+	if (config.hedge_read && concurrent_requests) {
+		options.hedge = TryGetHedgeDelay(timeout_retry_handle, static_cast<idx_t>(nr_bytes), options.hedge_delay_us);
+	}
+	if (!options.hedge && options.deadline_ms == 0) {
+		// Without enough information to tell a straggler apart, read directly and learn the latency from it.
+		ConcurrencySlot slot(timeout_retry_handle.GetConcurrencyLimiter(), config.read_retry.concurrency_limit,
+		                     timeout_retry_handle.GetReadMetrics());
+		const auto start = std::chrono::steady_clock::now();
+		ReadFromInner(inner_handle, config, buffer, nr_bytes, location);
+		if (track_latency) {
+			latency_tracker.Record(GetElapsedMicros(start));
+		}
+		return;
+	}
+	ReadInBackground(timeout_retry_handle, buffer, nr_bytes, location, options);
+}
+
+void FileSystemTimeoutRetryWrapper::ReadFromInner(FileHandle &inner_handle, const TimeoutRetryHandleConfig &config,
+                                                  void *buffer, int64_t nr_bytes, idx_t location) {
+	if (!config.fault_injection.enabled) {
+		inner_filesystem->Read(inner_handle, buffer, nr_bytes, location);
+		return;
+	}
+	const auto &path = inner_handle.GetPath();
+	const auto stall_ms =
+	    fault_injector.Inject(config.fault_injection, HttpfsOperationType::READ, path, config.client_timeout_ms);
+	if (stall_ms == 0 || nr_bytes < 2) {
+		inner_filesystem->Read(inner_handle, buffer, nr_bytes, location);
+		return;
+	}
+	// Stall between the two halves of the transfer; the first half is received either way.
+	const auto first_half = nr_bytes / 2;
+	inner_filesystem->Read(inner_handle, buffer, first_half, location);
+	FaultInjector::Stall(HttpfsOperationType::READ, path, stall_ms, config.client_timeout_ms);
+	inner_filesystem->Read(inner_handle, static_cast<data_ptr_t>(buffer) + first_half, nr_bytes - first_half,
+	                       location + static_cast<idx_t>(first_half));
 }
 
 void FileSystemTimeoutRetryWrapper::Write(FileHandle &handle, void *buffer, int64_t nr_bytes, idx_t location) {
-	inner_filesystem->Write(handle, buffer, nr_bytes, location);
+	auto &timeout_retry_handle = handle.Cast<TimeoutRetryFileHandle>();
+	OperationRecorder recorder(timeout_retry_handle.GetWriteMetrics());
+	try {
+		RunHandleWrite(timeout_retry_handle, [&]() {
+			inner_filesystem->Write(timeout_retry_handle.GetInnerHandle(), buffer, nr_bytes, location);
+		});
+	} catch (std::exception &ex) {
+		recorder.Fail(IsTimeoutError(ex));
+		throw;
+	}
+	recorder.SetBytes(static_cast<idx_t>(MaxValue<int64_t>(nr_bytes, 0)));
 }
 
 int64_t FileSystemTimeoutRetryWrapper::Read(FileHandle &handle, void *buffer, int64_t nr_bytes) {
-	return inner_filesystem->Read(handle, buffer, nr_bytes);
+	auto &timeout_retry_handle = handle.Cast<TimeoutRetryFileHandle>();
+	auto &read_metrics = timeout_retry_handle.GetReadMetrics();
+	auto &retry_budget = timeout_retry_handle.GetRetryBudget();
+	const auto &retry_config = timeout_retry_handle.GetConfig().read_retry;
+	OperationRecorder recorder(read_metrics);
+	recorder.SetRetryBudget(retry_budget, retry_config.budget);
+	try {
+		auto read_ahead = timeout_retry_handle.GetReadAhead();
+		if (read_ahead && nr_bytes > 0) {
+			const auto bytes_read = read_ahead->Read(static_cast<data_ptr_t>(buffer), static_cast<idx_t>(nr_bytes));
+			recorder.SetBytes(bytes_read);
+			return static_cast<int64_t>(bytes_read);
+		}
+		// File offset only advances on a successful read, so a failed read can be simply repeated.
+		auto &inner_handle = timeout_retry_handle.GetInnerHandle();
+		const auto &config = timeout_retry_handle.GetConfig();
+		const auto bytes_read = RunWithRetries(
+		    retry_config, retry_budget, timeout_retry_handle.GetCircuitBreaker(),
+		    timeout_retry_handle.GetConcurrencyLimiter(), read_metrics, [&]() {
+			    if (config.fault_injection.enabled) {
+				    // Injected stalls come before the read, which could not be repeated once it advanced the offset.
+				    const auto &path = timeout_retry_handle.GetPath();
+				    const auto stall_ms = fault_injector.Inject(config.fault_injection, HttpfsOperationType::READ,
+				                                                path, config.client_timeout_ms);
+				    if (stall_ms > 0) {
+					    FaultInjector::Stall(HttpfsOperationType::READ, path, stall_ms, config.client_timeout_ms);
+				    }
+			    }
+			    return inner_filesystem->Read(inner_handle, buffer, nr_bytes);
+		    });
+		recorder.SetBytes(static_cast<idx_t>(MaxValue<int64_t>(bytes_read, 0)));
+		return bytes_read;
+	} catch (std::exception &ex) {
+		recorder.Fail(IsTimeoutError(ex));
+		throw;
+	}
 }
 
 int64_t FileSystemTimeoutRetryWrapper::Write(FileHandle &handle, void *buffer, int64_t nr_bytes) {
-	return inner_filesystem->Write(handle, buffer, nr_bytes);
+	auto &timeout_retry_handle = handle.Cast<TimeoutRetryFileHandle>();
+	OperationRecorder recorder(timeout_retry_handle.GetWriteMetrics());
+	try {
+		const auto bytes_written = RunHandleWrite(timeout_retry_handle, [&]() {
+			return inner_filesystem->Write(timeout_retry_handle.GetInnerHandle(), buffer, nr_bytes);
+		});
+		recorder.SetBytes(static_cast<idx_t>(MaxValue<int64_t>(bytes_written, 0)));
+		return bytes_written;
+	} catch (std::exception &ex) {
+		recorder.Fail(IsTimeoutError(ex));
+		throw;
+	}
 }
 
 int64_t FileSystemTimeoutRetryWrapper::GetFileSize(FileHandle &handle) {
-	return inner_filesystem->GetFileSize(handle);
+	auto &inner_handle = handle.Cast<TimeoutRetryFileHandle>().GetInnerHandle();
+	return inner_filesystem->GetFileSize(inner_handle);
 }
 
 timestamp_t FileSystemTimeoutRetryWrapper::GetLastModifiedTime(FileHandle &handle) {
-	return inner_filesystem->GetLastModifiedTime(handle);
+	auto &inner_handle = handle.Cast<TimeoutRetryFileHandle>().GetInnerHandle();
+	return inner_filesystem->GetLastModifiedTime(inner_handle);
 }
 
 string FileSystemTimeoutRetryWrapper::GetVersionTag(FileHandle &handle) {
-	return inner_filesystem->GetVersionTag(handle);
+	auto &inner_handle = handle.Cast<TimeoutRetryFileHandle>().GetInnerHandle();
+	return inner_filesystem->GetVersionTag(inner_handle);
 }
 
 FileType FileSystemTimeoutRetryWrapper::GetFileType(FileHandle &handle) {
-	return inner_filesystem->GetFileType(handle);
+	auto &inner_handle = handle.Cast<TimeoutRetryFileHandle>().GetInnerHandle();
+	return inner_filesystem->GetFileType(inner_handle);
 }
 
 void FileSystemTimeoutRetryWrapper::FileSync(FileHandle &handle) {
-	inner_filesystem->FileSync(handle);
+	auto &timeout_retry_handle = handle.Cast<TimeoutRetryFileHandle>();
+	RunHandleWrite(timeout_retry_handle,
+	               [&]() { inner_filesystem->FileSync(timeout_retry_handle.GetInnerHandle()); });
 }
 
 void FileSystemTimeoutRetryWrapper::Truncate(FileHandle &handle, int64_t new_size) {
-	inner_filesystem->Truncate(handle, new_size);
+	auto &timeout_retry_handle = handle.Cast<TimeoutRetryFileHandle>();
+	RunHandleWrite(timeout_retry_handle,
+	               [&]() { inner_filesystem->Truncate(timeout_retry_handle.GetInnerHandle(), new_size); });
 }
 
 bool FileSystemTimeoutRetryWrapper::Trim(FileHandle &handle, idx_t offset_bytes, idx_t length_bytes) {
-	return inner_filesystem->Trim(handle, offset_bytes, length_bytes);
+	auto &inner_handle = handle.Cast<TimeoutRetryFileHandle>().GetInnerHandle();
+	return inner_filesystem->Trim(inner_handle, offset_bytes, length_bytes);
 }
 
 string FileSystemTimeoutRetryWrapper::GetHomeDirectory() {
@@ -253,15 +1948,32 @@ bool FileSystemTimeoutRetryWrapper::CanHandleFile(const string &fpath) {
 }
 
 void FileSystemTimeoutRetryWrapper::Seek(FileHandle &handle, idx_t location) {
-	inner_filesystem->Seek(handle, location);
+	auto &timeout_retry_handle = handle.Cast<TimeoutRetryFileHandle>();
+	auto read_ahead = timeout_retry_handle.GetReadAhead();
+	if (read_ahead) {
+		read_ahead->Seek(location);
+		return;
+	}
+	inner_filesystem->Seek(timeout_retry_handle.GetInnerHandle(), location);
 }
 
 void FileSystemTimeoutRetryWrapper::Reset(FileHandle &handle) {
-	inner_filesystem->Reset(handle);
+	auto &timeout_retry_handle = handle.Cast<TimeoutRetryFileHandle>();
+	auto read_ahead = timeout_retry_handle.GetReadAhead();
+	if (read_ahead) {
+		read_ahead->Seek(0);
+		return;
+	}
+	inner_filesystem->Reset(timeout_retry_handle.GetInnerHandle());
 }
 
 idx_t FileSystemTimeoutRetryWrapper::SeekPosition(FileHandle &handle) {
-	return inner_filesystem->SeekPosition(handle);
+	auto &timeout_retry_handle = handle.Cast<TimeoutRetryFileHandle>();
+	auto read_ahead = timeout_retry_handle.GetReadAhead();
+	if (read_ahead) {
+		return read_ahead->GetPosition();
+	}
+	return inner_filesystem->SeekPosition(timeout_retry_handle.GetInnerHandle());
 }
 
 bool FileSystemTimeoutRetryWrapper::IsManuallySet() {
@@ -273,7 +1985,8 @@ bool FileSystemTimeoutRetryWrapper::CanSeek() {
 }
 
 bool FileSystemTimeoutRetryWrapper::OnDiskFile(FileHandle &handle) {
-	return inner_filesystem->OnDiskFile(handle);
+	auto &inner_handle = handle.Cast<TimeoutRetryFileHandle>().GetInnerHandle();
+	return inner_filesystem->OnDiskFile(inner_handle);
 }
 
 unique_ptr<FileHandle> FileSystemTimeoutRetryWrapper::OpenCompressedFile(QueryContext context,
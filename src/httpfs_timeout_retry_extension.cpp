@@ -4,14 +4,19 @@
 #include "duckdb/common/http_util.hpp"
 #include "duckdb/common/opener_file_system.hpp"
 #include "duckdb/common/string.hpp"
+#include "duckdb/common/string_util.hpp"
 #include "duckdb/common/vector.hpp"
+#include "duckdb/main/database_file_opener.hpp"
 #include "duckdb/main/extension_helper.hpp"
 #include "duckdb/main/extension_install_info.hpp"
 #include "duckdb/main/extension_manager.hpp"
+#include "connection_warmup.hpp"
 #include "file_system_timeout_retry_wrapper.hpp"
 #include "httpfs_timeout_retry_extension.hpp"
 #include "httpfs_timeout_retry_settings.hpp"
 #include "httpfs_extension.hpp"
+#include "timeout_retry_policy.hpp"
+#include "timeout_retry_stats_function.hpp"
 
 namespace duckdb {
 
@@ -19,11 +24,12 @@ namespace {
 
 constexpr const char *HTTPFS_EXTENSION = "httpfs";
 
+// Prefix of settings registered by this extension.
+constexpr const char *EXTENSION_SETTING_PREFIX = "httpfs_";
+
 // Default values matching httpfs extension for compatibility
 constexpr uint64_t DEFAULT_TIMEOUT_MS = HTTPParams::DEFAULT_TIMEOUT_SECONDS * 1000;
 constexpr uint64_t DEFAULT_RETRIES = HTTPParams::DEFAULT_RETRIES;
-constexpr uint64_t DEFAULT_RETRY_WAIT_MS = HTTPParams::DEFAULT_RETRY_WAIT_MS;
-constexpr float DEFAULT_RETRY_BACKOFF = HTTPParams::DEFAULT_RETRY_BACKOFF;
 
 // Whether `httpfs` extension has already been loaded.
 bool IsHttpfsExtensionLoaded(DatabaseInstance &db_instance) {
@@ -72,6 +78,16 @@ void WrapHttpfsFileSystems(DatabaseInstance &instance) {
 	}
 }
 
+// Warm up endpoints set at database startup, i.e. in the config of a serverless function.
+void WarmUpConfiguredEndpoints(DatabaseInstance &instance) {
+	DatabaseFileOpener opener(instance);
+	Value endpoints;
+	if (!FileOpener::TryGetCurrentSetting(&opener, HTTPFS_WARMUP_ENDPOINTS, endpoints) || endpoints.IsNull()) {
+		return;
+	}
+	StartBackgroundWarmup(instance.shared_from_this(), ParseWarmupEndpoints(endpoints.ToString()));
+}
+
 void LoadInternal(ExtensionLoader &loader) {
 	auto &instance = loader.GetDatabaseInstance();
 	auto &config = DBConfig::GetConfig(instance);
@@ -94,6 +110,12 @@ void LoadInternal(ExtensionLoader &loader) {
 	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
 	config.AddExtensionOption(HTTPFS_TIMEOUT_CREATE_DIR_MS, "Timeout for creating directories (in milliseconds)",
 	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
+	config.AddExtensionOption(HTTPFS_TIMEOUT_READ_MS,
+	                          "Timeout for reads on file handles (in milliseconds), default to file operation timeout",
+	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
+	config.AddExtensionOption(HTTPFS_TIMEOUT_WRITE_MS,
+	                          "Timeout for writes on file handles (in milliseconds), default to file operation timeout",
+	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
 
 	// Retry settings for different HTTP operations
 	config.AddExtensionOption(HTTPFS_RETRIES_FILE_OPERATION,
@@ -107,6 +129,268 @@ void LoadInternal(ExtensionLoader &loader) {
 	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
 	config.AddExtensionOption(HTTPFS_RETRIES_CREATE_DIR, "Maximum number of retries for creating directories",
 	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
+	config.AddExtensionOption(HTTPFS_RETRIES_READ,
+	                          "Maximum number of retries for reads on file handles, default to file operation retries",
+	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
+	config.AddExtensionOption(HTTPFS_RETRIES_WRITE,
+	                          "Maximum number of retries for writes on file handles, default to file operation retries",
+	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
+
+	// Retry wait settings for different HTTP operations
+	config.AddExtensionOption(HTTPFS_RETRY_WAIT_FILE_OPERATION_MS,
+	                          "Initial retry wait for file operations (open/read/write) (in milliseconds)",
+	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
+	config.AddExtensionOption(HTTPFS_RETRY_WAIT_LIST_MS, "Initial retry wait for listing directories (in milliseconds)",
+	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
+	config.AddExtensionOption(HTTPFS_RETRY_WAIT_DELETE_MS, "Initial retry wait for deleting files (in milliseconds)",
+	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
+	config.AddExtensionOption(HTTPFS_RETRY_WAIT_STAT_MS,
+	                          "Initial retry wait for stat/metadata operations (in milliseconds)",
+	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
+	config.AddExtensionOption(HTTPFS_RETRY_WAIT_CREATE_DIR_MS,
+	                          "Initial retry wait for creating directories (in milliseconds)",
+	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
+	config.AddExtensionOption(HTTPFS_RETRY_WAIT_READ_MS,
+	                          "Initial retry wait for reads (in milliseconds), default to file operation retry wait",
+	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
+	config.AddExtensionOption(HTTPFS_RETRY_WAIT_WRITE_MS,
+	                          "Initial retry wait for writes (in milliseconds), default to file operation retry wait",
+	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
+	config.AddExtensionOption(HTTPFS_RETRY_BACKOFF_FILE_OPERATION,
+	                          "Retry wait multiplier for file operations (open/read/write)",
+	                          LogicalType {LogicalTypeId::DOUBLE}, Value());
+	config.AddExtensionOption(HTTPFS_RETRY_BACKOFF_LIST, "Retry wait multiplier for listing directories",
+	                          LogicalType {LogicalTypeId::DOUBLE}, Value());
+	config.AddExtensionOption(HTTPFS_RETRY_BACKOFF_DELETE, "Retry wait multiplier for deleting files",
+	                          LogicalType {LogicalTypeId::DOUBLE}, Value());
+	config.AddExtensionOption(HTTPFS_RETRY_BACKOFF_STAT, "Retry wait multiplier for stat/metadata operations",
+	                          LogicalType {LogicalTypeId::DOUBLE}, Value());
+	config.AddExtensionOption(HTTPFS_RETRY_BACKOFF_CREATE_DIR, "Retry wait multiplier for creating directories",
+	                          LogicalType {LogicalTypeId::DOUBLE}, Value());
+	config.AddExtensionOption(HTTPFS_RETRY_BACKOFF_READ,
+	                          "Retry wait multiplier for reads, default to file operation retry backoff",
+	                          LogicalType {LogicalTypeId::DOUBLE}, Value());
+	config.AddExtensionOption(HTTPFS_RETRY_BACKOFF_WRITE,
+	                          "Retry wait multiplier for writes, default to file operation retry backoff",
+	                          LogicalType {LogicalTypeId::DOUBLE}, Value());
+	config.AddExtensionOption(HTTPFS_RETRY_MAX_WAIT_FILE_OPERATION_MS,
+	                          "Maximum retry wait for file operations (open/read/write) (in milliseconds)",
+	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
+	config.AddExtensionOption(HTTPFS_RETRY_MAX_WAIT_LIST_MS,
+	                          "Maximum retry wait for listing directories (in milliseconds)",
+	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
+	config.AddExtensionOption(HTTPFS_RETRY_MAX_WAIT_DELETE_MS,
+	                          "Maximum retry wait for deleting files (in milliseconds)",
+	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
+	config.AddExtensionOption(HTTPFS_RETRY_MAX_WAIT_STAT_MS,
+	                          "Maximum retry wait for stat/metadata operations (in milliseconds)",
+	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
+	config.AddExtensionOption(HTTPFS_RETRY_MAX_WAIT_CREATE_DIR_MS,
+	                          "Maximum retry wait for creating directories (in milliseconds)",
+	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
+	config.AddExtensionOption(HTTPFS_RETRY_MAX_WAIT_READ_MS,
+	                          "Maximum retry wait for reads (in milliseconds), default to file operation max wait",
+	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
+	config.AddExtensionOption(HTTPFS_RETRY_MAX_WAIT_WRITE_MS,
+	                          "Maximum retry wait for writes (in milliseconds), default to file operation max wait",
+	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
+	config.AddExtensionOption(HTTPFS_RETRY_JITTER,
+	                          "Jitter of retry waits, one of 'none', 'full', 'equal' and 'decorrelated'",
+	                          LogicalType {LogicalTypeId::VARCHAR}, Value());
+
+	// Prefix policy overrides, i.e. for buckets slower or faster than the rest
+	config.AddExtensionOption(HTTPFS_PREFIX_POLICY_OVERRIDES,
+	                          "Timeout and retry settings overridden for paths under a prefix, as "
+	                          "'<prefix> <setting>=<value>, ...; ...', i.e. 's3://archive-bucket/ "
+	                          "httpfs_timeout_read_ms=60000, httpfs_retries_read=10', the longest matching prefix wins",
+	                          LogicalType {LogicalTypeId::VARCHAR}, Value());
+
+	// Retry budget settings, shared by all operations on the same endpoint
+	config.AddExtensionOption(HTTPFS_RETRY_BUDGET_RATIO,
+	                          "Enable retry budget, which caps retries to the given fraction of successful requests",
+	                          LogicalType {LogicalTypeId::DOUBLE}, Value());
+	config.AddExtensionOption(HTTPFS_RETRY_BUDGET_MIN_RETRIES_PER_SECOND,
+	                          "Number of retries per second allowed by retry budget regardless of successful requests",
+	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
+
+	// Circuit breaker settings, shared by all operations on the same endpoint
+	config.AddExtensionOption(HTTPFS_CIRCUIT_BREAKER_FAILURE_THRESHOLD,
+	                          "Enable circuit breaker, which opens after the given number of consecutive failures",
+	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
+	config.AddExtensionOption(HTTPFS_CIRCUIT_BREAKER_COOL_DOWN_MS,
+	                          "Time an open circuit breaker fails requests before probing the endpoint (in milliseconds)",
+	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
+
+	// Concurrency limit settings, shared by all operations on the same endpoint
+	config.AddExtensionOption(HTTPFS_MAX_CONCURRENT_REQUESTS,
+	                          "Enable concurrency limit, which caps in-flight requests to each endpoint to the given "
+	                          "number, and queues the others with metadata operations ahead of reads and writes",
+	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
+	config.AddExtensionOption(HTTPFS_MAX_CONCURRENT_REQUESTS_PER_OPERATION,
+	                          "Maximum number of in-flight requests of each operation type to each endpoint",
+	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
+
+	// Adaptive timeout settings
+	config.AddExtensionOption(HTTPFS_ADAPTIVE_TIMEOUT_MULTIPLIER,
+	                          "Enable adaptive timeout, which sets timeout to the given multiple of observed p99 latency",
+	                          LogicalType {LogicalTypeId::DOUBLE}, Value());
+	config.AddExtensionOption(HTTPFS_ADAPTIVE_TIMEOUT_MIN_MS, "Lower bound of adaptive timeout (in milliseconds)",
+	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
+	config.AddExtensionOption(HTTPFS_ADAPTIVE_TIMEOUT_MAX_MS,
+	                          "Upper bound of adaptive timeout (in milliseconds), default to per-operation timeout",
+	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
+
+	// Hedged read settings for positional reads
+	config.AddExtensionOption(HTTPFS_HEDGE_READ_DELAY_MS,
+	                          "Minimum delay before a hedged request is issued for a slow read (in milliseconds)",
+	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
+	config.AddExtensionOption(HTTPFS_HEDGE_READ_PERCENTILE,
+	                          "Latency percentile of recent reads after which a hedged request is issued, in (0, 1]",
+	                          LogicalType {LogicalTypeId::DOUBLE}, Value());
+
+	// Parallel read settings for large positional reads
+	config.AddExtensionOption(HTTPFS_PARALLEL_READ_THRESHOLD_BYTES,
+	                          "Enable parallel reads, which split positional reads of at least the given size (in "
+	                          "bytes) into concurrent ranged requests",
+	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
+	config.AddExtensionOption(HTTPFS_PARALLEL_READ_PARTS,
+	                          "Number of concurrent ranged requests a large read is split into, default to 4",
+	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
+
+	// Single-flight settings for concurrent identical operations
+	config.AddExtensionOption(HTTPFS_ENABLE_SINGLE_FLIGHT,
+	                          "Enable single-flight, which lets concurrent identical existence checks, opens and reads "
+	                          "of the same remote file share one request",
+	                          LogicalType {LogicalTypeId::BOOLEAN}, Value());
+
+	// Read-ahead settings for sequential reads
+	config.AddExtensionOption(HTTPFS_READ_AHEAD_MAX_BYTES,
+	                          "Enable read-ahead for sequential reads, which prefetches windows of up to the given "
+	                          "size (in bytes) in the background",
+	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
+
+	// Read coalescing settings for concurrent small positional reads
+	config.AddExtensionOption(HTTPFS_READ_COALESCE_MAX_GAP_BYTES,
+	                          "Enable read coalescing, which merges concurrent reads of the same file apart by at most "
+	                          "the given gap (in bytes) into one ranged request",
+	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
+	config.AddExtensionOption(HTTPFS_READ_COALESCE_MAX_REQUEST_BYTES,
+	                          "Maximum size of a merged read request (in bytes), default to 8 MiB",
+	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
+	config.AddExtensionOption(HTTPFS_READ_COALESCE_WINDOW_US,
+	                          "Time a read waits for other reads to merge with (in microseconds), default to 1000",
+	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
+
+	// Block cache settings for positional reads
+	config.AddExtensionOption(HTTPFS_CACHE_BLOCK_SIZE_BYTES, "Size of cached blocks of remote files (in bytes)",
+	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
+	config.AddExtensionOption(HTTPFS_DISK_CACHE_DIRECTORY,
+	                          "Enable on-disk block cache, which keeps blocks of remote files in the given directory",
+	                          LogicalType {LogicalTypeId::VARCHAR}, Value());
+	config.AddExtensionOption(HTTPFS_DISK_CACHE_MAX_SIZE_MB, "Maximum size of on-disk block cache (in MiB)",
+	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
+	config.AddExtensionOption(HTTPFS_MEMORY_CACHE_MAX_SIZE_MB,
+	                          "Enable in-memory block cache, which keeps blocks of remote files in memory of up to the "
+	                          "given size (in MiB)",
+	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
+
+	// Upload settings for multipart uploads
+	config.AddExtensionOption(HTTPFS_UPLOAD_PART_SIZE_BYTES, "Size of parts of multipart uploads (in bytes)",
+	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
+	config.AddExtensionOption(HTTPFS_UPLOAD_CONCURRENCY,
+	                          "Maximum number of parts of a file uploaded concurrently, which bounds buffered parts",
+	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
+	config.AddExtensionOption(HTTPFS_UPLOAD_PART_TIMEOUT_MS,
+	                          "Timeout of each part upload (in milliseconds), default to write timeout",
+	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
+	config.AddExtensionOption(HTTPFS_UPLOAD_PART_RETRIES, "Retries of each part upload, default to write retries",
+	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
+
+	// Delete settings for deletes of many files
+	config.AddExtensionOption(HTTPFS_DELETE_PARALLELISM,
+	                          "Enable batched deletes, which remove many files with multi-object delete requests of "
+	                          "up to 1000 keys on object storage, or single deletes elsewhere, with up to the given "
+	                          "number of concurrent requests",
+	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
+
+	// Glob settings for wildcard directories
+	config.AddExtensionOption(HTTPFS_GLOB_PARALLELISM,
+	                          "Enable partition-aware globs, which list the directories matching the first wildcard "
+	                          "directory of a pattern, and glob under them with up to the given number of threads",
+	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
+
+	// Metadata cache settings for stat-type operations
+	config.AddExtensionOption(HTTPFS_METADATA_CACHE_TTL_MS,
+	                          "Enable metadata cache, which keeps file existence, size, modification time and etag "
+	                          "for the given time (in milliseconds)",
+	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
+	config.AddExtensionOption(HTTPFS_METADATA_CACHE_MAX_ENTRIES, "Maximum number of paths kept in metadata cache",
+	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
+
+	// Listing cache settings for globs and directory listings
+	config.AddExtensionOption(HTTPFS_LIST_CACHE_TTL_MS,
+	                          "Enable listing cache, which keeps glob and directory listing results for the given time "
+	                          "(in milliseconds)",
+	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
+	config.AddExtensionOption(HTTPFS_LIST_CACHE_MAX_MEMORY_MB,
+	                          "Maximum memory held by listing cache (in MiB), least recently used listings are evicted",
+	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
+
+	// Fault injection settings for reproducing slow or failing object storage
+	config.AddExtensionOption(HTTPFS_FAULT_LATENCY_MS,
+	                          "Enable fault injection with latency added to each request, the mean (or median for "
+	                          "lognormal) of the latency distribution (in milliseconds)",
+	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
+	config.AddExtensionOption(HTTPFS_FAULT_LATENCY_DISTRIBUTION,
+	                          "Distribution of injected latency, one of 'fixed', 'uniform', 'exponential' and "
+	                          "'lognormal', default to 'fixed'",
+	                          LogicalType {LogicalTypeId::VARCHAR}, Value());
+	config.AddExtensionOption(HTTPFS_FAULT_LATENCY_SIGMA,
+	                          "Shape of lognormal injected latency, larger values give a longer tail, default to 1",
+	                          LogicalType {LogicalTypeId::DOUBLE}, Value());
+	config.AddExtensionOption(HTTPFS_FAULT_ERROR_RATE,
+	                          "Enable fault injection with the given fraction of requests failing with a transient "
+	                          "error, in [0, 1]",
+	                          LogicalType {LogicalTypeId::DOUBLE}, Value());
+	config.AddExtensionOption(HTTPFS_FAULT_STALL_RATE,
+	                          "Enable fault injection with the given fraction of reads stalling halfway through the "
+	                          "transfer, in [0, 1]",
+	                          LogicalType {LogicalTypeId::DOUBLE}, Value());
+	config.AddExtensionOption(HTTPFS_FAULT_STALL_MS, "Duration of injected stalls (in milliseconds)",
+	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
+	config.AddExtensionOption(HTTPFS_FAULT_OPERATIONS,
+	                          "Comma-separated operation types faults are injected into, i.e. 'read,list', default to "
+	                          "all",
+	                          LogicalType {LogicalTypeId::VARCHAR}, Value());
+	config.AddExtensionOption(HTTPFS_FAULT_PATH_PATTERN,
+	                          "Glob pattern of paths faults are injected into, where '*' also matches '/', default to "
+	                          "all",
+	                          LogicalType {LogicalTypeId::VARCHAR}, Value());
+	config.AddExtensionOption(HTTPFS_FAULT_SEED, "Seed of injected faults, the same seed injects the same faults",
+	                          LogicalType {LogicalTypeId::UBIGINT}, Value());
+
+	// Warm-up settings for serverless cold starts
+	config.AddExtensionOption(HTTPFS_WARMUP_ENDPOINTS,
+	                          "Comma-separated endpoints warmed up in the background, i.e. 's3://bucket,"
+	                          "https://example.com', which pays DNS resolution, TLS handshake and credential lookup "
+	                          "ahead of the first query",
+	                          LogicalType {LogicalTypeId::VARCHAR}, Value(), OnWarmupEndpointsChanged);
+
+	// Operations take timeout and retry policies from a snapshot cached per connection, which is re-resolved once any
+	// of the extension settings is set or reset.
+	for (auto &entry : config.extension_parameters) {
+		if (StringUtil::StartsWith(entry.first, EXTENSION_SETTING_PREFIX) && !entry.second.set_function) {
+			entry.second.set_function = OnPolicySettingChanged;
+		}
+	}
+
+	// Register metrics functions
+	loader.RegisterFunction(GetTimeoutRetryStatsFunction());
+	loader.RegisterFunction(GetTimeoutRetryStatsResetFunction());
+
+	// Register warm-up function, and warm up endpoints configured before the extension is loaded
+	loader.RegisterFunction(GetWarmupFunction());
+	WarmUpConfiguredEndpoints(instance);
 }
 
 } // namespace
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "duckdb/common/optional_ptr.hpp"
+#include "duckdb/common/string.hpp"
+#include "endpoint_registry.hpp"
+#include "latency_tracker.hpp"
+#include "timeout_retry_file_opener.hpp"
+
+namespace duckdb {
+
+// Adaptive timeout config, resolved from settings.
+struct AdaptiveTimeoutConfig {
+	bool enabled = false;
+	// Request timeout is [multiplier] times the observed latency percentile.
+	double multiplier = 0;
+	// Lower and upper bound of the adaptive timeout; without upper bound set, the static timeout of the operation is
+	// used as upper bound.
+	uint64_t min_timeout_ms = 0;
+	bool has_max_timeout = false;
+	uint64_t max_timeout_ms = 0;
+};
+
+// AdaptiveTimeoutEstimator keeps a sliding window of recent latencies for one (operation type, endpoint) pair, and
+// derives request timeout from the observed p99 latency.
+class AdaptiveTimeoutEstimator {
+public:
+	static constexpr idx_t WINDOW_SIZE = 256;
+	// Min number of observations before the estimation is trusted.
+	static constexpr idx_t MIN_SAMPLES = 20;
+	static constexpr double LATENCY_PERCENTILE = 0.99;
+
+	AdaptiveTimeoutEstimator();
+
+public:
+	void Record(uint64_t latency_us);
+	// Get the adaptive timeout, return false if there aren't enough observations.
+	bool TryGetTimeoutMs(const AdaptiveTimeoutConfig &config, uint64_t &timeout_ms) const;
+
+private:
+	LatencyTracker recent_latencies;
+};
+
+// AdaptiveTimeoutRegistry is the process-wide registry of adaptive timeout estimators.
+class AdaptiveTimeoutRegistry {
+public:
+	static AdaptiveTimeoutRegistry &GetInstance();
+
+public:
+	AdaptiveTimeoutEstimator &GetEstimator(HttpfsOperationType operation_type, const string &endpoint);
+
+private:
+	AdaptiveTimeoutRegistry() = default;
+
+private:
+	EndpointRegistry<AdaptiveTimeoutEstimator> registry;
+};
+
+// Get adaptive timeout config from settings, which is disabled unless the multiplier is set.
+AdaptiveTimeoutConfig GetAdaptiveTimeoutConfig(FileOpener &opener);
+
+// Get [config] with its upper bound resolved: the static timeout of the operation of [opener] unless configured, so
+// adaptive timeout only makes requests fail faster.
+AdaptiveTimeoutConfig GetAdaptiveTimeoutBounds(const AdaptiveTimeoutConfig &config, TimeoutRetryFileOpener &opener);
+
+// Get the adaptive timeout from [latencies] and [config] with resolved bounds, return false if there aren't enough
+// observations.
+bool TryGetAdaptiveTimeoutMs(const AdaptiveTimeoutConfig &config, const LatencyTracker &latencies,
+                             uint64_t &timeout_ms);
+
+// Apply adaptive timeout to the opener if enabled by [config], and there're enough observations for the endpoint.
+// Return the estimator which should observe the operation latency, or nullptr if adaptive timeout is disabled.
+optional_ptr<AdaptiveTimeoutEstimator> ApplyAdaptiveTimeout(const AdaptiveTimeoutConfig &config,
+                                                            TimeoutRetryFileOpener &opener, const string &endpoint);
+
+} // namespace duckdb
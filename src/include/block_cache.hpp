@@ -0,0 +1,56 @@
+#pragma once
+
+#include "duckdb/common/file_opener.hpp"
+#include "duckdb/common/optional_ptr.hpp"
+#include "duckdb/common/string.hpp"
+#include "disk_block_cache.hpp"
+#include "memory_block_cache.hpp"
+
+namespace duckdb {
+
+// Block cache config, resolved from settings when a file is opened.
+struct BlockCacheConfig {
+	// Size of cached blocks, in bytes; the last block of a file could be smaller.
+	idx_t block_size = 0;
+	// Memory budget of the in-memory tier, in bytes; 0 means disabled.
+	idx_t memory_max_bytes = 0;
+	// Local directory of the on-disk tier; empty means disabled.
+	string disk_directory;
+	// Max total size of the on-disk tier, in bytes.
+	idx_t disk_max_bytes = 0;
+
+	bool IsEnabled() const {
+		return memory_max_bytes > 0 || !disk_directory.empty();
+	}
+};
+
+// Block cache of a file handle, resolved when the file is opened. Reads check the memory tier first, then the disk
+// tier; blocks found on disk are promoted to memory, and fetched blocks are written to both.
+struct HandleBlockCache {
+	optional_ptr<MemoryBlockCache> memory_cache;
+	optional_ptr<DiskBlockCache> disk_cache;
+	idx_t disk_cache_max_bytes = 0;
+	idx_t block_size = 0;
+	// Identifies the file content in the cache, see [GetBlockCacheFileKey]; the memory tier takes its hashes.
+	string file_key;
+	BlockCacheFileHashes file_hashes;
+	idx_t file_size = 0;
+
+	bool IsEnabled() const {
+		return memory_cache != nullptr || disk_cache != nullptr;
+	}
+};
+
+// Get block cache config from settings.
+BlockCacheConfig GetBlockCacheConfig(FileOpener &opener);
+
+// Get the key identifying the file content in the block cache by path, version tag (i.e. etag) and block size; return
+// empty string if the content cannot be identified.
+string GetBlockCacheFileKey(const string &path, const string &version_tag, idx_t block_size);
+// Get the hashes the file key is made of, return false if the content cannot be identified.
+bool TryGetBlockCacheFileHashes(const string &path, const string &version_tag, idx_t block_size,
+                                BlockCacheFileHashes &result);
+// Get the file key made of [hashes].
+string GetBlockCacheFileKey(const BlockCacheFileHashes &hashes);
+
+} // namespace duckdb
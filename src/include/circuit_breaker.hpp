@@ -0,0 +1,80 @@
+#pragma once
+
+#include "duckdb/common/atomic.hpp"
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/string.hpp"
+#include "endpoint_registry.hpp"
+
+#include <chrono>
+
+namespace duckdb {
+
+// Circuit breaker config, resolved from settings for each operation.
+struct CircuitBreakerConfig {
+	// Whether requests go through the per-endpoint circuit breaker.
+	bool enabled = false;
+	// Number of consecutive transient failures which trip the breaker.
+	uint64_t failure_threshold = 0;
+	// Time the breaker stays open before a probe request is let through, in milliseconds.
+	uint64_t cool_down_ms = 0;
+};
+
+// CircuitBreaker tracks the health of one endpoint (host or bucket).
+// - CLOSED: requests go through; consecutive transient failures reaching the threshold trip the breaker open.
+// - OPEN: requests fail immediately, until the cool-down time has passed.
+// - HALF_OPEN: a single probe request goes through; its success closes the breaker, and its failure opens it again.
+class CircuitBreaker {
+public:
+	enum class State : uint8_t { CLOSED, OPEN, HALF_OPEN };
+
+	explicit CircuitBreaker(string endpoint_p);
+
+public:
+	// Whether a request is allowed to go out; every allowed request must report its outcome via [RecordSuccess] or
+	// [RecordFailure].
+	bool TryAcquire(const CircuitBreakerConfig &config);
+	// Record a request which reached the endpoint, including the ones which failed with non-transient errors.
+	void RecordSuccess();
+	// Record a request which failed with a transient error.
+	void RecordFailure(const CircuitBreakerConfig &config);
+
+	// Overloads with explicit clock, for testing purpose.
+	bool TryAcquire(const CircuitBreakerConfig &config, std::chrono::steady_clock::time_point now);
+	void RecordFailure(const CircuitBreakerConfig &config, std::chrono::steady_clock::time_point now);
+
+	State GetState() const {
+		return state.load(std::memory_order_relaxed);
+	}
+	const string &GetEndpoint() const {
+		return endpoint;
+	}
+
+private:
+	const string endpoint;
+	mutex breaker_mutex;
+	// Read without lock on the hot path, so a closed breaker costs no lock acquisition; only written with
+	// [breaker_mutex] held.
+	atomic<State> state {State::CLOSED};
+	atomic<uint64_t> consecutive_failures {0};
+	std::chrono::steady_clock::time_point opened_at;
+	// Whether the probe request in half-open state is still in flight.
+	bool probe_in_flight = false;
+};
+
+// CircuitBreakerRegistry is the process-wide registry of circuit breakers.
+class CircuitBreakerRegistry {
+public:
+	static CircuitBreakerRegistry &GetInstance();
+
+public:
+	// Get the circuit breaker shared by all operations to the endpoint.
+	CircuitBreaker &GetCircuitBreaker(const string &endpoint);
+
+private:
+	CircuitBreakerRegistry() = default;
+
+private:
+	EndpointRegistry<CircuitBreaker> registry;
+};
+
+} // namespace duckdb
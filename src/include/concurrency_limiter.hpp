@@ -0,0 +1,91 @@
+#pragma once
+
+#include "duckdb/common/array.hpp"
+#include "duckdb/common/list.hpp"
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/string.hpp"
+#include "endpoint_registry.hpp"
+#include "timeout_retry_file_opener.hpp"
+
+#include <condition_variable>
+
+namespace duckdb {
+
+// Concurrency limit config, resolved from settings for each operation.
+struct ConcurrencyLimitConfig {
+	// Whether requests wait for a slot of the per-endpoint concurrency limiter.
+	bool enabled = false;
+	// Max number of in-flight requests to the endpoint.
+	uint64_t max_requests = 0;
+	// Max number of in-flight requests of each operation type to the endpoint; 0 means only [max_requests] applies.
+	uint64_t max_requests_per_operation = 0;
+};
+
+// ConcurrencyLimiter bounds in-flight requests to one endpoint (host or bucket), in total and per operation type.
+// Requests which cannot go out wait in a queue, where metadata operations (open, stat, list, etc) go ahead of bulk
+// reads and writes, so query planning doesn't stall behind scans; requests of the same priority are served in arrival
+// order. A waiting request only skips ahead of earlier ones when those are held back by their per-operation limit.
+class ConcurrencyLimiter {
+public:
+	ConcurrencyLimiter() = default;
+
+public:
+	// Block until a request of [operation_type] is allowed to go out, return the time waited in microseconds; every
+	// acquired slot must be returned via [Release].
+	uint64_t Acquire(HttpfsOperationType operation_type, const ConcurrencyLimitConfig &config);
+	// Take a slot if one is free, without blocking. Free slots are handed to waiting requests as soon as they fit, so
+	// this never jumps the queue.
+	bool TryAcquire(HttpfsOperationType operation_type, const ConcurrencyLimitConfig &config);
+	void Release(HttpfsOperationType operation_type);
+
+	idx_t GetInFlightCount() const;
+	idx_t GetWaitingCount() const;
+
+	// Whether requests of [operation_type] go ahead of bulk reads and writes.
+	static bool IsHighPriority(HttpfsOperationType operation_type);
+
+private:
+	// A waiting request, which lives on the stack of [Acquire]; each one has its own condition variable, so a released
+	// slot only wakes the request it's handed to.
+	struct Waiter {
+		HttpfsOperationType operation_type;
+		const ConcurrencyLimitConfig *config;
+		std::condition_variable slot_cv;
+		// Whether a slot has been taken on behalf of the request.
+		bool granted = false;
+	};
+
+	// Whether a request of [operation_type] fits in the limits, requires [limiter_mutex] held.
+	bool HasFreeSlot(HttpfsOperationType operation_type, const ConcurrencyLimitConfig &config) const;
+	// Queue a waiting request after those of the same or higher priority, requires [limiter_mutex] held.
+	void Enqueue(Waiter &waiter);
+	// Hand free slots to waiting requests in queue order, skipping those held back by their per-operation limit;
+	// requires [limiter_mutex] held. Waiting requests never fit in the limits once it returns.
+	void GrantSlots();
+	void TakeSlot(HttpfsOperationType operation_type);
+
+private:
+	mutable mutex limiter_mutex;
+	idx_t in_flight_count = 0;
+	array<idx_t, HTTPFS_OPERATION_TYPE_COUNT> in_flight_per_operation {};
+	// Waiting requests, high-priority ones first, each priority in arrival order.
+	list<Waiter *> waiters;
+};
+
+// ConcurrencyLimiterRegistry is the process-wide registry of concurrency limiters.
+class ConcurrencyLimiterRegistry {
+public:
+	static ConcurrencyLimiterRegistry &GetInstance();
+
+public:
+	// Get the concurrency limiter shared by all operations to the endpoint.
+	ConcurrencyLimiter &GetConcurrencyLimiter(const string &endpoint);
+
+private:
+	ConcurrencyLimiterRegistry() = default;
+
+private:
+	EndpointRegistry<ConcurrencyLimiter> registry;
+};
+
+} // namespace duckdb
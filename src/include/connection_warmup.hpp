@@ -0,0 +1,56 @@
+#pragma once
+
+#include "duckdb/common/file_opener.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/optional_ptr.hpp"
+#include "duckdb/common/shared_ptr.hpp"
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/vector.hpp"
+#include "duckdb/function/table_function.hpp"
+
+namespace duckdb {
+
+class DatabaseInstance;
+
+// Result of warming up one endpoint.
+struct WarmupResult {
+	// Endpoint warmed up, i.e. "s3://bucket" or "https://example.com".
+	string endpoint;
+	// Whether the endpoint answered, an HTTP error response (i.e. 403 or 404) still counts as connected.
+	bool connected = false;
+	uint64_t latency_us = 0;
+	// Error message if the endpoint could not be reached.
+	string error;
+};
+
+// Parse a comma-separated list of endpoints or paths into distinct endpoints; throw if any entry has no scheme.
+vector<string> ParseWarmupEndpoints(const string &endpoints);
+
+// WarmupRequestScope marks requests sent by the current thread as warm-up requests while it lives. The wrapper sends
+// them once with the static timeout, and keeps them out of the circuit breaker, retry budget, adaptive timeout and
+// metrics of the endpoint, which only reflect requests of queries.
+class WarmupRequestScope {
+public:
+	WarmupRequestScope();
+	~WarmupRequestScope();
+
+	// Whether requests sent by the current thread are warm-up requests.
+	static bool IsActive();
+};
+
+// Warm up [endpoints] through [fs], by sending one lightweight request to the root of each endpoint concurrently. The
+// request pays the one-time costs of the first request to an endpoint ahead of queries: DNS resolution, TLS setup and
+// handshake, and credential lookup. Errors are reported in the results.
+vector<WarmupResult> WarmUpEndpoints(FileSystem &fs, const vector<string> &endpoints, optional_ptr<FileOpener> opener);
+
+// Warm up [endpoints] in a detached thread with database-wide settings and secrets, so loading the extension or setting
+// the endpoints doesn't wait for the network. The thread doesn't keep the database alive once it's closed.
+void StartBackgroundWarmup(weak_ptr<DatabaseInstance> db_instance, vector<string> endpoints);
+
+// Setting callback which starts a background warm-up of the endpoints set.
+void OnWarmupEndpointsChanged(ClientContext &context, SetScope scope, Value &parameter);
+
+// Table function which warms up the given endpoints and returns the result of each.
+TableFunction GetWarmupFunction();
+
+} // namespace duckdb
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "duckdb/common/atomic.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/list.hpp"
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/unique_ptr.hpp"
+#include "duckdb/common/unordered_map.hpp"
+#include "endpoint_registry.hpp"
+
+namespace duckdb {
+
+// DiskBlockCache persists fixed-size blocks of remote files in a local directory, one file per block. Blocks are keyed
+// by a file key (see [GetBlockCacheFileKey]) plus the block index; since the file key identifies the file content,
+// blocks of a modified file are simply never hit again, and age out of the cache. Least recently used blocks are
+// removed once the total size exceeds the cap.
+//
+// Cache failures (i.e. disk full, corrupted blocks) are treated as misses, and never fail the read.
+class DiskBlockCache {
+public:
+	explicit DiskBlockCache(string directory_p);
+
+public:
+	// Read the cached block into [buffer], which must be exactly [nr_bytes] long; return false on miss.
+	bool TryRead(const string &file_key, idx_t block_index, data_ptr_t buffer, idx_t nr_bytes);
+	// Whether the block is cached, without reading it.
+	bool Contains(const string &file_key, idx_t block_index) const;
+	// Cache the block, and evict least recently used blocks beyond [max_bytes].
+	void Write(const string &file_key, idx_t block_index, const_data_ptr_t buffer, idx_t nr_bytes, idx_t max_bytes);
+
+	idx_t GetBlockCount() const;
+	idx_t GetSizeBytes() const;
+
+private:
+	struct BlockEntry {
+		string block_name;
+		idx_t nr_bytes;
+	};
+
+	string GetBlockPath(const string &block_name) const;
+	// Index blocks left in the directory by earlier processes, and remove incomplete writes.
+	void LoadExistingBlocks();
+	// Remove the block from the index, caller must hold [cache_mutex].
+	void EraseEntry(const string &block_name);
+
+private:
+	const string directory;
+	unique_ptr<FileSystem> local_filesystem;
+	// Used to name temporary files of in-progress writes.
+	atomic<idx_t> write_counter {0};
+
+	mutable mutex cache_mutex;
+	// Blocks ordered from most to least recently used.
+	list<BlockEntry> lru_list;
+	unordered_map<string, list<BlockEntry>::iterator> entries;
+	idx_t size_bytes = 0;
+};
+
+// DiskBlockCacheRegistry is the process-wide registry of disk block caches, one per cache directory, so all
+// filesystems and databases in the process share the index and the size cap of the same directory.
+class DiskBlockCacheRegistry {
+public:
+	static DiskBlockCacheRegistry &GetInstance();
+
+public:
+	DiskBlockCache &GetDiskBlockCache(const string &directory);
+
+private:
+	DiskBlockCacheRegistry() = default;
+
+private:
+	EndpointRegistry<DiskBlockCache> registry;
+};
+
+} // namespace duckdb
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "duckdb/common/array.hpp"
+#include "duckdb/common/helper.hpp"
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/unique_ptr.hpp"
+#include "duckdb/common/unordered_map.hpp"
+#include "timeout_retry_file_opener.hpp"
+
+#include <functional>
+#include <utility>
+
+namespace duckdb {
+
+// Get registry key for per-operation, per-endpoint state.
+inline string GetOperationEndpointKey(HttpfsOperationType operation_type, const string &endpoint) {
+	return HttpfsOperationTypeToString(operation_type) + " " + endpoint;
+}
+
+// EndpointRegistry holds long-lived state keyed by endpoint (or operation plus endpoint); entries are never removed,
+// so references returned stay valid for the lifetime of the registry. Lookups are sharded to reduce lock contention.
+template <class T>
+class EndpointRegistry {
+public:
+	// Get the entry for the key, or create one with [args] if it doesn't exist.
+	template <class... ARGS>
+	T &GetOrCreate(const string &key, ARGS &&...args) {
+		auto &shard = GetShard(key);
+		lock_guard<mutex> lck(shard.shard_mutex);
+		auto &entry = shard.entries[key];
+		if (entry == nullptr) {
+			entry = make_uniq<T>(std::forward<ARGS>(args)...);
+		}
+		return *entry;
+	}
+
+	// Invoke [func] on every entry.
+	template <class FUNC>
+	void ForEach(FUNC &&func) const {
+		for (const auto &shard : shards) {
+			lock_guard<mutex> lck(shard.shard_mutex);
+			for (const auto &entry : shard.entries) {
+				func(*entry.second);
+			}
+		}
+	}
+
+private:
+	static constexpr idx_t SHARD_COUNT = 16;
+
+	struct Shard {
+		mutable mutex shard_mutex;
+		unordered_map<string, unique_ptr<T>> entries;
+	};
+
+	Shard &GetShard(const string &key) {
+		return shards[std::hash<string>()(key) % SHARD_COUNT];
+	}
+
+private:
+	array<Shard, SHARD_COUNT> shards;
+};
+
+} // namespace duckdb
@@ -0,0 +1,11 @@
+#pragma once
+
+#include "duckdb/common/string.hpp"
+
+namespace duckdb {
+
+// Get the endpoint a remote path belongs to, which is the scheme plus the authority, i.e. "https://example.com:8080"
+// for http(s) URLs and "s3://bucket" for object storage paths. Return empty string if the path is not a URL.
+string GetEndpoint(const string &path);
+
+} // namespace duckdb
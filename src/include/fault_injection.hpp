@@ -0,0 +1,83 @@
+#pragma once
+
+#include "duckdb/common/array.hpp"
+#include "duckdb/common/file_opener.hpp"
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/unordered_map.hpp"
+#include "timeout_retry_file_opener.hpp"
+
+namespace duckdb {
+
+// Distribution of injected latency.
+// - FIXED: always the configured latency.
+// - UNIFORM: uniform in [0, 2 * latency].
+// - EXPONENTIAL: exponential with mean of the configured latency.
+// - LOGNORMAL: log-normal with median of the configured latency and shape [sigma], which has the long tail of object
+//   storage.
+enum class FaultLatencyDistribution : uint8_t { FIXED, UNIFORM, EXPONENTIAL, LOGNORMAL };
+
+// Fault injection config, resolved from settings along with timeout and retry policies.
+struct FaultInjectionConfig {
+	// Whether any fault is injected, i.e. any of latency, error rate and stall rate is set.
+	bool enabled = false;
+	// Operation types faults are injected into, indexed by operation type. Writes are buffered and uploaded by the
+	// inner filesystem, so faults are never injected into them.
+	array<bool, HTTPFS_OPERATION_TYPE_COUNT> operations {};
+	// Glob pattern of paths faults are injected into, where '*' also matches '/'; empty means all paths.
+	string path_pattern;
+	FaultLatencyDistribution latency_distribution = FaultLatencyDistribution::FIXED;
+	uint64_t latency_ms = 0;
+	double latency_sigma = 1;
+	// Fraction of requests failing with a transient error.
+	double error_rate = 0;
+	// Fraction of reads which stall for [stall_ms] halfway through the transfer.
+	double stall_rate = 0;
+	uint64_t stall_ms = 0;
+	uint64_t seed = 0;
+
+	// Whether faults are injected into requests of [operation_type] on [path].
+	bool AppliesTo(HttpfsOperationType operation_type, const string &path) const;
+};
+
+// Get fault injection config from settings.
+FaultInjectionConfig GetFaultInjectionConfig(FileOpener &opener);
+
+// Faults drawn for one request.
+struct InjectedFault {
+	// Latency added before the request is sent, in milliseconds.
+	uint64_t latency_ms = 0;
+	// Whether the request fails with a transient error once the latency has passed.
+	bool error = false;
+	// Stall halfway through the transfer, in milliseconds; only drawn for reads.
+	uint64_t stall_ms = 0;
+};
+
+// FaultInjector draws faults of requests from the seed, the operation type, the path, and the number of requests of the
+// operation on the path so far. The n-th request of an operation on a path thus gets the same faults for the same seed,
+// regardless of how requests of other paths and threads interleave.
+class FaultInjector {
+public:
+	// Draw the faults of the next request of [operation_type] on [path].
+	InjectedFault Draw(const FaultInjectionConfig &config, HttpfsOperationType operation_type, const string &path);
+	// Draw the faults of the request with the given sequence number, for testing purpose.
+	static InjectedFault Draw(const FaultInjectionConfig &config, HttpfsOperationType operation_type,
+	                          const string &path, uint64_t sequence);
+
+	// Draw and apply the latency and error of the next request, if faults are injected into it; return the stall to
+	// apply halfway through the transfer, in milliseconds. Faults reaching the request timeout [timeout_ms] (0 if
+	// unknown) fail the request with a timeout, like the HTTP client would.
+	uint64_t Inject(const FaultInjectionConfig &config, HttpfsOperationType operation_type, const string &path,
+	                uint64_t timeout_ms);
+	// Apply the stall drawn by [Inject] between the two halves of a transfer.
+	static void Stall(HttpfsOperationType operation_type, const string &path, uint64_t stall_ms, uint64_t timeout_ms);
+
+private:
+	mutex sequence_mutex;
+	// Seed the sequences are counted for; a new seed restarts all of them.
+	uint64_t sequence_seed = 0;
+	// Number of requests drawn so far, keyed by operation type and path.
+	unordered_map<string, uint64_t> sequences;
+};
+
+} // namespace duckdb
@@ -1,9 +1,22 @@
 #pragma once
 
 #include "duckdb/common/file_system.hpp"
+#include "duckdb/common/mutex.hpp"
 #include "duckdb/common/string.hpp"
 #include "duckdb/common/vector.hpp"
 #include "duckdb/main/database.hpp"
+#include "duckdb/main/database_file_opener.hpp"
+#include "fault_injection.hpp"
+#include "listing_cache.hpp"
+#include "memory_block_cache.hpp"
+#include "metadata_cache.hpp"
+#include "single_flight.hpp"
+#include "timeout_retry_file_handle.hpp"
+#include "timeout_retry_file_opener.hpp"
+#include "timeout_retry_policy.hpp"
+
+#include <condition_variable>
+#include <utility>
 
 namespace duckdb {
 
@@ -12,6 +25,7 @@ namespace duckdb {
 class FileSystemTimeoutRetryWrapper : public FileSystem {
 public:
 	FileSystemTimeoutRetryWrapper(unique_ptr<FileSystem> inner_filesystem, DatabaseInstance &db);
+	~FileSystemTimeoutRetryWrapper() override;
 
 	string GetName() const override;
 
@@ -66,6 +80,7 @@ public:
 	bool IsPipe(const string &filename, optional_ptr<FileOpener> opener = nullptr) override;
 	void RemoveFile(const string &filename, optional_ptr<FileOpener> opener = nullptr) override;
 	bool TryRemoveFile(const string &filename, optional_ptr<FileOpener> opener = nullptr) override;
+	void RemoveFiles(const vector<string> &filenames, optional_ptr<FileOpener> opener = nullptr) override;
 	void FileSync(FileHandle &handle) override;
 	void Truncate(FileHandle &handle, int64_t new_size) override;
 	bool Trim(FileHandle &handle, idx_t offset_bytes, idx_t length_bytes) override;
@@ -103,9 +118,141 @@ public:
 	void SetDisabledFileSystems(const vector<string> &names) override;
 	bool SubSystemIsDisabled(const string &name) override;
 
+private:
+	// Key of a single-flight positional read: the file content, by hashes of path and version tag, and the range; so
+	// reads don't format or hash strings.
+	struct ReadFlightKey {
+		BlockCacheFileHashes content_hashes;
+		idx_t location;
+		idx_t nr_bytes;
+
+		bool operator==(const ReadFlightKey &other) const {
+			return content_hashes.first == other.content_hashes.first &&
+			       content_hashes.second == other.content_hashes.second && location == other.location &&
+			       nr_bytes == other.nr_bytes;
+		}
+	};
+	struct ReadFlightKeyHash {
+		size_t operator()(const ReadFlightKey &key) const;
+	};
+
+	// Run a path-based operation on the inner filesystem with the per-operation opener, and record its metrics.
+	// Transient failures are retried by the wrapper within the endpoint retry budget and circuit breaker, instead of by
+	// the inner filesystem; unless [retry_in_wrapper] is false, in which case the inner filesystem keeps retrying.
+	template <class FUNC>
+	auto RunOperation(HttpfsOperationType operation_type, const string &path, optional_ptr<FileOpener> opener,
+	                  FUNC &&func, bool retry_in_wrapper = true)
+	    -> decltype(func(std::declval<TimeoutRetryFileOpener &>()));
+	// Run the existence check [check] of [path] like RunOperation. HTTP clients only take the timeout in whole
+	// seconds, so when it isn't one, the check runs in the background and is abandoned at the exact deadline; [check]
+	// gets the opener to pass to the inner filesystem, and must own everything else it uses.
+	bool RunStatOperation(const string &path, optional_ptr<FileOpener> opener, std::function<bool(FileOpener &)> check);
+
+	// Get timeout and retry policies of all operation types, cached per connection, or for the database if there's no
+	// opener.
+	shared_ptr<const TimeoutRetryPolicySnapshot> ResolvePolicies(FileOpener &opener);
+	// Get metadata cache config from the policies of the opener, or of the database if there's no opener.
+	MetadataCacheConfig ResolveMetadataCacheConfig(optional_ptr<FileOpener> opener);
+	// Get listing cache config from the policies of the opener, or of the database if there's no opener.
+	ListingCacheConfig ResolveListingCacheConfig(optional_ptr<FileOpener> opener);
+	// Whether single-flight is enabled by the policies of the opener, or of the database if there's no opener.
+	bool ResolveSingleFlight(optional_ptr<FileOpener> opener);
+	// Get block cache config from [policies] of the open, with the memory tier configured from database settings only.
+	BlockCacheConfig ResolveBlockCacheConfig(const TimeoutRetryPolicySnapshot &policies);
+	// Get max number of concurrent requests of batched deletes, 0 means batched deletes are disabled; taken from the
+	// policies of the opener, or of the database if there's no opener.
+	idx_t ResolveDeleteParallelism(optional_ptr<FileOpener> opener);
+	// Remove files with multi-object delete requests on object storage and single deletes elsewhere, issued
+	// concurrently; keys of a failed multi-object delete are removed one by one, and failures are reported per file
+	// once all requests complete.
+	void RemoveFilesInBatches(const vector<string> &filenames, idx_t parallelism, optional_ptr<FileOpener> opener);
+	// Get max number of concurrent partition listings of a glob, 0 means partition-aware globs are disabled; taken from
+	// the policies of the opener, or of the database if there's no opener.
+	idx_t ResolveGlobParallelism(optional_ptr<FileOpener> opener);
+	// Glob on the inner filesystem, without listing cache.
+	vector<OpenFileInfo> GlobInternal(const string &path, optional_ptr<FileOpener> opener);
+	// Expand the first wildcard directory of [path] by listing, and glob under each matching partition concurrently;
+	// return false if the pattern cannot be expanded (i.e. on Azure), so it should be globbed as a whole.
+	bool TryGlobPartitioned(const string &path, idx_t parallelism, optional_ptr<FileOpener> opener,
+	                        vector<OpenFileInfo> &result);
+	// Open the file on the inner filesystem, without single-flight and metadata cache.
+	unique_ptr<FileHandle> OpenFileInternal(const OpenFileInfo &info, FileOpenFlags flags,
+	                                        optional_ptr<FileOpener> opener);
+	// Drop cached metadata and listings affected by a change to [path], or to anything under it if [recursive].
+	void InvalidateCachedPath(const string &path, bool recursive = false);
+
+	// Wrap the file handle returned by inner filesystem, so handle-level operations go through the wrapper.
+	// [client_timeout_ms] is the timeout of HTTP clients created for the handle, 0 if unknown.
+	unique_ptr<FileHandle> WrapFileHandle(unique_ptr<FileHandle> inner_handle, FileOpenFlags flags,
+	                                      TimeoutRetryFileOpener &opener, uint64_t client_timeout_ms);
+
+	struct BackgroundReadOptions {
+		// Whether to issue an identical request if the first one hasn't finished after [hedge_delay_us].
+		bool hedge = false;
+		uint64_t hedge_delay_us = 0;
+		// Deadline of the read in milliseconds, 0 means no deadline.
+		uint64_t deadline_ms = 0;
+	};
+
+	// Positional read through the block cache if enabled; without metrics recording.
+	void ReadRange(TimeoutRetryFileHandle &handle, void *buffer, int64_t nr_bytes, idx_t location);
+	// Positional read from the remote file, shared with identical concurrent reads if single-flight is enabled.
+	void FetchRange(TimeoutRetryFileHandle &handle, void *buffer, int64_t nr_bytes, idx_t location);
+	// Positional read from the remote file, split into parallel requests if large enough.
+	void FetchRangeInternal(TimeoutRetryFileHandle &handle, void *buffer, int64_t nr_bytes, idx_t location);
+	// Serve the read from cached blocks, and fetch and cache the missing ones.
+	void ReadThroughBlockCache(TimeoutRetryFileHandle &handle, data_ptr_t buffer, idx_t nr_bytes, idx_t location);
+	// Positional read with retries, without metrics recording. Retries read in chunks, so a retry which fails again
+	// resumes from its last completed chunk; data received by a failed first attempt is not kept.
+	void ReadWithRetries(TimeoutRetryFileHandle &handle, void *buffer, int64_t nr_bytes, idx_t location);
+	// Split the positional read into concurrent ranged reads, each writing into its own slice of [buffer] and retrying
+	// independently.
+	void ReadInParallel(TimeoutRetryFileHandle &handle, void *buffer, int64_t nr_bytes, idx_t location);
+	// Positional read without retries and metrics recording. Each request holds a slot of the concurrency limiter until
+	// it finishes, including background requests which outlive the read.
+	void ReadAtLocation(TimeoutRetryFileHandle &handle, void *buffer, int64_t nr_bytes, idx_t location);
+	// Positional read on the inner handle, with faults of [config] injected if enabled.
+	void ReadFromInner(FileHandle &inner_handle, const TimeoutRetryHandleConfig &config, void *buffer, int64_t nr_bytes,
+	                   idx_t location);
+	// Issue the read in the background, so the foreground could return once the first request succeeds (hedging), or
+	// once the deadline passes.
+	void ReadInBackground(TimeoutRetryFileHandle &handle, void *buffer, int64_t nr_bytes, idx_t location,
+	                      const BackgroundReadOptions &options);
+	// Get the delay after which a hedged read of [nr_bytes] is issued, return false if there's not enough information
+	// to decide.
+	bool TryGetHedgeDelay(TimeoutRetryFileHandle &handle, idx_t nr_bytes, uint64_t &delay_us) const;
+	// Take what a hedged read is counted against: a slot of the concurrency limiter and a token of the retry budget,
+	// if enabled. Return false, holding neither, if either is used up, in which case the read isn't hedged.
+	bool TryAcquireHedge(TimeoutRetryFileHandle &handle) const;
+
 private:
 	unique_ptr<FileSystem> inner_filesystem;
 	DatabaseInstance &db;
+	// Opener of database settings, used by operations called without an opener.
+	DatabaseFileOpener database_opener;
+	// Policies resolved from database settings.
+	TimeoutRetryPolicyCache database_policy_cache;
+	// Metadata of recently accessed paths, used when the metadata cache is enabled.
+	MetadataCache metadata_cache;
+	// Glob and directory listing results, used when the listing cache is enabled.
+	ListingCache listing_cache;
+	// In-flight existence checks, opens and positional reads, shared when single-flight is enabled.
+	SingleFlight<bool> exists_flight;
+	SingleFlight<CachedFileMetadata> open_flight;
+	SingleFlight<const_data_ptr_t, ReadFlightKey, ReadFlightKeyHash> read_flight;
+	// Draws faults of requests, when fault injection is enabled.
+	FaultInjector fault_injector;
+	// In-memory tier of the block cache, configured from database settings, so databases don't drop each other's
+	// blocks.
+	MemoryBlockCache memory_block_cache;
+	// Background requests still in flight, which outlive their handle but read through the inner filesystem, so the
+	// wrapper waits for them before it's destroyed.
+	mutex background_request_mutex;
+	std::condition_variable background_request_cv;
+	idx_t background_request_count = 0;
+
+	void RegisterBackgroundRequest();
+	void UnregisterBackgroundRequest();
 };
 
 } // namespace duckdb
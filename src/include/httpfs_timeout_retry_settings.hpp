@@ -8,6 +8,8 @@ inline constexpr const char *HTTPFS_TIMEOUT_LIST_MS = "httpfs_timeout_list_ms";
 inline constexpr const char *HTTPFS_TIMEOUT_DELETE_MS = "httpfs_timeout_delete_ms";
 inline constexpr const char *HTTPFS_TIMEOUT_STAT_MS = "httpfs_timeout_stat_ms";
 inline constexpr const char *HTTPFS_TIMEOUT_CREATE_DIR_MS = "httpfs_timeout_create_dir_ms";
+inline constexpr const char *HTTPFS_TIMEOUT_READ_MS = "httpfs_timeout_read_ms";
+inline constexpr const char *HTTPFS_TIMEOUT_WRITE_MS = "httpfs_timeout_write_ms";
 
 // Retry setting names
 inline constexpr const char *HTTPFS_RETRIES_FILE_OPERATION = "httpfs_retries_file_operation";
@@ -15,5 +17,117 @@ inline constexpr const char *HTTPFS_RETRIES_LIST = "httpfs_retries_list";
 inline constexpr const char *HTTPFS_RETRIES_DELETE = "httpfs_retries_delete";
 inline constexpr const char *HTTPFS_RETRIES_STAT = "httpfs_retries_stat";
 inline constexpr const char *HTTPFS_RETRIES_CREATE_DIR = "httpfs_retries_create_dir";
+inline constexpr const char *HTTPFS_RETRIES_READ = "httpfs_retries_read";
+inline constexpr const char *HTTPFS_RETRIES_WRITE = "httpfs_retries_write";
+
+// Retry wait setting names (in milliseconds), the wait before the first retry
+inline constexpr const char *HTTPFS_RETRY_WAIT_FILE_OPERATION_MS = "httpfs_retry_wait_file_operation_ms";
+inline constexpr const char *HTTPFS_RETRY_WAIT_LIST_MS = "httpfs_retry_wait_list_ms";
+inline constexpr const char *HTTPFS_RETRY_WAIT_DELETE_MS = "httpfs_retry_wait_delete_ms";
+inline constexpr const char *HTTPFS_RETRY_WAIT_STAT_MS = "httpfs_retry_wait_stat_ms";
+inline constexpr const char *HTTPFS_RETRY_WAIT_CREATE_DIR_MS = "httpfs_retry_wait_create_dir_ms";
+inline constexpr const char *HTTPFS_RETRY_WAIT_READ_MS = "httpfs_retry_wait_read_ms";
+inline constexpr const char *HTTPFS_RETRY_WAIT_WRITE_MS = "httpfs_retry_wait_write_ms";
+
+// Retry backoff setting names, the multiplier to the wait for each following retry
+inline constexpr const char *HTTPFS_RETRY_BACKOFF_FILE_OPERATION = "httpfs_retry_backoff_file_operation";
+inline constexpr const char *HTTPFS_RETRY_BACKOFF_LIST = "httpfs_retry_backoff_list";
+inline constexpr const char *HTTPFS_RETRY_BACKOFF_DELETE = "httpfs_retry_backoff_delete";
+inline constexpr const char *HTTPFS_RETRY_BACKOFF_STAT = "httpfs_retry_backoff_stat";
+inline constexpr const char *HTTPFS_RETRY_BACKOFF_CREATE_DIR = "httpfs_retry_backoff_create_dir";
+inline constexpr const char *HTTPFS_RETRY_BACKOFF_READ = "httpfs_retry_backoff_read";
+inline constexpr const char *HTTPFS_RETRY_BACKOFF_WRITE = "httpfs_retry_backoff_write";
+
+// Max retry wait setting names (in milliseconds), which cap the wait after backoff
+inline constexpr const char *HTTPFS_RETRY_MAX_WAIT_FILE_OPERATION_MS = "httpfs_retry_max_wait_file_operation_ms";
+inline constexpr const char *HTTPFS_RETRY_MAX_WAIT_LIST_MS = "httpfs_retry_max_wait_list_ms";
+inline constexpr const char *HTTPFS_RETRY_MAX_WAIT_DELETE_MS = "httpfs_retry_max_wait_delete_ms";
+inline constexpr const char *HTTPFS_RETRY_MAX_WAIT_STAT_MS = "httpfs_retry_max_wait_stat_ms";
+inline constexpr const char *HTTPFS_RETRY_MAX_WAIT_CREATE_DIR_MS = "httpfs_retry_max_wait_create_dir_ms";
+inline constexpr const char *HTTPFS_RETRY_MAX_WAIT_READ_MS = "httpfs_retry_max_wait_read_ms";
+inline constexpr const char *HTTPFS_RETRY_MAX_WAIT_WRITE_MS = "httpfs_retry_max_wait_write_ms";
+
+// Retry jitter setting names, the jitter applies to retry waits of all operations
+inline constexpr const char *HTTPFS_RETRY_JITTER = "httpfs_retry_jitter";
+
+// Prefix policy override setting name, which overrides the timeout and retry settings above for paths under a prefix
+inline constexpr const char *HTTPFS_PREFIX_POLICY_OVERRIDES = "httpfs_prefix_policy_overrides";
+
+// Retry budget setting names, the budget is shared by all operations on the same endpoint
+inline constexpr const char *HTTPFS_RETRY_BUDGET_RATIO = "httpfs_retry_budget_ratio";
+inline constexpr const char *HTTPFS_RETRY_BUDGET_MIN_RETRIES_PER_SECOND = "httpfs_retry_budget_min_retries_per_second";
+
+// Circuit breaker setting names, the breaker is shared by all operations on the same endpoint
+inline constexpr const char *HTTPFS_CIRCUIT_BREAKER_FAILURE_THRESHOLD = "httpfs_circuit_breaker_failure_threshold";
+inline constexpr const char *HTTPFS_CIRCUIT_BREAKER_COOL_DOWN_MS = "httpfs_circuit_breaker_cool_down_ms";
+
+// Concurrency limit setting names, the limits are shared by all operations on the same endpoint
+inline constexpr const char *HTTPFS_MAX_CONCURRENT_REQUESTS = "httpfs_max_concurrent_requests";
+inline constexpr const char *HTTPFS_MAX_CONCURRENT_REQUESTS_PER_OPERATION =
+    "httpfs_max_concurrent_requests_per_operation";
+
+// Adaptive timeout setting names, which apply to all operations except handle-level reads and writes
+inline constexpr const char *HTTPFS_ADAPTIVE_TIMEOUT_MULTIPLIER = "httpfs_adaptive_timeout_multiplier";
+inline constexpr const char *HTTPFS_ADAPTIVE_TIMEOUT_MIN_MS = "httpfs_adaptive_timeout_min_ms";
+inline constexpr const char *HTTPFS_ADAPTIVE_TIMEOUT_MAX_MS = "httpfs_adaptive_timeout_max_ms";
+
+// Hedged read setting names, which apply to positional reads issued by file operations
+inline constexpr const char *HTTPFS_HEDGE_READ_DELAY_MS = "httpfs_hedge_read_delay_ms";
+inline constexpr const char *HTTPFS_HEDGE_READ_PERCENTILE = "httpfs_hedge_read_percentile";
+
+// Parallel read setting names, which apply to large positional reads
+inline constexpr const char *HTTPFS_PARALLEL_READ_THRESHOLD_BYTES = "httpfs_parallel_read_threshold_bytes";
+inline constexpr const char *HTTPFS_PARALLEL_READ_PARTS = "httpfs_parallel_read_parts";
+
+// Single-flight setting names, which apply to existence checks, opens and positional reads
+inline constexpr const char *HTTPFS_ENABLE_SINGLE_FLIGHT = "httpfs_enable_single_flight";
+
+// Read-ahead setting names, which apply to sequential reads
+inline constexpr const char *HTTPFS_READ_AHEAD_MAX_BYTES = "httpfs_read_ahead_max_bytes";
+
+// Read coalescing setting names, which apply to concurrent small positional reads of the same file handle
+inline constexpr const char *HTTPFS_READ_COALESCE_MAX_GAP_BYTES = "httpfs_read_coalesce_max_gap_bytes";
+inline constexpr const char *HTTPFS_READ_COALESCE_MAX_REQUEST_BYTES = "httpfs_read_coalesce_max_request_bytes";
+inline constexpr const char *HTTPFS_READ_COALESCE_WINDOW_US = "httpfs_read_coalesce_window_us";
+
+// Block cache setting names, the cache applies to positional reads of files with a version tag (i.e. etag)
+inline constexpr const char *HTTPFS_CACHE_BLOCK_SIZE_BYTES = "httpfs_cache_block_size_bytes";
+inline constexpr const char *HTTPFS_DISK_CACHE_DIRECTORY = "httpfs_disk_cache_directory";
+inline constexpr const char *HTTPFS_DISK_CACHE_MAX_SIZE_MB = "httpfs_disk_cache_max_size_mb";
+inline constexpr const char *HTTPFS_MEMORY_CACHE_MAX_SIZE_MB = "httpfs_memory_cache_max_size_mb";
+
+// Upload setting names, which apply to multipart uploads of files opened for writing on object storage
+inline constexpr const char *HTTPFS_UPLOAD_PART_SIZE_BYTES = "httpfs_upload_part_size_bytes";
+inline constexpr const char *HTTPFS_UPLOAD_CONCURRENCY = "httpfs_upload_concurrency";
+inline constexpr const char *HTTPFS_UPLOAD_PART_TIMEOUT_MS = "httpfs_upload_part_timeout_ms";
+inline constexpr const char *HTTPFS_UPLOAD_PART_RETRIES = "httpfs_upload_part_retries";
+
+// Delete setting names, which apply to deletes of many files at once (i.e. overwriting partitioned writes)
+inline constexpr const char *HTTPFS_DELETE_PARALLELISM = "httpfs_delete_parallelism";
+
+// Glob setting names, which apply to globs with a wildcard directory (i.e. Hive partitions)
+inline constexpr const char *HTTPFS_GLOB_PARALLELISM = "httpfs_glob_parallelism";
+
+// Metadata cache setting names, the cache applies to stat-type operations and file info fetched on open
+inline constexpr const char *HTTPFS_METADATA_CACHE_TTL_MS = "httpfs_metadata_cache_ttl_ms";
+inline constexpr const char *HTTPFS_METADATA_CACHE_MAX_ENTRIES = "httpfs_metadata_cache_max_entries";
+
+// Listing cache setting names, the cache applies to globs and directory listings
+inline constexpr const char *HTTPFS_LIST_CACHE_TTL_MS = "httpfs_list_cache_ttl_ms";
+inline constexpr const char *HTTPFS_LIST_CACHE_MAX_MEMORY_MB = "httpfs_list_cache_max_memory_mb";
+
+// Fault injection setting names, which add latency, transient errors and stalls to requests for testing
+inline constexpr const char *HTTPFS_FAULT_LATENCY_MS = "httpfs_fault_latency_ms";
+inline constexpr const char *HTTPFS_FAULT_LATENCY_DISTRIBUTION = "httpfs_fault_latency_distribution";
+inline constexpr const char *HTTPFS_FAULT_LATENCY_SIGMA = "httpfs_fault_latency_sigma";
+inline constexpr const char *HTTPFS_FAULT_ERROR_RATE = "httpfs_fault_error_rate";
+inline constexpr const char *HTTPFS_FAULT_STALL_RATE = "httpfs_fault_stall_rate";
+inline constexpr const char *HTTPFS_FAULT_STALL_MS = "httpfs_fault_stall_ms";
+inline constexpr const char *HTTPFS_FAULT_OPERATIONS = "httpfs_fault_operations";
+inline constexpr const char *HTTPFS_FAULT_PATH_PATTERN = "httpfs_fault_path_pattern";
+inline constexpr const char *HTTPFS_FAULT_SEED = "httpfs_fault_seed";
+
+// Warm-up setting names, which set up connections to endpoints ahead of the first query
+inline constexpr const char *HTTPFS_WARMUP_ENDPOINTS = "httpfs_warmup_endpoints";
 
 } // namespace duckdb
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "duckdb/common/array.hpp"
+#include "duckdb/common/atomic.hpp"
+#include "duckdb/common/typedefs.hpp"
+#include "duckdb/common/vector.hpp"
+
+namespace duckdb {
+
+// LatencyHistogram is a lock-free log-linear histogram of latency samples (in microseconds): every power of two range
+// is split into [SUB_BUCKET_COUNT] equally sized buckets, so the relative error of a reported percentile is bounded by
+// 1 / SUB_BUCKET_COUNT, about 3%.
+class LatencyHistogram {
+public:
+	static constexpr idx_t SUB_BUCKET_BITS = 5;
+	static constexpr idx_t SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+	static constexpr idx_t BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+	LatencyHistogram();
+
+public:
+	void Record(uint64_t latency_us);
+	// Add the bucket counts of the histogram to [bucket_counts], which should have [BUCKET_COUNT] elements.
+	void MergeInto(vector<uint64_t> &bucket_counts) const;
+	void Reset();
+
+	// Get the bucket index for the given latency.
+	static idx_t GetBucketIndex(uint64_t latency_us);
+	// Get the largest latency which falls into the given bucket.
+	static uint64_t GetBucketUpperBound(idx_t bucket_index);
+	// Get latency at the given percentile (in range (0, 1]) from merged bucket counts, return 0 if there's no sample.
+	static uint64_t GetPercentile(const vector<uint64_t> &bucket_counts, double percentile);
+
+private:
+	array<atomic<uint64_t>, BUCKET_COUNT> buckets;
+};
+
+} // namespace duckdb
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "duckdb/common/array.hpp"
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/typedefs.hpp"
+#include "duckdb/common/vector.hpp"
+#include "endpoint_registry.hpp"
+
+namespace duckdb {
+
+// LatencyTracker keeps a fixed-size window of the most recent latency samples, and answers percentile queries over
+// them. It's used to decide how long a request is allowed to be outstanding before it's considered a straggler.
+class LatencyTracker {
+public:
+	static constexpr idx_t DEFAULT_CAPACITY = 1024;
+
+	explicit LatencyTracker(idx_t capacity = DEFAULT_CAPACITY);
+
+public:
+	// Record one latency sample, in microseconds.
+	void Record(uint64_t latency_us);
+	// Get the latency at the given percentile (in range (0, 1]), return false if fewer than [min_samples] samples have
+	// been recorded.
+	bool TryGetPercentile(double percentile, idx_t min_samples, uint64_t &latency_us) const;
+	// Get number of samples currently held in the window.
+	idx_t GetSampleCount() const;
+
+private:
+	mutable mutex latency_mutex;
+	// Ring buffer of latency samples.
+	vector<uint64_t> samples;
+	// Index to write the next sample to.
+	idx_t next_index = 0;
+	// Number of valid samples, capped by window capacity.
+	idx_t sample_count = 0;
+};
+
+// ReadLatencyTrackers keeps the latencies of reads from one endpoint apart by read size, since transfer time grows with
+// it: against a window mixing sizes, small reads would never look slow, and large ones would always look slow.
+class ReadLatencyTrackers {
+public:
+	// Reads of up to 64 KiB, up to 1 MiB, up to 16 MiB, and larger ones.
+	static constexpr idx_t SIZE_CLASS_COUNT = 4;
+
+	// Get the size class of a read of [nr_bytes].
+	static idx_t GetSizeClass(idx_t nr_bytes);
+	// Get the tracker of reads of the same size class as a read of [nr_bytes].
+	LatencyTracker &GetTracker(idx_t nr_bytes);
+
+private:
+	array<LatencyTracker, SIZE_CLASS_COUNT> trackers;
+};
+
+// ReadLatencyTrackerRegistry is the process-wide registry of read latency trackers.
+class ReadLatencyTrackerRegistry {
+public:
+	static ReadLatencyTrackerRegistry &GetInstance();
+
+public:
+	// Get the read latency trackers of the endpoint.
+	ReadLatencyTrackers &GetReadLatencyTrackers(const string &endpoint);
+
+private:
+	ReadLatencyTrackerRegistry() = default;
+
+private:
+	EndpointRegistry<ReadLatencyTrackers> registry;
+};
+
+} // namespace duckdb
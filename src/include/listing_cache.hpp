@@ -0,0 +1,97 @@
+#pragma once
+
+#include "duckdb/common/file_opener.hpp"
+#include "duckdb/common/list.hpp"
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/open_file_info.hpp"
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/unique_ptr.hpp"
+#include "duckdb/common/unordered_map.hpp"
+#include "duckdb/common/vector.hpp"
+
+#include <chrono>
+
+namespace duckdb {
+
+// Listing cache config, resolved from settings for each operation.
+struct ListingCacheConfig {
+	bool enabled = false;
+	// Time-to-live of cached listings, in milliseconds.
+	uint64_t ttl_ms = 0;
+	// Max estimated memory held by cached listings, in bytes.
+	idx_t max_memory_bytes = 0;
+};
+
+// Kind of cached listing; glob results and directory listings of the same path are cached separately.
+enum class ListingKind : uint8_t { GLOB, LIST };
+
+// ListingCache caches results of globs and directory listings. Entries live in a trie keyed by path segments, at the
+// node of the longest path prefix without wildcards, so a write to a path only invalidates listings which could
+// include it: those at the ancestors of the path. Least recently used entries are evicted once the estimated memory
+// exceeds the budget.
+class ListingCache {
+public:
+	using time_point = std::chrono::steady_clock::time_point;
+
+	// Get the cached listing for [path] (a glob pattern or a directory), return false if absent or expired.
+	bool TryGet(ListingKind kind, const string &path, const ListingCacheConfig &config, vector<OpenFileInfo> &result);
+	bool TryGet(ListingKind kind, const string &path, const ListingCacheConfig &config, vector<OpenFileInfo> &result,
+	            time_point now);
+	void Put(ListingKind kind, const string &path, const ListingCacheConfig &config, vector<OpenFileInfo> result);
+	void Put(ListingKind kind, const string &path, const ListingCacheConfig &config, vector<OpenFileInfo> result,
+	         time_point now);
+
+	// Drop listings which could include [path].
+	void Invalidate(const string &path);
+	// Drop listings which could include [path] or anything under it.
+	void InvalidateRecursive(const string &path);
+
+	// Get number of cached listings.
+	idx_t Size() const;
+	// Get estimated memory held by cached listings, in bytes.
+	idx_t GetMemoryBytes() const;
+
+	// Get the longest prefix of [pattern] made of whole path segments without wildcards.
+	static string GetNonWildcardPrefix(const string &pattern);
+
+private:
+	struct TrieNode;
+
+	struct Entry {
+		TrieNode *node;
+		string key;
+		vector<OpenFileInfo> result;
+		time_point inserted_at;
+		idx_t memory_bytes;
+	};
+
+	struct TrieNode {
+		TrieNode *parent = nullptr;
+		string segment;
+		unordered_map<string, unique_ptr<TrieNode>> children;
+		unordered_map<string, list<Entry>::iterator> entries;
+	};
+
+	// Get the node of [prefix], return nullptr if it doesn't exist.
+	TrieNode *FindNode(const string &prefix);
+	TrieNode &GetOrCreateNode(const string &prefix);
+	void EraseEntry(list<Entry>::iterator entry);
+	// Remove [node] and its ancestors while they hold neither entries nor children.
+	void PruneNode(TrieNode *node);
+	// Erase all entries held by [node] and its descendants.
+	void EraseSubtree(TrieNode &node);
+	// Erase entries at [path] and its ancestors, and under [path] as well if [recursive].
+	void InvalidateInternal(const string &path, bool recursive);
+
+private:
+	mutable mutex cache_mutex;
+	TrieNode root;
+	// Entries ordered from most to least recently used.
+	list<Entry> lru_list;
+	idx_t memory_bytes = 0;
+};
+
+// Get listing cache config from settings.
+ListingCacheConfig GetListingCacheConfig(FileOpener &opener);
+
+} // namespace duckdb
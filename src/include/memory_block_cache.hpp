@@ -0,0 +1,101 @@
+#pragma once
+
+#include "duckdb/common/array.hpp"
+#include "duckdb/common/atomic.hpp"
+#include "duckdb/common/list.hpp"
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/unordered_map.hpp"
+#include "duckdb/common/vector.hpp"
+
+namespace duckdb {
+
+// File key of the block cache (see [GetBlockCacheFileKey]) as its two 64-bit hashes, which the memory tier keys blocks
+// by, so lookups don't format or hash strings.
+struct BlockCacheFileHashes {
+	uint64_t first = 0;
+	uint64_t second = 0;
+};
+
+// MemoryBlockCache is the in-memory tier of the block cache of a database. Blocks are stored in fixed-size slots carved
+// from slabs allocated once per configuration, so caching a block never allocates, and the memory never fragments.
+// Lookups are sharded by block key to reduce lock contention; each shard owns an equal part of the memory budget, and
+// evicts its least recently used blocks once its slots run out.
+class MemoryBlockCache {
+public:
+	// Max number of shards; budgets of fewer blocks use as many shards as blocks.
+	static constexpr idx_t SHARD_COUNT = 16;
+
+	MemoryBlockCache() = default;
+
+public:
+	// Apply block size and memory budget, which drops all cached blocks if either changes. The budget should be at
+	// least one block, otherwise nothing is cached.
+	void Configure(idx_t block_size, idx_t max_bytes);
+
+	// Read [nr_bytes] at [offset] of the cached block, which must be exactly [block_bytes] long, into [buffer]; return
+	// false on miss.
+	bool TryRead(const BlockCacheFileHashes &file_key, idx_t block_index, idx_t block_bytes, idx_t offset,
+	             data_ptr_t buffer, idx_t nr_bytes);
+	// Read the whole cached block into [buffer], which must be exactly [nr_bytes] long; return false on miss.
+	bool TryRead(const BlockCacheFileHashes &file_key, idx_t block_index, data_ptr_t buffer, idx_t nr_bytes) {
+		return TryRead(file_key, block_index, nr_bytes, 0, buffer, nr_bytes);
+	}
+	// Whether the block is cached, without reading it.
+	bool Contains(const BlockCacheFileHashes &file_key, idx_t block_index) const;
+	// Cache the block, evicting the least recently used block of its shard if there's no free slot.
+	void Write(const BlockCacheFileHashes &file_key, idx_t block_index, const_data_ptr_t buffer, idx_t nr_bytes);
+
+	idx_t GetBlockCount() const;
+	// Get number of slots, i.e. max number of cached blocks.
+	idx_t GetSlotCount() const;
+	// Get number of shards in use.
+	idx_t GetShardCount() const {
+		return shard_count.load();
+	}
+
+private:
+	struct BlockKey {
+		BlockCacheFileHashes file_key;
+		idx_t block_index;
+
+		bool operator==(const BlockKey &other) const {
+			return file_key.first == other.file_key.first && file_key.second == other.file_key.second &&
+			       block_index == other.block_index;
+		}
+	};
+	struct BlockKeyHash {
+		size_t operator()(const BlockKey &key) const;
+	};
+
+	struct SlotEntry {
+		BlockKey block_key;
+		idx_t slot_index;
+		idx_t nr_bytes;
+	};
+
+	struct Shard {
+		mutable mutex shard_mutex;
+		idx_t block_size = 0;
+		idx_t slot_count = 0;
+		// [slot_count] slots of [block_size] bytes each.
+		unsafe_unique_array<data_t> slab;
+		vector<idx_t> free_slots;
+		// Cached blocks ordered from most to least recently used.
+		list<SlotEntry> lru_list;
+		unordered_map<BlockKey, list<SlotEntry>::iterator, BlockKeyHash> entries;
+	};
+
+	Shard &GetShard(const BlockKey &block_key);
+	const Shard &GetShard(const BlockKey &block_key) const;
+
+private:
+	// Serializes reconfiguration.
+	mutex configure_mutex;
+	idx_t configured_block_size = 0;
+	idx_t configured_max_bytes = 0;
+	// Number of shards in use, the first ones of [shards].
+	atomic<idx_t> shard_count {1};
+	array<Shard, SHARD_COUNT> shards;
+};
+
+} // namespace duckdb
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "duckdb/common/file_opener.hpp"
+#include "duckdb/common/open_file_info.hpp"
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/types/timestamp.hpp"
+#include "ttl_lru_cache.hpp"
+
+namespace duckdb {
+
+class FileHandle;
+
+// Metadata cache config, resolved from settings for each operation.
+struct MetadataCacheConfig {
+	bool enabled = false;
+	// Time-to-live of cached entries, in milliseconds.
+	uint64_t ttl_ms = 0;
+	// Max number of cached entries for files, and for directories.
+	idx_t max_entries = 0;
+};
+
+// Cached metadata of one file.
+struct CachedFileMetadata {
+	bool exists = false;
+	// Whether file size, last modification time and etag are known; only valid for existing files.
+	bool has_file_info = false;
+	idx_t file_size = 0;
+	timestamp_t last_modified;
+	string etag;
+};
+
+// MetadataCache caches results of stat-type calls (existence, file size, last modification time and etag) keyed by
+// path. Entries are dropped when they expire, or when the path is modified through the wrapper.
+class MetadataCache {
+public:
+	bool TryGetFile(const string &path, const MetadataCacheConfig &config, CachedFileMetadata &metadata);
+	void PutFile(const string &path, const MetadataCacheConfig &config, CachedFileMetadata metadata);
+	// Record the existence of a file, which keeps file info already cached for an existing file.
+	void PutFileExists(const string &path, const MetadataCacheConfig &config, bool exists);
+	// Record file info from an opened file handle.
+	void PutFileHandle(FileHandle &handle, const MetadataCacheConfig &config);
+	// Record file info from a listing entry, if it carries all of file size, last modification time and etag.
+	void PutListingEntry(const OpenFileInfo &info, const MetadataCacheConfig &config);
+
+	bool TryGetDirectoryExists(const string &path, const MetadataCacheConfig &config, bool &exists);
+	void PutDirectoryExists(const string &path, const MetadataCacheConfig &config, bool exists);
+
+	// Drop cached entries for the path.
+	void Invalidate(const string &path);
+	// Drop cached entries for the path and everything under it.
+	void InvalidateRecursive(const string &path);
+
+	// Attach cached file info to [info], so the inner filesystem could skip the metadata request on open.
+	// Return false if there's no cached file info, or [info] already carries its own.
+	bool TryAttachFileInfo(OpenFileInfo &info, const MetadataCacheConfig &config);
+
+private:
+	TtlLruCache<CachedFileMetadata> file_cache;
+	TtlLruCache<bool> directory_cache;
+};
+
+// Get metadata of an open file from its handle.
+CachedFileMetadata GetFileHandleMetadata(FileHandle &handle);
+// Attach file info of [metadata] to [info], so the inner filesystem skips its metadata request on open.
+void AttachFileInfo(OpenFileInfo &info, const CachedFileMetadata &metadata);
+
+// Get metadata cache config from settings.
+MetadataCacheConfig GetMetadataCacheConfig(FileOpener &opener);
+
+} // namespace duckdb
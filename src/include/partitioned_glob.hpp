@@ -0,0 +1,32 @@
+#pragma once
+
+#include "duckdb/common/string.hpp"
+
+namespace duckdb {
+
+// Glob pattern split at its first wildcard segment, which is expanded by listing the directory before it, i.e.
+// "s3://bucket/t/year=*/month=*/*.parquet" is split into directory "s3://bucket/t", partition pattern "year=*" and
+// remainder "month=*/*.parquet". Each matching partition is then globbed on its own.
+struct PartitionedGlob {
+	string directory;
+	string partition_pattern;
+	string remainder;
+
+	// Get the glob pattern under the partition directory named [partition].
+	string GetPartitionGlob(const string &partition) const {
+		return directory + "/" + partition + "/" + remainder;
+	}
+};
+
+// Split [pattern] at its first wildcard segment; return false if there's no such segment with more segments after it,
+// or the segment is a recursive wildcard ("**"), which cannot be expanded by one listing.
+bool TrySplitPartitionedGlob(const string &pattern, PartitionedGlob &result);
+
+// Whether [name] matches the glob [pattern] of one path segment, which supports '*', '?' and '[...]'.
+bool MatchGlobSegment(const string &name, const string &pattern);
+
+// Get the last segment of a listed path, which the inner filesystem could report as a full path or a relative name,
+// with or without trailing separator.
+string GetListedName(const string &listed_path);
+
+} // namespace duckdb
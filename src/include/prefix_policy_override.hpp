@@ -0,0 +1,74 @@
+#pragma once
+
+#include "duckdb/common/constants.hpp"
+#include "duckdb/common/file_opener.hpp"
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/types/value.hpp"
+#include "duckdb/common/unordered_map.hpp"
+#include "duckdb/common/vector.hpp"
+
+#include <utility>
+
+namespace duckdb {
+
+// PrefixTrie maps string prefixes to values, and finds the value of the longest prefix of a string in time linear in
+// the string length, regardless of the number of prefixes. Nodes live in one vector with child edges sorted by
+// character, so the trie is compiled once and looked up without allocation.
+class PrefixTrie {
+public:
+	static constexpr idx_t NOT_FOUND = DConstants::INVALID_INDEX;
+
+	PrefixTrie();
+
+	// Map [prefix] to [value], replacing the value of an equal prefix.
+	void Insert(const string &prefix, idx_t value);
+	// Get the value of the longest prefix of [str], or NOT_FOUND if no prefix matches.
+	idx_t FindLongestPrefix(const string &str) const;
+
+private:
+	struct Node {
+		// Edges to child nodes, sorted by character.
+		vector<std::pair<char, idx_t>> children;
+		idx_t value = NOT_FOUND;
+	};
+
+	// Get the child of node [node_index] along [character], or NOT_FOUND.
+	idx_t FindChild(idx_t node_index, char character) const;
+
+	// Root node is the first one.
+	vector<Node> nodes;
+};
+
+// Timeout and retry settings overridden for paths under a prefix.
+struct PrefixPolicyOverride {
+	// Path prefix, i.e. "s3://archive-bucket/".
+	string prefix;
+	// Setting values by setting name, which include the overrides of enclosing prefixes.
+	unordered_map<string, Value> settings;
+};
+
+// Get prefix policy overrides from settings, sorted by prefix length so enclosing prefixes come first.
+vector<PrefixPolicyOverride> GetPrefixPolicyOverrides(FileOpener &opener);
+
+// Parse prefix policy overrides, of the form "<prefix> <setting>=<value>, ...; <prefix> <setting>=<value>, ...".
+vector<PrefixPolicyOverride> ParsePrefixPolicyOverrides(const string &overrides);
+
+// FileOpener wrapper which reports the settings of a prefix policy override over the settings of the inner opener.
+class PrefixOverrideFileOpener : public FileOpener {
+public:
+	PrefixOverrideFileOpener(FileOpener &inner_opener_p, const PrefixPolicyOverride &policy_override_p);
+
+	SettingLookupResult TryGetCurrentSetting(const string &key, Value &result, FileOpenerInfo &info) override;
+	SettingLookupResult TryGetCurrentSetting(const string &key, Value &result) override;
+
+	optional_ptr<ClientContext> TryGetClientContext() override;
+	optional_ptr<DatabaseInstance> TryGetDatabase() override;
+	shared_ptr<HTTPUtil> &GetHTTPUtil() override;
+	Logger &GetLogger() const override;
+
+private:
+	FileOpener &inner_opener;
+	const PrefixPolicyOverride &policy_override;
+};
+
+} // namespace duckdb
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "duckdb/common/list.hpp"
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/shared_ptr.hpp"
+#include "duckdb/common/typedefs.hpp"
+#include "duckdb/common/unique_ptr.hpp"
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+
+namespace duckdb {
+
+// ReadCoalescer merges concurrent small positional reads of one file handle into fewer ranged requests. The first read
+// which cannot join a pending batch starts one, and waits up to the coalescing window for other reads to join if other
+// batches are pending or in flight, otherwise it's sent right away; reads join a pending batch if the gap between them
+// and the batch range is within the max gap, and the merged range stays within the max request size. The batch range
+// is then fetched with one request, and split back into the readers' buffers. Bytes in the gaps are fetched and
+// dropped.
+class ReadCoalescer {
+public:
+	// Read [nr_bytes] at [location] into [buffer], throw on failure.
+	using FetchFunction = std::function<void(data_ptr_t buffer, idx_t nr_bytes, idx_t location)>;
+
+	ReadCoalescer(idx_t max_gap_bytes_p, idx_t max_request_bytes_p, uint64_t window_us_p, idx_t file_size_p,
+	              FetchFunction fetch_p);
+
+public:
+	// Whether the read is eligible for coalescing; reads past end of file are left to the inner filesystem to report.
+	bool ShouldCoalesce(idx_t nr_bytes, idx_t location) const;
+	// Read [nr_bytes] at [location] into [buffer], possibly as part of a merged request; throw on failure.
+	void Read(data_ptr_t buffer, idx_t nr_bytes, idx_t location);
+
+	// Get number of requests issued, and number of reads served by them.
+	idx_t GetRequestCount() const;
+	idx_t GetReadCount() const;
+
+private:
+	struct Batch {
+		idx_t start;
+		idx_t end;
+		bool done = false;
+		unsafe_unique_array<data_t> data;
+		std::exception_ptr error;
+		// Notified when the batch is full (leader stops waiting), and when it's done (readers copy their range).
+		std::condition_variable batch_cv;
+	};
+
+	// Find a pending batch the read can join, and extend its range; caller must hold [coalescer_mutex].
+	shared_ptr<Batch> TryJoinBatch(idx_t start, idx_t end);
+	// Issue the request of [batch], which the calling thread started.
+	void FetchBatch(Batch &batch, std::unique_lock<mutex> &lck);
+
+private:
+	const idx_t max_gap_bytes;
+	const idx_t max_request_bytes;
+	const uint64_t window_us;
+	const idx_t file_size;
+	const FetchFunction fetch;
+
+	mutable mutex coalescer_mutex;
+	// Batches which still accept reads, i.e. whose leader is waiting for the coalescing window.
+	list<shared_ptr<Batch>> pending_batches;
+	// Number of batches being fetched.
+	idx_t in_flight_requests = 0;
+	idx_t request_count = 0;
+	idx_t read_count = 0;
+};
+
+} // namespace duckdb
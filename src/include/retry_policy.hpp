@@ -0,0 +1,119 @@
+#pragma once
+
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/string.hpp"
+#include "circuit_breaker.hpp"
+#include "concurrency_limiter.hpp"
+#include "endpoint_registry.hpp"
+#include "timeout_retry_file_opener.hpp"
+
+#include <chrono>
+#include <exception>
+
+namespace duckdb {
+
+// Retry budget config, resolved from settings for each operation.
+struct RetryBudgetConfig {
+	// Whether retries are bounded by the per-endpoint retry budget.
+	bool enabled = false;
+	// Retry tokens earned by each successful request, i.e. the fraction of successful requests which can be retried.
+	double ratio = 0;
+	// Retry tokens earned per second regardless of traffic, so endpoints with few requests can still retry.
+	double min_retries_per_second = 0;
+};
+
+// Jitter applied to the exponential retry wait, which keeps retries from many threads from hitting the endpoint at the
+// same moment.
+// - NONE: wait exactly the exponential wait.
+// - FULL: wait a random time up to the exponential wait.
+// - EQUAL: wait half the exponential wait, plus a random time up to the other half.
+// - DECORRELATED: wait a random time between the initial wait and three times the previous wait.
+enum class RetryJitter : uint8_t { NONE, FULL, EQUAL, DECORRELATED };
+
+// Retry config for an operation, which is run and retried by the wrapper instead of the inner filesystem.
+struct RetryConfig {
+	// Max number of retries after the first attempt.
+	uint64_t max_retries = 0;
+	// Wait time before the first retry, in milliseconds.
+	uint64_t retry_wait_ms = 0;
+	// Multiplier to the wait time for each following retry.
+	double retry_backoff = 1;
+	// Max wait time before a retry, in milliseconds; 0 means unbounded.
+	uint64_t retry_max_wait_ms = 0;
+	RetryJitter jitter = RetryJitter::NONE;
+	RetryBudgetConfig budget;
+	CircuitBreakerConfig circuit_breaker;
+	ConcurrencyLimitConfig concurrency_limit;
+};
+
+// RetryBudget is a token bucket shared by all requests to one endpoint (host or bucket). Successful requests deposit
+// [ratio] tokens, and tokens also trickle in at [min_retries_per_second]; each retry takes one token. When the bucket
+// is empty, failed requests are not retried, which keeps concurrent scans from multiplying load on an endpoint which
+// is already struggling.
+class RetryBudget {
+public:
+	// Max number of retries which can be saved up, which bounds the burst of retries when an endpoint starts failing.
+	static constexpr double MAX_TOKENS = 100;
+
+	RetryBudget() = default;
+
+public:
+	void RecordSuccess(const RetryBudgetConfig &config);
+	// Take one token for a retry, return false if the budget is exhausted.
+	bool TryAcquireRetry(const RetryBudgetConfig &config);
+
+	// Overloads with explicit clock, for testing purpose.
+	void RecordSuccess(const RetryBudgetConfig &config, std::chrono::steady_clock::time_point now);
+	bool TryAcquireRetry(const RetryBudgetConfig &config, std::chrono::steady_clock::time_point now);
+
+private:
+	// Add tokens earned over time since last refill, requires [budget_mutex] held.
+	void Refill(const RetryBudgetConfig &config, std::chrono::steady_clock::time_point now);
+
+private:
+	mutex budget_mutex;
+	bool initialized = false;
+	double tokens = 0;
+	std::chrono::steady_clock::time_point last_refill;
+};
+
+// RetryBudgetRegistry is the process-wide registry of retry budgets.
+class RetryBudgetRegistry {
+public:
+	static RetryBudgetRegistry &GetInstance();
+
+public:
+	// Get the retry budget shared by all operations to the endpoint.
+	RetryBudget &GetRetryBudget(const string &endpoint);
+
+private:
+	RetryBudgetRegistry() = default;
+
+private:
+	EndpointRegistry<RetryBudget> registry;
+};
+
+// Get retry config for the operation from settings, including retry budget, circuit breaker and concurrency limit;
+// taken from the policy snapshot of the opener if it has one.
+RetryConfig GetRetryConfig(TimeoutRetryFileOpener &opener);
+
+// Get wait time before the retry with the given index (0-based), in milliseconds; [previous_wait_ms] is the wait
+// before the previous retry, or the initial wait for the first retry, which decorrelated jitter grows from.
+uint64_t GetRetryWaitMs(const RetryConfig &config, idx_t retry_index, uint64_t previous_wait_ms);
+// Overload with explicit random number in [0, 1), for testing purpose.
+uint64_t GetRetryWaitMs(const RetryConfig &config, idx_t retry_index, uint64_t previous_wait_ms, double random);
+
+// Get the wait time requested by the server via Retry-After header of a throttled or unavailable response, in
+// milliseconds; return false if the error doesn't carry one.
+bool TryGetRetryAfterMs(const std::exception &ex, uint64_t &retry_after_ms);
+// Get the longest wait a Retry-After header could ask for before the retry is given up, in milliseconds: the max retry
+// wait of [config], or one minute if unbounded.
+uint64_t GetMaxRetryAfterMs(const RetryConfig &config);
+
+// Whether the error is a throttling response, i.e. HTTP 429, or S3 error codes like SlowDown.
+bool IsThrottlingError(const std::exception &ex);
+
+// Whether the error is transient and worth retrying, i.e. IO errors, request timeout, throttling and server errors.
+bool IsRetryableError(const std::exception &ex);
+
+} // namespace duckdb
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/typedefs.hpp"
+#include "duckdb/common/unique_ptr.hpp"
+
+#include <condition_variable>
+#include <functional>
+
+namespace duckdb {
+
+// SequentialReadAhead serves sequential reads of one file handle from memory, while the next window of the file is
+// fetched in the background. The window starts small and doubles every time a prefetched window is consumed, up to the
+// configured max; a seek resets it. At most two windows (the one being consumed and the one being fetched) are held.
+//
+// A seek never waits for the background fetch: a fetch the seek made stale completes in the background, and its window
+// is dropped. Unless the handle allows concurrent requests, foreground fetches wait for it to complete first, so the
+// file handle never sees concurrent requests.
+class SequentialReadAhead {
+public:
+	// Read [nr_bytes] at [location] into [buffer], throw on failure.
+	using FetchFunction = std::function<void(data_ptr_t buffer, idx_t nr_bytes, idx_t location)>;
+
+	// Number of consecutive sequential reads before prefetch starts.
+	static constexpr idx_t SEQUENTIAL_READS_BEFORE_PREFETCH = 2;
+	// Initial window size, capped by the max window size.
+	static constexpr idx_t MIN_WINDOW_BYTES = 1024 * 1024;
+
+	SequentialReadAhead(idx_t max_window_bytes_p, idx_t file_size_p, bool concurrent_fetches_p, FetchFunction fetch_p);
+	~SequentialReadAhead();
+
+public:
+	// Read up to [nr_bytes] at the current position and advance it, return the number of bytes read.
+	idx_t Read(data_ptr_t buffer, idx_t nr_bytes);
+	void Seek(idx_t location);
+	idx_t GetPosition() const;
+	// Block until the background fetch (if any) completes; the file handle must not be closed before.
+	void WaitForPrefetch();
+
+	// Get the window size of the next prefetch.
+	idx_t GetWindowBytes() const;
+
+private:
+	struct Window {
+		unsafe_unique_array<data_t> data;
+		idx_t capacity = 0;
+		idx_t start = 0;
+		idx_t size = 0;
+
+		void Reserve(idx_t nr_bytes);
+		bool Contains(idx_t location) const {
+			return location >= start && location < start + size;
+		}
+	};
+
+	// Swap in the prefetched window if it starts at the current position, return whether it did.
+	bool TryTakePrefetch();
+	void StartPrefetch();
+	// Fetch in the foreground, once the background fetch completes unless concurrent fetches are allowed.
+	void FetchInForeground(data_ptr_t buffer, idx_t nr_bytes, idx_t location);
+
+private:
+	const idx_t max_window_bytes;
+	const idx_t file_size;
+	const bool concurrent_fetches;
+	const FetchFunction fetch;
+
+	// Held for the whole of each read and seek, which serializes them.
+	mutable mutex read_mutex;
+	idx_t position = 0;
+	idx_t sequential_reads = 0;
+	idx_t window_bytes;
+	// Window being consumed.
+	Window current;
+
+	// Guards the prefetched window, which is only accessed by the background fetch while it's in flight.
+	mutex prefetch_mutex;
+	std::condition_variable prefetch_cv;
+	Window prefetched;
+	bool prefetch_in_flight = false;
+	bool prefetch_failed = false;
+};
+
+} // namespace duckdb
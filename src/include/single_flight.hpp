@@ -0,0 +1,124 @@
+#pragma once
+
+#include "duckdb/common/helper.hpp"
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/shared_ptr.hpp"
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/unordered_map.hpp"
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+
+namespace duckdb {
+
+// SingleFlight deduplicates concurrent calls with the same key: the first caller (the leader) runs the call, while
+// callers arriving before it completes wait and share its result, or its error. Nothing is kept once the call
+// completes, so later callers always run a fresh call.
+template <class T, class KEY = string, class KEY_HASH = std::hash<KEY>>
+class SingleFlight {
+public:
+	// Run [func] for [key] unless an identical call is in flight, in which case wait for it; [shared] is set to whether
+	// the result (or error) was shared from another caller, who paid for timeouts and retries alone.
+	template <class FUNC>
+	T Do(const KEY &key, FUNC &&func, bool &shared) {
+		std::unique_lock<mutex> lck(flight_mutex);
+		auto iter = calls.find(key);
+		if (iter != calls.end()) {
+			auto call = iter->second;
+			shared = true;
+			call->call_cv.wait(lck, [&]() { return call->done; });
+			if (call->error) {
+				std::rethrow_exception(call->error);
+			}
+			return call->result;
+		}
+		auto call = make_shared_ptr<Call>();
+		calls.emplace(key, call);
+		shared = false;
+		lck.unlock();
+
+		try {
+			call->result = func();
+		} catch (...) {
+			call->error = std::current_exception();
+		}
+
+		lck.lock();
+		call->done = true;
+		calls.erase(key);
+		call->call_cv.notify_all();
+		if (call->error) {
+			std::rethrow_exception(call->error);
+		}
+		return call->result;
+	}
+
+	// Like [Do], for results which only stay valid during the leader's call, i.e. pointing into the leader's buffer:
+	// followers pass the result to [share] (which must not throw) before the leader returns, so the leader doesn't
+	// have to copy its result anywhere, at the cost of waiting for its followers.
+	template <class FUNC, class SHARE>
+	void DoInPlace(const KEY &key, FUNC &&func, SHARE &&share, bool &shared) {
+		std::unique_lock<mutex> lck(flight_mutex);
+		auto iter = calls.find(key);
+		if (iter != calls.end()) {
+			auto call = iter->second;
+			shared = true;
+			++call->followers;
+			call->call_cv.wait(lck, [&]() { return call->done; });
+			const auto error = call->error;
+			if (error == nullptr) {
+				lck.unlock();
+				share(call->result);
+				lck.lock();
+			}
+			--call->followers;
+			call->call_cv.notify_all();
+			if (error) {
+				std::rethrow_exception(error);
+			}
+			return;
+		}
+		auto call = make_shared_ptr<Call>();
+		calls.emplace(key, call);
+		shared = false;
+		lck.unlock();
+
+		try {
+			call->result = func();
+		} catch (...) {
+			call->error = std::current_exception();
+		}
+
+		lck.lock();
+		call->done = true;
+		calls.erase(key);
+		call->call_cv.notify_all();
+		call->call_cv.wait(lck, [&]() { return call->followers == 0; });
+		if (call->error) {
+			std::rethrow_exception(call->error);
+		}
+	}
+
+	// Get number of calls in flight.
+	idx_t GetInFlightCount() const {
+		lock_guard<mutex> lck(flight_mutex);
+		return calls.size();
+	}
+
+private:
+	struct Call {
+		bool done = false;
+		// Number of followers of [DoInPlace] which haven't taken the result yet.
+		idx_t followers = 0;
+		T result;
+		std::exception_ptr error;
+		std::condition_variable call_cv;
+	};
+
+private:
+	mutable mutex flight_mutex;
+	unordered_map<KEY, shared_ptr<Call>, KEY_HASH> calls;
+};
+
+} // namespace duckdb
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "duckdb/common/deque.hpp"
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/shared_ptr.hpp"
+#include "duckdb/common/typedefs.hpp"
+
+#include <condition_variable>
+#include <functional>
+
+namespace duckdb {
+
+// TaskExecutor runs tasks on a bounded set of worker threads. Workers are started on demand up to the max, and kept
+// for later tasks once started, so background requests don't pay a thread creation each; tasks beyond the max wait in
+// arrival order for a free worker.
+//
+// Tasks must not wait for other tasks of the same executor, which could all be waiting behind them. Workers are
+// detached and exit once the executor is destroyed and its queue is drained, so a task stuck in a request never blocks
+// the owner of the executor.
+class TaskExecutor {
+public:
+	// Task to run on a worker, which must not throw.
+	using Task = std::function<void()>;
+
+	explicit TaskExecutor(idx_t max_threads_p);
+	~TaskExecutor();
+
+public:
+	// Run [task] on an idle worker, on a new worker if fewer than the max are running, or once a worker frees up.
+	void Schedule(Task task);
+
+	// Get number of running workers.
+	idx_t GetThreadCount() const;
+
+private:
+	// Shared with the workers, which could outlive the executor.
+	struct State {
+		mutex state_mutex;
+		std::condition_variable state_cv;
+		deque<Task> tasks;
+		idx_t thread_count = 0;
+		idx_t idle_thread_count = 0;
+		bool shutdown = false;
+	};
+
+	static void RunWorker(shared_ptr<State> state);
+
+private:
+	const idx_t max_threads;
+	shared_ptr<State> state;
+};
+
+} // namespace duckdb
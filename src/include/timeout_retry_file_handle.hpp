@@ -0,0 +1,163 @@
+#pragma once
+
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/optional_ptr.hpp"
+#include "duckdb/common/shared_ptr.hpp"
+#include "duckdb/common/unique_ptr.hpp"
+#include "adaptive_timeout.hpp"
+#include "block_cache.hpp"
+#include "fault_injection.hpp"
+#include "latency_tracker.hpp"
+#include "read_coalescer.hpp"
+#include "retry_policy.hpp"
+#include "sequential_read_ahead.hpp"
+
+#include <functional>
+#include <utility>
+
+namespace duckdb {
+
+class OperationMetrics;
+
+// Per-handle read config, resolved once when the file is opened.
+struct TimeoutRetryHandleConfig {
+	// Whether hedged reads are enabled for the file handle.
+	bool hedge_read = false;
+	// Minimum delay before a hedged request is issued, in milliseconds.
+	uint64_t hedge_delay_ms = 0;
+	// Latency percentile of recent reads to wait for before a hedged request is issued; 0 means not configured.
+	double hedge_percentile = 0;
+	// Deadline for a read enforced by the wrapper, in milliseconds; 0 means the HTTP client timeout is precise enough.
+	uint64_t read_deadline_ms = 0;
+	// Adaptive timeout of reads with resolved bounds, enforced as deadline on handles which allow concurrent requests.
+	AdaptiveTimeoutConfig read_adaptive_timeout;
+	// Positional reads of at least this many bytes are split into concurrent ranged reads; 0 means disabled.
+	idx_t parallel_read_threshold = 0;
+	// Number of concurrent ranged reads a large positional read is split into.
+	idx_t parallel_read_parts = 0;
+	// Whether concurrent identical positional reads of the file share one request.
+	bool single_flight = false;
+	// Max window of sequential read-ahead, in bytes; 0 means disabled.
+	idx_t read_ahead_max_bytes = 0;
+	// Whether concurrent small positional reads are coalesced.
+	bool read_coalesce = false;
+	// Max gap between coalesced reads, in bytes.
+	idx_t read_coalesce_max_gap_bytes = 0;
+	// Max size of a coalesced request, in bytes.
+	idx_t read_coalesce_max_request_bytes = 0;
+	// Time a read waits for other reads to coalesce with, in microseconds.
+	uint64_t read_coalesce_window_us = 0;
+	// Timeout of HTTP clients created for the handle in milliseconds, 0 if unknown.
+	uint64_t client_timeout_ms = 0;
+	// Faults injected into reads.
+	FaultInjectionConfig fault_injection;
+	// Retry config for reads.
+	RetryConfig read_retry;
+	// Retry config for writes, which never retries in the wrapper: files opened for writing keep retries in the inner
+	// filesystem, since a write call could flush buffered data and cannot be simply repeated.
+	RetryConfig write_retry;
+};
+
+// TimeoutRetryFileHandle wraps the file handle returned by the inner filesystem, so handle-level IO operations (read,
+// write, file info, etc) are routed back to the timeout/retry wrapper instead of going to inner filesystem directly.
+class TimeoutRetryFileHandle : public FileHandle {
+public:
+	TimeoutRetryFileHandle(FileSystem &wrapper_filesystem, unique_ptr<FileHandle> inner_handle_p, FileOpenFlags flags,
+	                       TimeoutRetryHandleConfig config_p, OperationMetrics &read_metrics_p,
+	                       OperationMetrics &write_metrics_p, RetryBudget &retry_budget_p,
+	                       CircuitBreaker &circuit_breaker_p, ConcurrencyLimiter &concurrency_limiter_p,
+	                       ReadLatencyTrackers &read_latency_trackers_p);
+	~TimeoutRetryFileHandle() override;
+
+public:
+	void Close() override;
+
+	FileHandle &GetInnerHandle() {
+		return *inner_handle;
+	}
+	const TimeoutRetryHandleConfig &GetConfig() const {
+		return *config;
+	}
+	// Background requests (i.e. hedged reads which lost the race, or reads past their deadline) keep running after the
+	// foreground read returns, so they share the inner handle and config instead of holding the handle open.
+	const shared_ptr<FileHandle> &GetSharedInnerHandle() const {
+		return inner_handle;
+	}
+	const shared_ptr<const TimeoutRetryHandleConfig> &GetSharedConfig() const {
+		return config;
+	}
+	OperationMetrics &GetReadMetrics() {
+		return read_metrics;
+	}
+	OperationMetrics &GetWriteMetrics() {
+		return write_metrics;
+	}
+	RetryBudget &GetRetryBudget() {
+		return retry_budget;
+	}
+	CircuitBreaker &GetCircuitBreaker() {
+		return circuit_breaker;
+	}
+	ConcurrencyLimiter &GetConcurrencyLimiter() {
+		return concurrency_limiter;
+	}
+	// Latency of recent reads from the endpoint by read size, used to decide hedging delay.
+	ReadLatencyTrackers &GetReadLatencyTrackers() {
+		return read_latency_trackers;
+	}
+
+	// Positional reads go through the block cache if it's set.
+	void SetBlockCache(HandleBlockCache block_cache_p) {
+		block_cache = std::move(block_cache_p);
+	}
+	const HandleBlockCache &GetBlockCache() const {
+		return block_cache;
+	}
+
+	// Identity of the file content, by hashes of path and version tag, which keys single-flight reads.
+	void SetContentHashes(const BlockCacheFileHashes &content_hashes_p) {
+		content_hashes = content_hashes_p;
+	}
+	const BlockCacheFileHashes &GetContentHashes() const {
+		return content_hashes;
+	}
+
+	// Sequential reads are served by the read-ahead if it's set.
+	void SetReadAhead(unique_ptr<SequentialReadAhead> read_ahead_p) {
+		read_ahead = std::move(read_ahead_p);
+	}
+	optional_ptr<SequentialReadAhead> GetReadAhead() {
+		return read_ahead.get();
+	}
+
+	// Small positional reads are coalesced by the read coalescer if it's set.
+	void SetReadCoalescer(unique_ptr<ReadCoalescer> read_coalescer_p) {
+		read_coalescer = std::move(read_coalescer_p);
+	}
+	optional_ptr<ReadCoalescer> GetReadCoalescer() {
+		return read_coalescer.get();
+	}
+
+	// Set the callback invoked once the handle is closed or destroyed, i.e. to invalidate cached metadata of the file.
+	void SetCloseCallback(std::function<void()> close_callback_p) {
+		close_callback = std::move(close_callback_p);
+	}
+
+private:
+	shared_ptr<FileHandle> inner_handle;
+	shared_ptr<const TimeoutRetryHandleConfig> config;
+	// Metrics are resolved at open time, so recording on the hot IO path doesn't go through the metrics registry.
+	OperationMetrics &read_metrics;
+	OperationMetrics &write_metrics;
+	RetryBudget &retry_budget;
+	CircuitBreaker &circuit_breaker;
+	ConcurrencyLimiter &concurrency_limiter;
+	ReadLatencyTrackers &read_latency_trackers;
+	std::function<void()> close_callback;
+	unique_ptr<SequentialReadAhead> read_ahead;
+	unique_ptr<ReadCoalescer> read_coalescer;
+	HandleBlockCache block_cache;
+	BlockCacheFileHashes content_hashes;
+};
+
+} // namespace duckdb
@@ -2,15 +2,31 @@
 
 #include "duckdb/common/file_opener.hpp"
 #include "duckdb/common/string.hpp"
+#include "duckdb/common/unordered_map.hpp"
 
 namespace duckdb {
 
-enum class HttpfsOperationType { OPEN, LIST, DELETE, STAT, CREATE_DIR };
+struct OperationPolicy;
+struct TimeoutRetryPolicySnapshot;
 
-// FileOpener wrapper that provides per-operation timeout and retry settings
+// READ and WRITE are handle-level IO operations, which fall back to file operation settings when their own settings are
+// not set.
+enum class HttpfsOperationType { OPEN, LIST, DELETE, STAT, CREATE_DIR, READ, WRITE };
+
+// Number of operation types.
+inline constexpr idx_t HTTPFS_OPERATION_TYPE_COUNT = 7;
+
+// Get the display name of the operation type.
+string HttpfsOperationTypeToString(HttpfsOperationType operation_type);
+
+// FileOpener wrapper that provides per-operation timeout and retry settings.
+// With [policies_p], timeouts and retries are taken from the resolved snapshot instead of looked up in settings, with
+// the overrides of the longest policy prefix of [path_p] applied.
 class TimeoutRetryFileOpener : public FileOpener {
 public:
-	TimeoutRetryFileOpener(FileOpener &inner_opener_p, HttpfsOperationType operation_type_p);
+	TimeoutRetryFileOpener(FileOpener &inner_opener_p, HttpfsOperationType operation_type_p,
+	                       optional_ptr<const TimeoutRetryPolicySnapshot> policies_p = nullptr,
+	                       const string &path_p = string());
 
 	SettingLookupResult TryGetCurrentSetting(const string &key, Value &result, FileOpenerInfo &info) override;
 	SettingLookupResult TryGetCurrentSetting(const string &key, Value &result) override;
@@ -24,14 +40,91 @@ public:
 		return operation_type;
 	}
 
+	// Get the policy snapshot the opener resolves timeouts and retries from, nullptr if they're looked up in settings.
+	optional_ptr<const TimeoutRetryPolicySnapshot> GetPolicies() const {
+		return policies;
+	}
+	// Get the policy of the operation on the path from the snapshot, nullptr if there's no snapshot.
+	optional_ptr<const OperationPolicy> GetOperationPolicy() const {
+		return operation_policy;
+	}
+	// Get the path of the operation, empty if unknown.
+	const string &GetPath() const {
+		return path;
+	}
+
+	// Get the effective timeout for the operation in milliseconds, without rounding to whole seconds.
+	// Return false if neither per-operation timeout nor http_timeout is available.
+	bool TryGetTimeoutMs(uint64_t &timeout_ms);
+
+	// Override timeout for the operation, which takes precedence over settings.
+	void SetTimeoutOverrideMs(uint64_t timeout_ms) {
+		timeout_override_ms = timeout_ms;
+	}
+
+	// Get the configured retry count for the operation, ignoring [SetInnerRetriesOverride].
+	// Return false if neither per-operation retries nor http_retries is available.
+	bool TryGetRetries(uint64_t &retries);
+
+	// Get the configured retry wait (in milliseconds) and backoff for the operation, falling back to http_retry_wait_ms
+	// and http_retry_backoff. Return false if neither is available.
+	bool TryGetRetryWaitMs(uint64_t &retry_wait_ms);
+	bool TryGetRetryBackoff(double &retry_backoff);
+	// Get the configured max retry wait for the operation in milliseconds, return false if it's not set.
+	bool TryGetRetryMaxWaitMs(uint64_t &retry_max_wait_ms);
+
+	// Report the given http_retries to the inner filesystem instead of settings.
+	void SetInnerRetriesOverride(uint64_t retries) {
+		has_inner_retries_override = true;
+		inner_retries_override = retries;
+	}
+	// Report zero http_retries to the inner filesystem, when the wrapper retries the operation itself.
+	void DisableInnerRetries() {
+		SetInnerRetriesOverride(0);
+	}
+
+	// Report [value] for setting [key] to the inner filesystem instead of settings, i.e. to tune its multipart uploads.
+	void SetSettingOverride(const string &key, Value value) {
+		setting_overrides[key] = std::move(value);
+	}
+
+	FileOpener &GetInnerOpener() {
+		return inner_opener;
+	}
+
 private:
 	FileOpener &inner_opener;
 	HttpfsOperationType operation_type;
+	optional_ptr<const TimeoutRetryPolicySnapshot> policies;
+	string path;
+	// Policy of the operation on the path, looked up in [policies] once.
+	optional_ptr<const OperationPolicy> operation_policy;
+	// Timeout override in milliseconds, 0 means not set.
+	uint64_t timeout_override_ms = 0;
+	bool has_inner_retries_override = false;
+	uint64_t inner_retries_override = 0;
+	unordered_map<string, Value> setting_overrides;
 
 	// Util to get per-operation timeout setting name
 	string GetTimeoutSettingName() const;
 	// Util to get per-operation retry setting name
 	string GetRetrySettingName() const;
+	// Whether the operation is a handle-level read or write.
+	bool IsHandleOperation() const;
+	// Get the setting from inner opener, return false if it's not found or NULL.
+	bool TryGetNonNullSetting(const string &key, Value &result, FileOpenerInfo &info);
+	// Get per-operation setting [setting_name], where reads and writes fall back to [file_operation_setting_name];
+	// return false if it's not set.
+	bool TryGetOperationSetting(const string &setting_name, const string &file_operation_setting_name, Value &result,
+	                            FileOpenerInfo &info);
+	// Get per-operation timeout (in milliseconds) or retry setting, return false if it's not set.
+	bool TryGetOperationTimeoutSetting(Value &result, FileOpenerInfo &info);
+	bool TryGetOperationRetrySetting(Value &result, FileOpenerInfo &info);
+	// Get per-operation retry wait (in milliseconds), retry backoff or max retry wait setting, return false if it's
+	// not set.
+	bool TryGetOperationRetryWaitSetting(Value &result, FileOpenerInfo &info);
+	bool TryGetOperationRetryBackoffSetting(Value &result, FileOpenerInfo &info);
+	bool TryGetOperationRetryMaxWaitSetting(Value &result, FileOpenerInfo &info);
 };
 
 } // namespace duckdb
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "duckdb/common/array.hpp"
+#include "duckdb/common/atomic.hpp"
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/vector.hpp"
+#include "endpoint_registry.hpp"
+#include "latency_histogram.hpp"
+#include "timeout_retry_file_opener.hpp"
+
+namespace duckdb {
+
+// Point-in-time view of metrics for one (operation type, endpoint) pair.
+struct OperationMetricsSnapshot {
+	HttpfsOperationType operation_type;
+	string endpoint;
+	uint64_t requests = 0;
+	uint64_t errors = 0;
+	uint64_t timeouts = 0;
+	uint64_t retries = 0;
+	uint64_t retry_budget_exhausted = 0;
+	uint64_t circuit_breaker_rejected = 0;
+	uint64_t hedged_requests = 0;
+	uint64_t deduplicated_requests = 0;
+	uint64_t queued_requests = 0;
+	uint64_t queue_wait_us = 0;
+	uint64_t bytes = 0;
+	uint64_t latency_p50_us = 0;
+	uint64_t latency_p90_us = 0;
+	uint64_t latency_p99_us = 0;
+	uint64_t latency_max_us = 0;
+};
+
+// OperationMetrics records requests for one (operation type, endpoint) pair.
+// Counters are sharded by thread, so concurrent recording from IO threads doesn't contend on the same atomics.
+class OperationMetrics {
+public:
+	OperationMetrics(HttpfsOperationType operation_type_p, string endpoint_p);
+
+public:
+	// Record a successful request, with the number of bytes transferred.
+	void RecordSuccess(uint64_t latency_us, idx_t bytes = 0);
+	// Record a failed request.
+	void RecordError(uint64_t latency_us, bool is_timeout);
+	// Record a retry issued by the wrapper.
+	void RecordRetry();
+	// Record a failed request which wasn't retried because the retry budget was exhausted.
+	void RecordRetryBudgetExhausted();
+	// Record a request which wasn't sent because the circuit breaker was open.
+	void RecordCircuitBreakerRejected();
+	// Record an extra request issued for hedging.
+	void RecordHedgedRequest();
+	// Record an operation which shared the result of an identical in-flight request instead of sending its own.
+	void RecordDeduplicatedRequest();
+	// Record a request which waited for a slot of the endpoint concurrency limiter.
+	void RecordQueueWait(uint64_t wait_us);
+
+	HttpfsOperationType GetOperationType() const {
+		return operation_type;
+	}
+
+	OperationMetricsSnapshot GetSnapshot() const;
+	void Reset();
+
+private:
+	static constexpr idx_t SHARD_COUNT = 16;
+
+	// Histogram buckets in each shard keep the counters of neighbouring shards well apart on different cache lines.
+	struct MetricsShard {
+		atomic<uint64_t> requests {0};
+		atomic<uint64_t> errors {0};
+		atomic<uint64_t> timeouts {0};
+		atomic<uint64_t> retries {0};
+		atomic<uint64_t> retry_budget_exhausted {0};
+		atomic<uint64_t> circuit_breaker_rejected {0};
+		atomic<uint64_t> hedged_requests {0};
+		atomic<uint64_t> deduplicated_requests {0};
+		atomic<uint64_t> queued_requests {0};
+		atomic<uint64_t> queue_wait_us {0};
+		atomic<uint64_t> bytes {0};
+		atomic<uint64_t> latency_max_us {0};
+		LatencyHistogram latency_histogram;
+	};
+
+	MetricsShard &GetShard();
+	void RecordLatency(MetricsShard &shard, uint64_t latency_us);
+
+private:
+	const HttpfsOperationType operation_type;
+	const string endpoint;
+	array<MetricsShard, SHARD_COUNT> shards;
+};
+
+// TimeoutRetryMetrics is the process-wide registry of operation metrics.
+class TimeoutRetryMetrics {
+public:
+	static TimeoutRetryMetrics &GetInstance();
+
+public:
+	// Get metrics for the given operation and endpoint, which stay valid for the lifetime of the process.
+	OperationMetrics &GetOperationMetrics(HttpfsOperationType operation_type, const string &endpoint);
+	// Get snapshot of all metrics, ordered by endpoint and operation type.
+	vector<OperationMetricsSnapshot> GetSnapshots() const;
+	// Reset all metrics to zero.
+	void Reset();
+
+private:
+	TimeoutRetryMetrics() = default;
+
+private:
+	EndpointRegistry<OperationMetrics> registry;
+};
+
+} // namespace duckdb
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "duckdb/common/array.hpp"
+#include "duckdb/common/enums/set_scope.hpp"
+#include "duckdb/common/file_opener.hpp"
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/shared_ptr.hpp"
+#include "duckdb/common/vector.hpp"
+#include "adaptive_timeout.hpp"
+#include "block_cache.hpp"
+#include "fault_injection.hpp"
+#include "listing_cache.hpp"
+#include "metadata_cache.hpp"
+#include "prefix_policy_override.hpp"
+#include "retry_policy.hpp"
+#include "timeout_retry_file_handle.hpp"
+#include "timeout_retry_file_opener.hpp"
+
+namespace duckdb {
+
+class ClientContext;
+
+// Timeout and retry policy of one operation type, resolved from settings.
+struct OperationPolicy {
+	// Whether the per-operation timeout or http_timeout is set.
+	bool has_timeout = false;
+	// Effective timeout in milliseconds.
+	uint64_t timeout_ms = 0;
+	// Whether the per-operation retries or http_retries is set.
+	bool has_retries = false;
+	// Effective retry config, including retry budget, circuit breaker and concurrency limit.
+	RetryConfig retry;
+};
+
+// Upload settings of files opened for writing, which are translated into uploader settings of the inner filesystem.
+struct UploadConfig {
+	// Size of each part of a multipart upload, in bytes; 0 means not configured.
+	uint64_t part_size = 0;
+	// Number of parts uploaded concurrently; 0 means not configured.
+	uint64_t concurrency = 0;
+	// Timeout and retries of each part, which take precedence over write settings.
+	bool has_part_timeout = false;
+	uint64_t part_timeout_ms = 0;
+	bool has_part_retries = false;
+	uint64_t part_retries = 0;
+};
+
+// Policies of all operation types, resolved together from one version of the settings.
+struct TimeoutRetryPolicySnapshot {
+	// Version of settings the policies are resolved from.
+	uint64_t settings_version = 0;
+	array<OperationPolicy, HTTPFS_OPERATION_TYPE_COUNT> operations;
+	// Policies of paths under prefixes with policy overrides, indexed by the values of [prefix_trie].
+	vector<array<OperationPolicy, HTTPFS_OPERATION_TYPE_COUNT>> prefix_operations;
+	PrefixTrie prefix_trie;
+	// Other settings looked up by every operation, which are part of the snapshot so operations don't look them up.
+	FaultInjectionConfig fault_injection;
+	AdaptiveTimeoutConfig adaptive_timeout;
+	MetadataCacheConfig metadata_cache;
+	ListingCacheConfig listing_cache;
+	bool single_flight = false;
+	// Settings of file handles opened for reading (hedging, read-ahead, coalescing and parallel reads); timeouts and
+	// retries of the handle are resolved at open, since they depend on the path.
+	TimeoutRetryHandleConfig handle;
+	UploadConfig upload;
+	BlockCacheConfig block_cache;
+	// Number of concurrent requests of batched deletes and partition-aware globs; 0 means disabled.
+	idx_t delete_parallelism = 0;
+	idx_t glob_parallelism = 0;
+
+	const OperationPolicy &GetOperationPolicy(HttpfsOperationType operation_type) const {
+		return operations[static_cast<idx_t>(operation_type)];
+	}
+	// Get the policy of [operation_type] on [path], which takes the overrides of the longest prefix of the path.
+	const OperationPolicy &GetOperationPolicy(HttpfsOperationType operation_type, const string &path) const {
+		if (!prefix_operations.empty()) {
+			const auto prefix_index = prefix_trie.FindLongestPrefix(path);
+			if (prefix_index != PrefixTrie::NOT_FOUND) {
+				return prefix_operations[prefix_index][static_cast<idx_t>(operation_type)];
+			}
+		}
+		return GetOperationPolicy(operation_type);
+	}
+};
+
+// Resolve policies of all operation types from the settings visible to [opener].
+shared_ptr<const TimeoutRetryPolicySnapshot> ResolveTimeoutRetryPolicies(FileOpener &opener);
+
+// Get version of settings, which is bumped whenever one of them is set or reset.
+uint64_t GetPolicySettingsVersion();
+void BumpPolicySettingsVersion();
+// Setting callback installed on all extension settings, which bumps the settings version once the statement setting
+// them completes.
+void OnPolicySettingChanged(ClientContext &context, SetScope scope, Value &parameter);
+
+// TimeoutRetryPolicyCache keeps the policy snapshot of one source of settings, i.e. a connection or the database, so
+// operations don't resolve dozens of settings each. The snapshot is re-resolved once the settings version changes.
+//
+// Setting callbacks run before the new value is stored, and don't tell which setting is changed, so the version is
+// bumped at the end of the statement, once the value is stored. The httpfs settings which per-operation settings fall
+// back to (http_timeout, http_retries, http_retry_wait_ms and http_retry_backoff) come without change notification;
+// each connection compares them at the end of each query instead, and bumps the version if any differs.
+class TimeoutRetryPolicyCache {
+public:
+	shared_ptr<const TimeoutRetryPolicySnapshot> Get(FileOpener &opener);
+
+private:
+	mutex cache_mutex;
+	shared_ptr<const TimeoutRetryPolicySnapshot> snapshot;
+};
+
+// Get the policy cache of the connection, which lives as long as the client context.
+TimeoutRetryPolicyCache &GetClientPolicyCache(ClientContext &context);
+
+} // namespace duckdb
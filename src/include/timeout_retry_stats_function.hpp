@@ -0,0 +1,14 @@
+#pragma once
+
+#include "duckdb/function/scalar_function.hpp"
+#include "duckdb/function/table_function.hpp"
+
+namespace duckdb {
+
+// Table function which returns per-operation, per-endpoint request metrics.
+TableFunction GetTimeoutRetryStatsFunction();
+
+// Scalar function which resets all request metrics.
+ScalarFunction GetTimeoutRetryStatsResetFunction();
+
+} // namespace duckdb
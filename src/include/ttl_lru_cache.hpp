@@ -0,0 +1,108 @@
+#pragma once
+
+#include "duckdb/common/list.hpp"
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/unordered_map.hpp"
+
+#include <chrono>
+#include <utility>
+
+namespace duckdb {
+
+// TtlLruCache is a thread-safe string-keyed cache, whose entries expire after a time-to-live, and the least recently
+// used entries are evicted once the max entry count is exceeded. TTL and capacity are passed in on each access, so
+// they follow setting changes without rebuilding the cache.
+template <class V>
+class TtlLruCache {
+public:
+	using time_point = std::chrono::steady_clock::time_point;
+
+	// Get the value for [key] if it's cached no longer than [ttl_ms] ago, return false otherwise.
+	bool TryGet(const string &key, uint64_t ttl_ms, V &value) {
+		return TryGet(key, ttl_ms, value, std::chrono::steady_clock::now());
+	}
+	bool TryGet(const string &key, uint64_t ttl_ms, V &value, time_point now) {
+		lock_guard<mutex> lck(cache_mutex);
+		auto iter = entries.find(key);
+		if (iter == entries.end()) {
+			return false;
+		}
+		auto entry = iter->second;
+		if (now - entry->inserted_at >= std::chrono::milliseconds(ttl_ms)) {
+			lru_list.erase(entry);
+			entries.erase(iter);
+			return false;
+		}
+		lru_list.splice(lru_list.begin(), lru_list, entry);
+		value = entry->value;
+		return true;
+	}
+
+	// Insert or overwrite the value for [key], and evict least recently used entries beyond [max_entries].
+	void Put(const string &key, V value, idx_t max_entries) {
+		Put(key, std::move(value), max_entries, std::chrono::steady_clock::now());
+	}
+	void Put(const string &key, V value, idx_t max_entries, time_point now) {
+		lock_guard<mutex> lck(cache_mutex);
+		auto iter = entries.find(key);
+		if (iter != entries.end()) {
+			lru_list.erase(iter->second);
+			entries.erase(iter);
+		}
+		lru_list.emplace_front(Entry {key, std::move(value), now});
+		entries[key] = lru_list.begin();
+		while (entries.size() > max_entries) {
+			entries.erase(lru_list.back().key);
+			lru_list.pop_back();
+		}
+	}
+
+	void Erase(const string &key) {
+		lock_guard<mutex> lck(cache_mutex);
+		auto iter = entries.find(key);
+		if (iter == entries.end()) {
+			return;
+		}
+		lru_list.erase(iter->second);
+		entries.erase(iter);
+	}
+
+	// Erase all entries whose key starts with [prefix], which takes time linear to the cache size.
+	void EraseByPrefix(const string &prefix) {
+		lock_guard<mutex> lck(cache_mutex);
+		for (auto entry = lru_list.begin(); entry != lru_list.end();) {
+			if (entry->key.compare(0, prefix.size(), prefix) == 0) {
+				entries.erase(entry->key);
+				entry = lru_list.erase(entry);
+			} else {
+				++entry;
+			}
+		}
+	}
+
+	void Clear() {
+		lock_guard<mutex> lck(cache_mutex);
+		entries.clear();
+		lru_list.clear();
+	}
+
+	idx_t Size() const {
+		lock_guard<mutex> lck(cache_mutex);
+		return entries.size();
+	}
+
+private:
+	struct Entry {
+		string key;
+		V value;
+		time_point inserted_at;
+	};
+
+	mutable mutex cache_mutex;
+	// Entries ordered from most to least recently used.
+	list<Entry> lru_list;
+	unordered_map<string, typename list<Entry>::iterator> entries;
+};
+
+} // namespace duckdb
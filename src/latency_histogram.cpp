@@ -0,0 +1,89 @@
+#include "latency_histogram.hpp"
+
+#include "duckdb/common/exception.hpp"
+
+#include <cmath>
+
+namespace duckdb {
+
+namespace {
+
+// Index of the most significant set bit, [value] must be non-zero.
+idx_t GetMostSignificantBit(uint64_t value) {
+	D_ASSERT(value != 0);
+	idx_t msb = 0;
+	while (value >>= 1) {
+		++msb;
+	}
+	return msb;
+}
+
+} // namespace
+
+LatencyHistogram::LatencyHistogram() {
+	Reset();
+}
+
+void LatencyHistogram::Record(uint64_t latency_us) {
+	buckets[GetBucketIndex(latency_us)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::MergeInto(vector<uint64_t> &bucket_counts) const {
+	D_ASSERT(bucket_counts.size() == BUCKET_COUNT);
+	for (idx_t idx = 0; idx < BUCKET_COUNT; ++idx) {
+		bucket_counts[idx] += buckets[idx].load(std::memory_order_relaxed);
+	}
+}
+
+void LatencyHistogram::Reset() {
+	for (auto &bucket : buckets) {
+		bucket.store(0, std::memory_order_relaxed);
+	}
+}
+
+idx_t LatencyHistogram::GetBucketIndex(uint64_t latency_us) {
+	// Small values get one bucket each.
+	if (latency_us < SUB_BUCKET_COUNT) {
+		return latency_us;
+	}
+	const idx_t msb = GetMostSignificantBit(latency_us);
+	const idx_t shift = msb - SUB_BUCKET_BITS;
+	const idx_t sub_bucket = (latency_us >> shift) & (SUB_BUCKET_COUNT - 1);
+	return (shift + 1) * SUB_BUCKET_COUNT + sub_bucket;
+}
+
+uint64_t LatencyHistogram::GetBucketUpperBound(idx_t bucket_index) {
+	D_ASSERT(bucket_index < BUCKET_COUNT);
+	if (bucket_index < SUB_BUCKET_COUNT) {
+		return bucket_index;
+	}
+	const idx_t shift = bucket_index / SUB_BUCKET_COUNT - 1;
+	const idx_t sub_bucket = bucket_index % SUB_BUCKET_COUNT;
+	const uint64_t lower_bound = (static_cast<uint64_t>(SUB_BUCKET_COUNT + sub_bucket)) << shift;
+	return lower_bound + ((static_cast<uint64_t>(1) << shift) - 1);
+}
+
+uint64_t LatencyHistogram::GetPercentile(const vector<uint64_t> &bucket_counts, double percentile) {
+	D_ASSERT(bucket_counts.size() == BUCKET_COUNT);
+	D_ASSERT(percentile > 0 && percentile <= 1);
+	uint64_t total = 0;
+	for (const auto count : bucket_counts) {
+		total += count;
+	}
+	if (total == 0) {
+		return 0;
+	}
+
+	// Nearest-rank percentile.
+	const auto rank = static_cast<uint64_t>(std::ceil(percentile * static_cast<double>(total)));
+	uint64_t cumulative = 0;
+	for (idx_t idx = 0; idx < BUCKET_COUNT; ++idx) {
+		cumulative += bucket_counts[idx];
+		if (cumulative >= rank) {
+			return GetBucketUpperBound(idx);
+		}
+	}
+	return GetBucketUpperBound(BUCKET_COUNT - 1);
+}
+
+} // namespace duckdb
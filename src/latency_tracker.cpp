@@ -0,0 +1,80 @@
+#include "latency_tracker.hpp"
+
+#include "duckdb/common/algorithm.hpp"
+#include "duckdb/common/exception.hpp"
+
+#include <cmath>
+
+namespace duckdb {
+
+namespace {
+
+// Upper bounds of read size classes, except for the last one which holds all larger reads.
+constexpr idx_t SIZE_CLASS_MAX_BYTES[] = {64 * 1024, 1024 * 1024, 16 * 1024 * 1024};
+
+} // namespace
+
+LatencyTracker::LatencyTracker(idx_t capacity) : samples(capacity, 0) {
+	D_ASSERT(capacity > 0);
+}
+
+void LatencyTracker::Record(uint64_t latency_us) {
+	lock_guard<mutex> lck(latency_mutex);
+	samples[next_index] = latency_us;
+	next_index = (next_index + 1) % samples.size();
+	sample_count = MinValue<idx_t>(sample_count + 1, samples.size());
+}
+
+bool LatencyTracker::TryGetPercentile(double percentile, idx_t min_samples, uint64_t &latency_us) const {
+	D_ASSERT(percentile > 0 && percentile <= 1);
+	vector<uint64_t> window;
+	{
+		lock_guard<mutex> lck(latency_mutex);
+		if (sample_count == 0 || sample_count < min_samples) {
+			return false;
+		}
+		window.assign(samples.begin(), samples.begin() + sample_count);
+	}
+
+	// Nearest-rank percentile.
+	idx_t rank = static_cast<idx_t>(std::ceil(percentile * static_cast<double>(window.size())));
+	rank = MinValue<idx_t>(MaxValue<idx_t>(rank, 1), window.size()) - 1;
+	std::nth_element(window.begin(), window.begin() + rank, window.end());
+	latency_us = window[rank];
+	return true;
+}
+
+idx_t LatencyTracker::GetSampleCount() const {
+	lock_guard<mutex> lck(latency_mutex);
+	return sample_count;
+}
+
+//===--------------------------------------------------------------------===//
+// ReadLatencyTrackers
+//===--------------------------------------------------------------------===//
+
+idx_t ReadLatencyTrackers::GetSizeClass(idx_t nr_bytes) {
+	idx_t size_class = 0;
+	for (const auto max_bytes : SIZE_CLASS_MAX_BYTES) {
+		if (nr_bytes <= max_bytes) {
+			return size_class;
+		}
+		++size_class;
+	}
+	return size_class;
+}
+
+LatencyTracker &ReadLatencyTrackers::GetTracker(idx_t nr_bytes) {
+	return trackers[GetSizeClass(nr_bytes)];
+}
+
+ReadLatencyTrackerRegistry &ReadLatencyTrackerRegistry::GetInstance() {
+	static ReadLatencyTrackerRegistry registry;
+	return registry;
+}
+
+ReadLatencyTrackers &ReadLatencyTrackerRegistry::GetReadLatencyTrackers(const string &endpoint) {
+	return registry.GetOrCreate(endpoint);
+}
+
+} // namespace duckdb
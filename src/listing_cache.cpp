@@ -0,0 +1,264 @@
+#include "listing_cache.hpp"
+
+#include "duckdb/common/helper.hpp"
+#include "duckdb/common/shared_ptr.hpp"
+#include "httpfs_timeout_retry_settings.hpp"
+
+#include <iterator>
+#include <utility>
+
+namespace duckdb {
+
+namespace {
+
+constexpr idx_t DEFAULT_LISTING_CACHE_MAX_MEMORY_MB = 64;
+constexpr idx_t BYTES_PER_MB = 1024 * 1024;
+
+// Rough per-entry and per-option overhead for memory estimation, covering list, map and trie bookkeeping.
+constexpr idx_t ENTRY_OVERHEAD_BYTES = 256;
+constexpr idx_t EXTENDED_OPTION_BYTES = 96;
+
+bool IsWildcardSegment(const string &segment) {
+	return segment.find_first_of("*?[") != string::npos;
+}
+
+// Split [path] into segments separated by '/', ignoring trailing separators.
+vector<string> SplitPathSegments(const string &path) {
+	vector<string> segments;
+	idx_t end = path.size();
+	while (end > 0 && path[end - 1] == '/') {
+		--end;
+	}
+	if (end == 0) {
+		return segments;
+	}
+	idx_t start = 0;
+	while (true) {
+		const auto separator = path.find('/', start);
+		if (separator == string::npos || separator >= end) {
+			segments.emplace_back(path.substr(start, end - start));
+			return segments;
+		}
+		segments.emplace_back(path.substr(start, separator - start));
+		start = separator + 1;
+	}
+}
+
+string GetEntryKey(ListingKind kind, const string &path) {
+	return (kind == ListingKind::GLOB ? "glob:" : "list:") + path;
+}
+
+idx_t EstimateMemoryBytes(const string &key, const vector<OpenFileInfo> &result) {
+	idx_t bytes = ENTRY_OVERHEAD_BYTES + key.size();
+	for (const auto &info : result) {
+		bytes += sizeof(OpenFileInfo) + info.path.size();
+		if (info.extended_info) {
+			bytes += info.extended_info->options.size() * EXTENDED_OPTION_BYTES;
+		}
+	}
+	return bytes;
+}
+
+// Callers could modify extended info of listed entries, which mustn't leak into or out of the cache.
+void DetachExtendedInfo(vector<OpenFileInfo> &result) {
+	for (auto &info : result) {
+		if (info.extended_info) {
+			info.extended_info = make_shared_ptr<ExtendedOpenFileInfo>(*info.extended_info);
+		}
+	}
+}
+
+} // namespace
+
+ListingCacheConfig GetListingCacheConfig(FileOpener &opener) {
+	ListingCacheConfig config;
+	Value value;
+	if (!FileOpener::TryGetCurrentSetting(&opener, HTTPFS_LIST_CACHE_TTL_MS, value) || value.IsNull()) {
+		return config;
+	}
+	config.ttl_ms = value.GetValue<uint64_t>();
+	config.enabled = config.ttl_ms > 0;
+	config.max_memory_bytes = DEFAULT_LISTING_CACHE_MAX_MEMORY_MB * BYTES_PER_MB;
+	if (FileOpener::TryGetCurrentSetting(&opener, HTTPFS_LIST_CACHE_MAX_MEMORY_MB, value) && !value.IsNull()) {
+		config.max_memory_bytes = value.GetValue<uint64_t>() * BYTES_PER_MB;
+	}
+	return config;
+}
+
+string ListingCache::GetNonWildcardPrefix(const string &pattern) {
+	string prefix;
+	bool first = true;
+	for (const auto &segment : SplitPathSegments(pattern)) {
+		if (IsWildcardSegment(segment)) {
+			break;
+		}
+		if (!first) {
+			prefix += '/';
+		}
+		prefix += segment;
+		first = false;
+	}
+	return prefix;
+}
+
+bool ListingCache::TryGet(ListingKind kind, const string &path, const ListingCacheConfig &config,
+                          vector<OpenFileInfo> &result) {
+	return TryGet(kind, path, config, result, std::chrono::steady_clock::now());
+}
+
+bool ListingCache::TryGet(ListingKind kind, const string &path, const ListingCacheConfig &config,
+                          vector<OpenFileInfo> &result, time_point now) {
+	lock_guard<mutex> lck(cache_mutex);
+	auto node = FindNode(GetNonWildcardPrefix(path));
+	if (node == nullptr) {
+		return false;
+	}
+	auto iter = node->entries.find(GetEntryKey(kind, path));
+	if (iter == node->entries.end()) {
+		return false;
+	}
+	auto entry = iter->second;
+	if (now - entry->inserted_at >= std::chrono::milliseconds(config.ttl_ms)) {
+		EraseEntry(entry);
+		PruneNode(node);
+		return false;
+	}
+	lru_list.splice(lru_list.begin(), lru_list, entry);
+
+	result = entry->result;
+	DetachExtendedInfo(result);
+	return true;
+}
+
+void ListingCache::Put(ListingKind kind, const string &path, const ListingCacheConfig &config,
+                       vector<OpenFileInfo> result) {
+	Put(kind, path, config, std::move(result), std::chrono::steady_clock::now());
+}
+
+void ListingCache::Put(ListingKind kind, const string &path, const ListingCacheConfig &config,
+                       vector<OpenFileInfo> result, time_point now) {
+	auto key = GetEntryKey(kind, path);
+	const auto entry_bytes = EstimateMemoryBytes(key, result);
+	DetachExtendedInfo(result);
+	lock_guard<mutex> lck(cache_mutex);
+	auto &node = GetOrCreateNode(GetNonWildcardPrefix(path));
+	auto iter = node.entries.find(key);
+	if (iter != node.entries.end()) {
+		EraseEntry(iter->second);
+	}
+	// Listings larger than the whole budget would only evict everything else.
+	if (entry_bytes > config.max_memory_bytes) {
+		PruneNode(&node);
+		return;
+	}
+	lru_list.emplace_front(Entry {&node, key, std::move(result), now, entry_bytes});
+	node.entries[std::move(key)] = lru_list.begin();
+	memory_bytes += entry_bytes;
+	while (memory_bytes > config.max_memory_bytes) {
+		auto victim = std::prev(lru_list.end());
+		auto victim_node = victim->node;
+		EraseEntry(victim);
+		PruneNode(victim_node);
+	}
+}
+
+void ListingCache::Invalidate(const string &path) {
+	lock_guard<mutex> lck(cache_mutex);
+	InvalidateInternal(path, /*recursive=*/false);
+}
+
+void ListingCache::InvalidateRecursive(const string &path) {
+	lock_guard<mutex> lck(cache_mutex);
+	InvalidateInternal(path, /*recursive=*/true);
+}
+
+idx_t ListingCache::Size() const {
+	lock_guard<mutex> lck(cache_mutex);
+	return lru_list.size();
+}
+
+idx_t ListingCache::GetMemoryBytes() const {
+	lock_guard<mutex> lck(cache_mutex);
+	return memory_bytes;
+}
+
+ListingCache::TrieNode *ListingCache::FindNode(const string &prefix) {
+	auto node = &root;
+	for (const auto &segment : SplitPathSegments(prefix)) {
+		auto child = node->children.find(segment);
+		if (child == node->children.end()) {
+			return nullptr;
+		}
+		node = child->second.get();
+	}
+	return node;
+}
+
+ListingCache::TrieNode &ListingCache::GetOrCreateNode(const string &prefix) {
+	auto node = &root;
+	for (auto &segment : SplitPathSegments(prefix)) {
+		auto &child = node->children[segment];
+		if (child == nullptr) {
+			child = make_uniq<TrieNode>();
+			child->parent = node;
+			child->segment = std::move(segment);
+		}
+		node = child.get();
+	}
+	return *node;
+}
+
+void ListingCache::EraseEntry(list<Entry>::iterator entry) {
+	entry->node->entries.erase(entry->key);
+	memory_bytes -= entry->memory_bytes;
+	lru_list.erase(entry);
+}
+
+void ListingCache::PruneNode(TrieNode *node) {
+	while (node != &root && node->entries.empty() && node->children.empty()) {
+		auto parent = node->parent;
+		// Destroys [node].
+		parent->children.erase(node->segment);
+		node = parent;
+	}
+}
+
+void ListingCache::EraseSubtree(TrieNode &node) {
+	while (!node.entries.empty()) {
+		EraseEntry(node.entries.begin()->second);
+	}
+	for (auto &child : node.children) {
+		EraseSubtree(*child.second);
+	}
+	node.children.clear();
+}
+
+void ListingCache::InvalidateInternal(const string &path, bool recursive) {
+	// Listings at the ancestors of [path] could include it; listings of [path] itself could be for a single file or
+	// for the directory, which are both affected.
+	auto node = &root;
+	bool reached = true;
+	for (const auto &segment : SplitPathSegments(path)) {
+		while (!node->entries.empty()) {
+			EraseEntry(node->entries.begin()->second);
+		}
+		auto child = node->children.find(segment);
+		if (child == node->children.end()) {
+			reached = false;
+			break;
+		}
+		node = child->second.get();
+	}
+	if (reached) {
+		if (recursive) {
+			EraseSubtree(*node);
+		} else {
+			while (!node->entries.empty()) {
+				EraseEntry(node->entries.begin()->second);
+			}
+		}
+	}
+	PruneNode(node);
+}
+
+} // namespace duckdb
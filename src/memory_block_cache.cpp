@@ -0,0 +1,140 @@
+#include "memory_block_cache.hpp"
+
+#include "duckdb/common/helper.hpp"
+#include "duckdb/common/types/hash.hpp"
+
+#include <cstring>
+
+namespace duckdb {
+
+namespace {
+
+hash_t GetBlockHash(const BlockCacheFileHashes &file_key, idx_t block_index) {
+	// The file key is a hash already.
+	return CombineHash(file_key.first, Hash(block_index));
+}
+
+} // namespace
+
+size_t MemoryBlockCache::BlockKeyHash::operator()(const BlockKey &key) const {
+	return static_cast<size_t>(GetBlockHash(key.file_key, key.block_index));
+}
+
+void MemoryBlockCache::Configure(idx_t block_size, idx_t max_bytes) {
+	lock_guard<mutex> configure_lck(configure_mutex);
+	if (block_size == configured_block_size && max_bytes == configured_max_bytes) {
+		return;
+	}
+	const idx_t total_slots = block_size == 0 ? 0 : max_bytes / block_size;
+	// Every shard in use gets at least one slot, otherwise blocks hashed to a shard without slots would never be
+	// cached; small budgets use fewer shards instead of being rounded up.
+	const idx_t new_shard_count = MaxValue<idx_t>(MinValue<idx_t>(total_slots, SHARD_COUNT), 1);
+	for (idx_t shard_index = 0; shard_index < SHARD_COUNT; ++shard_index) {
+		auto &shard = shards[shard_index];
+		// Spread the remainder over the first shards, so the whole budget is usable.
+		idx_t slot_count = 0;
+		if (shard_index < new_shard_count) {
+			slot_count = total_slots / new_shard_count + (shard_index < total_slots % new_shard_count ? 1 : 0);
+		}
+		lock_guard<mutex> lck(shard.shard_mutex);
+		shard.lru_list.clear();
+		shard.entries.clear();
+		shard.slab.reset();
+		shard.block_size = block_size;
+		shard.slot_count = slot_count;
+		// Pages are only committed by the OS once touched, so an unused budget doesn't take physical memory.
+		if (slot_count > 0) {
+			shard.slab = make_unsafe_uniq_array_uninitialized<data_t>(slot_count * block_size);
+		}
+		shard.free_slots.clear();
+		shard.free_slots.reserve(slot_count);
+		for (idx_t slot_index = slot_count; slot_index > 0; --slot_index) {
+			shard.free_slots.emplace_back(slot_index - 1);
+		}
+	}
+	// Lookups racing with reconfiguration could pick a shard by the previous count, and only miss.
+	shard_count = new_shard_count;
+	configured_block_size = block_size;
+	configured_max_bytes = max_bytes;
+}
+
+MemoryBlockCache::Shard &MemoryBlockCache::GetShard(const BlockKey &block_key) {
+	// Pick the shard by other bits than the hash map of the shard uses.
+	return shards[(GetBlockHash(block_key.file_key, block_key.block_index) >> 32) % shard_count.load()];
+}
+
+const MemoryBlockCache::Shard &MemoryBlockCache::GetShard(const BlockKey &block_key) const {
+	return shards[(GetBlockHash(block_key.file_key, block_key.block_index) >> 32) % shard_count.load()];
+}
+
+bool MemoryBlockCache::TryRead(const BlockCacheFileHashes &file_key, idx_t block_index, idx_t block_bytes,
+                               idx_t offset, data_ptr_t buffer, idx_t nr_bytes) {
+	D_ASSERT(offset + nr_bytes <= block_bytes);
+	const BlockKey block_key {file_key, block_index};
+	auto &shard = GetShard(block_key);
+	lock_guard<mutex> lck(shard.shard_mutex);
+	auto iter = shard.entries.find(block_key);
+	if (iter == shard.entries.end() || iter->second->nr_bytes != block_bytes) {
+		return false;
+	}
+	auto entry = iter->second;
+	shard.lru_list.splice(shard.lru_list.begin(), shard.lru_list, entry);
+	memcpy(buffer, shard.slab.get() + entry->slot_index * shard.block_size + offset, nr_bytes);
+	return true;
+}
+
+bool MemoryBlockCache::Contains(const BlockCacheFileHashes &file_key, idx_t block_index) const {
+	const BlockKey block_key {file_key, block_index};
+	const auto &shard = GetShard(block_key);
+	lock_guard<mutex> lck(shard.shard_mutex);
+	return shard.entries.find(block_key) != shard.entries.end();
+}
+
+void MemoryBlockCache::Write(const BlockCacheFileHashes &file_key, idx_t block_index, const_data_ptr_t buffer,
+                             idx_t nr_bytes) {
+	const BlockKey block_key {file_key, block_index};
+	auto &shard = GetShard(block_key);
+	lock_guard<mutex> lck(shard.shard_mutex);
+	// Blocks of a different size belong to a previous configuration (the file key includes the block size).
+	if (shard.slot_count == 0 || nr_bytes > shard.block_size) {
+		return;
+	}
+	idx_t slot_index;
+	auto iter = shard.entries.find(block_key);
+	if (iter != shard.entries.end()) {
+		slot_index = iter->second->slot_index;
+		shard.lru_list.erase(iter->second);
+		shard.entries.erase(iter);
+	} else if (!shard.free_slots.empty()) {
+		slot_index = shard.free_slots.back();
+		shard.free_slots.pop_back();
+	} else {
+		auto &victim = shard.lru_list.back();
+		slot_index = victim.slot_index;
+		shard.entries.erase(victim.block_key);
+		shard.lru_list.pop_back();
+	}
+	memcpy(shard.slab.get() + slot_index * shard.block_size, buffer, nr_bytes);
+	shard.lru_list.emplace_front(SlotEntry {block_key, slot_index, nr_bytes});
+	shard.entries[block_key] = shard.lru_list.begin();
+}
+
+idx_t MemoryBlockCache::GetBlockCount() const {
+	idx_t block_count = 0;
+	for (const auto &shard : shards) {
+		lock_guard<mutex> lck(shard.shard_mutex);
+		block_count += shard.entries.size();
+	}
+	return block_count;
+}
+
+idx_t MemoryBlockCache::GetSlotCount() const {
+	idx_t slot_count = 0;
+	for (const auto &shard : shards) {
+		lock_guard<mutex> lck(shard.shard_mutex);
+		slot_count += shard.slot_count;
+	}
+	return slot_count;
+}
+
+} // namespace duckdb
@@ -0,0 +1,138 @@
+#include "metadata_cache.hpp"
+
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/helper.hpp"
+#include "httpfs_timeout_retry_settings.hpp"
+
+namespace duckdb {
+
+namespace {
+
+constexpr idx_t DEFAULT_METADATA_CACHE_MAX_ENTRIES = 16384;
+
+// Keys of extended open file info, which are filled in by listing, and consumed by HTTP file handles on open.
+constexpr const char *FILE_SIZE_KEY = "file_size";
+constexpr const char *LAST_MODIFIED_KEY = "last_modified";
+constexpr const char *ETAG_KEY = "etag";
+
+// Directory paths are compared with and without trailing separator.
+string TrimTrailingSlash(const string &path) {
+	if (path.size() > 1 && path.back() == '/') {
+		return path.substr(0, path.size() - 1);
+	}
+	return path;
+}
+
+} // namespace
+
+CachedFileMetadata GetFileHandleMetadata(FileHandle &handle) {
+	auto &fs = handle.file_system;
+	CachedFileMetadata metadata;
+	metadata.exists = true;
+	metadata.has_file_info = true;
+	metadata.file_size = static_cast<idx_t>(fs.GetFileSize(handle));
+	metadata.last_modified = fs.GetLastModifiedTime(handle);
+	metadata.etag = fs.GetVersionTag(handle);
+	return metadata;
+}
+
+void AttachFileInfo(OpenFileInfo &info, const CachedFileMetadata &metadata) {
+	D_ASSERT(metadata.has_file_info);
+	info.extended_info = make_shared_ptr<ExtendedOpenFileInfo>();
+	auto &options = info.extended_info->options;
+	options[FILE_SIZE_KEY] = Value::UBIGINT(metadata.file_size);
+	options[LAST_MODIFIED_KEY] = Value::TIMESTAMP(metadata.last_modified);
+	options[ETAG_KEY] = Value(metadata.etag);
+}
+
+MetadataCacheConfig GetMetadataCacheConfig(FileOpener &opener) {
+	MetadataCacheConfig config;
+	Value value;
+	if (!FileOpener::TryGetCurrentSetting(&opener, HTTPFS_METADATA_CACHE_TTL_MS, value) || value.IsNull()) {
+		return config;
+	}
+	config.ttl_ms = value.GetValue<uint64_t>();
+	config.enabled = config.ttl_ms > 0;
+	config.max_entries = DEFAULT_METADATA_CACHE_MAX_ENTRIES;
+	if (FileOpener::TryGetCurrentSetting(&opener, HTTPFS_METADATA_CACHE_MAX_ENTRIES, value) && !value.IsNull()) {
+		config.max_entries = value.GetValue<uint64_t>();
+	}
+	return config;
+}
+
+bool MetadataCache::TryGetFile(const string &path, const MetadataCacheConfig &config, CachedFileMetadata &metadata) {
+	return file_cache.TryGet(path, config.ttl_ms, metadata);
+}
+
+void MetadataCache::PutFile(const string &path, const MetadataCacheConfig &config, CachedFileMetadata metadata) {
+	file_cache.Put(path, std::move(metadata), config.max_entries);
+}
+
+void MetadataCache::PutFileExists(const string &path, const MetadataCacheConfig &config, bool exists) {
+	CachedFileMetadata metadata;
+	if (exists && TryGetFile(path, config, metadata) && metadata.exists) {
+		return;
+	}
+	metadata = CachedFileMetadata();
+	metadata.exists = exists;
+	PutFile(path, config, std::move(metadata));
+}
+
+void MetadataCache::PutFileHandle(FileHandle &handle, const MetadataCacheConfig &config) {
+	PutFile(handle.GetPath(), config, GetFileHandleMetadata(handle));
+}
+
+void MetadataCache::PutListingEntry(const OpenFileInfo &info, const MetadataCacheConfig &config) {
+	if (!info.extended_info) {
+		return;
+	}
+	const auto &options = info.extended_info->options;
+	auto file_size = options.find(FILE_SIZE_KEY);
+	auto last_modified = options.find(LAST_MODIFIED_KEY);
+	auto etag = options.find(ETAG_KEY);
+	if (file_size == options.end() || last_modified == options.end() || etag == options.end()) {
+		return;
+	}
+	CachedFileMetadata metadata;
+	metadata.exists = true;
+	metadata.has_file_info = true;
+	metadata.file_size = file_size->second.GetValue<uint64_t>();
+	metadata.last_modified = last_modified->second.GetValue<timestamp_t>();
+	metadata.etag = etag->second.ToString();
+	PutFile(info.path, config, std::move(metadata));
+}
+
+bool MetadataCache::TryGetDirectoryExists(const string &path, const MetadataCacheConfig &config, bool &exists) {
+	return directory_cache.TryGet(TrimTrailingSlash(path), config.ttl_ms, exists);
+}
+
+void MetadataCache::PutDirectoryExists(const string &path, const MetadataCacheConfig &config, bool exists) {
+	directory_cache.Put(TrimTrailingSlash(path), exists, config.max_entries);
+}
+
+void MetadataCache::Invalidate(const string &path) {
+	file_cache.Erase(path);
+	// Creating or removing a file could implicitly create or remove its parent directories on object storage.
+	directory_cache.Clear();
+}
+
+void MetadataCache::InvalidateRecursive(const string &path) {
+	const auto directory = TrimTrailingSlash(path);
+	file_cache.Erase(directory);
+	file_cache.EraseByPrefix(directory + "/");
+	directory_cache.Clear();
+}
+
+bool MetadataCache::TryAttachFileInfo(OpenFileInfo &info, const MetadataCacheConfig &config) {
+	if (info.extended_info) {
+		return false;
+	}
+	CachedFileMetadata metadata;
+	if (!TryGetFile(info.path, config, metadata) || !metadata.has_file_info) {
+		return false;
+	}
+	AttachFileInfo(info, metadata);
+	return true;
+}
+
+} // namespace duckdb
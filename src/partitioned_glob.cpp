@@ -0,0 +1,127 @@
+#include "partitioned_glob.hpp"
+
+namespace duckdb {
+
+namespace {
+
+bool IsWildcardSegment(const string &segment) {
+	return segment.find_first_of("*?[") != string::npos;
+}
+
+// Match [c] against the character class starting at [pattern_pos] (right after '['), and advance [pattern_pos] past
+// the closing ']'; return false for an unterminated class, which then matches '[' literally.
+bool TryMatchCharacterClass(const string &pattern, idx_t &pattern_pos, char c, bool &matched) {
+	idx_t pos = pattern_pos;
+	bool negated = false;
+	if (pos < pattern.size() && (pattern[pos] == '!' || pattern[pos] == '^')) {
+		negated = true;
+		++pos;
+	}
+	matched = false;
+	bool first = true;
+	while (pos < pattern.size() && (first || pattern[pos] != ']')) {
+		first = false;
+		if (pos + 2 < pattern.size() && pattern[pos + 1] == '-' && pattern[pos + 2] != ']') {
+			matched |= c >= pattern[pos] && c <= pattern[pos + 2];
+			pos += 3;
+			continue;
+		}
+		matched |= c == pattern[pos];
+		++pos;
+	}
+	if (pos >= pattern.size()) {
+		return false;
+	}
+	matched = matched != negated;
+	pattern_pos = pos + 1;
+	return true;
+}
+
+} // namespace
+
+bool TrySplitPartitionedGlob(const string &pattern, PartitionedGlob &result) {
+	idx_t segment_start = 0;
+	while (true) {
+		const auto separator = pattern.find('/', segment_start);
+		const auto segment_end = separator == string::npos ? pattern.size() : separator;
+		const auto segment = pattern.substr(segment_start, segment_end - segment_start);
+		if (IsWildcardSegment(segment)) {
+			if (segment_start == 0 || separator == string::npos || separator + 1 == pattern.size() ||
+			    segment.find("**") != string::npos) {
+				return false;
+			}
+			result.directory = pattern.substr(0, segment_start - 1);
+			result.partition_pattern = segment;
+			result.remainder = pattern.substr(separator + 1);
+			return true;
+		}
+		if (separator == string::npos) {
+			return false;
+		}
+		segment_start = separator + 1;
+	}
+}
+
+bool MatchGlobSegment(const string &name, const string &pattern) {
+	idx_t name_pos = 0;
+	idx_t pattern_pos = 0;
+	// Position after the last '*' seen, and the name position it's currently matched up to, for backtracking.
+	idx_t star_pattern_pos = string::npos;
+	idx_t star_name_pos = 0;
+	while (name_pos < name.size()) {
+		if (pattern_pos < pattern.size()) {
+			const char p = pattern[pattern_pos];
+			if (p == '*') {
+				star_pattern_pos = ++pattern_pos;
+				star_name_pos = name_pos;
+				continue;
+			}
+			if (p == '?') {
+				++pattern_pos;
+				++name_pos;
+				continue;
+			}
+			if (p == '[') {
+				idx_t class_pos = pattern_pos + 1;
+				bool matched = false;
+				if (TryMatchCharacterClass(pattern, class_pos, name[name_pos], matched)) {
+					if (matched) {
+						pattern_pos = class_pos;
+						++name_pos;
+						continue;
+					}
+				} else if (name[name_pos] == '[') {
+					++pattern_pos;
+					++name_pos;
+					continue;
+				}
+			} else if (p == name[name_pos]) {
+				++pattern_pos;
+				++name_pos;
+				continue;
+			}
+		}
+		// Mismatch, let the last '*' swallow one more character.
+		if (star_pattern_pos == string::npos) {
+			return false;
+		}
+		pattern_pos = star_pattern_pos;
+		name_pos = ++star_name_pos;
+	}
+	while (pattern_pos < pattern.size() && pattern[pattern_pos] == '*') {
+		++pattern_pos;
+	}
+	return pattern_pos == pattern.size();
+}
+
+string GetListedName(const string &listed_path) {
+	auto end = listed_path.size();
+	while (end > 0 && listed_path[end - 1] == '/') {
+		--end;
+	}
+	const auto separator = listed_path.rfind('/', end == 0 ? 0 : end - 1);
+	const auto start = separator == string::npos ? 0 : separator + 1;
+	return listed_path.substr(start, end - start);
+}
+
+} // namespace duckdb
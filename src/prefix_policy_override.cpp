@@ -0,0 +1,254 @@
+#include "prefix_policy_override.hpp"
+
+#include "duckdb/common/algorithm.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/main/setting_info.hpp"
+#include "httpfs_timeout_retry_settings.hpp"
+
+namespace duckdb {
+
+namespace {
+
+constexpr const char *SCHEME_DELIMITER = "://";
+
+// Settings which can be overridden per prefix, those resolved into per-operation timeout and retry policies.
+constexpr const char *OVERRIDABLE_SETTINGS[] = {
+    HTTPFS_TIMEOUT_FILE_OPERATION_MS,
+    HTTPFS_TIMEOUT_LIST_MS,
+    HTTPFS_TIMEOUT_DELETE_MS,
+    HTTPFS_TIMEOUT_STAT_MS,
+    HTTPFS_TIMEOUT_CREATE_DIR_MS,
+    HTTPFS_TIMEOUT_READ_MS,
+    HTTPFS_TIMEOUT_WRITE_MS,
+    HTTPFS_RETRIES_FILE_OPERATION,
+    HTTPFS_RETRIES_LIST,
+    HTTPFS_RETRIES_DELETE,
+    HTTPFS_RETRIES_STAT,
+    HTTPFS_RETRIES_CREATE_DIR,
+    HTTPFS_RETRIES_READ,
+    HTTPFS_RETRIES_WRITE,
+    HTTPFS_RETRY_WAIT_FILE_OPERATION_MS,
+    HTTPFS_RETRY_WAIT_LIST_MS,
+    HTTPFS_RETRY_WAIT_DELETE_MS,
+    HTTPFS_RETRY_WAIT_STAT_MS,
+    HTTPFS_RETRY_WAIT_CREATE_DIR_MS,
+    HTTPFS_RETRY_WAIT_READ_MS,
+    HTTPFS_RETRY_WAIT_WRITE_MS,
+    HTTPFS_RETRY_BACKOFF_FILE_OPERATION,
+    HTTPFS_RETRY_BACKOFF_LIST,
+    HTTPFS_RETRY_BACKOFF_DELETE,
+    HTTPFS_RETRY_BACKOFF_STAT,
+    HTTPFS_RETRY_BACKOFF_CREATE_DIR,
+    HTTPFS_RETRY_BACKOFF_READ,
+    HTTPFS_RETRY_BACKOFF_WRITE,
+    HTTPFS_RETRY_MAX_WAIT_FILE_OPERATION_MS,
+    HTTPFS_RETRY_MAX_WAIT_LIST_MS,
+    HTTPFS_RETRY_MAX_WAIT_DELETE_MS,
+    HTTPFS_RETRY_MAX_WAIT_STAT_MS,
+    HTTPFS_RETRY_MAX_WAIT_CREATE_DIR_MS,
+    HTTPFS_RETRY_MAX_WAIT_READ_MS,
+    HTTPFS_RETRY_MAX_WAIT_WRITE_MS,
+    HTTPFS_RETRY_JITTER,
+};
+
+// Order of child edges by character, for binary search.
+bool IsChildBefore(const std::pair<char, idx_t> &child, char character) {
+	return child.first < character;
+}
+
+// Get the type a setting is registered with, throw if it cannot be overridden per prefix.
+LogicalType GetOverridableSettingType(const string &name) {
+	const auto iter = std::find_if(std::begin(OVERRIDABLE_SETTINGS), std::end(OVERRIDABLE_SETTINGS),
+	                               [&](const char *setting) { return name == setting; });
+	if (iter == std::end(OVERRIDABLE_SETTINGS)) {
+		throw InvalidInputException("%s should only override timeout, retry, retry wait, retry backoff, retry max "
+		                            "wait and retry jitter settings, but got '%s'",
+		                            HTTPFS_PREFIX_POLICY_OVERRIDES, name);
+	}
+	if (name == HTTPFS_RETRY_JITTER) {
+		return LogicalType::VARCHAR;
+	}
+	if (StringUtil::StartsWith(name, "httpfs_retry_backoff_")) {
+		return LogicalType::DOUBLE;
+	}
+	return LogicalType::UBIGINT;
+}
+
+// Parse one "<prefix> <setting>=<value>, ..." rule.
+PrefixPolicyOverride ParseRule(const string &rule) {
+	PrefixPolicyOverride policy_override;
+	const auto prefix_end = rule.find_first_of(" \t\n");
+	policy_override.prefix = rule.substr(0, prefix_end);
+	if (policy_override.prefix.find(SCHEME_DELIMITER) == string::npos) {
+		throw InvalidInputException("%s should start each rule with a path prefix with a scheme, i.e. "
+		                            "'s3://bucket/', but got '%s'",
+		                            HTTPFS_PREFIX_POLICY_OVERRIDES, rule);
+	}
+	const auto settings = prefix_end == string::npos ? string() : rule.substr(prefix_end);
+	for (auto &setting : StringUtil::Split(settings, ',')) {
+		StringUtil::Trim(setting);
+		const auto delimiter = setting.find('=');
+		if (delimiter == string::npos) {
+			throw InvalidInputException("%s should list settings of a prefix as <setting>=<value>, but got '%s'",
+			                            HTTPFS_PREFIX_POLICY_OVERRIDES, setting);
+		}
+		auto name = setting.substr(0, delimiter);
+		auto raw_value = setting.substr(delimiter + 1);
+		StringUtil::Trim(name);
+		StringUtil::Trim(raw_value);
+		name = StringUtil::Lower(name);
+		Value value(raw_value);
+		if (!value.DefaultTryCastAs(GetOverridableSettingType(name))) {
+			throw InvalidInputException("%s has invalid value '%s' for %s under prefix '%s'",
+			                            HTTPFS_PREFIX_POLICY_OVERRIDES, raw_value, name, policy_override.prefix);
+		}
+		policy_override.settings[name] = std::move(value);
+	}
+	if (policy_override.settings.empty()) {
+		throw InvalidInputException("%s should override at least one setting for prefix '%s'",
+		                            HTTPFS_PREFIX_POLICY_OVERRIDES, policy_override.prefix);
+	}
+	return policy_override;
+}
+
+} // namespace
+
+//===--------------------------------------------------------------------===//
+// PrefixTrie
+//===--------------------------------------------------------------------===//
+
+PrefixTrie::PrefixTrie() : nodes(1) {
+}
+
+idx_t PrefixTrie::FindChild(idx_t node_index, char character) const {
+	const auto &children = nodes[node_index].children;
+	const auto iter = std::lower_bound(children.begin(), children.end(), character, IsChildBefore);
+	if (iter == children.end() || iter->first != character) {
+		return NOT_FOUND;
+	}
+	return iter->second;
+}
+
+void PrefixTrie::Insert(const string &prefix, idx_t value) {
+	idx_t node_index = 0;
+	for (const auto character : prefix) {
+		auto child_index = FindChild(node_index, character);
+		if (child_index == NOT_FOUND) {
+			child_index = nodes.size();
+			auto &children = nodes[node_index].children;
+			children.insert(std::lower_bound(children.begin(), children.end(), character, IsChildBefore),
+			                std::make_pair(character, child_index));
+			// Appending may move the nodes, so it comes after the parent's edge is added.
+			nodes.emplace_back();
+		}
+		node_index = child_index;
+	}
+	nodes[node_index].value = value;
+}
+
+idx_t PrefixTrie::FindLongestPrefix(const string &str) const {
+	idx_t node_index = 0;
+	idx_t longest_value = nodes[0].value;
+	for (const auto character : str) {
+		node_index = FindChild(node_index, character);
+		if (node_index == NOT_FOUND) {
+			break;
+		}
+		if (nodes[node_index].value != NOT_FOUND) {
+			longest_value = nodes[node_index].value;
+		}
+	}
+	return longest_value;
+}
+
+//===--------------------------------------------------------------------===//
+// Prefix policy overrides
+//===--------------------------------------------------------------------===//
+
+vector<PrefixPolicyOverride> ParsePrefixPolicyOverrides(const string &overrides) {
+	vector<PrefixPolicyOverride> result;
+	for (auto &rule : StringUtil::Split(overrides, ';')) {
+		StringUtil::Trim(rule);
+		if (rule.empty()) {
+			continue;
+		}
+		auto policy_override = ParseRule(rule);
+		for (const auto &existing : result) {
+			if (existing.prefix == policy_override.prefix) {
+				throw InvalidInputException("%s has more than one rule for prefix '%s'",
+				                            HTTPFS_PREFIX_POLICY_OVERRIDES, policy_override.prefix);
+			}
+		}
+		result.emplace_back(std::move(policy_override));
+	}
+
+	// Nested prefixes take the overrides of enclosing prefixes, which they override in turn.
+	std::stable_sort(result.begin(), result.end(),
+	                 [](const PrefixPolicyOverride &lhs, const PrefixPolicyOverride &rhs) {
+		                 return lhs.prefix.size() < rhs.prefix.size();
+	                 });
+	for (idx_t idx = 0; idx < result.size(); ++idx) {
+		for (idx_t enclosing_idx = idx; enclosing_idx > 0; --enclosing_idx) {
+			const auto &enclosing = result[enclosing_idx - 1];
+			if (!StringUtil::StartsWith(result[idx].prefix, enclosing.prefix)) {
+				continue;
+			}
+			// Enclosing prefixes are visited from the longest, so settings already taken are not replaced.
+			for (const auto &entry : enclosing.settings) {
+				result[idx].settings.insert(entry);
+			}
+		}
+	}
+	return result;
+}
+
+vector<PrefixPolicyOverride> GetPrefixPolicyOverrides(FileOpener &opener) {
+	Value value;
+	if (!FileOpener::TryGetCurrentSetting(&opener, HTTPFS_PREFIX_POLICY_OVERRIDES, value) || value.IsNull()) {
+		return {};
+	}
+	return ParsePrefixPolicyOverrides(value.ToString());
+}
+
+//===--------------------------------------------------------------------===//
+// PrefixOverrideFileOpener
+//===--------------------------------------------------------------------===//
+
+PrefixOverrideFileOpener::PrefixOverrideFileOpener(FileOpener &inner_opener_p,
+                                                   const PrefixPolicyOverride &policy_override_p)
+    : inner_opener(inner_opener_p), policy_override(policy_override_p) {
+}
+
+SettingLookupResult PrefixOverrideFileOpener::TryGetCurrentSetting(const string &key, Value &result,
+                                                                   FileOpenerInfo &info) {
+	auto iter = policy_override.settings.find(key);
+	if (iter != policy_override.settings.end()) {
+		result = iter->second;
+		return SettingLookupResult(SettingScope::GLOBAL);
+	}
+	return inner_opener.TryGetCurrentSetting(key, result, info);
+}
+
+SettingLookupResult PrefixOverrideFileOpener::TryGetCurrentSetting(const string &key, Value &result) {
+	FileOpenerInfo info;
+	return TryGetCurrentSetting(key, result, info);
+}
+
+optional_ptr<ClientContext> PrefixOverrideFileOpener::TryGetClientContext() {
+	return inner_opener.TryGetClientContext();
+}
+
+optional_ptr<DatabaseInstance> PrefixOverrideFileOpener::TryGetDatabase() {
+	return inner_opener.TryGetDatabase();
+}
+
+shared_ptr<HTTPUtil> &PrefixOverrideFileOpener::GetHTTPUtil() {
+	return inner_opener.GetHTTPUtil();
+}
+
+Logger &PrefixOverrideFileOpener::GetLogger() const {
+	return inner_opener.GetLogger();
+}
+
+} // namespace duckdb
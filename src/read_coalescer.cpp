@@ -0,0 +1,107 @@
+#include "read_coalescer.hpp"
+
+#include "duckdb/common/helper.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <utility>
+
+namespace duckdb {
+
+ReadCoalescer::ReadCoalescer(idx_t max_gap_bytes_p, idx_t max_request_bytes_p, uint64_t window_us_p,
+                             idx_t file_size_p, FetchFunction fetch_p)
+    : max_gap_bytes(max_gap_bytes_p), max_request_bytes(max_request_bytes_p), window_us(window_us_p),
+      file_size(file_size_p), fetch(std::move(fetch_p)) {
+}
+
+bool ReadCoalescer::ShouldCoalesce(idx_t nr_bytes, idx_t location) const {
+	return nr_bytes > 0 && nr_bytes < max_request_bytes && location + nr_bytes <= file_size;
+}
+
+shared_ptr<ReadCoalescer::Batch> ReadCoalescer::TryJoinBatch(idx_t start, idx_t end) {
+	for (auto &batch : pending_batches) {
+		// Ranges overlap, or are apart by no more than the max gap.
+		if (start > batch->end + max_gap_bytes || batch->start > end + max_gap_bytes) {
+			continue;
+		}
+		const auto merged_start = MinValue<idx_t>(batch->start, start);
+		const auto merged_end = MaxValue<idx_t>(batch->end, end);
+		if (merged_end - merged_start > max_request_bytes) {
+			continue;
+		}
+		batch->start = merged_start;
+		batch->end = merged_end;
+		if (merged_end - merged_start == max_request_bytes) {
+			batch->batch_cv.notify_all();
+		}
+		return batch;
+	}
+	return nullptr;
+}
+
+void ReadCoalescer::Read(data_ptr_t buffer, idx_t nr_bytes, idx_t location) {
+	const auto read_end = location + nr_bytes;
+	std::unique_lock<mutex> lck(coalescer_mutex);
+	++read_count;
+	auto batch = TryJoinBatch(location, read_end);
+	if (batch == nullptr) {
+		// Other reads only come along while there's concurrent demand on the handle, a lone read is sent right away.
+		const bool has_concurrent_reads = !pending_batches.empty() || in_flight_requests > 0;
+		batch = make_shared_ptr<Batch>();
+		batch->start = location;
+		batch->end = read_end;
+		pending_batches.emplace_back(batch);
+		if (has_concurrent_reads) {
+			// Wait for other reads to join, unless the batch fills up earlier.
+			batch->batch_cv.wait_for(lck, std::chrono::microseconds(window_us),
+			                         [&]() { return batch->end - batch->start >= max_request_bytes; });
+		}
+		FetchBatch(*batch, lck);
+	} else {
+		batch->batch_cv.wait(lck, [&]() { return batch->done; });
+	}
+
+	if (batch->error) {
+		std::rethrow_exception(batch->error);
+	}
+	memcpy(buffer, batch->data.get() + (location - batch->start), nr_bytes);
+}
+
+void ReadCoalescer::FetchBatch(Batch &batch, std::unique_lock<mutex> &lck) {
+	for (auto iter = pending_batches.begin(); iter != pending_batches.end(); ++iter) {
+		if (iter->get() == &batch) {
+			pending_batches.erase(iter);
+			break;
+		}
+	}
+	++request_count;
+	++in_flight_requests;
+	const auto start = batch.start;
+	const auto nr_bytes = batch.end - batch.start;
+	lck.unlock();
+
+	// The batch no longer changes, and is only read by the readers once it's done.
+	try {
+		batch.data = make_unsafe_uniq_array<data_t>(nr_bytes);
+		fetch(batch.data.get(), nr_bytes, start);
+	} catch (...) {
+		batch.error = std::current_exception();
+	}
+
+	lck.lock();
+	--in_flight_requests;
+	batch.done = true;
+	batch.batch_cv.notify_all();
+}
+
+idx_t ReadCoalescer::GetRequestCount() const {
+	lock_guard<mutex> lck(coalescer_mutex);
+	return request_count;
+}
+
+idx_t ReadCoalescer::GetReadCount() const {
+	lock_guard<mutex> lck(coalescer_mutex);
+	return read_count;
+}
+
+} // namespace duckdb
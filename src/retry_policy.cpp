@@ -0,0 +1,316 @@
+#include "retry_policy.hpp"
+
+#include "duckdb/common/error_data.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/http_util.hpp"
+#include "duckdb/common/limits.hpp"
+#include "duckdb/common/random_engine.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "httpfs_timeout_retry_settings.hpp"
+#include "timeout_retry_policy.hpp"
+
+#include <cmath>
+#include <cstdlib>
+
+namespace duckdb {
+
+namespace {
+
+// Allow one retry per second for endpoints with little traffic by default.
+constexpr uint64_t DEFAULT_RETRY_BUDGET_MIN_RETRIES_PER_SECOND = 1;
+
+constexpr uint64_t DEFAULT_CIRCUIT_BREAKER_COOL_DOWN_MS = 10000;
+
+// Default values matching httpfs extension for compatibility.
+constexpr uint64_t DEFAULT_RETRY_WAIT_MS = HTTPParams::DEFAULT_RETRY_WAIT_MS;
+constexpr double DEFAULT_RETRY_BACKOFF = HTTPParams::DEFAULT_RETRY_BACKOFF;
+
+constexpr uint64_t MILLISECONDS_PER_SECOND = 1000;
+
+// Longest wait taken from Retry-After headers when the retry wait is unbounded.
+constexpr uint64_t DEFAULT_MAX_RETRY_AFTER_MS = 60 * MILLISECONDS_PER_SECOND;
+
+// S3 error codes of throttled requests, which come with HTTP 503 or 400 depending on the service.
+constexpr const char *S3_THROTTLING_ERROR_CODES[] = {"<Code>SlowDown</Code>",
+                                                     "<Code>Throttling</Code>",
+                                                     "<Code>ThrottlingException</Code>",
+                                                     "<Code>RequestLimitExceeded</Code>",
+                                                     "<Code>RequestThrottled</Code>",
+                                                     "<Code>TooManyRequestsException</Code>"};
+
+bool IsRetryableStatusCode(int64_t status_code) {
+	// Request timeout, throttling, and server errors.
+	return status_code == 408 || status_code == 429 || status_code >= 500;
+}
+
+// Get the status code of an HTTP error, return false for other errors.
+bool TryGetStatusCode(const ErrorData &error, int64_t &status_code) {
+	if (error.Type() != ExceptionType::HTTP) {
+		return false;
+	}
+	const auto &extra_info = error.ExtraInfo();
+	auto iter = extra_info.find("status_code");
+	if (iter == extra_info.end()) {
+		return false;
+	}
+	status_code = std::strtoll(iter->second.c_str(), nullptr, 10);
+	return true;
+}
+
+bool HasThrottlingErrorCode(const ErrorData &error) {
+	const auto &extra_info = error.ExtraInfo();
+	auto iter = extra_info.find("response_body");
+	if (iter == extra_info.end()) {
+		return false;
+	}
+	for (const auto *error_code : S3_THROTTLING_ERROR_CODES) {
+		if (StringUtil::Contains(iter->second, error_code)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool IsThrottlingResponse(const ErrorData &error) {
+	int64_t status_code = 0;
+	if (!TryGetStatusCode(error, status_code)) {
+		return false;
+	}
+	return status_code == 429 || HasThrottlingErrorCode(error);
+}
+
+RetryJitter GetRetryJitter(TimeoutRetryFileOpener &opener) {
+	Value value;
+	if (!FileOpener::TryGetCurrentSetting(&opener, HTTPFS_RETRY_JITTER, value) || value.IsNull()) {
+		return RetryJitter::NONE;
+	}
+	const auto jitter = StringUtil::Lower(value.ToString());
+	if (jitter == "none") {
+		return RetryJitter::NONE;
+	}
+	if (jitter == "full") {
+		return RetryJitter::FULL;
+	}
+	if (jitter == "equal") {
+		return RetryJitter::EQUAL;
+	}
+	if (jitter == "decorrelated") {
+		return RetryJitter::DECORRELATED;
+	}
+	throw InvalidInputException("%s should be one of 'none', 'full', 'equal' and 'decorrelated', but got '%s'",
+	                            HTTPFS_RETRY_JITTER, value.ToString());
+}
+
+// Random number in [0, 1), drawn from a per-thread engine so concurrent retries don't contend on a lock.
+double GetJitterRandom() {
+	static thread_local RandomEngine random_engine;
+	return random_engine.NextRandom();
+}
+
+} // namespace
+
+//===--------------------------------------------------------------------===//
+// RetryBudget
+//===--------------------------------------------------------------------===//
+
+void RetryBudget::Refill(const RetryBudgetConfig &config, std::chrono::steady_clock::time_point now) {
+	// Start with one second worth of retries, so the first failures on a new endpoint could still be retried.
+	if (!initialized) {
+		initialized = true;
+		tokens = MinValue<double>(config.min_retries_per_second, MAX_TOKENS);
+		last_refill = now;
+		return;
+	}
+	if (now <= last_refill) {
+		return;
+	}
+	const double elapsed_seconds = std::chrono::duration<double>(now - last_refill).count();
+	tokens = MinValue<double>(tokens + elapsed_seconds * config.min_retries_per_second, MAX_TOKENS);
+	last_refill = now;
+}
+
+void RetryBudget::RecordSuccess(const RetryBudgetConfig &config, std::chrono::steady_clock::time_point now) {
+	lock_guard<mutex> lck(budget_mutex);
+	Refill(config, now);
+	tokens = MinValue<double>(tokens + config.ratio, MAX_TOKENS);
+}
+
+bool RetryBudget::TryAcquireRetry(const RetryBudgetConfig &config, std::chrono::steady_clock::time_point now) {
+	lock_guard<mutex> lck(budget_mutex);
+	Refill(config, now);
+	if (tokens < 1) {
+		return false;
+	}
+	tokens -= 1;
+	return true;
+}
+
+void RetryBudget::RecordSuccess(const RetryBudgetConfig &config) {
+	RecordSuccess(config, std::chrono::steady_clock::now());
+}
+
+bool RetryBudget::TryAcquireRetry(const RetryBudgetConfig &config) {
+	return TryAcquireRetry(config, std::chrono::steady_clock::now());
+}
+
+//===--------------------------------------------------------------------===//
+// RetryBudgetRegistry
+//===--------------------------------------------------------------------===//
+
+RetryBudgetRegistry &RetryBudgetRegistry::GetInstance() {
+	static RetryBudgetRegistry registry;
+	return registry;
+}
+
+RetryBudget &RetryBudgetRegistry::GetRetryBudget(const string &endpoint) {
+	return registry.GetOrCreate(endpoint);
+}
+
+//===--------------------------------------------------------------------===//
+// Retry config and error classification
+//===--------------------------------------------------------------------===//
+
+RetryConfig GetRetryConfig(TimeoutRetryFileOpener &opener) {
+	const auto operation_policy = opener.GetOperationPolicy();
+	if (operation_policy) {
+		return operation_policy->retry;
+	}
+
+	RetryConfig config;
+	if (!opener.TryGetRetries(config.max_retries)) {
+		config.max_retries = HTTPParams::DEFAULT_RETRIES;
+	}
+
+	Value value;
+	if (!opener.TryGetRetryWaitMs(config.retry_wait_ms)) {
+		config.retry_wait_ms = DEFAULT_RETRY_WAIT_MS;
+	}
+	if (!opener.TryGetRetryBackoff(config.retry_backoff)) {
+		config.retry_backoff = DEFAULT_RETRY_BACKOFF;
+	}
+	opener.TryGetRetryMaxWaitMs(config.retry_max_wait_ms);
+	config.jitter = GetRetryJitter(opener);
+
+	if (FileOpener::TryGetCurrentSetting(&opener, HTTPFS_RETRY_BUDGET_RATIO, value) && !value.IsNull()) {
+		config.budget.enabled = true;
+		config.budget.ratio = value.GetValue<double>();
+		if (config.budget.ratio < 0) {
+			throw InvalidInputException("%s should be non-negative, but got %f", HTTPFS_RETRY_BUDGET_RATIO,
+			                            config.budget.ratio);
+		}
+		config.budget.min_retries_per_second = DEFAULT_RETRY_BUDGET_MIN_RETRIES_PER_SECOND;
+		if (FileOpener::TryGetCurrentSetting(&opener, HTTPFS_RETRY_BUDGET_MIN_RETRIES_PER_SECOND, value) &&
+		    !value.IsNull()) {
+			config.budget.min_retries_per_second = static_cast<double>(value.GetValue<uint64_t>());
+		}
+	}
+
+	if (FileOpener::TryGetCurrentSetting(&opener, HTTPFS_CIRCUIT_BREAKER_FAILURE_THRESHOLD, value) &&
+	    !value.IsNull()) {
+		config.circuit_breaker.failure_threshold = value.GetValue<uint64_t>();
+		if (config.circuit_breaker.failure_threshold == 0) {
+			throw InvalidInputException("%s should be positive", HTTPFS_CIRCUIT_BREAKER_FAILURE_THRESHOLD);
+		}
+		config.circuit_breaker.enabled = true;
+		config.circuit_breaker.cool_down_ms = DEFAULT_CIRCUIT_BREAKER_COOL_DOWN_MS;
+		if (FileOpener::TryGetCurrentSetting(&opener, HTTPFS_CIRCUIT_BREAKER_COOL_DOWN_MS, value) && !value.IsNull()) {
+			config.circuit_breaker.cool_down_ms = value.GetValue<uint64_t>();
+		}
+	}
+
+	if (FileOpener::TryGetCurrentSetting(&opener, HTTPFS_MAX_CONCURRENT_REQUESTS, value) && !value.IsNull()) {
+		config.concurrency_limit.max_requests = value.GetValue<uint64_t>();
+		if (config.concurrency_limit.max_requests == 0) {
+			throw InvalidInputException("%s should be positive", HTTPFS_MAX_CONCURRENT_REQUESTS);
+		}
+		config.concurrency_limit.enabled = true;
+		if (FileOpener::TryGetCurrentSetting(&opener, HTTPFS_MAX_CONCURRENT_REQUESTS_PER_OPERATION, value) &&
+		    !value.IsNull()) {
+			config.concurrency_limit.max_requests_per_operation = value.GetValue<uint64_t>();
+			if (config.concurrency_limit.max_requests_per_operation == 0) {
+				throw InvalidInputException("%s should be positive", HTTPFS_MAX_CONCURRENT_REQUESTS_PER_OPERATION);
+			}
+		}
+	}
+	return config;
+}
+
+uint64_t GetRetryWaitMs(const RetryConfig &config, idx_t retry_index, uint64_t previous_wait_ms) {
+	return GetRetryWaitMs(config, retry_index, previous_wait_ms, GetJitterRandom());
+}
+
+uint64_t GetRetryWaitMs(const RetryConfig &config, idx_t retry_index, uint64_t previous_wait_ms, double random) {
+	// Unbounded waits are still kept in range of the integer type.
+	const auto max_wait_ms = static_cast<double>(config.retry_max_wait_ms > 0 ? config.retry_max_wait_ms
+	                                                                          : NumericLimits<uint32_t>::Maximum());
+	const auto initial_wait_ms = static_cast<double>(config.retry_wait_ms);
+	const auto exponential_wait_ms = MinValue<double>(
+	    initial_wait_ms * std::pow(config.retry_backoff, static_cast<double>(retry_index)), max_wait_ms);
+	switch (config.jitter) {
+	case RetryJitter::FULL:
+		return static_cast<uint64_t>(random * exponential_wait_ms);
+	case RetryJitter::EQUAL:
+		return static_cast<uint64_t>(exponential_wait_ms / 2 + random * exponential_wait_ms / 2);
+	case RetryJitter::DECORRELATED: {
+		const auto upper_wait_ms = MaxValue<double>(initial_wait_ms, static_cast<double>(previous_wait_ms) * 3);
+		return static_cast<uint64_t>(
+		    MinValue<double>(initial_wait_ms + random * (upper_wait_ms - initial_wait_ms), max_wait_ms));
+	}
+	case RetryJitter::NONE:
+	default:
+		return static_cast<uint64_t>(exponential_wait_ms);
+	}
+}
+
+bool TryGetRetryAfterMs(const std::exception &ex, uint64_t &retry_after_ms) {
+	ErrorData error(ex);
+	if (error.Type() != ExceptionType::HTTP) {
+		return false;
+	}
+	// Response headers are kept as "header_<name>" extra info, header names are case-insensitive. Only the
+	// delay-seconds form is taken, since object storage doesn't send an HTTP date.
+	for (const auto &entry : error.ExtraInfo()) {
+		if (!StringUtil::CIEquals(entry.first, "header_retry-after")) {
+			continue;
+		}
+		const auto &retry_after = entry.second;
+		if (retry_after.empty() || !StringUtil::CharacterIsDigit(retry_after[0])) {
+			return false;
+		}
+		// Clamped, so huge values don't overflow once converted to milliseconds.
+		const auto retry_after_seconds = MinValue<uint64_t>(std::strtoull(retry_after.c_str(), nullptr, 10),
+		                                                    NumericLimits<uint32_t>::Maximum());
+		retry_after_ms = retry_after_seconds * MILLISECONDS_PER_SECOND;
+		return true;
+	}
+	return false;
+}
+
+uint64_t GetMaxRetryAfterMs(const RetryConfig &config) {
+	return config.retry_max_wait_ms > 0 ? config.retry_max_wait_ms : DEFAULT_MAX_RETRY_AFTER_MS;
+}
+
+bool IsThrottlingError(const std::exception &ex) {
+	return IsThrottlingResponse(ErrorData(ex));
+}
+
+bool IsRetryableError(const std::exception &ex) {
+	ErrorData error(ex);
+	switch (error.Type()) {
+	// Connection failures and deadlines enforced by the wrapper surface as IO errors.
+	case ExceptionType::IO:
+		return true;
+	case ExceptionType::HTTP: {
+		int64_t status_code = 0;
+		if (!TryGetStatusCode(error, status_code)) {
+			return false;
+		}
+		// Some services throttle with HTTP 400 and an error code.
+		return IsRetryableStatusCode(status_code) || IsThrottlingResponse(error);
+	}
+	default:
+		return false;
+	}
+}
+
+} // namespace duckdb
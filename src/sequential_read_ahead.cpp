@@ -0,0 +1,170 @@
+#include "sequential_read_ahead.hpp"
+
+#include "duckdb/common/helper.hpp"
+#include "task_executor.hpp"
+
+#include <cstring>
+#include <utility>
+
+namespace duckdb {
+
+namespace {
+
+// Max number of windows fetched in the background at the same time, across all file handles.
+constexpr idx_t MAX_PREFETCH_THREADS = 16;
+
+TaskExecutor &GetPrefetchExecutor() {
+	static TaskExecutor executor(MAX_PREFETCH_THREADS);
+	return executor;
+}
+
+} // namespace
+
+void SequentialReadAhead::Window::Reserve(idx_t nr_bytes) {
+	if (capacity < nr_bytes) {
+		data = make_unsafe_uniq_array<data_t>(nr_bytes);
+		capacity = nr_bytes;
+	}
+}
+
+SequentialReadAhead::SequentialReadAhead(idx_t max_window_bytes_p, idx_t file_size_p, bool concurrent_fetches_p,
+                                         FetchFunction fetch_p)
+    : max_window_bytes(max_window_bytes_p), file_size(file_size_p), concurrent_fetches(concurrent_fetches_p),
+      fetch(std::move(fetch_p)), window_bytes(MinValue<idx_t>(MIN_WINDOW_BYTES, max_window_bytes_p)) {
+}
+
+SequentialReadAhead::~SequentialReadAhead() {
+	WaitForPrefetch();
+}
+
+idx_t SequentialReadAhead::Read(data_ptr_t buffer, idx_t nr_bytes) {
+	lock_guard<mutex> lck(read_mutex);
+	idx_t bytes_read = 0;
+	while (bytes_read < nr_bytes && position < file_size) {
+		if (current.Contains(position)) {
+			const auto offset = position - current.start;
+			const auto copy_bytes = MinValue<idx_t>(nr_bytes - bytes_read, current.size - offset);
+			memcpy(buffer + bytes_read, current.data.get() + offset, copy_bytes);
+			bytes_read += copy_bytes;
+			position += copy_bytes;
+			continue;
+		}
+		if (TryTakePrefetch()) {
+			continue;
+		}
+
+		// Nothing prefetched covers the position: reads larger than the window go straight into the caller's buffer,
+		// smaller ones fetch a whole window.
+		const auto remaining_bytes = MinValue<idx_t>(nr_bytes - bytes_read, file_size - position);
+		if (remaining_bytes >= window_bytes) {
+			FetchInForeground(buffer + bytes_read, remaining_bytes, position);
+			bytes_read += remaining_bytes;
+			position += remaining_bytes;
+			continue;
+		}
+		const auto fetch_bytes = MinValue<idx_t>(window_bytes, file_size - position);
+		current.Reserve(fetch_bytes);
+		current.size = 0;
+		FetchInForeground(current.data.get(), fetch_bytes, position);
+		current.start = position;
+		current.size = fetch_bytes;
+	}
+
+	++sequential_reads;
+	if (sequential_reads >= SEQUENTIAL_READS_BEFORE_PREFETCH) {
+		StartPrefetch();
+	}
+	return bytes_read;
+}
+
+void SequentialReadAhead::Seek(idx_t location) {
+	lock_guard<mutex> lck(read_mutex);
+	if (location == position) {
+		return;
+	}
+	// Random access, start over with the smallest window; data already buffered stays usable if the seek lands in it,
+	// and a prefetched window which doesn't start at the new position is dropped once it completes.
+	position = location;
+	sequential_reads = 0;
+	window_bytes = MinValue<idx_t>(MIN_WINDOW_BYTES, max_window_bytes);
+}
+
+idx_t SequentialReadAhead::GetPosition() const {
+	lock_guard<mutex> lck(read_mutex);
+	return position;
+}
+
+void SequentialReadAhead::WaitForPrefetch() {
+	std::unique_lock<mutex> prefetch_lck(prefetch_mutex);
+	prefetch_cv.wait(prefetch_lck, [&]() { return !prefetch_in_flight; });
+}
+
+idx_t SequentialReadAhead::GetWindowBytes() const {
+	lock_guard<mutex> lck(read_mutex);
+	return window_bytes;
+}
+
+bool SequentialReadAhead::TryTakePrefetch() {
+	std::unique_lock<mutex> prefetch_lck(prefetch_mutex);
+	// Only wait for a background fetch of the window needed next; a stale one keeps running.
+	if (prefetch_in_flight && prefetched.start == position) {
+		prefetch_cv.wait(prefetch_lck, [&]() { return !prefetch_in_flight; });
+	}
+	if (prefetch_in_flight) {
+		return false;
+	}
+	// A failed prefetch is left to the foreground fetch, which reports the error if it fails again.
+	if (prefetch_failed || prefetched.size == 0 || prefetched.start != position) {
+		prefetch_failed = false;
+		prefetched.size = 0;
+		return false;
+	}
+	std::swap(current, prefetched);
+	prefetched.size = 0;
+	// The consumer caught up with the prefetch, a larger window keeps it ahead.
+	window_bytes = MinValue<idx_t>(window_bytes * 2, max_window_bytes);
+	return true;
+}
+
+void SequentialReadAhead::StartPrefetch() {
+	const auto next_start = current.Contains(position) ? current.start + current.size : position;
+	lock_guard<mutex> prefetch_lck(prefetch_mutex);
+	if (prefetch_in_flight) {
+		return;
+	}
+	if (!prefetch_failed && prefetched.size > 0 && prefetched.start == next_start) {
+		return;
+	}
+	// Drop a window made stale by a seek.
+	prefetch_failed = false;
+	prefetched.size = 0;
+	if (next_start >= file_size) {
+		return;
+	}
+	const auto fetch_bytes = MinValue<idx_t>(window_bytes, file_size - next_start);
+	prefetched.Reserve(fetch_bytes);
+	prefetched.start = next_start;
+	prefetch_in_flight = true;
+	GetPrefetchExecutor().Schedule([this, fetch_bytes, next_start]() {
+		bool failed = false;
+		try {
+			fetch(prefetched.data.get(), fetch_bytes, next_start);
+		} catch (...) {
+			failed = true;
+		}
+		lock_guard<mutex> lck(prefetch_mutex);
+		prefetched.size = failed ? 0 : fetch_bytes;
+		prefetch_failed = failed;
+		prefetch_in_flight = false;
+		prefetch_cv.notify_all();
+	});
+}
+
+void SequentialReadAhead::FetchInForeground(data_ptr_t buffer, idx_t nr_bytes, idx_t location) {
+	if (!concurrent_fetches) {
+		WaitForPrefetch();
+	}
+	fetch(buffer, nr_bytes, location);
+}
+
+} // namespace duckdb
@@ -0,0 +1,57 @@
+#include "task_executor.hpp"
+
+#include "duckdb/common/helper.hpp"
+
+#include <thread>
+#include <utility>
+
+namespace duckdb {
+
+TaskExecutor::TaskExecutor(idx_t max_threads_p)
+    : max_threads(MaxValue<idx_t>(max_threads_p, 1)), state(make_shared_ptr<State>()) {
+}
+
+TaskExecutor::~TaskExecutor() {
+	lock_guard<mutex> lck(state->state_mutex);
+	state->shutdown = true;
+	state->state_cv.notify_all();
+}
+
+void TaskExecutor::Schedule(Task task) {
+	lock_guard<mutex> lck(state->state_mutex);
+	state->tasks.emplace_back(std::move(task));
+	// Idle workers pick up queued tasks in turn; only start another one if they cannot take them all.
+	if (state->tasks.size() > state->idle_thread_count && state->thread_count < max_threads) {
+		++state->thread_count;
+		std::thread(RunWorker, state).detach();
+		return;
+	}
+	state->state_cv.notify_one();
+}
+
+idx_t TaskExecutor::GetThreadCount() const {
+	lock_guard<mutex> lck(state->state_mutex);
+	return state->thread_count;
+}
+
+void TaskExecutor::RunWorker(shared_ptr<State> state) {
+	std::unique_lock<mutex> lck(state->state_mutex);
+	while (true) {
+		++state->idle_thread_count;
+		state->state_cv.wait(lck, [&]() { return !state->tasks.empty() || state->shutdown; });
+		--state->idle_thread_count;
+		if (state->tasks.empty()) {
+			--state->thread_count;
+			return;
+		}
+		auto task = std::move(state->tasks.front());
+		state->tasks.pop_front();
+		lck.unlock();
+		task();
+		// Release whatever the task holds before waiting for the next one.
+		task = nullptr;
+		lck.lock();
+	}
+}
+
+} // namespace duckdb
@@ -0,0 +1,42 @@
+#include "timeout_retry_file_handle.hpp"
+
+namespace duckdb {
+
+TimeoutRetryFileHandle::TimeoutRetryFileHandle(FileSystem &wrapper_filesystem, unique_ptr<FileHandle> inner_handle_p,
+                                               FileOpenFlags flags, TimeoutRetryHandleConfig config_p,
+                                               OperationMetrics &read_metrics_p, OperationMetrics &write_metrics_p,
+                                               RetryBudget &retry_budget_p, CircuitBreaker &circuit_breaker_p,
+                                               ConcurrencyLimiter &concurrency_limiter_p,
+                                               ReadLatencyTrackers &read_latency_trackers_p)
+    : FileHandle(wrapper_filesystem, inner_handle_p->GetPath(), flags), inner_handle(std::move(inner_handle_p)),
+      config(make_shared_ptr<const TimeoutRetryHandleConfig>(std::move(config_p))), read_metrics(read_metrics_p),
+      write_metrics(write_metrics_p), retry_budget(retry_budget_p), circuit_breaker(circuit_breaker_p),
+      concurrency_limiter(concurrency_limiter_p), read_latency_trackers(read_latency_trackers_p) {
+}
+
+TimeoutRetryFileHandle::~TimeoutRetryFileHandle() {
+	// Prefetch keeps using the inner handle until it completes, and could issue background requests itself.
+	read_ahead.reset();
+	// Inner handle could still flush written data when it's destroyed. Background requests still in flight share it,
+	// the last one of them destroys it instead; they only run on files opened for reading, so nothing is left to flush.
+	inner_handle.reset();
+	if (close_callback) {
+		close_callback();
+	}
+}
+
+void TimeoutRetryFileHandle::Close() {
+	if (read_ahead) {
+		read_ahead->WaitForPrefetch();
+	}
+	// Closing isn't held up by background requests still reading from the inner handle: it's left for the last of
+	// them to destroy, which releases it just the same for files opened for reading.
+	if (inner_handle.use_count() == 1) {
+		inner_handle->Close();
+	}
+	if (close_callback) {
+		close_callback();
+	}
+}
+
+} // namespace duckdb
@@ -1,59 +1,262 @@
 #include "timeout_retry_file_opener.hpp"
 
+#include "duckdb/common/array.hpp"
 #include "duckdb/common/exception.hpp"
 #include "duckdb/common/file_opener.hpp"
 #include "duckdb/common/string.hpp"
 #include "duckdb/main/client_context.hpp"
 #include "duckdb/main/setting_info.hpp"
 #include "httpfs_timeout_retry_settings.hpp"
+#include "timeout_retry_policy.hpp"
 
 namespace duckdb {
 
-TimeoutRetryFileOpener::TimeoutRetryFileOpener(FileOpener &inner_opener_p, HttpfsOperationType operation_type_p)
-    : inner_opener(inner_opener_p), operation_type(operation_type_p) {
+namespace {
+
+constexpr uint64_t MILLISECONDS_PER_SECOND = 1000;
+
+// Retry wait, backoff and max wait setting names, indexed by operation type; opens take the file operation settings.
+constexpr array<const char *, HTTPFS_OPERATION_TYPE_COUNT> RETRY_WAIT_SETTING_NAMES {
+    HTTPFS_RETRY_WAIT_FILE_OPERATION_MS, HTTPFS_RETRY_WAIT_LIST_MS,       HTTPFS_RETRY_WAIT_DELETE_MS,
+    HTTPFS_RETRY_WAIT_STAT_MS,           HTTPFS_RETRY_WAIT_CREATE_DIR_MS, HTTPFS_RETRY_WAIT_READ_MS,
+    HTTPFS_RETRY_WAIT_WRITE_MS};
+constexpr array<const char *, HTTPFS_OPERATION_TYPE_COUNT> RETRY_BACKOFF_SETTING_NAMES {
+    HTTPFS_RETRY_BACKOFF_FILE_OPERATION, HTTPFS_RETRY_BACKOFF_LIST,       HTTPFS_RETRY_BACKOFF_DELETE,
+    HTTPFS_RETRY_BACKOFF_STAT,           HTTPFS_RETRY_BACKOFF_CREATE_DIR, HTTPFS_RETRY_BACKOFF_READ,
+    HTTPFS_RETRY_BACKOFF_WRITE};
+constexpr array<const char *, HTTPFS_OPERATION_TYPE_COUNT> RETRY_MAX_WAIT_SETTING_NAMES {
+    HTTPFS_RETRY_MAX_WAIT_FILE_OPERATION_MS, HTTPFS_RETRY_MAX_WAIT_LIST_MS,       HTTPFS_RETRY_MAX_WAIT_DELETE_MS,
+    HTTPFS_RETRY_MAX_WAIT_STAT_MS,           HTTPFS_RETRY_MAX_WAIT_CREATE_DIR_MS, HTTPFS_RETRY_MAX_WAIT_READ_MS,
+    HTTPFS_RETRY_MAX_WAIT_WRITE_MS};
+
+// HTTP clients only take whole seconds; round up so the client never gives up earlier than requested, the wrapper
+// enforces the precise deadline where it can.
+uint64_t RoundUpToSeconds(uint64_t timeout_ms) {
+	return (timeout_ms + MILLISECONDS_PER_SECOND - 1) / MILLISECONDS_PER_SECOND;
+}
+
+} // namespace
+
+string HttpfsOperationTypeToString(HttpfsOperationType operation_type) {
+	switch (operation_type) {
+	case HttpfsOperationType::OPEN:
+		return "open";
+	case HttpfsOperationType::LIST:
+		return "list";
+	case HttpfsOperationType::DELETE:
+		return "delete";
+	case HttpfsOperationType::STAT:
+		return "stat";
+	case HttpfsOperationType::CREATE_DIR:
+		return "create_dir";
+	case HttpfsOperationType::READ:
+		return "read";
+	case HttpfsOperationType::WRITE:
+		return "write";
+	default:
+		throw InternalException("Unknown HttpfsOperationType in HttpfsOperationTypeToString: %d",
+		                        static_cast<int>(operation_type));
+	}
+}
+
+TimeoutRetryFileOpener::TimeoutRetryFileOpener(FileOpener &inner_opener_p, HttpfsOperationType operation_type_p,
+                                               optional_ptr<const TimeoutRetryPolicySnapshot> policies_p,
+                                               const string &path_p)
+    : inner_opener(inner_opener_p), operation_type(operation_type_p), policies(policies_p), path(path_p) {
+	if (policies) {
+		operation_policy = &policies->GetOperationPolicy(operation_type, path);
+	}
 }
 
 SettingLookupResult TimeoutRetryFileOpener::TryGetCurrentSetting(const string &key, Value &result,
                                                                  FileOpenerInfo &info) {
 	// Intercept http_timeout and http_retries to provide per-operation values
 	if (key == "http_timeout") {
-		// Try to get the per-operation timeout setting
-		string op_timeout_key = GetTimeoutSettingName();
-		if (FileOpener::TryGetCurrentSetting(&inner_opener, op_timeout_key, result, &info)) {
-			// If the per-operation setting is NULL, fallback to http_timeout
-			if (result.IsNull()) {
+		if (timeout_override_ms > 0) {
+			result = Value::UBIGINT(RoundUpToSeconds(timeout_override_ms));
+			return SettingLookupResult(SettingScope::GLOBAL);
+		}
+		if (operation_policy) {
+			if (!operation_policy->has_timeout) {
 				return inner_opener.TryGetCurrentSetting(key, result, info);
 			}
-			// Convert from milliseconds to seconds for http_timeout
-			uint64_t timeout_ms = result.GetValue<uint64_t>();
-			uint64_t timeout_seconds = (timeout_ms > 0 && timeout_ms < 1000) ? 1 : (timeout_ms / 1000);
-			result = Value::UBIGINT(timeout_seconds);
+			result = Value::UBIGINT(RoundUpToSeconds(operation_policy->timeout_ms));
+			return SettingLookupResult(SettingScope::GLOBAL);
+		}
+		// Try to get the per-operation timeout setting, and convert from milliseconds to seconds for http_timeout
+		if (TryGetOperationTimeoutSetting(result, info)) {
+			result = Value::UBIGINT(RoundUpToSeconds(result.GetValue<uint64_t>()));
 			// TODO(hjiang): double check the scope.
 			return SettingLookupResult(SettingScope::GLOBAL);
 		}
-		// Fall back to original http_timeout if per-operation setting not found
+		// Fall back to original http_timeout if per-operation setting is not set
 		return inner_opener.TryGetCurrentSetting(key, result, info);
 	}
 
 	if (key == "http_retries") {
-		// Try to get the per-operation retry setting
-		string op_retry_key = GetRetrySettingName();
-		if (FileOpener::TryGetCurrentSetting(&inner_opener, op_retry_key, result, &info)) {
-			// If the per-operation setting is NULL, fallback to http_retries
-			if (result.IsNull()) {
+		if (has_inner_retries_override) {
+			result = Value::UBIGINT(inner_retries_override);
+			return SettingLookupResult(SettingScope::GLOBAL);
+		}
+		if (operation_policy) {
+			if (!operation_policy->has_retries) {
 				return inner_opener.TryGetCurrentSetting(key, result, info);
 			}
+			result = Value::UBIGINT(operation_policy->retry.max_retries);
+			return SettingLookupResult(SettingScope::GLOBAL);
+		}
+		// Try to get the per-operation retry setting
+		if (TryGetOperationRetrySetting(result, info)) {
 			// TODO(hjiang): double check the scope.
 			return SettingLookupResult(SettingScope::GLOBAL);
 		}
-		// Fall back to original http_retries if per-operation setting not found
+		// Fall back to original http_retries if per-operation setting is not set
 		return inner_opener.TryGetCurrentSetting(key, result, info);
 	}
 
+	// Retry wait and backoff also apply to operations retried by the inner filesystem, i.e. writes; the snapshot holds
+	// them with fallbacks and defaults applied.
+	if (operation_policy && (key == "http_retry_wait_ms" || key == "http_retry_backoff")) {
+		const auto &retry_config = operation_policy->retry;
+		result = key == "http_retry_wait_ms" ? Value::UBIGINT(retry_config.retry_wait_ms)
+		                                     : Value::FLOAT(static_cast<float>(retry_config.retry_backoff));
+		return SettingLookupResult(SettingScope::GLOBAL);
+	}
+	if (key == "http_retry_wait_ms" && TryGetOperationRetryWaitSetting(result, info)) {
+		return SettingLookupResult(SettingScope::GLOBAL);
+	}
+	if (key == "http_retry_backoff" && TryGetOperationRetryBackoffSetting(result, info)) {
+		result = Value::FLOAT(result.GetValue<float>());
+		return SettingLookupResult(SettingScope::GLOBAL);
+	}
+
+	auto iter = setting_overrides.find(key);
+	if (iter != setting_overrides.end()) {
+		result = iter->second;
+		return SettingLookupResult(SettingScope::GLOBAL);
+	}
+
 	// For all other settings, delegate to inner opener
 	return inner_opener.TryGetCurrentSetting(key, result, info);
 }
 
+bool TimeoutRetryFileOpener::TryGetTimeoutMs(uint64_t &timeout_ms) {
+	if (timeout_override_ms > 0) {
+		timeout_ms = timeout_override_ms;
+		return true;
+	}
+	if (operation_policy) {
+		timeout_ms = operation_policy->timeout_ms;
+		return operation_policy->has_timeout;
+	}
+	Value result;
+	FileOpenerInfo info;
+	if (TryGetOperationTimeoutSetting(result, info)) {
+		timeout_ms = result.GetValue<uint64_t>();
+		return true;
+	}
+	// Fall back to http_timeout, which is in seconds.
+	if (inner_opener.TryGetCurrentSetting("http_timeout", result, info) && !result.IsNull()) {
+		timeout_ms = result.GetValue<uint64_t>() * MILLISECONDS_PER_SECOND;
+		return true;
+	}
+	return false;
+}
+
+bool TimeoutRetryFileOpener::TryGetRetries(uint64_t &retries) {
+	if (operation_policy) {
+		retries = operation_policy->retry.max_retries;
+		return operation_policy->has_retries;
+	}
+	Value result;
+	FileOpenerInfo info;
+	if (TryGetOperationRetrySetting(result, info)) {
+		retries = result.GetValue<uint64_t>();
+		return true;
+	}
+	if (inner_opener.TryGetCurrentSetting("http_retries", result, info) && !result.IsNull()) {
+		retries = result.GetValue<uint64_t>();
+		return true;
+	}
+	return false;
+}
+
+bool TimeoutRetryFileOpener::TryGetRetryWaitMs(uint64_t &retry_wait_ms) {
+	Value result;
+	FileOpenerInfo info;
+	if (TryGetOperationRetryWaitSetting(result, info) ||
+	    (inner_opener.TryGetCurrentSetting("http_retry_wait_ms", result, info) && !result.IsNull())) {
+		retry_wait_ms = result.GetValue<uint64_t>();
+		return true;
+	}
+	return false;
+}
+
+bool TimeoutRetryFileOpener::TryGetRetryBackoff(double &retry_backoff) {
+	Value result;
+	FileOpenerInfo info;
+	if (TryGetOperationRetryBackoffSetting(result, info) ||
+	    (inner_opener.TryGetCurrentSetting("http_retry_backoff", result, info) && !result.IsNull())) {
+		retry_backoff = result.GetValue<double>();
+		return true;
+	}
+	return false;
+}
+
+bool TimeoutRetryFileOpener::TryGetRetryMaxWaitMs(uint64_t &retry_max_wait_ms) {
+	Value result;
+	FileOpenerInfo info;
+	if (TryGetOperationRetryMaxWaitSetting(result, info)) {
+		retry_max_wait_ms = result.GetValue<uint64_t>();
+		return true;
+	}
+	return false;
+}
+
+bool TimeoutRetryFileOpener::TryGetNonNullSetting(const string &key, Value &result, FileOpenerInfo &info) {
+	return FileOpener::TryGetCurrentSetting(&inner_opener, key, result, &info) && !result.IsNull();
+}
+
+bool TimeoutRetryFileOpener::TryGetOperationSetting(const string &setting_name,
+                                                    const string &file_operation_setting_name, Value &result,
+                                                    FileOpenerInfo &info) {
+	if (TryGetNonNullSetting(setting_name, result, info)) {
+		return true;
+	}
+	// Reads and writes fall back to file operation settings.
+	if (IsHandleOperation()) {
+		return TryGetNonNullSetting(file_operation_setting_name, result, info);
+	}
+	return false;
+}
+
+bool TimeoutRetryFileOpener::TryGetOperationTimeoutSetting(Value &result, FileOpenerInfo &info) {
+	return TryGetOperationSetting(GetTimeoutSettingName(), HTTPFS_TIMEOUT_FILE_OPERATION_MS, result, info);
+}
+
+bool TimeoutRetryFileOpener::TryGetOperationRetrySetting(Value &result, FileOpenerInfo &info) {
+	return TryGetOperationSetting(GetRetrySettingName(), HTTPFS_RETRIES_FILE_OPERATION, result, info);
+}
+
+bool TimeoutRetryFileOpener::TryGetOperationRetryWaitSetting(Value &result, FileOpenerInfo &info) {
+	return TryGetOperationSetting(RETRY_WAIT_SETTING_NAMES[static_cast<idx_t>(operation_type)],
+	                              HTTPFS_RETRY_WAIT_FILE_OPERATION_MS, result, info);
+}
+
+bool TimeoutRetryFileOpener::TryGetOperationRetryBackoffSetting(Value &result, FileOpenerInfo &info) {
+	return TryGetOperationSetting(RETRY_BACKOFF_SETTING_NAMES[static_cast<idx_t>(operation_type)],
+	                              HTTPFS_RETRY_BACKOFF_FILE_OPERATION, result, info);
+}
+
+bool TimeoutRetryFileOpener::TryGetOperationRetryMaxWaitSetting(Value &result, FileOpenerInfo &info) {
+	return TryGetOperationSetting(RETRY_MAX_WAIT_SETTING_NAMES[static_cast<idx_t>(operation_type)],
+	                              HTTPFS_RETRY_MAX_WAIT_FILE_OPERATION_MS, result, info);
+}
+
+bool TimeoutRetryFileOpener::IsHandleOperation() const {
+	return operation_type == HttpfsOperationType::READ || operation_type == HttpfsOperationType::WRITE;
+}
+
 SettingLookupResult TimeoutRetryFileOpener::TryGetCurrentSetting(const string &key, Value &result) {
 	FileOpenerInfo info;
 	return TryGetCurrentSetting(key, result, info);
@@ -79,6 +282,10 @@ string TimeoutRetryFileOpener::GetTimeoutSettingName() const {
 	switch (operation_type) {
 	case HttpfsOperationType::OPEN:
 		return HTTPFS_TIMEOUT_FILE_OPERATION_MS;
+	case HttpfsOperationType::READ:
+		return HTTPFS_TIMEOUT_READ_MS;
+	case HttpfsOperationType::WRITE:
+		return HTTPFS_TIMEOUT_WRITE_MS;
 	case HttpfsOperationType::LIST:
 		return HTTPFS_TIMEOUT_LIST_MS;
 	case HttpfsOperationType::DELETE:
@@ -97,6 +304,10 @@ string TimeoutRetryFileOpener::GetRetrySettingName() const {
 	switch (operation_type) {
 	case HttpfsOperationType::OPEN:
 		return HTTPFS_RETRIES_FILE_OPERATION;
+	case HttpfsOperationType::READ:
+		return HTTPFS_RETRIES_READ;
+	case HttpfsOperationType::WRITE:
+		return HTTPFS_RETRIES_WRITE;
 	case HttpfsOperationType::LIST:
 		return HTTPFS_RETRIES_LIST;
 	case HttpfsOperationType::DELETE:
@@ -0,0 +1,168 @@
+#include "timeout_retry_metrics.hpp"
+
+#include "duckdb/common/algorithm.hpp"
+
+#include <functional>
+#include <thread>
+
+namespace duckdb {
+
+namespace {
+
+// Get the shard index of the current thread, computed once per thread.
+idx_t GetThreadShardIndex() {
+	static thread_local const idx_t shard_index = std::hash<std::thread::id>()(std::this_thread::get_id());
+	return shard_index;
+}
+
+void UpdateMax(atomic<uint64_t> &max_value, uint64_t value) {
+	uint64_t current = max_value.load(std::memory_order_relaxed);
+	while (current < value && !max_value.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+	}
+}
+
+} // namespace
+
+//===--------------------------------------------------------------------===//
+// OperationMetrics
+//===--------------------------------------------------------------------===//
+
+OperationMetrics::OperationMetrics(HttpfsOperationType operation_type_p, string endpoint_p)
+    : operation_type(operation_type_p), endpoint(std::move(endpoint_p)) {
+}
+
+OperationMetrics::MetricsShard &OperationMetrics::GetShard() {
+	return shards[GetThreadShardIndex() % SHARD_COUNT];
+}
+
+void OperationMetrics::RecordLatency(MetricsShard &shard, uint64_t latency_us) {
+	shard.latency_histogram.Record(latency_us);
+	UpdateMax(shard.latency_max_us, latency_us);
+}
+
+void OperationMetrics::RecordSuccess(uint64_t latency_us, idx_t bytes) {
+	auto &shard = GetShard();
+	shard.requests.fetch_add(1, std::memory_order_relaxed);
+	shard.bytes.fetch_add(bytes, std::memory_order_relaxed);
+	RecordLatency(shard, latency_us);
+}
+
+void OperationMetrics::RecordError(uint64_t latency_us, bool is_timeout) {
+	auto &shard = GetShard();
+	shard.requests.fetch_add(1, std::memory_order_relaxed);
+	shard.errors.fetch_add(1, std::memory_order_relaxed);
+	if (is_timeout) {
+		shard.timeouts.fetch_add(1, std::memory_order_relaxed);
+	}
+	RecordLatency(shard, latency_us);
+}
+
+void OperationMetrics::RecordRetry() {
+	GetShard().retries.fetch_add(1, std::memory_order_relaxed);
+}
+
+void OperationMetrics::RecordRetryBudgetExhausted() {
+	GetShard().retry_budget_exhausted.fetch_add(1, std::memory_order_relaxed);
+}
+
+void OperationMetrics::RecordCircuitBreakerRejected() {
+	GetShard().circuit_breaker_rejected.fetch_add(1, std::memory_order_relaxed);
+}
+
+void OperationMetrics::RecordHedgedRequest() {
+	GetShard().hedged_requests.fetch_add(1, std::memory_order_relaxed);
+}
+
+void OperationMetrics::RecordDeduplicatedRequest() {
+	GetShard().deduplicated_requests.fetch_add(1, std::memory_order_relaxed);
+}
+
+void OperationMetrics::RecordQueueWait(uint64_t wait_us) {
+	auto &shard = GetShard();
+	shard.queued_requests.fetch_add(1, std::memory_order_relaxed);
+	shard.queue_wait_us.fetch_add(wait_us, std::memory_order_relaxed);
+}
+
+OperationMetricsSnapshot OperationMetrics::GetSnapshot() const {
+	OperationMetricsSnapshot snapshot;
+	snapshot.operation_type = operation_type;
+	snapshot.endpoint = endpoint;
+
+	vector<uint64_t> bucket_counts(LatencyHistogram::BUCKET_COUNT, 0);
+	for (const auto &shard : shards) {
+		snapshot.requests += shard.requests.load(std::memory_order_relaxed);
+		snapshot.errors += shard.errors.load(std::memory_order_relaxed);
+		snapshot.timeouts += shard.timeouts.load(std::memory_order_relaxed);
+		snapshot.retries += shard.retries.load(std::memory_order_relaxed);
+		snapshot.retry_budget_exhausted += shard.retry_budget_exhausted.load(std::memory_order_relaxed);
+		snapshot.circuit_breaker_rejected += shard.circuit_breaker_rejected.load(std::memory_order_relaxed);
+		snapshot.hedged_requests += shard.hedged_requests.load(std::memory_order_relaxed);
+		snapshot.deduplicated_requests += shard.deduplicated_requests.load(std::memory_order_relaxed);
+		snapshot.queued_requests += shard.queued_requests.load(std::memory_order_relaxed);
+		snapshot.queue_wait_us += shard.queue_wait_us.load(std::memory_order_relaxed);
+		snapshot.bytes += shard.bytes.load(std::memory_order_relaxed);
+		snapshot.latency_max_us =
+		    MaxValue<uint64_t>(snapshot.latency_max_us, shard.latency_max_us.load(std::memory_order_relaxed));
+		shard.latency_histogram.MergeInto(bucket_counts);
+	}
+
+	// Histogram buckets only give an upper bound, which shouldn't exceed the actual max latency.
+	snapshot.latency_p50_us =
+	    MinValue<uint64_t>(LatencyHistogram::GetPercentile(bucket_counts, 0.5), snapshot.latency_max_us);
+	snapshot.latency_p90_us =
+	    MinValue<uint64_t>(LatencyHistogram::GetPercentile(bucket_counts, 0.9), snapshot.latency_max_us);
+	snapshot.latency_p99_us =
+	    MinValue<uint64_t>(LatencyHistogram::GetPercentile(bucket_counts, 0.99), snapshot.latency_max_us);
+	return snapshot;
+}
+
+void OperationMetrics::Reset() {
+	for (auto &shard : shards) {
+		shard.requests.store(0, std::memory_order_relaxed);
+		shard.errors.store(0, std::memory_order_relaxed);
+		shard.timeouts.store(0, std::memory_order_relaxed);
+		shard.retries.store(0, std::memory_order_relaxed);
+		shard.retry_budget_exhausted.store(0, std::memory_order_relaxed);
+		shard.circuit_breaker_rejected.store(0, std::memory_order_relaxed);
+		shard.hedged_requests.store(0, std::memory_order_relaxed);
+		shard.deduplicated_requests.store(0, std::memory_order_relaxed);
+		shard.queued_requests.store(0, std::memory_order_relaxed);
+		shard.queue_wait_us.store(0, std::memory_order_relaxed);
+		shard.bytes.store(0, std::memory_order_relaxed);
+		shard.latency_max_us.store(0, std::memory_order_relaxed);
+		shard.latency_histogram.Reset();
+	}
+}
+
+//===--------------------------------------------------------------------===//
+// TimeoutRetryMetrics
+//===--------------------------------------------------------------------===//
+
+TimeoutRetryMetrics &TimeoutRetryMetrics::GetInstance() {
+	static TimeoutRetryMetrics metrics;
+	return metrics;
+}
+
+OperationMetrics &TimeoutRetryMetrics::GetOperationMetrics(HttpfsOperationType operation_type,
+                                                           const string &endpoint) {
+	return registry.GetOrCreate(GetOperationEndpointKey(operation_type, endpoint), operation_type, endpoint);
+}
+
+vector<OperationMetricsSnapshot> TimeoutRetryMetrics::GetSnapshots() const {
+	vector<OperationMetricsSnapshot> snapshots;
+	registry.ForEach([&snapshots](const OperationMetrics &metrics) { snapshots.emplace_back(metrics.GetSnapshot()); });
+	std::sort(snapshots.begin(), snapshots.end(),
+	          [](const OperationMetricsSnapshot &lhs, const OperationMetricsSnapshot &rhs) {
+		          if (lhs.endpoint != rhs.endpoint) {
+			          return lhs.endpoint < rhs.endpoint;
+		          }
+		          return static_cast<idx_t>(lhs.operation_type) < static_cast<idx_t>(rhs.operation_type);
+	          });
+	return snapshots;
+}
+
+void TimeoutRetryMetrics::Reset() {
+	registry.ForEach([](OperationMetrics &metrics) { metrics.Reset(); });
+}
+
+} // namespace duckdb
@@ -0,0 +1,271 @@
+#include "timeout_retry_policy.hpp"
+
+#include "duckdb/common/atomic.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "duckdb/main/client_context_file_opener.hpp"
+#include "duckdb/main/client_context_state.hpp"
+#include "httpfs_timeout_retry_settings.hpp"
+
+namespace duckdb {
+
+namespace {
+
+// httpfs settings which per-operation settings fall back to.
+constexpr idx_t HTTP_FALLBACK_SETTING_COUNT = 4;
+constexpr array<const char *, HTTP_FALLBACK_SETTING_COUNT> HTTP_FALLBACK_SETTING_NAMES {
+    "http_timeout", "http_retries", "http_retry_wait_ms", "http_retry_backoff"};
+
+// Max number of parts of a multipart upload, which the inner filesystem defaults to.
+constexpr uint64_t DEFAULT_UPLOADER_MAX_PARTS_PER_FILE = 10000;
+
+// Number of concurrent ranged requests a large read is split into, unless configured.
+constexpr idx_t DEFAULT_PARALLEL_READ_PARTS = 4;
+
+// Max size of a coalesced read request and time a read waits for others to coalesce with, unless configured.
+constexpr idx_t DEFAULT_READ_COALESCE_MAX_REQUEST_BYTES = 8 * 1024 * 1024;
+constexpr uint64_t DEFAULT_READ_COALESCE_WINDOW_US = 1000;
+
+// Key of the policy cache in the registered state of a client context.
+constexpr const char *POLICY_CACHE_STATE_KEY = "httpfs_timeout_retry_policy_cache";
+
+constexpr HttpfsOperationType ALL_OPERATION_TYPES[] = {
+    HttpfsOperationType::OPEN, HttpfsOperationType::LIST,       HttpfsOperationType::DELETE,
+    HttpfsOperationType::STAT, HttpfsOperationType::CREATE_DIR, HttpfsOperationType::READ,
+    HttpfsOperationType::WRITE};
+
+atomic<uint64_t> &GetPolicySettingsVersionState() {
+	static atomic<uint64_t> version {0};
+	return version;
+}
+
+void ReadFallbackSettings(FileOpener &opener, array<Value, HTTP_FALLBACK_SETTING_COUNT> &values) {
+	for (idx_t idx = 0; idx < HTTP_FALLBACK_SETTING_COUNT; ++idx) {
+		if (!FileOpener::TryGetCurrentSetting(&opener, HTTP_FALLBACK_SETTING_NAMES[idx], values[idx])) {
+			values[idx] = Value();
+		}
+	}
+}
+
+bool MatchesFallbackSettings(const array<Value, HTTP_FALLBACK_SETTING_COUNT> &lhs,
+                             const array<Value, HTTP_FALLBACK_SETTING_COUNT> &rhs) {
+	for (idx_t idx = 0; idx < HTTP_FALLBACK_SETTING_COUNT; ++idx) {
+		if (!Value::NotDistinctFrom(lhs[idx], rhs[idx])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool IsSingleFlightEnabled(FileOpener &opener) {
+	Value value;
+	return FileOpener::TryGetCurrentSetting(&opener, HTTPFS_ENABLE_SINGLE_FLIGHT, value) && !value.IsNull() &&
+	       value.GetValue<bool>();
+}
+
+UploadConfig GetUploadConfig(FileOpener &opener) {
+	UploadConfig config;
+	Value value;
+	if (FileOpener::TryGetCurrentSetting(&opener, HTTPFS_UPLOAD_PART_SIZE_BYTES, value) && !value.IsNull()) {
+		config.part_size = value.GetValue<uint64_t>();
+		if (config.part_size == 0) {
+			throw InvalidInputException("%s should be positive", HTTPFS_UPLOAD_PART_SIZE_BYTES);
+		}
+	}
+	if (FileOpener::TryGetCurrentSetting(&opener, HTTPFS_UPLOAD_CONCURRENCY, value) && !value.IsNull()) {
+		config.concurrency = value.GetValue<uint64_t>();
+		if (config.concurrency == 0) {
+			throw InvalidInputException("%s should be positive", HTTPFS_UPLOAD_CONCURRENCY);
+		}
+	}
+	if (FileOpener::TryGetCurrentSetting(&opener, HTTPFS_UPLOAD_PART_TIMEOUT_MS, value) && !value.IsNull()) {
+		config.has_part_timeout = true;
+		config.part_timeout_ms = value.GetValue<uint64_t>();
+	}
+	if (FileOpener::TryGetCurrentSetting(&opener, HTTPFS_UPLOAD_PART_RETRIES, value) && !value.IsNull()) {
+		config.has_part_retries = true;
+		config.part_retries = value.GetValue<uint64_t>();
+	}
+	return config;
+}
+
+TimeoutRetryHandleConfig GetHandleReadConfig(FileOpener &opener) {
+	TimeoutRetryHandleConfig config;
+	Value value;
+	if (FileOpener::TryGetCurrentSetting(&opener, HTTPFS_HEDGE_READ_DELAY_MS, value) && !value.IsNull()) {
+		config.hedge_read = true;
+		config.hedge_delay_ms = value.GetValue<uint64_t>();
+	}
+	if (FileOpener::TryGetCurrentSetting(&opener, HTTPFS_HEDGE_READ_PERCENTILE, value) && !value.IsNull()) {
+		const double percentile = value.GetValue<double>();
+		if (percentile <= 0 || percentile > 1) {
+			throw InvalidInputException("%s should be in range (0, 1], but got %f", HTTPFS_HEDGE_READ_PERCENTILE,
+			                            percentile);
+		}
+		config.hedge_read = true;
+		config.hedge_percentile = percentile;
+	}
+	if (FileOpener::TryGetCurrentSetting(&opener, HTTPFS_READ_AHEAD_MAX_BYTES, value) && !value.IsNull()) {
+		config.read_ahead_max_bytes = value.GetValue<uint64_t>();
+	}
+	if (FileOpener::TryGetCurrentSetting(&opener, HTTPFS_READ_COALESCE_MAX_GAP_BYTES, value) && !value.IsNull()) {
+		config.read_coalesce = true;
+		config.read_coalesce_max_gap_bytes = value.GetValue<uint64_t>();
+		config.read_coalesce_max_request_bytes = DEFAULT_READ_COALESCE_MAX_REQUEST_BYTES;
+		if (FileOpener::TryGetCurrentSetting(&opener, HTTPFS_READ_COALESCE_MAX_REQUEST_BYTES, value) &&
+		    !value.IsNull()) {
+			config.read_coalesce_max_request_bytes = value.GetValue<uint64_t>();
+		}
+		if (config.read_coalesce_max_request_bytes == 0) {
+			throw InvalidInputException("%s should be positive", HTTPFS_READ_COALESCE_MAX_REQUEST_BYTES);
+		}
+		config.read_coalesce_window_us = DEFAULT_READ_COALESCE_WINDOW_US;
+		if (FileOpener::TryGetCurrentSetting(&opener, HTTPFS_READ_COALESCE_WINDOW_US, value) && !value.IsNull()) {
+			config.read_coalesce_window_us = value.GetValue<uint64_t>();
+		}
+	}
+	if (FileOpener::TryGetCurrentSetting(&opener, HTTPFS_PARALLEL_READ_THRESHOLD_BYTES, value) && !value.IsNull()) {
+		config.parallel_read_threshold = value.GetValue<uint64_t>();
+		config.parallel_read_parts = DEFAULT_PARALLEL_READ_PARTS;
+		if (FileOpener::TryGetCurrentSetting(&opener, HTTPFS_PARALLEL_READ_PARTS, value) && !value.IsNull()) {
+			config.parallel_read_parts = value.GetValue<uint64_t>();
+		}
+		if (config.parallel_read_parts == 0) {
+			throw InvalidInputException("%s should be positive", HTTPFS_PARALLEL_READ_PARTS);
+		}
+	}
+	return config;
+}
+
+// Get the value of a parallelism setting, 0 if not set.
+idx_t GetParallelism(FileOpener &opener, const char *setting_name) {
+	Value value;
+	if (!FileOpener::TryGetCurrentSetting(&opener, setting_name, value) || value.IsNull()) {
+		return 0;
+	}
+	const auto parallelism = value.GetValue<uint64_t>();
+	if (parallelism == 0) {
+		throw InvalidInputException("%s should be positive", setting_name);
+	}
+	return parallelism;
+}
+
+void ResolveOperationPolicies(FileOpener &opener, array<OperationPolicy, HTTPFS_OPERATION_TYPE_COUNT> &operations) {
+	for (const auto operation_type : ALL_OPERATION_TYPES) {
+		TimeoutRetryFileOpener operation_opener(opener, operation_type);
+		auto &policy = operations[static_cast<idx_t>(operation_type)];
+		uint64_t retries = 0;
+		policy.has_timeout = operation_opener.TryGetTimeoutMs(policy.timeout_ms);
+		policy.has_retries = operation_opener.TryGetRetries(retries);
+		policy.retry = GetRetryConfig(operation_opener);
+	}
+}
+
+class PolicyCacheState : public ClientContextState {
+public:
+	// Settings changed by the statement are stored by now, so snapshots resolved from here on pick them up.
+	void QueryEnd(ClientContext &context) override {
+		bool changed = settings_changed;
+		settings_changed = false;
+		ClientContextFileOpener opener(context);
+		array<Value, HTTP_FALLBACK_SETTING_COUNT> current_fallback_settings;
+		ReadFallbackSettings(opener, current_fallback_settings);
+		if (has_fallback_settings && !MatchesFallbackSettings(fallback_settings, current_fallback_settings)) {
+			changed = true;
+		}
+		fallback_settings = std::move(current_fallback_settings);
+		has_fallback_settings = true;
+		if (changed) {
+			BumpPolicySettingsVersion();
+		}
+	}
+
+	TimeoutRetryPolicyCache cache;
+	// Whether the running statement sets or resets an extension setting.
+	bool settings_changed = false;
+	// Values of the httpfs fallback settings at the end of the last query.
+	bool has_fallback_settings = false;
+	array<Value, HTTP_FALLBACK_SETTING_COUNT> fallback_settings;
+};
+
+PolicyCacheState &GetPolicyCacheState(ClientContext &context) {
+	return *context.registered_state->GetOrCreate<PolicyCacheState>(POLICY_CACHE_STATE_KEY);
+}
+
+} // namespace
+
+//===--------------------------------------------------------------------===//
+// Settings version
+//===--------------------------------------------------------------------===//
+
+uint64_t GetPolicySettingsVersion() {
+	return GetPolicySettingsVersionState().load(std::memory_order_acquire);
+}
+
+void BumpPolicySettingsVersion() {
+	GetPolicySettingsVersionState().fetch_add(1, std::memory_order_acq_rel);
+}
+
+void OnPolicySettingChanged(ClientContext &context, SetScope scope, Value &parameter) {
+	GetPolicyCacheState(context).settings_changed = true;
+}
+
+//===--------------------------------------------------------------------===//
+// Policy resolution
+//===--------------------------------------------------------------------===//
+
+shared_ptr<const TimeoutRetryPolicySnapshot> ResolveTimeoutRetryPolicies(FileOpener &opener) {
+	auto snapshot = make_shared_ptr<TimeoutRetryPolicySnapshot>();
+	// Take the version before reading settings, so a change made meanwhile leaves the snapshot outdated.
+	snapshot->settings_version = GetPolicySettingsVersion();
+	ResolveOperationPolicies(opener, snapshot->operations);
+	// Each prefix gets policies of its own, resolved with its overrides over the settings, so operations only look up
+	// the longest matching prefix.
+	const auto prefix_overrides = GetPrefixPolicyOverrides(opener);
+	snapshot->prefix_operations.resize(prefix_overrides.size());
+	for (idx_t idx = 0; idx < prefix_overrides.size(); ++idx) {
+		PrefixOverrideFileOpener prefix_opener(opener, prefix_overrides[idx]);
+		ResolveOperationPolicies(prefix_opener, snapshot->prefix_operations[idx]);
+		snapshot->prefix_trie.Insert(prefix_overrides[idx].prefix, idx);
+	}
+	snapshot->fault_injection = GetFaultInjectionConfig(opener);
+	snapshot->adaptive_timeout = GetAdaptiveTimeoutConfig(opener);
+	snapshot->metadata_cache = GetMetadataCacheConfig(opener);
+	snapshot->listing_cache = GetListingCacheConfig(opener);
+	snapshot->single_flight = IsSingleFlightEnabled(opener);
+	snapshot->handle = GetHandleReadConfig(opener);
+	snapshot->handle.single_flight = snapshot->single_flight;
+	snapshot->upload = GetUploadConfig(opener);
+	snapshot->block_cache = GetBlockCacheConfig(opener);
+	snapshot->delete_parallelism = GetParallelism(opener, HTTPFS_DELETE_PARALLELISM);
+	snapshot->glob_parallelism = GetParallelism(opener, HTTPFS_GLOB_PARALLELISM);
+	return snapshot;
+}
+
+//===--------------------------------------------------------------------===//
+// TimeoutRetryPolicyCache
+//===--------------------------------------------------------------------===//
+
+shared_ptr<const TimeoutRetryPolicySnapshot> TimeoutRetryPolicyCache::Get(FileOpener &opener) {
+	const auto version = GetPolicySettingsVersion();
+	{
+		lock_guard<mutex> lck(cache_mutex);
+		if (snapshot && snapshot->settings_version == version) {
+			return snapshot;
+		}
+	}
+
+	auto resolved = ResolveTimeoutRetryPolicies(opener);
+	lock_guard<mutex> lck(cache_mutex);
+	// Concurrent operations could resolve at once, a snapshot of an older version doesn't replace a newer one.
+	if (!snapshot || snapshot->settings_version <= resolved->settings_version) {
+		snapshot = resolved;
+	}
+	return resolved;
+}
+
+TimeoutRetryPolicyCache &GetClientPolicyCache(ClientContext &context) {
+	return GetPolicyCacheState(context).cache;
+}
+
+} // namespace duckdb
@@ -0,0 +1,116 @@
+#include "timeout_retry_stats_function.hpp"
+
+#include "duckdb/common/types/data_chunk.hpp"
+#include "duckdb/common/types/vector.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "timeout_retry_metrics.hpp"
+
+namespace duckdb {
+
+namespace {
+
+constexpr double MICROSECONDS_PER_MILLISECOND = 1000.0;
+
+struct TimeoutRetryStatsData : public GlobalTableFunctionState {
+	vector<OperationMetricsSnapshot> snapshots;
+	// Index of the next snapshot to emit.
+	idx_t offset = 0;
+};
+
+unique_ptr<FunctionData> TimeoutRetryStatsBind(ClientContext &context, TableFunctionBindInput &input,
+                                               vector<LogicalType> &return_types, vector<string> &names) {
+	names.emplace_back("operation");
+	return_types.emplace_back(LogicalType::VARCHAR);
+	names.emplace_back("endpoint");
+	return_types.emplace_back(LogicalType::VARCHAR);
+	names.emplace_back("requests");
+	return_types.emplace_back(LogicalType::UBIGINT);
+	names.emplace_back("errors");
+	return_types.emplace_back(LogicalType::UBIGINT);
+	names.emplace_back("timeouts");
+	return_types.emplace_back(LogicalType::UBIGINT);
+	names.emplace_back("retries");
+	return_types.emplace_back(LogicalType::UBIGINT);
+	names.emplace_back("retry_budget_exhausted");
+	return_types.emplace_back(LogicalType::UBIGINT);
+	names.emplace_back("circuit_breaker_rejected");
+	return_types.emplace_back(LogicalType::UBIGINT);
+	names.emplace_back("hedged_requests");
+	return_types.emplace_back(LogicalType::UBIGINT);
+	names.emplace_back("deduplicated_requests");
+	return_types.emplace_back(LogicalType::UBIGINT);
+	names.emplace_back("queued_requests");
+	return_types.emplace_back(LogicalType::UBIGINT);
+	names.emplace_back("queue_wait_ms");
+	return_types.emplace_back(LogicalType::DOUBLE);
+	names.emplace_back("bytes");
+	return_types.emplace_back(LogicalType::UBIGINT);
+	names.emplace_back("latency_p50_ms");
+	return_types.emplace_back(LogicalType::DOUBLE);
+	names.emplace_back("latency_p90_ms");
+	return_types.emplace_back(LogicalType::DOUBLE);
+	names.emplace_back("latency_p99_ms");
+	return_types.emplace_back(LogicalType::DOUBLE);
+	names.emplace_back("latency_max_ms");
+	return_types.emplace_back(LogicalType::DOUBLE);
+	return nullptr;
+}
+
+unique_ptr<GlobalTableFunctionState> TimeoutRetryStatsInit(ClientContext &context, TableFunctionInitInput &input) {
+	auto state = make_uniq<TimeoutRetryStatsData>();
+	state->snapshots = TimeoutRetryMetrics::GetInstance().GetSnapshots();
+	return std::move(state);
+}
+
+Value GetLatencyMsValue(uint64_t latency_us) {
+	return Value::DOUBLE(static_cast<double>(latency_us) / MICROSECONDS_PER_MILLISECOND);
+}
+
+void TimeoutRetryStatsFunc(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+	auto &state = data_p.global_state->Cast<TimeoutRetryStatsData>();
+	idx_t count = 0;
+	while (state.offset < state.snapshots.size() && count < STANDARD_VECTOR_SIZE) {
+		const auto &snapshot = state.snapshots[state.offset++];
+		idx_t col = 0;
+		output.SetValue(col++, count, Value(HttpfsOperationTypeToString(snapshot.operation_type)));
+		output.SetValue(col++, count, Value(snapshot.endpoint));
+		output.SetValue(col++, count, Value::UBIGINT(snapshot.requests));
+		output.SetValue(col++, count, Value::UBIGINT(snapshot.errors));
+		output.SetValue(col++, count, Value::UBIGINT(snapshot.timeouts));
+		output.SetValue(col++, count, Value::UBIGINT(snapshot.retries));
+		output.SetValue(col++, count, Value::UBIGINT(snapshot.retry_budget_exhausted));
+		output.SetValue(col++, count, Value::UBIGINT(snapshot.circuit_breaker_rejected));
+		output.SetValue(col++, count, Value::UBIGINT(snapshot.hedged_requests));
+		output.SetValue(col++, count, Value::UBIGINT(snapshot.deduplicated_requests));
+		output.SetValue(col++, count, Value::UBIGINT(snapshot.queued_requests));
+		output.SetValue(col++, count, GetLatencyMsValue(snapshot.queue_wait_us));
+		output.SetValue(col++, count, Value::UBIGINT(snapshot.bytes));
+		output.SetValue(col++, count, GetLatencyMsValue(snapshot.latency_p50_us));
+		output.SetValue(col++, count, GetLatencyMsValue(snapshot.latency_p90_us));
+		output.SetValue(col++, count, GetLatencyMsValue(snapshot.latency_p99_us));
+		output.SetValue(col++, count, GetLatencyMsValue(snapshot.latency_max_us));
+		++count;
+	}
+	output.SetCardinality(count);
+}
+
+void TimeoutRetryStatsResetFunc(DataChunk &args, ExpressionState &state, Vector &result) {
+	TimeoutRetryMetrics::GetInstance().Reset();
+	result.Reference(Value::BOOLEAN(true));
+}
+
+} // namespace
+
+TableFunction GetTimeoutRetryStatsFunction() {
+	return TableFunction("httpfs_timeout_retry_stats", /*arguments=*/ {}, TimeoutRetryStatsFunc,
+	                     TimeoutRetryStatsBind, TimeoutRetryStatsInit);
+}
+
+ScalarFunction GetTimeoutRetryStatsResetFunction() {
+	ScalarFunction reset_function("httpfs_timeout_retry_stats_reset", /*arguments=*/ {}, LogicalType::BOOLEAN,
+	                              TimeoutRetryStatsResetFunc);
+	reset_function.stability = FunctionStability::VOLATILE;
+	return reset_function;
+}
+
+} // namespace duckdb
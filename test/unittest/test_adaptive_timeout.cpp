@@ -0,0 +1,125 @@
+#include "catch/catch.hpp"
+#include "adaptive_timeout.hpp"
+#include "duckdb/main/database.hpp"
+#include "duckdb/main/database_file_opener.hpp"
+
+using namespace duckdb;
+
+namespace {
+void RegisterExtensionOptions(DBConfig &db_config) {
+	db_config.AddExtensionOption("httpfs_timeout_stat_ms", "Timeout for stat/metadata operations (in milliseconds)",
+	                             LogicalType {LogicalTypeId::UBIGINT}, Value());
+	db_config.AddExtensionOption("httpfs_retries_stat", "Maximum number of retries for stat/metadata operations",
+	                             LogicalType {LogicalTypeId::UBIGINT}, Value());
+	db_config.AddExtensionOption("httpfs_adaptive_timeout_multiplier", "Adaptive timeout multiplier",
+	                             LogicalType {LogicalTypeId::DOUBLE}, Value());
+	db_config.AddExtensionOption("httpfs_adaptive_timeout_min_ms", "Lower bound of adaptive timeout",
+	                             LogicalType {LogicalTypeId::UBIGINT}, Value());
+	db_config.AddExtensionOption("httpfs_adaptive_timeout_max_ms", "Upper bound of adaptive timeout",
+	                             LogicalType {LogicalTypeId::UBIGINT}, Value());
+}
+} // namespace
+
+TEST_CASE("Test adaptive timeout estimation", "[adaptive_timeout]") {
+	AdaptiveTimeoutConfig config;
+	config.multiplier = 2;
+	config.min_timeout_ms = 10;
+	config.max_timeout_ms = 1000;
+
+	AdaptiveTimeoutEstimator estimator;
+	uint64_t timeout_ms = 0;
+	REQUIRE(!estimator.TryGetTimeoutMs(config, timeout_ms));
+
+	// 100 milliseconds latency.
+	for (idx_t idx = 0; idx < AdaptiveTimeoutEstimator::MIN_SAMPLES; ++idx) {
+		estimator.Record(100000);
+	}
+	REQUIRE(estimator.TryGetTimeoutMs(config, timeout_ms));
+	REQUIRE(timeout_ms == 200);
+
+	// Clamped by upper bound.
+	for (idx_t idx = 0; idx < AdaptiveTimeoutEstimator::WINDOW_SIZE; ++idx) {
+		estimator.Record(10000000);
+	}
+	REQUIRE(estimator.TryGetTimeoutMs(config, timeout_ms));
+	REQUIRE(timeout_ms == 1000);
+
+	// Clamped by lower bound.
+	for (idx_t idx = 0; idx < AdaptiveTimeoutEstimator::WINDOW_SIZE; ++idx) {
+		estimator.Record(1);
+	}
+	REQUIRE(estimator.TryGetTimeoutMs(config, timeout_ms));
+	REQUIRE(timeout_ms == 10);
+}
+
+TEST_CASE("Test adaptive timeout of reads by size class", "[adaptive_timeout]") {
+	AdaptiveTimeoutConfig config;
+	config.enabled = true;
+	config.multiplier = 3;
+	config.min_timeout_ms = 10;
+	config.max_timeout_ms = 60000;
+
+	// Small reads are fast, large reads slow; each size class gets a timeout of its own.
+	ReadLatencyTrackers trackers;
+	for (idx_t idx = 0; idx < AdaptiveTimeoutEstimator::MIN_SAMPLES; ++idx) {
+		trackers.GetTracker(4096).Record(20000);
+		trackers.GetTracker(64 * 1024 * 1024).Record(2000000);
+	}
+	uint64_t timeout_ms = 0;
+	REQUIRE(TryGetAdaptiveTimeoutMs(config, trackers.GetTracker(4096), timeout_ms));
+	REQUIRE(timeout_ms == 60);
+	REQUIRE(TryGetAdaptiveTimeoutMs(config, trackers.GetTracker(64 * 1024 * 1024), timeout_ms));
+	REQUIRE(timeout_ms == 6000);
+	// Size classes without enough observations keep the static timeout.
+	REQUIRE(!TryGetAdaptiveTimeoutMs(config, trackers.GetTracker(512 * 1024), timeout_ms));
+}
+
+TEST_CASE("Test adaptive timeout applied to opener", "[adaptive_timeout]") {
+	DBConfig config;
+	DuckDB db(nullptr, &config);
+	DatabaseInstance &db_instance = *db.instance;
+	auto &db_config = DBConfig::GetConfig(db_instance);
+
+	RegisterExtensionOptions(db_config);
+	db_config.SetOptionByName("httpfs_timeout_stat_ms", Value::UBIGINT(20000));
+	DatabaseFileOpener opener(db_instance);
+	const string endpoint = "s3://test-adaptive-timeout";
+
+	// Adaptive timeout disabled.
+	{
+		TimeoutRetryFileOpener timeout_retry_opener(opener, HttpfsOperationType::STAT);
+		REQUIRE(ApplyAdaptiveTimeout(GetAdaptiveTimeoutConfig(opener), timeout_retry_opener, endpoint) == nullptr);
+	}
+
+	db_config.SetOptionByName("httpfs_adaptive_timeout_multiplier", Value::DOUBLE(3));
+	db_config.SetOptionByName("httpfs_adaptive_timeout_min_ms", Value::UBIGINT(1000));
+
+	// No observation yet, fall back to static timeout.
+	{
+		TimeoutRetryFileOpener timeout_retry_opener(opener, HttpfsOperationType::STAT);
+		auto estimator = ApplyAdaptiveTimeout(GetAdaptiveTimeoutConfig(opener), timeout_retry_opener, endpoint);
+		REQUIRE(estimator != nullptr);
+		uint64_t timeout_ms = 0;
+		REQUIRE(timeout_retry_opener.TryGetTimeoutMs(timeout_ms));
+		REQUIRE(timeout_ms == 20000);
+
+		// 1 second latency.
+		for (idx_t idx = 0; idx < AdaptiveTimeoutEstimator::MIN_SAMPLES; ++idx) {
+			estimator->Record(1000000);
+		}
+	}
+
+	// Timeout derived from observed latency.
+	{
+		TimeoutRetryFileOpener timeout_retry_opener(opener, HttpfsOperationType::STAT);
+		REQUIRE(ApplyAdaptiveTimeout(GetAdaptiveTimeoutConfig(opener), timeout_retry_opener, endpoint) != nullptr);
+		uint64_t timeout_ms = 0;
+		REQUIRE(timeout_retry_opener.TryGetTimeoutMs(timeout_ms));
+		REQUIRE(timeout_ms == 3000);
+
+		Value timeout_value;
+		auto timeout_result = FileOpener::TryGetCurrentSetting(&timeout_retry_opener, "http_timeout", timeout_value);
+		REQUIRE(static_cast<bool>(timeout_result));
+		REQUIRE(timeout_value.GetValue<uint64_t>() == 3);
+	}
+}
@@ -0,0 +1,61 @@
+#include "catch/catch.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/main/database.hpp"
+#include "file_system_timeout_retry_wrapper.hpp"
+
+#include <algorithm>
+
+using namespace duckdb;
+
+namespace {
+
+// Object storage filesystem whose multi-object deletes fail as a whole, and which refuses single deletes of keys
+// containing "locked".
+class BatchDeleteTestFileSystem : public FileSystem {
+public:
+	void RemoveFiles(const vector<string> &filenames, optional_ptr<FileOpener> opener = nullptr) override {
+		throw PermissionException("Failed to delete %llu keys", filenames.size());
+	}
+	void RemoveFile(const string &filename, optional_ptr<FileOpener> opener = nullptr) override {
+		if (StringUtil::Contains(filename, "locked")) {
+			throw PermissionException("Access Denied for %s", filename);
+		}
+		lock_guard<mutex> lck(removed_mutex);
+		removed_files.push_back(filename);
+	}
+	string GetName() const override {
+		return "BatchDeleteTestFileSystem";
+	}
+
+	mutex removed_mutex;
+	vector<string> removed_files;
+};
+
+} // namespace
+
+TEST_CASE("Test failed batch delete reports each file", "[batched_delete]") {
+	DBConfig config;
+	DuckDB db(nullptr, &config);
+	DatabaseInstance &db_instance = *db.instance;
+	auto &db_config = DBConfig::GetConfig(db_instance);
+	db_config.AddExtensionOption("httpfs_delete_parallelism", "Max number of concurrent delete requests",
+	                             LogicalType {LogicalTypeId::UBIGINT}, Value());
+	db_config.SetOptionByName("httpfs_delete_parallelism", Value::UBIGINT(4));
+
+	auto test_filesystem = make_uniq<BatchDeleteTestFileSystem>();
+	auto &removed_files = test_filesystem->removed_files;
+	FileSystemTimeoutRetryWrapper wrapper(std::move(test_filesystem), db_instance);
+
+	const vector<string> filenames {"s3://batch-delete-bucket/a", "s3://batch-delete-bucket/locked",
+	                                "s3://batch-delete-bucket/b"};
+	// Only the refused file is reported, with its own error rather than the one of the batch.
+	REQUIRE_THROWS_WITH(wrapper.RemoveFiles(filenames),
+	                    Catch::Contains("Failed to remove 1 of 3 files") &&
+	                        Catch::Contains("Access Denied for s3://batch-delete-bucket/locked") &&
+	                        !Catch::Contains("Failed to delete 3 keys"));
+	std::sort(removed_files.begin(), removed_files.end());
+	REQUIRE(removed_files == vector<string> {"s3://batch-delete-bucket/a", "s3://batch-delete-bucket/b"});
+}
@@ -0,0 +1,65 @@
+#include "catch/catch.hpp"
+#include "circuit_breaker.hpp"
+
+#include <chrono>
+
+using namespace duckdb;
+
+namespace {
+CircuitBreakerConfig GetTestConfig() {
+	CircuitBreakerConfig config;
+	config.enabled = true;
+	config.failure_threshold = 3;
+	config.cool_down_ms = 1000;
+	return config;
+}
+} // namespace
+
+TEST_CASE("Test circuit breaker trips after consecutive failures", "[circuit_breaker]") {
+	const auto config = GetTestConfig();
+	CircuitBreaker breaker("s3://bucket");
+	const auto now = std::chrono::steady_clock::now();
+
+	// Success in between resets the failure count.
+	breaker.RecordFailure(config, now);
+	breaker.RecordFailure(config, now);
+	breaker.RecordSuccess();
+	breaker.RecordFailure(config, now);
+	breaker.RecordFailure(config, now);
+	REQUIRE(breaker.GetState() == CircuitBreaker::State::CLOSED);
+	REQUIRE(breaker.TryAcquire(config, now));
+
+	breaker.RecordFailure(config, now);
+	REQUIRE(breaker.GetState() == CircuitBreaker::State::OPEN);
+	REQUIRE(!breaker.TryAcquire(config, now));
+	REQUIRE(!breaker.TryAcquire(config, now + std::chrono::milliseconds(999)));
+}
+
+TEST_CASE("Test circuit breaker half-open probe", "[circuit_breaker]") {
+	const auto config = GetTestConfig();
+	CircuitBreaker breaker("s3://bucket");
+	auto now = std::chrono::steady_clock::now();
+	for (idx_t idx = 0; idx < config.failure_threshold; ++idx) {
+		breaker.RecordFailure(config, now);
+	}
+	REQUIRE(breaker.GetState() == CircuitBreaker::State::OPEN);
+
+	// Only one probe goes through after cool-down.
+	now += std::chrono::milliseconds(config.cool_down_ms);
+	REQUIRE(breaker.TryAcquire(config, now));
+	REQUIRE(breaker.GetState() == CircuitBreaker::State::HALF_OPEN);
+	REQUIRE(!breaker.TryAcquire(config, now));
+
+	// Failed probe opens the breaker for another cool-down.
+	breaker.RecordFailure(config, now);
+	REQUIRE(breaker.GetState() == CircuitBreaker::State::OPEN);
+	REQUIRE(!breaker.TryAcquire(config, now));
+
+	// Successful probe closes the breaker.
+	now += std::chrono::milliseconds(config.cool_down_ms);
+	REQUIRE(breaker.TryAcquire(config, now));
+	breaker.RecordSuccess();
+	REQUIRE(breaker.GetState() == CircuitBreaker::State::CLOSED);
+	REQUIRE(breaker.TryAcquire(config, now));
+	REQUIRE(breaker.TryAcquire(config, now));
+}
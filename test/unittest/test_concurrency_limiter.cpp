@@ -0,0 +1,131 @@
+#include "catch/catch.hpp"
+#include "concurrency_limiter.hpp"
+
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/vector.hpp"
+
+#include <chrono>
+#include <thread>
+
+using namespace duckdb;
+
+namespace {
+ConcurrencyLimitConfig MakeConfig(uint64_t max_requests, uint64_t max_requests_per_operation = 0) {
+	ConcurrencyLimitConfig config;
+	config.enabled = true;
+	config.max_requests = max_requests;
+	config.max_requests_per_operation = max_requests_per_operation;
+	return config;
+}
+
+// Wait until [count] requests are queued on [limiter].
+void WaitForWaiters(const ConcurrencyLimiter &limiter, idx_t count) {
+	while (limiter.GetWaitingCount() < count) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+}
+} // namespace
+
+TEST_CASE("Test concurrency limiter bounds in-flight requests", "[concurrency_limiter]") {
+	ConcurrencyLimiter limiter;
+	const auto config = MakeConfig(/*max_requests=*/2);
+
+	REQUIRE(limiter.TryAcquire(HttpfsOperationType::READ, config));
+	REQUIRE(limiter.TryAcquire(HttpfsOperationType::STAT, config));
+	REQUIRE_FALSE(limiter.TryAcquire(HttpfsOperationType::READ, config));
+	REQUIRE(limiter.GetInFlightCount() == 2);
+
+	limiter.Release(HttpfsOperationType::READ);
+	REQUIRE(limiter.TryAcquire(HttpfsOperationType::READ, config));
+	limiter.Release(HttpfsOperationType::READ);
+	limiter.Release(HttpfsOperationType::STAT);
+	REQUIRE(limiter.GetInFlightCount() == 0);
+}
+
+TEST_CASE("Test concurrency limiter bounds in-flight requests per operation", "[concurrency_limiter]") {
+	ConcurrencyLimiter limiter;
+	const auto config = MakeConfig(/*max_requests=*/3, /*max_requests_per_operation=*/2);
+
+	REQUIRE(limiter.TryAcquire(HttpfsOperationType::READ, config));
+	REQUIRE(limiter.TryAcquire(HttpfsOperationType::READ, config));
+	REQUIRE_FALSE(limiter.TryAcquire(HttpfsOperationType::READ, config));
+	// Other operations still get the remaining slot.
+	REQUIRE(limiter.TryAcquire(HttpfsOperationType::LIST, config));
+	REQUIRE_FALSE(limiter.TryAcquire(HttpfsOperationType::LIST, config));
+
+	limiter.Release(HttpfsOperationType::READ);
+	limiter.Release(HttpfsOperationType::READ);
+	limiter.Release(HttpfsOperationType::LIST);
+}
+
+TEST_CASE("Test concurrency limiter serves metadata operations ahead of reads", "[concurrency_limiter]") {
+	ConcurrencyLimiter limiter;
+	const auto config = MakeConfig(/*max_requests=*/1);
+	REQUIRE(limiter.TryAcquire(HttpfsOperationType::READ, config));
+
+	mutex order_mutex;
+	vector<HttpfsOperationType> order;
+	vector<uint64_t> wait_times;
+	auto acquire = [&](HttpfsOperationType operation_type) {
+		const auto wait_us = limiter.Acquire(operation_type, config);
+		{
+			lock_guard<mutex> lck(order_mutex);
+			order.emplace_back(operation_type);
+			wait_times.emplace_back(wait_us);
+		}
+		limiter.Release(operation_type);
+	};
+
+	// Reads queue first, then a stat arrives and goes ahead of them.
+	std::thread first_read(acquire, HttpfsOperationType::READ);
+	WaitForWaiters(limiter, 1);
+	std::thread second_read(acquire, HttpfsOperationType::READ);
+	WaitForWaiters(limiter, 2);
+	std::thread stat(acquire, HttpfsOperationType::STAT);
+	WaitForWaiters(limiter, 3);
+
+	limiter.Release(HttpfsOperationType::READ);
+	first_read.join();
+	second_read.join();
+	stat.join();
+
+	REQUIRE(order.size() == 3);
+	REQUIRE(order[0] == HttpfsOperationType::STAT);
+	REQUIRE(order[1] == HttpfsOperationType::READ);
+	REQUIRE(order[2] == HttpfsOperationType::READ);
+	// Every request waited in the queue.
+	for (const auto wait_us : wait_times) {
+		REQUIRE(wait_us > 0);
+	}
+	REQUIRE(limiter.GetInFlightCount() == 0);
+	REQUIRE(limiter.GetWaitingCount() == 0);
+}
+
+TEST_CASE("Test concurrency limiter hands a released slot past requests held back per operation",
+          "[concurrency_limiter]") {
+	ConcurrencyLimiter limiter;
+	const auto config = MakeConfig(/*max_requests=*/2, /*max_requests_per_operation=*/1);
+	REQUIRE(limiter.TryAcquire(HttpfsOperationType::READ, config));
+	REQUIRE(limiter.TryAcquire(HttpfsOperationType::LIST, config));
+
+	// The second read is held back by the read in flight, the write queues behind it.
+	std::thread second_read([&]() {
+		limiter.Acquire(HttpfsOperationType::READ, config);
+		limiter.Release(HttpfsOperationType::READ);
+	});
+	WaitForWaiters(limiter, 1);
+	std::thread write([&]() { limiter.Acquire(HttpfsOperationType::WRITE, config); });
+	WaitForWaiters(limiter, 2);
+
+	// The slot released by the listing goes to the write, the read keeps waiting.
+	limiter.Release(HttpfsOperationType::LIST);
+	write.join();
+	REQUIRE(limiter.GetWaitingCount() == 1);
+	REQUIRE(limiter.GetInFlightCount() == 2);
+
+	limiter.Release(HttpfsOperationType::READ);
+	second_read.join();
+	limiter.Release(HttpfsOperationType::WRITE);
+	REQUIRE(limiter.GetInFlightCount() == 0);
+	REQUIRE(limiter.GetWaitingCount() == 0);
+}
@@ -0,0 +1,72 @@
+#include "catch/catch.hpp"
+#include "connection_warmup.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/exception/http_exception.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/mutex.hpp"
+
+using namespace duckdb;
+
+namespace {
+
+// Filesystem which answers the root of "https://ok.example.com" and "https://forbidden.example.com" (with an HTTP
+// error), and fails to connect to any other host.
+class WarmupTestFileSystem : public FileSystem {
+public:
+	unique_ptr<FileHandle> OpenFile(const string &path, FileOpenFlags flags,
+	                                optional_ptr<FileOpener> opener = nullptr) override {
+		{
+			lock_guard<mutex> lck(paths_mutex);
+			opened_paths.push_back(path);
+			all_in_warmup_scope = all_in_warmup_scope && WarmupRequestScope::IsActive();
+		}
+		if (path == "https://ok.example.com/") {
+			return nullptr;
+		}
+		if (path == "https://forbidden.example.com/") {
+			throw HTTPException("HTTP 403 Forbidden");
+		}
+		throw IOException("Could not establish connection to %s", path);
+	}
+	string GetName() const override {
+		return "WarmupTestFileSystem";
+	}
+
+	mutex paths_mutex;
+	vector<string> opened_paths;
+	bool all_in_warmup_scope = true;
+};
+
+} // namespace
+
+TEST_CASE("Test parse warm-up endpoints", "[connection_warmup]") {
+	const auto endpoints =
+	    ParseWarmupEndpoints(" s3://Bucket/prefix/file.parquet, https://example.com:8443/path,, s3://bucket ");
+	REQUIRE(endpoints == vector<string> {"s3://bucket", "https://example.com:8443"});
+	REQUIRE(ParseWarmupEndpoints("").empty());
+	REQUIRE_THROWS_AS(ParseWarmupEndpoints("s3://bucket,example.com"), InvalidInputException);
+	REQUIRE_THROWS_AS(ParseWarmupEndpoints("s3://"), InvalidInputException);
+}
+
+TEST_CASE("Test warm up endpoints", "[connection_warmup]") {
+	WarmupTestFileSystem fs;
+	const auto results = WarmUpEndpoints(
+	    fs, {"https://ok.example.com", "https://forbidden.example.com", "https://unreachable.example.com"}, nullptr);
+	REQUIRE(results.size() == 3);
+	REQUIRE(fs.opened_paths.size() == 3);
+	// Warm-up requests are marked as such while they are sent, and only then.
+	REQUIRE(fs.all_in_warmup_scope);
+	REQUIRE(!WarmupRequestScope::IsActive());
+
+	// Results are in the order of endpoints, however the warm-ups interleave.
+	REQUIRE(results[0].endpoint == "https://ok.example.com");
+	REQUIRE(results[0].connected);
+	REQUIRE(results[0].error.empty());
+	// An HTTP error response still sets up the connection.
+	REQUIRE(results[1].endpoint == "https://forbidden.example.com");
+	REQUIRE(results[1].connected);
+	REQUIRE(results[1].error.empty());
+	REQUIRE(results[2].endpoint == "https://unreachable.example.com");
+	REQUIRE(!results[2].connected);
+	REQUIRE_THAT(results[2].error, Catch::Contains("Could not establish connection"));
+}
@@ -0,0 +1,81 @@
+#include "catch/catch.hpp"
+#include "block_cache.hpp"
+#include "disk_block_cache.hpp"
+#include "test_helpers.hpp"
+
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/vector.hpp"
+
+using namespace duckdb;
+
+namespace {
+vector<data_t> GetBlock(idx_t nr_bytes, data_t value) {
+	return vector<data_t>(nr_bytes, value);
+}
+
+string GetCacheDirectory(const string &name) {
+	auto local_filesystem = FileSystem::CreateLocal();
+	const auto directory = TestCreatePath(name);
+	if (local_filesystem->DirectoryExists(directory)) {
+		local_filesystem->RemoveDirectory(directory);
+	}
+	return directory;
+}
+} // namespace
+
+TEST_CASE("Test block cache file key", "[disk_block_cache]") {
+	const auto key = GetBlockCacheFileKey("s3://bucket/file.parquet", "\"etag\"", 1024);
+	REQUIRE(key.size() == 32);
+	REQUIRE(key == GetBlockCacheFileKey("s3://bucket/file.parquet", "\"etag\"", 1024));
+	// Modified files and different block sizes never share blocks.
+	REQUIRE(key != GetBlockCacheFileKey("s3://bucket/file.parquet", "\"other\"", 1024));
+	REQUIRE(key != GetBlockCacheFileKey("s3://bucket/file.parquet", "\"etag\"", 2048));
+	// Files without version tag cannot be cached.
+	REQUIRE(GetBlockCacheFileKey("s3://bucket/file.parquet", "", 1024).empty());
+}
+
+TEST_CASE("Test disk block cache read and write", "[disk_block_cache]") {
+	const auto directory = GetCacheDirectory("disk_block_cache_read_write");
+	DiskBlockCache cache(directory);
+	const auto file_key = GetBlockCacheFileKey("s3://bucket/file.parquet", "\"etag\"", 16);
+
+	vector<data_t> buffer(16);
+	REQUIRE(!cache.TryRead(file_key, 0, buffer.data(), buffer.size()));
+	const auto block = GetBlock(16, 7);
+	cache.Write(file_key, 0, block.data(), block.size(), /*max_bytes=*/1024);
+	REQUIRE(cache.Contains(file_key, 0));
+	REQUIRE(cache.TryRead(file_key, 0, buffer.data(), buffer.size()));
+	REQUIRE(buffer == block);
+
+	// Size mismatch is a miss, which drops the block.
+	vector<data_t> short_buffer(8);
+	REQUIRE(!cache.TryRead(file_key, 0, short_buffer.data(), short_buffer.size()));
+	REQUIRE(!cache.Contains(file_key, 0));
+	REQUIRE(cache.GetSizeBytes() == 0);
+}
+
+TEST_CASE("Test disk block cache eviction and reload", "[disk_block_cache]") {
+	const auto directory = GetCacheDirectory("disk_block_cache_eviction");
+	const auto file_key = GetBlockCacheFileKey("s3://bucket/file.parquet", "\"etag\"", 16);
+	vector<data_t> buffer(16);
+	{
+		DiskBlockCache cache(directory);
+		for (idx_t block_index = 0; block_index < 3; ++block_index) {
+			const auto block = GetBlock(16, static_cast<data_t>(block_index));
+			cache.Write(file_key, block_index, block.data(), block.size(), /*max_bytes=*/32);
+			// Keep block 0 most recently used.
+			cache.TryRead(file_key, 0, buffer.data(), buffer.size());
+		}
+		REQUIRE(cache.GetBlockCount() == 2);
+		REQUIRE(cache.GetSizeBytes() == 32);
+		REQUIRE(cache.Contains(file_key, 0));
+		REQUIRE(!cache.Contains(file_key, 1));
+		REQUIRE(cache.Contains(file_key, 2));
+	}
+
+	// Blocks persist across processes.
+	DiskBlockCache cache(directory);
+	REQUIRE(cache.GetBlockCount() == 2);
+	REQUIRE(cache.TryRead(file_key, 2, buffer.data(), buffer.size()));
+	REQUIRE(buffer == GetBlock(16, 2));
+}
@@ -1,9 +1,16 @@
 #include "catch/catch.hpp"
+#include "duckdb/common/atomic.hpp"
+#include "duckdb/common/mutex.hpp"
 #include "duckdb/common/file_opener.hpp"
+#include "duckdb/common/file_system.hpp"
 #include "duckdb/main/database.hpp"
 #include "duckdb/main/database_file_opener.hpp"
+#include "file_system_timeout_retry_wrapper.hpp"
 #include "timeout_retry_file_opener.hpp"
 
+#include <chrono>
+#include <thread>
+
 using namespace duckdb;
 
 namespace {
@@ -33,7 +40,73 @@ void RegisterExtensionOptions(DBConfig &db_config) {
 	                             LogicalType {LogicalTypeId::UBIGINT}, Value());
 	db_config.AddExtensionOption("httpfs_retries_create_dir", "Maximum number of retries for creating directories",
 	                             LogicalType {LogicalTypeId::UBIGINT}, Value());
+	db_config.AddExtensionOption("httpfs_timeout_read_ms", "Timeout for reads on file handles (in milliseconds)",
+	                             LogicalType {LogicalTypeId::UBIGINT}, Value());
+	db_config.AddExtensionOption("httpfs_timeout_write_ms", "Timeout for writes on file handles (in milliseconds)",
+	                             LogicalType {LogicalTypeId::UBIGINT}, Value());
+	db_config.AddExtensionOption("httpfs_retries_read", "Maximum number of retries for reads on file handles",
+	                             LogicalType {LogicalTypeId::UBIGINT}, Value());
+	db_config.AddExtensionOption("httpfs_retries_write", "Maximum number of retries for writes on file handles",
+	                             LogicalType {LogicalTypeId::UBIGINT}, Value());
+	db_config.AddExtensionOption("httpfs_upload_part_size_bytes", "Size of parts of multipart uploads (in bytes)",
+	                             LogicalType {LogicalTypeId::UBIGINT}, Value());
+	db_config.AddExtensionOption("httpfs_upload_concurrency", "Max number of parts uploaded concurrently per file",
+	                             LogicalType {LogicalTypeId::UBIGINT}, Value());
+	db_config.AddExtensionOption("httpfs_upload_part_timeout_ms", "Timeout of each part upload (in milliseconds)",
+	                             LogicalType {LogicalTypeId::UBIGINT}, Value());
+	db_config.AddExtensionOption("httpfs_upload_part_retries", "Retries of each part upload",
+	                             LogicalType {LogicalTypeId::UBIGINT}, Value());
 }
+
+// Filesystem which records the settings it is opened with, as the inner filesystem of the wrapper.
+class SettingsCapturingFileSystem : public FileSystem {
+public:
+	unique_ptr<FileHandle> OpenFile(const string &path, FileOpenFlags flags,
+	                                optional_ptr<FileOpener> opener = nullptr) override {
+		for (const auto &key : {"s3_uploader_max_filesize", "s3_uploader_thread_limit", "http_timeout",
+		                        "http_retries"}) {
+			Value value;
+			if (FileOpener::TryGetCurrentSetting(opener, key, value)) {
+				settings[key] = value;
+			}
+		}
+		return nullptr;
+	}
+	string GetName() const override {
+		return "SettingsCapturingFileSystem";
+	}
+
+	unordered_map<string, Value> settings;
+};
+
+// Filesystem whose existence checks take [check_ms], and record the settings they're sent with.
+class SlowExistsFileSystem : public FileSystem {
+public:
+	explicit SlowExistsFileSystem(uint64_t check_ms_p) : check_ms(check_ms_p) {
+	}
+
+	bool FileExists(const string &filename, optional_ptr<FileOpener> opener = nullptr) override {
+		Value timeout;
+		Value retries;
+		FileOpener::TryGetCurrentSetting(opener, "http_timeout", timeout);
+		FileOpener::TryGetCurrentSetting(opener, "http_retries", retries);
+		{
+			lock_guard<mutex> lck(settings_mutex);
+			http_timeout = timeout;
+			http_retries = retries;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(check_ms.load()));
+		return true;
+	}
+	string GetName() const override {
+		return "SlowExistsFileSystem";
+	}
+
+	atomic<uint64_t> check_ms;
+	mutex settings_mutex;
+	Value http_timeout;
+	Value http_retries;
+};
 } // namespace
 
 TEST_CASE("Test OPEN operation via direct opener", "[extension_settings_opener]") {
@@ -328,3 +401,245 @@ TEST_CASE("Test fallback updates when http_retries changes", "[extension_setting
 	REQUIRE(static_cast<bool>(retries_result));
 	REQUIRE(retries_value.GetValue<uint64_t>() == 8);
 }
+
+TEST_CASE("Test sub-second timeout rounds up to whole seconds", "[extension_settings_opener]") {
+	DBConfig config;
+	DuckDB db(nullptr, &config);
+	DatabaseInstance &db_instance = *db.instance;
+	auto &db_config = DBConfig::GetConfig(db_instance);
+
+	RegisterExtensionOptions(db_config);
+	db_config.SetOptionByName("httpfs_timeout_stat_ms", Value::UBIGINT(250));
+	db_config.SetOptionByName("httpfs_timeout_list_ms", Value::UBIGINT(1999));
+
+	DatabaseFileOpener opener(db_instance);
+
+	// STAT operation
+	{
+		TimeoutRetryFileOpener timeout_retry_opener(opener, HttpfsOperationType::STAT);
+		Value timeout_value;
+		auto timeout_result = FileOpener::TryGetCurrentSetting(&timeout_retry_opener, "http_timeout", timeout_value);
+		REQUIRE(static_cast<bool>(timeout_result));
+		REQUIRE(timeout_value.GetValue<uint64_t>() == 1);
+
+		uint64_t timeout_ms = 0;
+		REQUIRE(timeout_retry_opener.TryGetTimeoutMs(timeout_ms));
+		REQUIRE(timeout_ms == 250);
+	}
+
+	// LIST operation
+	{
+		TimeoutRetryFileOpener timeout_retry_opener(opener, HttpfsOperationType::LIST);
+		Value timeout_value;
+		auto timeout_result = FileOpener::TryGetCurrentSetting(&timeout_retry_opener, "http_timeout", timeout_value);
+		REQUIRE(static_cast<bool>(timeout_result));
+		REQUIRE(timeout_value.GetValue<uint64_t>() == 2);
+
+		uint64_t timeout_ms = 0;
+		REQUIRE(timeout_retry_opener.TryGetTimeoutMs(timeout_ms));
+		REQUIRE(timeout_ms == 1999);
+	}
+}
+
+TEST_CASE("Test millisecond timeout falls back to http_timeout", "[extension_settings_opener]") {
+	DBConfig config;
+	DuckDB db(nullptr, &config);
+	DatabaseInstance &db_instance = *db.instance;
+	auto &db_config = DBConfig::GetConfig(db_instance);
+
+	RegisterExtensionOptions(db_config);
+	db_config.SetOptionByName("http_timeout", Value::UBIGINT(15));
+
+	DatabaseFileOpener opener(db_instance);
+	TimeoutRetryFileOpener timeout_retry_opener(opener, HttpfsOperationType::OPEN);
+
+	uint64_t timeout_ms = 0;
+	REQUIRE(timeout_retry_opener.TryGetTimeoutMs(timeout_ms));
+	REQUIRE(timeout_ms == 15000);
+}
+
+TEST_CASE("Test READ and WRITE operations fall back to file operation settings", "[extension_settings_opener]") {
+	DBConfig config;
+	DuckDB db(nullptr, &config);
+	DatabaseInstance &db_instance = *db.instance;
+	auto &db_config = DBConfig::GetConfig(db_instance);
+
+	RegisterExtensionOptions(db_config);
+	db_config.SetOptionByName("httpfs_timeout_file_operation_ms", Value::UBIGINT(12000));
+	db_config.SetOptionByName("httpfs_retries_file_operation", Value::UBIGINT(4));
+	db_config.SetOptionByName("httpfs_timeout_read_ms", Value::UBIGINT(3000));
+	db_config.SetOptionByName("httpfs_retries_write", Value::UBIGINT(8));
+
+	DatabaseFileOpener opener(db_instance);
+
+	// Read timeout is set, read retries fall back to file operation retries.
+	{
+		TimeoutRetryFileOpener timeout_retry_opener(opener, HttpfsOperationType::READ);
+		uint64_t timeout_ms = 0;
+		REQUIRE(timeout_retry_opener.TryGetTimeoutMs(timeout_ms));
+		REQUIRE(timeout_ms == 3000);
+		uint64_t retries = 0;
+		REQUIRE(timeout_retry_opener.TryGetRetries(retries));
+		REQUIRE(retries == 4);
+	}
+
+	// Write retries are set, write timeout falls back to file operation timeout.
+	{
+		TimeoutRetryFileOpener timeout_retry_opener(opener, HttpfsOperationType::WRITE);
+		Value timeout_value;
+		auto timeout_result = FileOpener::TryGetCurrentSetting(&timeout_retry_opener, "http_timeout", timeout_value);
+		REQUIRE(static_cast<bool>(timeout_result));
+		REQUIRE(timeout_value.GetValue<uint64_t>() == 12);
+
+		Value retries_value;
+		auto retries_result = FileOpener::TryGetCurrentSetting(&timeout_retry_opener, "http_retries", retries_value);
+		REQUIRE(static_cast<bool>(retries_result));
+		REQUIRE(retries_value.GetValue<uint64_t>() == 8);
+	}
+
+	// OPEN doesn't pick up read and write settings.
+	{
+		TimeoutRetryFileOpener timeout_retry_opener(opener, HttpfsOperationType::OPEN);
+		uint64_t timeout_ms = 0;
+		REQUIRE(timeout_retry_opener.TryGetTimeoutMs(timeout_ms));
+		REQUIRE(timeout_ms == 12000);
+	}
+}
+
+TEST_CASE("Test setting overrides are reported to the inner filesystem", "[extension_settings_opener]") {
+	DBConfig config;
+	DuckDB db(nullptr, &config);
+	DatabaseInstance &db_instance = *db.instance;
+	auto &db_config = DBConfig::GetConfig(db_instance);
+
+	RegisterExtensionOptions(db_config);
+	db_config.SetOptionByName("httpfs_timeout_write_ms", Value::UBIGINT(7000));
+
+	DatabaseFileOpener opener(db_instance);
+	TimeoutRetryFileOpener timeout_retry_opener(opener, HttpfsOperationType::WRITE);
+
+	Value value;
+	REQUIRE_FALSE(FileOpener::TryGetCurrentSetting(&timeout_retry_opener, "s3_uploader_thread_limit", value));
+
+	timeout_retry_opener.SetSettingOverride("s3_uploader_thread_limit", Value::UBIGINT(4));
+	auto result = FileOpener::TryGetCurrentSetting(&timeout_retry_opener, "s3_uploader_thread_limit", value);
+	REQUIRE(static_cast<bool>(result));
+	REQUIRE(value.GetValue<uint64_t>() == 4);
+
+	// Timeout and retries still resolve from per-operation settings.
+	REQUIRE(static_cast<bool>(FileOpener::TryGetCurrentSetting(&timeout_retry_opener, "http_timeout", value)));
+	REQUIRE(value.GetValue<uint64_t>() == 7);
+}
+
+TEST_CASE("Test upload settings reach the inner filesystem on open for writing", "[extension_settings_opener]") {
+	DBConfig config;
+	DuckDB db(nullptr, &config);
+	DatabaseInstance &db_instance = *db.instance;
+	auto &db_config = DBConfig::GetConfig(db_instance);
+
+	RegisterExtensionOptions(db_config);
+	db_config.SetOptionByName("httpfs_timeout_file_operation_ms", Value::UBIGINT(10000));
+	db_config.SetOptionByName("httpfs_retries_write", Value::UBIGINT(2));
+	db_config.SetOptionByName("httpfs_upload_part_size_bytes", Value::UBIGINT(16 * 1024 * 1024));
+	db_config.SetOptionByName("httpfs_upload_concurrency", Value::UBIGINT(8));
+	db_config.SetOptionByName("httpfs_upload_part_timeout_ms", Value::UBIGINT(60000));
+	db_config.SetOptionByName("httpfs_upload_part_retries", Value::UBIGINT(5));
+
+	auto inner_filesystem = make_uniq<SettingsCapturingFileSystem>();
+	auto &inner = *inner_filesystem;
+	FileSystemTimeoutRetryWrapper wrapper(std::move(inner_filesystem), db_instance);
+	DatabaseFileOpener opener(db_instance);
+	REQUIRE(wrapper.OpenFile("s3://upload-bucket/file.parquet", FileFlags::FILE_FLAGS_WRITE, &opener) == nullptr);
+
+	// Part size is translated into the max file size of 10000 parts, the uploader's default max number of parts.
+	REQUIRE(inner.settings.at("s3_uploader_max_filesize").GetValue<uint64_t>() == 16ULL * 1024 * 1024 * 10000);
+	REQUIRE(inner.settings.at("s3_uploader_thread_limit").GetValue<uint64_t>() == 8);
+	// Per-part timeout and retries take precedence over file operation and write settings.
+	REQUIRE(inner.settings.at("http_timeout").GetValue<uint64_t>() == 60);
+	REQUIRE(inner.settings.at("http_retries").GetValue<uint64_t>() == 5);
+
+	// Opens for reading are not affected by upload settings.
+	inner.settings.clear();
+	REQUIRE(wrapper.OpenFile("s3://upload-bucket/file.parquet", FileFlags::FILE_FLAGS_READ, &opener) == nullptr);
+	REQUIRE(inner.settings.count("s3_uploader_max_filesize") == 0);
+	REQUIRE(inner.settings.count("s3_uploader_thread_limit") == 0);
+	REQUIRE(inner.settings.at("http_timeout").GetValue<uint64_t>() == 10);
+}
+
+TEST_CASE("Test per-part timeout shorter than the open timeout applies to uploads", "[extension_settings_opener]") {
+	DBConfig config;
+	DuckDB db(nullptr, &config);
+	DatabaseInstance &db_instance = *db.instance;
+	auto &db_config = DBConfig::GetConfig(db_instance);
+
+	RegisterExtensionOptions(db_config);
+	db_config.SetOptionByName("httpfs_timeout_file_operation_ms", Value::UBIGINT(30000));
+	db_config.SetOptionByName("httpfs_upload_part_timeout_ms", Value::UBIGINT(5000));
+
+	auto inner_filesystem = make_uniq<SettingsCapturingFileSystem>();
+	auto &inner = *inner_filesystem;
+	FileSystemTimeoutRetryWrapper wrapper(std::move(inner_filesystem), db_instance);
+	DatabaseFileOpener opener(db_instance);
+	REQUIRE(wrapper.OpenFile("s3://upload-bucket/file.parquet", FileFlags::FILE_FLAGS_WRITE, &opener) == nullptr);
+	REQUIRE(inner.settings.at("http_timeout").GetValue<uint64_t>() == 5);
+
+	// Without per-part timeout, the write timeout applies, even if shorter than the open timeout as well.
+	db_config.SetOptionByName("httpfs_upload_part_timeout_ms", Value());
+	db_config.SetOptionByName("httpfs_timeout_write_ms", Value::UBIGINT(8000));
+	inner.settings.clear();
+	REQUIRE(wrapper.OpenFile("s3://upload-bucket/file.parquet", FileFlags::FILE_FLAGS_WRITE, &opener) == nullptr);
+	REQUIRE(inner.settings.at("http_timeout").GetValue<uint64_t>() == 8);
+}
+
+TEST_CASE("Test read timeout shorter than the open timeout applies to read handles", "[extension_settings_opener]") {
+	DBConfig config;
+	DuckDB db(nullptr, &config);
+	DatabaseInstance &db_instance = *db.instance;
+	auto &db_config = DBConfig::GetConfig(db_instance);
+
+	RegisterExtensionOptions(db_config);
+	db_config.SetOptionByName("httpfs_timeout_file_operation_ms", Value::UBIGINT(30000));
+	db_config.SetOptionByName("httpfs_timeout_read_ms", Value::UBIGINT(5000));
+
+	auto inner_filesystem = make_uniq<SettingsCapturingFileSystem>();
+	auto &inner = *inner_filesystem;
+	FileSystemTimeoutRetryWrapper wrapper(std::move(inner_filesystem), db_instance);
+	DatabaseFileOpener opener(db_instance);
+	REQUIRE(wrapper.OpenFile("s3://bucket/file.csv", FileFlags::FILE_FLAGS_READ, &opener) == nullptr);
+	REQUIRE(inner.settings.at("http_timeout").GetValue<uint64_t>() == 5);
+
+	// A longer read timeout extends the client timeout as well.
+	db_config.SetOptionByName("httpfs_timeout_read_ms", Value::UBIGINT(60000));
+	inner.settings.clear();
+	REQUIRE(wrapper.OpenFile("s3://bucket/file.csv", FileFlags::FILE_FLAGS_READ, &opener) == nullptr);
+	REQUIRE(inner.settings.at("http_timeout").GetValue<uint64_t>() == 60);
+}
+
+TEST_CASE("Test stat timeout below a whole second is enforced by the wrapper", "[extension_settings_opener]") {
+	DBConfig config;
+	DuckDB db(nullptr, &config);
+	DatabaseInstance &db_instance = *db.instance;
+	auto &db_config = DBConfig::GetConfig(db_instance);
+
+	RegisterExtensionOptions(db_config);
+	db_config.SetOptionByName("httpfs_timeout_stat_ms", Value::UBIGINT(200));
+	db_config.SetOptionByName("httpfs_retries_stat", Value::UBIGINT(0));
+
+	auto inner_filesystem = make_uniq<SlowExistsFileSystem>(/*check_ms=*/1500);
+	auto &inner = *inner_filesystem;
+	FileSystemTimeoutRetryWrapper wrapper(std::move(inner_filesystem), db_instance);
+
+	// The client is still handed the rounded-up timeout, the wrapper gives up at 200 ms.
+	const auto start = std::chrono::steady_clock::now();
+	REQUIRE_THROWS_WITH(wrapper.FileExists("s3://bucket/file.parquet"), Catch::Contains("timed out after 200 ms"));
+	REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(1000));
+	{
+		lock_guard<mutex> lck(inner.settings_mutex);
+		REQUIRE(inner.http_timeout.GetValue<uint64_t>() == 1);
+		REQUIRE(inner.http_retries.GetValue<uint64_t>() == 0);
+	}
+
+	// Checks which finish in time return their result.
+	inner.check_ms = 0;
+	REQUIRE(wrapper.FileExists("s3://bucket/file.parquet"));
+}
@@ -0,0 +1,179 @@
+#include "catch/catch.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/main/client_context_file_opener.hpp"
+#include "duckdb/main/connection.hpp"
+#include "duckdb/main/database.hpp"
+#include "duckdb/main/database_file_opener.hpp"
+#include "fault_injection.hpp"
+#include "file_system_timeout_retry_wrapper.hpp"
+#include "test_helpers.hpp"
+#include "timeout_retry_policy.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+using namespace duckdb;
+
+namespace {
+constexpr idx_t SAMPLE_COUNT = 10000;
+
+// Settings are registered with the callback of the extension, so connections pick up changes right away.
+void RegisterExtensionOptions(DBConfig &db_config) {
+	db_config.AddExtensionOption("httpfs_fault_latency_ms", "Injected latency", LogicalType {LogicalTypeId::UBIGINT},
+	                             Value(), OnPolicySettingChanged);
+	db_config.AddExtensionOption("httpfs_fault_latency_distribution", "Distribution of injected latency",
+	                             LogicalType {LogicalTypeId::VARCHAR}, Value(), OnPolicySettingChanged);
+	db_config.AddExtensionOption("httpfs_fault_error_rate", "Fraction of failed requests",
+	                             LogicalType {LogicalTypeId::DOUBLE}, Value(), OnPolicySettingChanged);
+	db_config.AddExtensionOption("httpfs_fault_operations", "Operation types faults are injected into",
+	                             LogicalType {LogicalTypeId::VARCHAR}, Value(), OnPolicySettingChanged);
+	db_config.AddExtensionOption("httpfs_fault_path_pattern", "Paths faults are injected into",
+	                             LogicalType {LogicalTypeId::VARCHAR}, Value(), OnPolicySettingChanged);
+	db_config.AddExtensionOption("httpfs_fault_seed", "Seed of injected faults", LogicalType {LogicalTypeId::UBIGINT},
+	                             Value(), OnPolicySettingChanged);
+	db_config.AddExtensionOption("httpfs_retries_stat", "Maximum number of retries for stat operations",
+	                             LogicalType {LogicalTypeId::UBIGINT}, Value(), OnPolicySettingChanged);
+}
+
+FaultInjectionConfig MakeConfig(uint64_t latency_ms, double error_rate) {
+	FaultInjectionConfig config;
+	config.enabled = true;
+	config.operations.fill(true);
+	config.latency_ms = latency_ms;
+	config.error_rate = error_rate;
+	config.seed = 42;
+	return config;
+}
+} // namespace
+
+TEST_CASE("Test fault injection config from settings", "[fault_injection]") {
+	DBConfig config;
+	DuckDB db(nullptr, &config);
+	DatabaseInstance &db_instance = *db.instance;
+	auto &db_config = DBConfig::GetConfig(db_instance);
+	RegisterExtensionOptions(db_config);
+	DatabaseFileOpener opener(db_instance);
+
+	// Disabled unless any fault is configured.
+	REQUIRE(!GetFaultInjectionConfig(opener).enabled);
+
+	db_config.SetOptionByName("httpfs_fault_latency_ms", Value::UBIGINT(50));
+	db_config.SetOptionByName("httpfs_fault_latency_distribution", Value("LogNormal"));
+	db_config.SetOptionByName("httpfs_fault_operations", Value("read, list"));
+	db_config.SetOptionByName("httpfs_fault_path_pattern", Value("s3://bucket/slow/*"));
+	auto fault_config = GetFaultInjectionConfig(opener);
+	REQUIRE(fault_config.enabled);
+	REQUIRE(fault_config.latency_distribution == FaultLatencyDistribution::LOGNORMAL);
+	REQUIRE(fault_config.AppliesTo(HttpfsOperationType::READ, "s3://bucket/slow/year=2024/data.parquet"));
+	REQUIRE(fault_config.AppliesTo(HttpfsOperationType::LIST, "s3://bucket/slow/"));
+	REQUIRE(!fault_config.AppliesTo(HttpfsOperationType::STAT, "s3://bucket/slow/data.parquet"));
+	REQUIRE(!fault_config.AppliesTo(HttpfsOperationType::READ, "s3://bucket/fast/data.parquet"));
+
+	db_config.SetOptionByName("httpfs_fault_operations", Value("read,write"));
+	REQUIRE_THROWS_AS(GetFaultInjectionConfig(opener), InvalidInputException);
+	db_config.SetOptionByName("httpfs_fault_operations", Value());
+	db_config.SetOptionByName("httpfs_fault_error_rate", Value::DOUBLE(1.5));
+	REQUIRE_THROWS_AS(GetFaultInjectionConfig(opener), InvalidInputException);
+}
+
+TEST_CASE("Test injected faults are deterministic for a seed", "[fault_injection]") {
+	const auto config = MakeConfig(/*latency_ms=*/0, /*error_rate=*/0.3);
+	const string path = "s3://bucket/data.parquet";
+
+	// The same sequence of requests gets the same faults, regardless of requests to other paths in between.
+	FaultInjector first;
+	FaultInjector second;
+	for (idx_t idx = 0; idx < 100; ++idx) {
+		second.Draw(config, HttpfsOperationType::READ, "s3://bucket/other.parquet");
+		REQUIRE(first.Draw(config, HttpfsOperationType::READ, path).error ==
+		        second.Draw(config, HttpfsOperationType::READ, path).error);
+	}
+
+	// A different seed draws different faults.
+	auto reseeded = config;
+	reseeded.seed = 43;
+	idx_t differences = 0;
+	for (uint64_t sequence = 0; sequence < 100; ++sequence) {
+		differences += FaultInjector::Draw(config, HttpfsOperationType::READ, path, sequence).error !=
+		               FaultInjector::Draw(reseeded, HttpfsOperationType::READ, path, sequence).error;
+	}
+	REQUIRE(differences > 0);
+}
+
+TEST_CASE("Test injected fault rates and latency distributions", "[fault_injection]") {
+	const string path = "s3://bucket/data.parquet";
+	auto config = MakeConfig(/*latency_ms=*/100, /*error_rate=*/0.2);
+	config.stall_rate = 0.1;
+	config.stall_ms = 500;
+
+	for (const auto distribution : {FaultLatencyDistribution::FIXED, FaultLatencyDistribution::UNIFORM,
+	                                FaultLatencyDistribution::EXPONENTIAL, FaultLatencyDistribution::LOGNORMAL}) {
+		config.latency_distribution = distribution;
+		double total_latency_ms = 0;
+		idx_t errors = 0;
+		idx_t stalls = 0;
+		vector<uint64_t> latencies;
+		for (uint64_t sequence = 0; sequence < SAMPLE_COUNT; ++sequence) {
+			const auto fault = FaultInjector::Draw(config, HttpfsOperationType::READ, path, sequence);
+			total_latency_ms += static_cast<double>(fault.latency_ms);
+			latencies.push_back(fault.latency_ms);
+			errors += fault.error;
+			stalls += fault.stall_ms > 0;
+		}
+		REQUIRE(errors > SAMPLE_COUNT * 0.17);
+		REQUIRE(errors < SAMPLE_COUNT * 0.23);
+		REQUIRE(stalls > SAMPLE_COUNT * 0.08);
+		REQUIRE(stalls < SAMPLE_COUNT * 0.12);
+		std::sort(latencies.begin(), latencies.end());
+		const auto mean_ms = total_latency_ms / SAMPLE_COUNT;
+		const auto median_ms = latencies[SAMPLE_COUNT / 2];
+		if (distribution == FaultLatencyDistribution::LOGNORMAL) {
+			// Configured latency is the median, the mean is pulled up by the tail.
+			REQUIRE(median_ms >= 90);
+			REQUIRE(median_ms <= 110);
+			REQUIRE(mean_ms > 120);
+		} else {
+			REQUIRE(mean_ms >= 90);
+			REQUIRE(mean_ms <= 110);
+		}
+	}
+
+	// Stalls are only drawn for reads.
+	for (uint64_t sequence = 0; sequence < 100; ++sequence) {
+		REQUIRE(FaultInjector::Draw(config, HttpfsOperationType::LIST, path, sequence).stall_ms == 0);
+	}
+}
+
+TEST_CASE("Test injected faults reaching request timeout", "[fault_injection]") {
+	FaultInjector fault_injector;
+	const auto config = MakeConfig(/*latency_ms=*/50, /*error_rate=*/0);
+	const auto start = std::chrono::steady_clock::now();
+	REQUIRE_THROWS_WITH(fault_injector.Inject(config, HttpfsOperationType::STAT, "s3://bucket/file", 20),
+	                    Catch::Contains("timed out after 20 ms"));
+	// The request fails once its timeout passes, rather than after the injected latency.
+	REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(50));
+	REQUIRE(fault_injector.Inject(config, HttpfsOperationType::STAT, "s3://bucket/file", 1000) == 0);
+}
+
+TEST_CASE("Test wrapper injects transient errors", "[fault_injection]") {
+	DBConfig config;
+	DuckDB db(nullptr, &config);
+	DatabaseInstance &db_instance = *db.instance;
+	RegisterExtensionOptions(DBConfig::GetConfig(db_instance));
+	Connection con(db);
+	ClientContextFileOpener context_opener(*con.context);
+	const auto path = TestCreatePath("fault_injection_missing_file");
+	FileSystemTimeoutRetryWrapper wrapper(FileSystem::CreateLocal(), db_instance);
+
+	REQUIRE(con.Query("SET httpfs_retries_stat = 0")->GetError().empty());
+	REQUIRE(con.Query("SET httpfs_fault_error_rate = 1")->GetError().empty());
+	REQUIRE_THROWS_WITH(wrapper.FileExists(path, &context_opener), Catch::Contains("Injected fault"));
+
+	// Only matching paths are affected.
+	REQUIRE(con.Query("SET httpfs_fault_path_pattern = '*/other_*'")->GetError().empty());
+	REQUIRE(!wrapper.FileExists(path, &context_opener));
+	REQUIRE(con.Query("RESET httpfs_fault_path_pattern")->GetError().empty());
+	REQUIRE(con.Query("SET httpfs_fault_operations = 'read'")->GetError().empty());
+	REQUIRE(!wrapper.FileExists(path, &context_opener));
+}
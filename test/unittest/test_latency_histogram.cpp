@@ -0,0 +1,54 @@
+#include "catch/catch.hpp"
+#include "duckdb/common/limits.hpp"
+#include "latency_histogram.hpp"
+
+using namespace duckdb;
+
+TEST_CASE("Test latency histogram bucket boundaries", "[latency_histogram]") {
+	// Small values get one bucket each.
+	for (uint64_t latency = 0; latency < LatencyHistogram::SUB_BUCKET_COUNT; ++latency) {
+		REQUIRE(LatencyHistogram::GetBucketIndex(latency) == latency);
+		REQUIRE(LatencyHistogram::GetBucketUpperBound(latency) == latency);
+	}
+
+	// Every value falls into a bucket whose upper bound is no smaller than itself, and at most 1 / SUB_BUCKET_COUNT of
+	// the value larger, and buckets are contiguous.
+	for (uint64_t latency = 1; latency < 100000; ++latency) {
+		const auto bucket_index = LatencyHistogram::GetBucketIndex(latency);
+		REQUIRE(bucket_index < LatencyHistogram::BUCKET_COUNT);
+		const auto upper_bound = LatencyHistogram::GetBucketUpperBound(bucket_index);
+		REQUIRE(upper_bound >= latency);
+		REQUIRE((upper_bound - latency) * LatencyHistogram::SUB_BUCKET_COUNT <= latency);
+		REQUIRE(LatencyHistogram::GetBucketIndex(latency - 1) <= bucket_index);
+	}
+
+	REQUIRE(LatencyHistogram::GetBucketIndex(NumericLimits<uint64_t>::Maximum()) ==
+	        LatencyHistogram::BUCKET_COUNT - 1);
+	REQUIRE(LatencyHistogram::GetBucketUpperBound(LatencyHistogram::BUCKET_COUNT - 1) ==
+	        NumericLimits<uint64_t>::Maximum());
+}
+
+TEST_CASE("Test latency histogram percentile", "[latency_histogram]") {
+	LatencyHistogram histogram;
+	vector<uint64_t> bucket_counts(LatencyHistogram::BUCKET_COUNT, 0);
+	histogram.MergeInto(bucket_counts);
+	REQUIRE(LatencyHistogram::GetPercentile(bucket_counts, 0.5) == 0);
+
+	for (uint64_t latency = 1; latency <= 1000; ++latency) {
+		histogram.Record(latency);
+	}
+	histogram.MergeInto(bucket_counts);
+
+	// Reported percentile is the bucket upper bound, which is within 1 / 32 of the exact value.
+	const auto p50 = LatencyHistogram::GetPercentile(bucket_counts, 0.5);
+	REQUIRE(p50 >= 500);
+	REQUIRE(p50 <= 515);
+	const auto p99 = LatencyHistogram::GetPercentile(bucket_counts, 0.99);
+	REQUIRE(p99 >= 990);
+	REQUIRE(p99 <= 1020);
+
+	histogram.Reset();
+	vector<uint64_t> reset_bucket_counts(LatencyHistogram::BUCKET_COUNT, 0);
+	histogram.MergeInto(reset_bucket_counts);
+	REQUIRE(LatencyHistogram::GetPercentile(reset_bucket_counts, 0.5) == 0);
+}
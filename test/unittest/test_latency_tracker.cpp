@@ -0,0 +1,70 @@
+#include "catch/catch.hpp"
+#include "latency_tracker.hpp"
+
+using namespace duckdb;
+
+TEST_CASE("Test latency tracker with insufficient samples", "[latency_tracker]") {
+	LatencyTracker tracker;
+	uint64_t latency_us = 0;
+	REQUIRE(!tracker.TryGetPercentile(0.5, /*min_samples=*/1, latency_us));
+
+	tracker.Record(100);
+	REQUIRE(!tracker.TryGetPercentile(0.5, /*min_samples=*/2, latency_us));
+	REQUIRE(tracker.TryGetPercentile(0.5, /*min_samples=*/1, latency_us));
+	REQUIRE(latency_us == 100);
+}
+
+TEST_CASE("Test latency tracker percentile", "[latency_tracker]") {
+	LatencyTracker tracker;
+	for (uint64_t latency = 1; latency <= 100; ++latency) {
+		tracker.Record(latency);
+	}
+	REQUIRE(tracker.GetSampleCount() == 100);
+
+	uint64_t latency_us = 0;
+	REQUIRE(tracker.TryGetPercentile(0.5, /*min_samples=*/1, latency_us));
+	REQUIRE(latency_us == 50);
+	REQUIRE(tracker.TryGetPercentile(0.99, /*min_samples=*/1, latency_us));
+	REQUIRE(latency_us == 99);
+	REQUIRE(tracker.TryGetPercentile(1.0, /*min_samples=*/1, latency_us));
+	REQUIRE(latency_us == 100);
+}
+
+TEST_CASE("Test latency tracker evicts oldest samples", "[latency_tracker]") {
+	LatencyTracker tracker(/*capacity=*/4);
+	tracker.Record(1000);
+	tracker.Record(1000);
+	for (idx_t idx = 0; idx < 4; ++idx) {
+		tracker.Record(10);
+	}
+	REQUIRE(tracker.GetSampleCount() == 4);
+
+	uint64_t latency_us = 0;
+	REQUIRE(tracker.TryGetPercentile(1.0, /*min_samples=*/1, latency_us));
+	REQUIRE(latency_us == 10);
+}
+
+TEST_CASE("Test read latency trackers by size class", "[latency_tracker]") {
+	REQUIRE(ReadLatencyTrackers::GetSizeClass(1) == 0);
+	REQUIRE(ReadLatencyTrackers::GetSizeClass(64 * 1024) == 0);
+	REQUIRE(ReadLatencyTrackers::GetSizeClass(64 * 1024 + 1) == 1);
+	REQUIRE(ReadLatencyTrackers::GetSizeClass(16 * 1024 * 1024) == 2);
+	REQUIRE(ReadLatencyTrackers::GetSizeClass(1024 * 1024 * 1024) == ReadLatencyTrackers::SIZE_CLASS_COUNT - 1);
+
+	// Slow large reads don't raise the percentile of small ones.
+	auto &trackers = ReadLatencyTrackerRegistry::GetInstance().GetReadLatencyTrackers("s3://latency-size-class");
+	for (idx_t idx = 0; idx < 100; ++idx) {
+		trackers.GetTracker(4096).Record(1000);
+		trackers.GetTracker(64 * 1024 * 1024).Record(500000);
+	}
+	uint64_t latency_us = 0;
+	REQUIRE(trackers.GetTracker(8192).TryGetPercentile(0.99, /*min_samples=*/1, latency_us));
+	REQUIRE(latency_us == 1000);
+	REQUIRE(trackers.GetTracker(32 * 1024 * 1024).TryGetPercentile(0.99, /*min_samples=*/1, latency_us));
+	REQUIRE(latency_us == 500000);
+
+	// Endpoints have trackers of their own.
+	auto &other_trackers = ReadLatencyTrackerRegistry::GetInstance().GetReadLatencyTrackers("s3://latency-other");
+	REQUIRE(other_trackers.GetTracker(4096).GetSampleCount() == 0);
+	REQUIRE(&ReadLatencyTrackerRegistry::GetInstance().GetReadLatencyTrackers("s3://latency-size-class") == &trackers);
+}
@@ -0,0 +1,94 @@
+#include "catch/catch.hpp"
+#include "listing_cache.hpp"
+
+#include <chrono>
+
+using namespace duckdb;
+
+namespace {
+ListingCacheConfig GetTestConfig() {
+	ListingCacheConfig config;
+	config.enabled = true;
+	config.ttl_ms = 60000;
+	config.max_memory_bytes = 1024 * 1024;
+	return config;
+}
+
+vector<OpenFileInfo> GetListing(const string &path) {
+	vector<OpenFileInfo> result;
+	result.emplace_back(path);
+	return result;
+}
+} // namespace
+
+TEST_CASE("Test listing cache non-wildcard prefix", "[listing_cache]") {
+	REQUIRE(ListingCache::GetNonWildcardPrefix("s3://bucket/table/**/*.parquet") == "s3://bucket/table");
+	REQUIRE(ListingCache::GetNonWildcardPrefix("s3://bucket/table/year=*/data.parquet") == "s3://bucket/table");
+	REQUIRE(ListingCache::GetNonWildcardPrefix("s3://bucket/table/data.parquet") == "s3://bucket/table/data.parquet");
+	REQUIRE(ListingCache::GetNonWildcardPrefix("s3://bucket/table/") == "s3://bucket/table");
+}
+
+TEST_CASE("Test listing cache expiry", "[listing_cache]") {
+	const auto config = GetTestConfig();
+	ListingCache cache;
+	const auto now = std::chrono::steady_clock::now();
+	const string pattern = "s3://bucket/table/*.parquet";
+	cache.Put(ListingKind::GLOB, pattern, config, GetListing("s3://bucket/table/a.parquet"), now);
+
+	vector<OpenFileInfo> result;
+	REQUIRE(!cache.TryGet(ListingKind::LIST, pattern, config, result, now));
+	REQUIRE(cache.TryGet(ListingKind::GLOB, pattern, config, result, now + std::chrono::milliseconds(59999)));
+	REQUIRE(result.size() == 1);
+	REQUIRE(result[0].path == "s3://bucket/table/a.parquet");
+	REQUIRE(!cache.TryGet(ListingKind::GLOB, pattern, config, result, now + std::chrono::milliseconds(60000)));
+	REQUIRE(cache.Size() == 0);
+	REQUIRE(cache.GetMemoryBytes() == 0);
+}
+
+TEST_CASE("Test listing cache invalidation", "[listing_cache]") {
+	const auto config = GetTestConfig();
+	ListingCache cache;
+	cache.Put(ListingKind::GLOB, "s3://bucket/table/**/*.parquet", config, GetListing("s3://bucket/table/a.parquet"));
+	cache.Put(ListingKind::LIST, "s3://bucket/table/year=2024", config, GetListing("s3://bucket/table/year=2024/b"));
+	cache.Put(ListingKind::LIST, "s3://bucket/table/year=2025", config, GetListing("s3://bucket/table/year=2025/c"));
+	cache.Put(ListingKind::LIST, "s3://bucket/other", config, GetListing("s3://bucket/other/d"));
+	REQUIRE(cache.Size() == 4);
+
+	// Listings at ancestors of the written path are dropped, siblings are kept.
+	vector<OpenFileInfo> result;
+	cache.Invalidate("s3://bucket/table/year=2024/new.parquet");
+	REQUIRE(!cache.TryGet(ListingKind::GLOB, "s3://bucket/table/**/*.parquet", config, result));
+	REQUIRE(!cache.TryGet(ListingKind::LIST, "s3://bucket/table/year=2024", config, result));
+	REQUIRE(cache.TryGet(ListingKind::LIST, "s3://bucket/table/year=2025", config, result));
+	REQUIRE(cache.TryGet(ListingKind::LIST, "s3://bucket/other", config, result));
+
+	// Removing a directory drops listings under it as well.
+	cache.InvalidateRecursive("s3://bucket/table/");
+	REQUIRE(!cache.TryGet(ListingKind::LIST, "s3://bucket/table/year=2025", config, result));
+	REQUIRE(cache.TryGet(ListingKind::LIST, "s3://bucket/other", config, result));
+	REQUIRE(cache.Size() == 1);
+}
+
+TEST_CASE("Test listing cache memory budget", "[listing_cache]") {
+	auto config = GetTestConfig();
+	ListingCache cache;
+	cache.Put(ListingKind::LIST, "s3://bucket/a", config, GetListing("s3://bucket/a/file"));
+	const auto entry_bytes = cache.GetMemoryBytes();
+	REQUIRE(entry_bytes > 0);
+
+	// Budget fits two listings of the same size, the least recently used one is evicted.
+	config.max_memory_bytes = entry_bytes * 2;
+	cache.Put(ListingKind::LIST, "s3://bucket/b", config, GetListing("s3://bucket/b/file"));
+	vector<OpenFileInfo> result;
+	REQUIRE(cache.TryGet(ListingKind::LIST, "s3://bucket/a", config, result));
+	cache.Put(ListingKind::LIST, "s3://bucket/c", config, GetListing("s3://bucket/c/file"));
+	REQUIRE(cache.Size() == 2);
+	REQUIRE(cache.TryGet(ListingKind::LIST, "s3://bucket/a", config, result));
+	REQUIRE(!cache.TryGet(ListingKind::LIST, "s3://bucket/b", config, result));
+	REQUIRE(cache.GetMemoryBytes() <= config.max_memory_bytes);
+
+	// Listing larger than the whole budget isn't cached.
+	config.max_memory_bytes = entry_bytes - 1;
+	cache.Put(ListingKind::LIST, "s3://bucket/d", config, GetListing("s3://bucket/d/file"));
+	REQUIRE(!cache.TryGet(ListingKind::LIST, "s3://bucket/d", config, result));
+}
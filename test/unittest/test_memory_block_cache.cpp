@@ -0,0 +1,112 @@
+#include "catch/catch.hpp"
+#include "memory_block_cache.hpp"
+
+#include "duckdb/common/vector.hpp"
+
+using namespace duckdb;
+
+namespace {
+vector<data_t> GetBlock(idx_t nr_bytes, data_t value) {
+	return vector<data_t>(nr_bytes, value);
+}
+
+const BlockCacheFileHashes FILE_KEY {/*first=*/1, /*second=*/2};
+} // namespace
+
+TEST_CASE("Test memory block cache read and write", "[memory_block_cache]") {
+	MemoryBlockCache cache;
+	cache.Configure(/*block_size=*/16, /*max_bytes=*/16 * 64);
+	REQUIRE(cache.GetSlotCount() == 64);
+
+	vector<data_t> buffer(16);
+	REQUIRE_FALSE(cache.TryRead(FILE_KEY, 0, buffer.data(), 16));
+	REQUIRE_FALSE(cache.Contains(FILE_KEY, 0));
+
+	const auto block = GetBlock(16, 1);
+	cache.Write(FILE_KEY, 0, block.data(), block.size());
+	REQUIRE(cache.Contains(FILE_KEY, 0));
+	REQUIRE(cache.TryRead(FILE_KEY, 0, buffer.data(), 16));
+	REQUIRE(buffer == block);
+	REQUIRE(cache.GetBlockCount() == 1);
+
+	// The last block of a file could be smaller, and is only hit with the same size.
+	const auto last_block = GetBlock(5, 2);
+	cache.Write(FILE_KEY, 1, last_block.data(), last_block.size());
+	vector<data_t> last_buffer(5);
+	REQUIRE(cache.TryRead(FILE_KEY, 1, last_buffer.data(), 5));
+	REQUIRE(last_buffer == last_block);
+	REQUIRE_FALSE(cache.TryRead(FILE_KEY, 1, buffer.data(), 16));
+
+	// Part of a block is read straight from its slot.
+	vector<data_t> block_with_offsets(16);
+	for (idx_t offset = 0; offset < block_with_offsets.size(); ++offset) {
+		block_with_offsets[offset] = static_cast<data_t>(offset);
+	}
+	cache.Write(FILE_KEY, 3, block_with_offsets.data(), block_with_offsets.size());
+	vector<data_t> part(4);
+	REQUIRE(cache.TryRead(FILE_KEY, 3, /*block_bytes=*/16, /*offset=*/6, part.data(), part.size()));
+	REQUIRE(part == vector<data_t>({6, 7, 8, 9}));
+	REQUIRE_FALSE(cache.TryRead(FILE_KEY, 3, /*block_bytes=*/5, /*offset=*/0, part.data(), part.size()));
+
+	// Files are told apart by both hashes.
+	REQUIRE_FALSE(cache.Contains(BlockCacheFileHashes {/*first=*/1, /*second=*/3}, 0));
+
+	// Blocks larger than a slot are not cached.
+	const auto large_block = GetBlock(32, 3);
+	cache.Write(FILE_KEY, 2, large_block.data(), large_block.size());
+	REQUIRE_FALSE(cache.Contains(FILE_KEY, 2));
+}
+
+TEST_CASE("Test memory block cache eviction", "[memory_block_cache]") {
+	MemoryBlockCache cache;
+	// One slot per shard.
+	cache.Configure(/*block_size=*/16, /*max_bytes=*/16 * MemoryBlockCache::SHARD_COUNT);
+	REQUIRE(cache.GetSlotCount() == MemoryBlockCache::SHARD_COUNT);
+
+	for (idx_t block_index = 0; block_index < 1000; ++block_index) {
+		const auto block = GetBlock(16, static_cast<data_t>(block_index));
+		cache.Write(FILE_KEY, block_index, block.data(), block.size());
+		REQUIRE(cache.GetBlockCount() <= MemoryBlockCache::SHARD_COUNT);
+	}
+	// The most recently written block is always kept.
+	vector<data_t> buffer(16);
+	REQUIRE(cache.TryRead(FILE_KEY, 999, buffer.data(), 16));
+	REQUIRE(buffer == GetBlock(16, static_cast<data_t>(999)));
+}
+
+TEST_CASE("Test memory block cache reconfigure", "[memory_block_cache]") {
+	MemoryBlockCache cache;
+	cache.Configure(/*block_size=*/16, /*max_bytes=*/1024);
+	const auto block = GetBlock(16, 1);
+	cache.Write(FILE_KEY, 0, block.data(), block.size());
+
+	// Same config keeps cached blocks.
+	cache.Configure(/*block_size=*/16, /*max_bytes=*/1024);
+	REQUIRE(cache.GetBlockCount() == 1);
+
+	// A different config drops them.
+	cache.Configure(/*block_size=*/32, /*max_bytes=*/1024);
+	REQUIRE(cache.GetBlockCount() == 0);
+	REQUIRE(cache.GetSlotCount() == 32);
+
+	// Budgets of fewer blocks than shards use fewer shards, instead of being rounded up.
+	cache.Configure(/*block_size=*/32, /*max_bytes=*/32 * 4);
+	REQUIRE(cache.GetSlotCount() == 4);
+	REQUIRE(cache.GetShardCount() == 4);
+	for (idx_t block_index = 0; block_index < 1000; ++block_index) {
+		cache.Write(FILE_KEY, block_index, block.data(), block.size());
+		REQUIRE(cache.Contains(FILE_KEY, block_index));
+		REQUIRE(cache.GetBlockCount() <= 4);
+	}
+	cache.Configure(/*block_size=*/32, /*max_bytes=*/32);
+	REQUIRE(cache.GetSlotCount() == 1);
+	REQUIRE(cache.GetShardCount() == 1);
+	cache.Write(FILE_KEY, 0, block.data(), block.size());
+	REQUIRE(cache.Contains(FILE_KEY, 0));
+
+	// Zero budget disables caching.
+	cache.Configure(/*block_size=*/32, /*max_bytes=*/0);
+	const auto large_block = GetBlock(32, 1);
+	cache.Write(FILE_KEY, 0, large_block.data(), large_block.size());
+	REQUIRE(cache.GetBlockCount() == 0);
+}
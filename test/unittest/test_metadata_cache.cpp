@@ -0,0 +1,119 @@
+#include "catch/catch.hpp"
+#include "metadata_cache.hpp"
+#include "ttl_lru_cache.hpp"
+
+#include <chrono>
+
+using namespace duckdb;
+
+namespace {
+MetadataCacheConfig GetTestConfig() {
+	MetadataCacheConfig config;
+	config.enabled = true;
+	config.ttl_ms = 60000;
+	config.max_entries = 16;
+	return config;
+}
+} // namespace
+
+TEST_CASE("Test TTL LRU cache expiry", "[metadata_cache]") {
+	TtlLruCache<int> cache;
+	const auto now = std::chrono::steady_clock::now();
+	cache.Put("a", 1, /*max_entries=*/4, now);
+
+	int value = 0;
+	REQUIRE(cache.TryGet("a", /*ttl_ms=*/1000, value, now + std::chrono::milliseconds(999)));
+	REQUIRE(value == 1);
+	REQUIRE(!cache.TryGet("a", /*ttl_ms=*/1000, value, now + std::chrono::milliseconds(1000)));
+	// Expired entries are dropped on access.
+	REQUIRE(cache.Size() == 0);
+	REQUIRE(!cache.TryGet("b", /*ttl_ms=*/1000, value, now));
+}
+
+TEST_CASE("Test TTL LRU cache eviction", "[metadata_cache]") {
+	TtlLruCache<int> cache;
+	cache.Put("a", 1, /*max_entries=*/2);
+	cache.Put("b", 2, /*max_entries=*/2);
+
+	// Access makes "a" most recently used, so "b" is evicted.
+	int value = 0;
+	REQUIRE(cache.TryGet("a", /*ttl_ms=*/60000, value));
+	cache.Put("c", 3, /*max_entries=*/2);
+	REQUIRE(cache.Size() == 2);
+	REQUIRE(cache.TryGet("a", /*ttl_ms=*/60000, value));
+	REQUIRE(!cache.TryGet("b", /*ttl_ms=*/60000, value));
+	REQUIRE(cache.TryGet("c", /*ttl_ms=*/60000, value));
+	REQUIRE(value == 3);
+
+	// Overwrite keeps one entry per key.
+	cache.Put("c", 4, /*max_entries=*/2);
+	REQUIRE(cache.Size() == 2);
+	REQUIRE(cache.TryGet("c", /*ttl_ms=*/60000, value));
+	REQUIRE(value == 4);
+
+	cache.EraseByPrefix("a");
+	REQUIRE(cache.Size() == 1);
+}
+
+TEST_CASE("Test metadata cache file info", "[metadata_cache]") {
+	const auto config = GetTestConfig();
+	MetadataCache cache;
+	const string path = "s3://bucket/dir/file.parquet";
+
+	CachedFileMetadata metadata;
+	metadata.exists = true;
+	metadata.has_file_info = true;
+	metadata.file_size = 1024;
+	metadata.last_modified = Timestamp::FromEpochSeconds(1700000000);
+	metadata.etag = "\"abc\"";
+	cache.PutFile(path, config, metadata);
+
+	// Existence check doesn't drop file info already cached.
+	cache.PutFileExists(path, config, /*exists=*/true);
+	OpenFileInfo info(path);
+	REQUIRE(cache.TryAttachFileInfo(info, config));
+	REQUIRE(info.extended_info);
+	REQUIRE(info.extended_info->options["file_size"].GetValue<uint64_t>() == 1024);
+	REQUIRE(info.extended_info->options["last_modified"].GetValue<timestamp_t>() == metadata.last_modified);
+	REQUIRE(info.extended_info->options["etag"].ToString() == "\"abc\"");
+
+	// Listing entries round-trip through extended info, and caller-provided file info is never overwritten.
+	info.path = "s3://bucket/dir/other.parquet";
+	cache.PutListingEntry(info, config);
+	REQUIRE(!cache.TryAttachFileInfo(info, config));
+	CachedFileMetadata listed;
+	REQUIRE(cache.TryGetFile(info.path, config, listed));
+	REQUIRE(listed.has_file_info);
+	REQUIRE(listed.file_size == 1024);
+
+	// Entries without file info don't get attached.
+	cache.PutFileExists("s3://bucket/missing.parquet", config, /*exists=*/false);
+	OpenFileInfo missing("s3://bucket/missing.parquet");
+	REQUIRE(!cache.TryAttachFileInfo(missing, config));
+	REQUIRE(cache.TryGetFile(missing.path, config, metadata));
+	REQUIRE(!metadata.exists);
+}
+
+TEST_CASE("Test metadata cache invalidation", "[metadata_cache]") {
+	const auto config = GetTestConfig();
+	MetadataCache cache;
+	cache.PutFileExists("s3://bucket/dir/a.csv", config, /*exists=*/true);
+	cache.PutFileExists("s3://bucket/dir/b.csv", config, /*exists=*/true);
+	cache.PutFileExists("s3://bucket/other.csv", config, /*exists=*/true);
+	cache.PutDirectoryExists("s3://bucket/dir/", config, /*exists=*/true);
+
+	bool exists = false;
+	REQUIRE(cache.TryGetDirectoryExists("s3://bucket/dir", config, exists));
+	REQUIRE(exists);
+
+	CachedFileMetadata metadata;
+	cache.Invalidate("s3://bucket/dir/a.csv");
+	REQUIRE(!cache.TryGetFile("s3://bucket/dir/a.csv", config, metadata));
+	REQUIRE(cache.TryGetFile("s3://bucket/dir/b.csv", config, metadata));
+	// Writes could implicitly create or remove directories.
+	REQUIRE(!cache.TryGetDirectoryExists("s3://bucket/dir", config, exists));
+
+	cache.InvalidateRecursive("s3://bucket/dir/");
+	REQUIRE(!cache.TryGetFile("s3://bucket/dir/b.csv", config, metadata));
+	REQUIRE(cache.TryGetFile("s3://bucket/other.csv", config, metadata));
+}
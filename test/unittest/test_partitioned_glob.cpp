@@ -0,0 +1,129 @@
+#include "catch/catch.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/main/database.hpp"
+#include "file_system_timeout_retry_wrapper.hpp"
+#include "partitioned_glob.hpp"
+#include "test_helpers.hpp"
+
+#include <algorithm>
+
+using namespace duckdb;
+
+namespace {
+
+// Local filesystem which records the patterns it globs, as the inner filesystem of the wrapper.
+class GlobRecordingFileSystem : public FileSystem {
+public:
+	GlobRecordingFileSystem() : local_filesystem(FileSystem::CreateLocal()) {
+	}
+
+	vector<OpenFileInfo> Glob(const string &path, FileOpener *opener = nullptr) override {
+		{
+			lock_guard<mutex> lck(patterns_mutex);
+			globbed_patterns.push_back(path);
+		}
+		return local_filesystem->Glob(path, opener);
+	}
+	bool ListFiles(const string &directory, const std::function<void(const string &, bool)> &callback,
+	               FileOpener *opener = nullptr) override {
+		return local_filesystem->ListFiles(directory, callback, opener);
+	}
+	string GetName() const override {
+		return "GlobRecordingFileSystem";
+	}
+
+	unique_ptr<FileSystem> local_filesystem;
+	mutex patterns_mutex;
+	vector<string> globbed_patterns;
+};
+
+vector<string> GetSortedPaths(const vector<OpenFileInfo> &infos) {
+	vector<string> paths;
+	for (const auto &info : infos) {
+		paths.push_back(info.path);
+	}
+	std::sort(paths.begin(), paths.end());
+	return paths;
+}
+
+} // namespace
+
+TEST_CASE("Test partitioned glob split", "[partitioned_glob]") {
+	PartitionedGlob partitioned_glob;
+	REQUIRE(TrySplitPartitionedGlob("s3://bucket/t/year=*/month=*/*.parquet", partitioned_glob));
+	REQUIRE(partitioned_glob.directory == "s3://bucket/t");
+	REQUIRE(partitioned_glob.partition_pattern == "year=*");
+	REQUIRE(partitioned_glob.remainder == "month=*/*.parquet");
+	REQUIRE(partitioned_glob.GetPartitionGlob("year=2024") == "s3://bucket/t/year=2024/month=*/*.parquet");
+
+	// Wildcards in the last segment only match files.
+	REQUIRE_FALSE(TrySplitPartitionedGlob("s3://bucket/t/*.parquet", partitioned_glob));
+	// Recursive wildcards cannot be expanded by one listing.
+	REQUIRE_FALSE(TrySplitPartitionedGlob("s3://bucket/t/**/*.parquet", partitioned_glob));
+	// No wildcard at all.
+	REQUIRE_FALSE(TrySplitPartitionedGlob("s3://bucket/t/data.parquet", partitioned_glob));
+}
+
+TEST_CASE("Test glob segment matching", "[partitioned_glob]") {
+	REQUIRE(MatchGlobSegment("year=2024", "year=*"));
+	REQUIRE(MatchGlobSegment("year=2024", "year=202?"));
+	REQUIRE(MatchGlobSegment("year=2024", "*=2024"));
+	REQUIRE(MatchGlobSegment("year=2024", "year=20[0-2][3-5]"));
+	REQUIRE(MatchGlobSegment("year=2024", "*"));
+	REQUIRE_FALSE(MatchGlobSegment("month=01", "year=*"));
+	REQUIRE_FALSE(MatchGlobSegment("year=2024", "year=202"));
+	REQUIRE_FALSE(MatchGlobSegment("year=2024", "year=20[!2]4"));
+	REQUIRE(MatchGlobSegment("a*b*c", "a*c"));
+	REQUIRE(MatchGlobSegment("", "*"));
+	REQUIRE_FALSE(MatchGlobSegment("", "?"));
+	// Unterminated class matches '[' literally.
+	REQUIRE(MatchGlobSegment("[x", "[x"));
+}
+
+TEST_CASE("Test listed name", "[partitioned_glob]") {
+	REQUIRE(GetListedName("year=2024") == "year=2024");
+	REQUIRE(GetListedName("year=2024/") == "year=2024");
+	REQUIRE(GetListedName("s3://bucket/t/year=2024/") == "year=2024");
+	REQUIRE(GetListedName("s3://bucket/t/year=2024") == "year=2024");
+}
+
+TEST_CASE("Test partitioned glob matches a single glob", "[partitioned_glob]") {
+	DBConfig config;
+	DuckDB db(nullptr, &config);
+	DatabaseInstance &db_instance = *db.instance;
+	auto &db_config = DBConfig::GetConfig(db_instance);
+	db_config.AddExtensionOption("httpfs_glob_parallelism", "Max number of partitions globbed concurrently",
+	                             LogicalType {LogicalTypeId::UBIGINT}, Value());
+	db_config.SetOptionByName("httpfs_glob_parallelism", Value::UBIGINT(4));
+
+	auto local_filesystem = FileSystem::CreateLocal();
+	const auto directory = TestCreatePath("partitioned_glob_table");
+	if (local_filesystem->DirectoryExists(directory)) {
+		local_filesystem->RemoveDirectory(directory);
+	}
+	// Two matching partitions, one partition which doesn't match, and files which don't match the remainder.
+	for (const auto partition :
+	     {"year=2023/month=01", "year=2023/month=02", "year=2024/month=01", "other=1/month=01"}) {
+		const auto partition_directory = directory + "/" + partition;
+		local_filesystem->CreateDirectoriesRecursive(partition_directory);
+		for (const auto file_name : {"data.parquet", "data.csv"}) {
+			local_filesystem->OpenFile(partition_directory + "/" + file_name,
+			                           FileFlags::FILE_FLAGS_WRITE | FileFlags::FILE_FLAGS_FILE_CREATE);
+		}
+	}
+
+	auto recording_filesystem = make_uniq<GlobRecordingFileSystem>();
+	auto &globbed_patterns = recording_filesystem->globbed_patterns;
+	FileSystemTimeoutRetryWrapper wrapper(std::move(recording_filesystem), db_instance);
+
+	const auto pattern = directory + "/year=*/month=*/*.parquet";
+	const auto result = wrapper.Glob(pattern);
+	REQUIRE(result.size() == 3);
+	REQUIRE(GetSortedPaths(result) == GetSortedPaths(local_filesystem->Glob(pattern)));
+
+	// Each matching partition is globbed on its own, rather than the whole pattern.
+	std::sort(globbed_patterns.begin(), globbed_patterns.end());
+	REQUIRE(globbed_patterns == vector<string> {directory + "/year=2023/month=*/*.parquet",
+	                                            directory + "/year=2024/month=*/*.parquet"});
+}
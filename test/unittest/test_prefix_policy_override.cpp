@@ -0,0 +1,155 @@
+#include "catch/catch.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/main/database.hpp"
+#include "duckdb/main/database_file_opener.hpp"
+#include "prefix_policy_override.hpp"
+#include "timeout_retry_policy.hpp"
+
+#include <chrono>
+
+using namespace duckdb;
+
+namespace {
+constexpr idx_t BENCHMARK_ITERATIONS = 100000;
+
+void RegisterExtensionOptions(DBConfig &db_config) {
+	db_config.AddExtensionOption("httpfs_timeout_file_operation_ms",
+	                             "Timeout for file operations (open/read/write) (in milliseconds)",
+	                             LogicalType {LogicalTypeId::UBIGINT}, Value());
+	db_config.AddExtensionOption("httpfs_timeout_read_ms", "Timeout for reads on file handles (in milliseconds)",
+	                             LogicalType {LogicalTypeId::UBIGINT}, Value());
+	db_config.AddExtensionOption("httpfs_retries_read", "Maximum number of retries for reads on file handles",
+	                             LogicalType {LogicalTypeId::UBIGINT}, Value());
+	db_config.AddExtensionOption("httpfs_prefix_policy_overrides", "Timeout and retry settings overridden per prefix",
+	                             LogicalType {LogicalTypeId::VARCHAR}, Value());
+}
+
+// Average time of one call of [func], in nanoseconds.
+template <class FUNC>
+double MeasureNanosPerCall(FUNC &&func) {
+	const auto start = std::chrono::steady_clock::now();
+	for (idx_t idx = 0; idx < BENCHMARK_ITERATIONS; ++idx) {
+		func();
+	}
+	const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+	return elapsed.count() / static_cast<double>(BENCHMARK_ITERATIONS);
+}
+
+PrefixTrie MakeBucketTrie(idx_t bucket_count) {
+	PrefixTrie trie;
+	for (idx_t idx = 0; idx < bucket_count; ++idx) {
+		trie.Insert(StringUtil::Format("s3://bucket-%llu/", static_cast<unsigned long long>(idx)), idx);
+	}
+	return trie;
+}
+} // namespace
+
+TEST_CASE("Test prefix trie finds longest prefix", "[prefix_policy_override]") {
+	PrefixTrie trie;
+	REQUIRE(trie.FindLongestPrefix("s3://bucket/file") == PrefixTrie::NOT_FOUND);
+
+	trie.Insert("s3://bucket/", 0);
+	trie.Insert("s3://bucket/archive/", 1);
+	trie.Insert("s3://bucket-hot/", 2);
+	REQUIRE(trie.FindLongestPrefix("s3://bucket/file") == 0);
+	REQUIRE(trie.FindLongestPrefix("s3://bucket/archive/2024/file") == 1);
+	REQUIRE(trie.FindLongestPrefix("s3://bucket/archived") == 0);
+	REQUIRE(trie.FindLongestPrefix("s3://bucket-hot/file") == 2);
+	REQUIRE(trie.FindLongestPrefix("s3://bucket") == PrefixTrie::NOT_FOUND);
+	REQUIRE(trie.FindLongestPrefix("s3://other/file") == PrefixTrie::NOT_FOUND);
+	REQUIRE(trie.FindLongestPrefix("") == PrefixTrie::NOT_FOUND);
+
+	// Inserting an equal prefix replaces its value.
+	trie.Insert("s3://bucket/archive/", 3);
+	REQUIRE(trie.FindLongestPrefix("s3://bucket/archive/file") == 3);
+}
+
+TEST_CASE("Test parse prefix policy overrides", "[prefix_policy_override]") {
+	const auto overrides = ParsePrefixPolicyOverrides(
+	    "s3://bucket/archive/ httpfs_timeout_read_ms=60000; s3://bucket/ httpfs_timeout_read_ms=5000, "
+	    "HTTPFS_RETRIES_READ = 10, httpfs_retry_backoff_read=1.5;");
+	REQUIRE(overrides.size() == 2);
+
+	// Enclosing prefixes come first, and nested prefixes take their overrides.
+	REQUIRE(overrides[0].prefix == "s3://bucket/");
+	REQUIRE(overrides[0].settings.size() == 3);
+	REQUIRE(overrides[0].settings.at("httpfs_retry_backoff_read").GetValue<double>() == 1.5);
+	REQUIRE(overrides[1].prefix == "s3://bucket/archive/");
+	REQUIRE(overrides[1].settings.at("httpfs_timeout_read_ms").GetValue<uint64_t>() == 60000);
+	REQUIRE(overrides[1].settings.at("httpfs_retries_read").GetValue<uint64_t>() == 10);
+
+	REQUIRE(ParsePrefixPolicyOverrides(" ; ").empty());
+	REQUIRE_THROWS_AS(ParsePrefixPolicyOverrides("bucket/ httpfs_timeout_read_ms=1"), InvalidInputException);
+	REQUIRE_THROWS_AS(ParsePrefixPolicyOverrides("s3://bucket/"), InvalidInputException);
+	REQUIRE_THROWS_AS(ParsePrefixPolicyOverrides("s3://bucket/ httpfs_timeout_read_ms"), InvalidInputException);
+	REQUIRE_THROWS_AS(ParsePrefixPolicyOverrides("s3://bucket/ httpfs_timeout_read_ms=soon"), InvalidInputException);
+	REQUIRE_THROWS_AS(ParsePrefixPolicyOverrides("s3://bucket/ httpfs_metadata_cache_ttl_ms=1"),
+	                  InvalidInputException);
+	REQUIRE_THROWS_AS(
+	    ParsePrefixPolicyOverrides("s3://bucket/ httpfs_timeout_read_ms=1; s3://bucket/ httpfs_retries_read=1"),
+	    InvalidInputException);
+}
+
+TEST_CASE("Test policy snapshot applies prefix overrides", "[prefix_policy_override]") {
+	DBConfig config;
+	DuckDB db(nullptr, &config);
+	DatabaseInstance &db_instance = *db.instance;
+	auto &db_config = DBConfig::GetConfig(db_instance);
+
+	RegisterExtensionOptions(db_config);
+	db_config.SetOptionByName("httpfs_timeout_file_operation_ms", Value::UBIGINT(2000));
+	db_config.SetOptionByName("httpfs_retries_read", Value::UBIGINT(2));
+	db_config.SetOptionByName("httpfs_prefix_policy_overrides",
+	                          Value("s3://archive-bucket/ httpfs_timeout_read_ms=60000, httpfs_retries_read=10; "
+	                                "s3://archive-bucket/hot/ httpfs_timeout_read_ms=1500"));
+
+	DatabaseFileOpener opener(db_instance);
+	const auto policies = ResolveTimeoutRetryPolicies(opener);
+
+	// Paths outside of any prefix take the settings.
+	TimeoutRetryFileOpener default_opener(opener, HttpfsOperationType::READ, policies.get(), "s3://hot-bucket/file");
+	uint64_t timeout_ms = 0;
+	REQUIRE(default_opener.TryGetTimeoutMs(timeout_ms));
+	REQUIRE(timeout_ms == 2000);
+	REQUIRE(GetRetryConfig(default_opener).max_retries == 2);
+
+	TimeoutRetryFileOpener archive_opener(opener, HttpfsOperationType::READ, policies.get(),
+	                                      "s3://archive-bucket/2024/file.parquet");
+	REQUIRE(archive_opener.TryGetTimeoutMs(timeout_ms));
+	REQUIRE(timeout_ms == 60000);
+	REQUIRE(GetRetryConfig(archive_opener).max_retries == 10);
+	Value value;
+	REQUIRE(static_cast<bool>(FileOpener::TryGetCurrentSetting(&archive_opener, "http_timeout", value)));
+	REQUIRE(value.GetValue<uint64_t>() == 60);
+
+	// Nested prefixes keep the overrides of enclosing prefixes they don't override themselves.
+	TimeoutRetryFileOpener hot_opener(opener, HttpfsOperationType::READ, policies.get(),
+	                                  "s3://archive-bucket/hot/file.parquet");
+	REQUIRE(hot_opener.TryGetTimeoutMs(timeout_ms));
+	REQUIRE(timeout_ms == 1500);
+	REQUIRE(GetRetryConfig(hot_opener).max_retries == 10);
+
+	// Overrides only apply to the settings they name, opens still take file operation settings.
+	TimeoutRetryFileOpener open_opener(opener, HttpfsOperationType::OPEN, policies.get(),
+	                                   "s3://archive-bucket/2024/file.parquet");
+	REQUIRE(open_opener.TryGetTimeoutMs(timeout_ms));
+	REQUIRE(timeout_ms == 2000);
+
+	db_config.SetOptionByName("httpfs_prefix_policy_overrides", Value("s3://archive-bucket/ httpfs_retries_read=-1"));
+	REQUIRE_THROWS_AS(ResolveTimeoutRetryPolicies(opener), InvalidInputException);
+}
+
+TEST_CASE("Benchmark prefix lookup with many prefixes", "[prefix_policy_override][.benchmark]") {
+	const auto few_prefixes = MakeBucketTrie(4);
+	const auto many_prefixes = MakeBucketTrie(100000);
+	const string path = "s3://bucket-3/year=2024/month=01/data.parquet";
+
+	idx_t matches = 0;
+	const auto few_ns = MeasureNanosPerCall([&]() { matches += few_prefixes.FindLongestPrefix(path) == 3; });
+	const auto many_ns = MeasureNanosPerCall([&]() { matches += many_prefixes.FindLongestPrefix(path) == 3; });
+	WARN(StringUtil::Format("Prefix lookup: %.0f ns with 4 prefixes, %.0f ns with 100000 prefixes", few_ns, many_ns));
+	REQUIRE(matches == 2 * BENCHMARK_ITERATIONS);
+	// Lookups walk the path rather than the prefixes, so the cost barely grows with their number.
+	REQUIRE(many_ns < 10 * few_ns);
+}
@@ -0,0 +1,163 @@
+#include "catch/catch.hpp"
+#include "read_coalescer.hpp"
+
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/vector.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <stdexcept>
+#include <thread>
+
+using namespace duckdb;
+
+namespace {
+constexpr idx_t FILE_SIZE = 1024 * 1024;
+
+struct FetchRecorder {
+	mutex fetch_mutex;
+	// (location, bytes) of each fetch.
+	vector<std::pair<idx_t, idx_t>> fetches;
+	bool fail = false;
+	// Whether the first fetch is held in flight until released.
+	bool hold_first_fetch = false;
+	std::condition_variable release_cv;
+
+	void ReleaseFirstFetch() {
+		lock_guard<mutex> lck(fetch_mutex);
+		hold_first_fetch = false;
+		release_cv.notify_all();
+	}
+
+	ReadCoalescer::FetchFunction GetFetchFunction() {
+		return [this](data_ptr_t buffer, idx_t nr_bytes, idx_t location) {
+			std::unique_lock<mutex> lck(fetch_mutex);
+			fetches.emplace_back(location, nr_bytes);
+			if (fetches.size() == 1) {
+				release_cv.wait(lck, [&]() { return !hold_first_fetch; });
+			}
+			if (fail) {
+				throw std::runtime_error("injected fetch failure");
+			}
+			for (idx_t idx = 0; idx < nr_bytes; ++idx) {
+				buffer[idx] = static_cast<data_t>((location + idx) % 251);
+			}
+		};
+	}
+};
+
+bool HasContent(const vector<data_t> &buffer, idx_t location) {
+	for (idx_t idx = 0; idx < buffer.size(); ++idx) {
+		if (buffer[idx] != static_cast<data_t>((location + idx) % 251)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// Issue concurrent reads of [nr_bytes] at each of [locations], return whether each one got the right content.
+vector<bool> ReadConcurrently(ReadCoalescer &coalescer, const vector<idx_t> &locations, idx_t nr_bytes) {
+	vector<bool> succeeded(locations.size(), false);
+	vector<std::thread> threads;
+	for (idx_t idx = 0; idx < locations.size(); ++idx) {
+		threads.emplace_back([&, idx]() {
+			vector<data_t> buffer(nr_bytes);
+			try {
+				coalescer.Read(buffer.data(), nr_bytes, locations[idx]);
+				succeeded[idx] = HasContent(buffer, locations[idx]);
+			} catch (...) {
+				succeeded[idx] = false;
+			}
+		});
+	}
+	for (auto &thread : threads) {
+		thread.join();
+	}
+	return succeeded;
+}
+} // namespace
+
+TEST_CASE("Test read coalescer merges nearby reads", "[read_coalescer]") {
+	FetchRecorder recorder;
+	recorder.hold_first_fetch = true;
+	// A long window, so all reads behind the one in flight join the same batch.
+	ReadCoalescer coalescer(/*max_gap_bytes_p=*/100, /*max_request_bytes_p=*/FILE_SIZE, /*window_us_p=*/500000,
+	                        FILE_SIZE, recorder.GetFetchFunction());
+	std::thread first_read([&]() {
+		vector<data_t> buffer(100);
+		coalescer.Read(buffer.data(), buffer.size(), 0);
+	});
+	while (coalescer.GetRequestCount() == 0) {
+		std::this_thread::yield();
+	}
+
+	const vector<idx_t> locations {1000, 1150, 1300, 1450, 1600, 1750, 1900, 2050};
+	const auto succeeded = ReadConcurrently(coalescer, locations, /*nr_bytes=*/100);
+	recorder.ReleaseFirstFetch();
+	first_read.join();
+	for (const auto read_succeeded : succeeded) {
+		REQUIRE(read_succeeded);
+	}
+	REQUIRE(coalescer.GetReadCount() == locations.size() + 1);
+	REQUIRE(coalescer.GetRequestCount() == 2);
+	REQUIRE(recorder.fetches.size() == 2);
+	REQUIRE(recorder.fetches[1] == std::make_pair<idx_t, idx_t>(1000, 1150));
+}
+
+TEST_CASE("Test read coalescer sends lone reads right away", "[read_coalescer]") {
+	FetchRecorder recorder;
+	ReadCoalescer coalescer(/*max_gap_bytes_p=*/100, /*max_request_bytes_p=*/FILE_SIZE, /*window_us_p=*/10000000,
+	                        FILE_SIZE, recorder.GetFetchFunction());
+	const auto start = std::chrono::steady_clock::now();
+	for (idx_t location = 0; location < 1000; location += 100) {
+		vector<data_t> buffer(100);
+		coalescer.Read(buffer.data(), buffer.size(), location);
+		REQUIRE(HasContent(buffer, location));
+	}
+	// Nothing else is in flight, so no read waits for the window.
+	REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::seconds(5));
+	REQUIRE(coalescer.GetRequestCount() == 10);
+}
+
+TEST_CASE("Test read coalescer keeps distant reads apart", "[read_coalescer]") {
+	FetchRecorder recorder;
+	ReadCoalescer coalescer(/*max_gap_bytes_p=*/100, /*max_request_bytes_p=*/FILE_SIZE, /*window_us_p=*/200000,
+	                        FILE_SIZE, recorder.GetFetchFunction());
+	const vector<idx_t> locations {0, 10000, 20000};
+	const auto succeeded = ReadConcurrently(coalescer, locations, /*nr_bytes=*/100);
+	for (const auto read_succeeded : succeeded) {
+		REQUIRE(read_succeeded);
+	}
+	REQUIRE(coalescer.GetRequestCount() == 3);
+}
+
+TEST_CASE("Test read coalescer caps request size", "[read_coalescer]") {
+	FetchRecorder recorder;
+	ReadCoalescer coalescer(/*max_gap_bytes_p=*/100, /*max_request_bytes_p=*/400, /*window_us_p=*/200000, FILE_SIZE,
+	                        recorder.GetFetchFunction());
+	const vector<idx_t> locations {0, 100, 200, 300, 400, 500, 600, 700};
+	const auto succeeded = ReadConcurrently(coalescer, locations, /*nr_bytes=*/100);
+	for (const auto read_succeeded : succeeded) {
+		REQUIRE(read_succeeded);
+	}
+	REQUIRE(coalescer.GetRequestCount() >= 2);
+	for (const auto &fetch : recorder.fetches) {
+		REQUIRE(fetch.second <= 400);
+	}
+
+	// Reads at or beyond the max request size, or past end of file, are not coalesced.
+	REQUIRE(coalescer.ShouldCoalesce(100, 0));
+	REQUIRE_FALSE(coalescer.ShouldCoalesce(400, 0));
+	REQUIRE_FALSE(coalescer.ShouldCoalesce(100, FILE_SIZE - 50));
+}
+
+TEST_CASE("Test read coalescer propagates failure to all readers", "[read_coalescer]") {
+	FetchRecorder recorder;
+	recorder.fail = true;
+	ReadCoalescer coalescer(/*max_gap_bytes_p=*/100, /*max_request_bytes_p=*/FILE_SIZE, /*window_us_p=*/500000,
+	                        FILE_SIZE, recorder.GetFetchFunction());
+	const auto succeeded = ReadConcurrently(coalescer, {0, 100, 200}, /*nr_bytes=*/100);
+	for (const auto read_succeeded : succeeded) {
+		REQUIRE_FALSE(read_succeeded);
+	}
+}
@@ -0,0 +1,259 @@
+#include "catch/catch.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/limits.hpp"
+#include "duckdb/main/database.hpp"
+#include "duckdb/main/database_file_opener.hpp"
+#include "retry_policy.hpp"
+
+#include <chrono>
+
+using namespace duckdb;
+
+namespace {
+void RegisterExtensionOptions(DBConfig &db_config) {
+	db_config.AddExtensionOption("httpfs_retries_list", "Maximum number of retries for listing directories",
+	                             LogicalType {LogicalTypeId::UBIGINT}, Value());
+	db_config.AddExtensionOption("httpfs_retry_budget_ratio", "Retry budget ratio",
+	                             LogicalType {LogicalTypeId::DOUBLE}, Value());
+	db_config.AddExtensionOption("httpfs_retry_budget_min_retries_per_second", "Retry budget min retries per second",
+	                             LogicalType {LogicalTypeId::UBIGINT}, Value());
+	db_config.AddExtensionOption("httpfs_retry_wait_file_operation_ms", "Initial retry wait for file operations",
+	                             LogicalType {LogicalTypeId::UBIGINT}, Value());
+	db_config.AddExtensionOption("httpfs_retry_wait_list_ms", "Initial retry wait for listing directories",
+	                             LogicalType {LogicalTypeId::UBIGINT}, Value());
+	db_config.AddExtensionOption("httpfs_retry_backoff_list", "Retry wait multiplier for listing directories",
+	                             LogicalType {LogicalTypeId::DOUBLE}, Value());
+	db_config.AddExtensionOption("httpfs_retry_max_wait_list_ms", "Maximum retry wait for listing directories",
+	                             LogicalType {LogicalTypeId::UBIGINT}, Value());
+	db_config.AddExtensionOption("httpfs_retry_jitter", "Jitter of retry waits", LogicalType {LogicalTypeId::VARCHAR},
+	                             Value());
+}
+
+RetryConfig MakeRetryConfig(RetryJitter jitter) {
+	RetryConfig config;
+	config.retry_wait_ms = 100;
+	config.retry_backoff = 2;
+	config.retry_max_wait_ms = 1000;
+	config.jitter = jitter;
+	return config;
+}
+
+// Make an HTTP error with the given status code and extra info, the way httpfs reports failed requests.
+Exception MakeHTTPError(int64_t status_code, unordered_map<string, string> extra_info = {}) {
+	extra_info["status_code"] = std::to_string(status_code);
+	return Exception(ExceptionType::HTTP, "HTTP request failed", extra_info);
+}
+} // namespace
+
+TEST_CASE("Test retry budget deposit and withdrawal", "[retry_policy]") {
+	RetryBudgetConfig config;
+	config.enabled = true;
+	config.ratio = 0.1;
+	config.min_retries_per_second = 0;
+
+	RetryBudget budget;
+	const auto now = std::chrono::steady_clock::now();
+	REQUIRE(!budget.TryAcquireRetry(config, now));
+
+	// 10 successful requests earn one retry.
+	for (idx_t idx = 0; idx < 10; ++idx) {
+		budget.RecordSuccess(config, now);
+	}
+	REQUIRE(budget.TryAcquireRetry(config, now));
+	REQUIRE(!budget.TryAcquireRetry(config, now));
+
+	// Saved up retries are capped.
+	for (idx_t idx = 0; idx < 10000; ++idx) {
+		budget.RecordSuccess(config, now);
+	}
+	idx_t retries = 0;
+	while (budget.TryAcquireRetry(config, now)) {
+		++retries;
+	}
+	REQUIRE(retries == static_cast<idx_t>(RetryBudget::MAX_TOKENS));
+}
+
+TEST_CASE("Test retry budget refill over time", "[retry_policy]") {
+	RetryBudgetConfig config;
+	config.enabled = true;
+	config.ratio = 0;
+	config.min_retries_per_second = 2;
+
+	RetryBudget budget;
+	const auto now = std::chrono::steady_clock::now();
+	// Start with one second worth of retries.
+	REQUIRE(budget.TryAcquireRetry(config, now));
+	REQUIRE(budget.TryAcquireRetry(config, now));
+	REQUIRE(!budget.TryAcquireRetry(config, now));
+
+	const auto later = now + std::chrono::milliseconds(500);
+	REQUIRE(budget.TryAcquireRetry(config, later));
+	REQUIRE(!budget.TryAcquireRetry(config, later));
+}
+
+TEST_CASE("Test retryable error classification", "[retry_policy]") {
+	REQUIRE(IsRetryableError(IOException("Connection reset by peer")));
+	REQUIRE(!IsRetryableError(InvalidInputException("Invalid input")));
+	REQUIRE(!IsRetryableError(NotImplementedException("Not implemented")));
+}
+
+TEST_CASE("Test retry config resolution", "[retry_policy]") {
+	DBConfig config;
+	DuckDB db(nullptr, &config);
+	DatabaseInstance &db_instance = *db.instance;
+	auto &db_config = DBConfig::GetConfig(db_instance);
+
+	RegisterExtensionOptions(db_config);
+	db_config.SetOptionByName("http_retries", Value::UBIGINT(5));
+	DatabaseFileOpener opener(db_instance);
+
+	// Retry budget disabled by default, fall back to http_retries.
+	{
+		TimeoutRetryFileOpener timeout_retry_opener(opener, HttpfsOperationType::LIST);
+		const auto retry_config = GetRetryConfig(timeout_retry_opener);
+		REQUIRE(retry_config.max_retries == 5);
+		REQUIRE(!retry_config.budget.enabled);
+	}
+
+	db_config.SetOptionByName("httpfs_retries_list", Value::UBIGINT(2));
+	db_config.SetOptionByName("httpfs_retry_budget_ratio", Value::DOUBLE(0.2));
+	db_config.SetOptionByName("httpfs_retry_budget_min_retries_per_second", Value::UBIGINT(5));
+	{
+		TimeoutRetryFileOpener timeout_retry_opener(opener, HttpfsOperationType::LIST);
+		const auto retry_config = GetRetryConfig(timeout_retry_opener);
+		REQUIRE(retry_config.max_retries == 2);
+		REQUIRE(retry_config.budget.enabled);
+		REQUIRE(retry_config.budget.ratio == 0.2);
+		REQUIRE(retry_config.budget.min_retries_per_second == 5);
+
+		// Inner filesystem doesn't retry once the wrapper owns retries.
+		timeout_retry_opener.DisableInnerRetries();
+		Value retries_value;
+		auto retries_result = FileOpener::TryGetCurrentSetting(&timeout_retry_opener, "http_retries", retries_value);
+		REQUIRE(static_cast<bool>(retries_result));
+		REQUIRE(retries_value.GetValue<uint64_t>() == 0);
+
+		uint64_t retries = 0;
+		REQUIRE(timeout_retry_opener.TryGetRetries(retries));
+		REQUIRE(retries == 2);
+	}
+}
+
+TEST_CASE("Test retry wait backoff and max wait", "[retry_policy]") {
+	const auto config = MakeRetryConfig(RetryJitter::NONE);
+	REQUIRE(GetRetryWaitMs(config, /*retry_index=*/0, /*previous_wait_ms=*/100, /*random=*/0.5) == 100);
+	REQUIRE(GetRetryWaitMs(config, /*retry_index=*/2, /*previous_wait_ms=*/200, /*random=*/0.5) == 400);
+	// Waits are capped by the max wait.
+	REQUIRE(GetRetryWaitMs(config, /*retry_index=*/10, /*previous_wait_ms=*/1000, /*random=*/0.5) == 1000);
+}
+
+TEST_CASE("Test retry wait jitter", "[retry_policy]") {
+	// Full jitter waits up to the exponential wait.
+	{
+		const auto config = MakeRetryConfig(RetryJitter::FULL);
+		REQUIRE(GetRetryWaitMs(config, /*retry_index=*/2, /*previous_wait_ms=*/0, /*random=*/0) == 0);
+		REQUIRE(GetRetryWaitMs(config, /*retry_index=*/2, /*previous_wait_ms=*/0, /*random=*/0.5) == 200);
+	}
+	// Equal jitter waits at least half the exponential wait.
+	{
+		const auto config = MakeRetryConfig(RetryJitter::EQUAL);
+		REQUIRE(GetRetryWaitMs(config, /*retry_index=*/2, /*previous_wait_ms=*/0, /*random=*/0) == 200);
+		REQUIRE(GetRetryWaitMs(config, /*retry_index=*/2, /*previous_wait_ms=*/0, /*random=*/0.5) == 300);
+	}
+	// Decorrelated jitter waits between the initial wait and three times the previous wait, capped by the max wait.
+	{
+		const auto config = MakeRetryConfig(RetryJitter::DECORRELATED);
+		REQUIRE(GetRetryWaitMs(config, /*retry_index=*/0, /*previous_wait_ms=*/100, /*random=*/0) == 100);
+		REQUIRE(GetRetryWaitMs(config, /*retry_index=*/1, /*previous_wait_ms=*/200, /*random=*/0.5) == 350);
+		REQUIRE(GetRetryWaitMs(config, /*retry_index=*/5, /*previous_wait_ms=*/900, /*random=*/0.9) == 1000);
+	}
+	// Random waits stay within bounds.
+	{
+		const auto config = MakeRetryConfig(RetryJitter::FULL);
+		for (idx_t idx = 0; idx < 100; ++idx) {
+			REQUIRE(GetRetryWaitMs(config, /*retry_index=*/2, /*previous_wait_ms=*/0) <= 400);
+		}
+	}
+}
+
+TEST_CASE("Test Retry-After and throttling errors", "[retry_policy]") {
+	uint64_t retry_after_ms = 0;
+	REQUIRE(TryGetRetryAfterMs(MakeHTTPError(503, {{"header_Retry-After", "3"}}), retry_after_ms));
+	REQUIRE(retry_after_ms == 3000);
+	REQUIRE(TryGetRetryAfterMs(MakeHTTPError(429, {{"header_retry-after", "1"}}), retry_after_ms));
+	REQUIRE(retry_after_ms == 1000);
+	// HTTP dates and errors without the header are ignored.
+	REQUIRE(!TryGetRetryAfterMs(MakeHTTPError(503, {{"header_Retry-After", "Wed, 21 Oct 2015 07:28:00 GMT"}}),
+	                            retry_after_ms));
+	REQUIRE(!TryGetRetryAfterMs(MakeHTTPError(503), retry_after_ms));
+	REQUIRE(!TryGetRetryAfterMs(IOException("Connection reset by peer"), retry_after_ms));
+	// Huge values don't overflow.
+	REQUIRE(TryGetRetryAfterMs(MakeHTTPError(503, {{"header_Retry-After", "99999999999999999999"}}), retry_after_ms));
+	REQUIRE(retry_after_ms == static_cast<uint64_t>(NumericLimits<uint32_t>::Maximum()) * 1000);
+
+	// Longer waits are given up on, up to the max retry wait if bounded.
+	auto config = MakeRetryConfig(RetryJitter::NONE);
+	REQUIRE(GetMaxRetryAfterMs(config) == config.retry_max_wait_ms);
+	config.retry_max_wait_ms = 0;
+	REQUIRE(GetMaxRetryAfterMs(config) == 60000);
+
+	REQUIRE(IsThrottlingError(MakeHTTPError(429)));
+	REQUIRE(IsThrottlingError(MakeHTTPError(503, {{"response_body", "<Error><Code>SlowDown</Code></Error>"}})));
+	REQUIRE(!IsThrottlingError(MakeHTTPError(503)));
+	// Throttling with HTTP 400 is retried as well.
+	const auto throttled = MakeHTTPError(400, {{"response_body", "<Error><Code>RequestLimitExceeded</Code></Error>"}});
+	REQUIRE(IsThrottlingError(throttled));
+	REQUIRE(IsRetryableError(throttled));
+	REQUIRE(!IsRetryableError(MakeHTTPError(400)));
+}
+
+TEST_CASE("Test retry wait config resolution", "[retry_policy]") {
+	DBConfig config;
+	DuckDB db(nullptr, &config);
+	DatabaseInstance &db_instance = *db.instance;
+	auto &db_config = DBConfig::GetConfig(db_instance);
+
+	RegisterExtensionOptions(db_config);
+	db_config.SetOptionByName("http_retry_wait_ms", Value::UBIGINT(50));
+	DatabaseFileOpener opener(db_instance);
+
+	// Fall back to http_retry_wait_ms, without max wait and jitter.
+	{
+		TimeoutRetryFileOpener timeout_retry_opener(opener, HttpfsOperationType::LIST);
+		const auto retry_config = GetRetryConfig(timeout_retry_opener);
+		REQUIRE(retry_config.retry_wait_ms == 50);
+		REQUIRE(retry_config.retry_max_wait_ms == 0);
+		REQUIRE(retry_config.jitter == RetryJitter::NONE);
+	}
+
+	db_config.SetOptionByName("httpfs_retry_wait_list_ms", Value::UBIGINT(200));
+	db_config.SetOptionByName("httpfs_retry_backoff_list", Value::DOUBLE(3));
+	db_config.SetOptionByName("httpfs_retry_max_wait_list_ms", Value::UBIGINT(5000));
+	db_config.SetOptionByName("httpfs_retry_wait_file_operation_ms", Value::UBIGINT(300));
+	db_config.SetOptionByName("httpfs_retry_jitter", Value("Decorrelated"));
+	{
+		TimeoutRetryFileOpener timeout_retry_opener(opener, HttpfsOperationType::LIST);
+		const auto retry_config = GetRetryConfig(timeout_retry_opener);
+		REQUIRE(retry_config.retry_wait_ms == 200);
+		REQUIRE(retry_config.retry_backoff == 3);
+		REQUIRE(retry_config.retry_max_wait_ms == 5000);
+		REQUIRE(retry_config.jitter == RetryJitter::DECORRELATED);
+
+		// Operations retried by the inner filesystem see the per-operation wait as well.
+		Value wait_value;
+		REQUIRE(static_cast<bool>(
+		    FileOpener::TryGetCurrentSetting(&timeout_retry_opener, "http_retry_wait_ms", wait_value)));
+		REQUIRE(wait_value.GetValue<uint64_t>() == 200);
+	}
+	// Reads fall back to file operation settings.
+	{
+		TimeoutRetryFileOpener timeout_retry_opener(opener, HttpfsOperationType::READ);
+		REQUIRE(GetRetryConfig(timeout_retry_opener).retry_wait_ms == 300);
+	}
+
+	db_config.SetOptionByName("httpfs_retry_jitter", Value("random"));
+	{
+		TimeoutRetryFileOpener timeout_retry_opener(opener, HttpfsOperationType::LIST);
+		REQUIRE_THROWS_AS(GetRetryConfig(timeout_retry_opener), InvalidInputException);
+	}
+}
@@ -0,0 +1,146 @@
+#include "catch/catch.hpp"
+#include "sequential_read_ahead.hpp"
+
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/vector.hpp"
+
+#include <condition_variable>
+#include <stdexcept>
+
+using namespace duckdb;
+
+namespace {
+constexpr idx_t MB = 1024 * 1024;
+
+struct FetchRecorder {
+	mutex fetch_mutex;
+	// (location, bytes) of each fetch.
+	vector<std::pair<idx_t, idx_t>> fetches;
+	bool fail = false;
+	// Whether fetches at [held_location] are held in flight until released.
+	bool hold = false;
+	idx_t held_location = 0;
+	std::condition_variable release_cv;
+
+	void Release() {
+		lock_guard<mutex> lck(fetch_mutex);
+		hold = false;
+		release_cv.notify_all();
+	}
+
+	SequentialReadAhead::FetchFunction GetFetchFunction() {
+		return [this](data_ptr_t buffer, idx_t nr_bytes, idx_t location) {
+			std::unique_lock<mutex> lck(fetch_mutex);
+			fetches.emplace_back(location, nr_bytes);
+			release_cv.wait(lck, [&]() { return !hold || location != held_location; });
+			if (fail) {
+				throw std::runtime_error("injected fetch failure");
+			}
+			for (idx_t idx = 0; idx < nr_bytes; ++idx) {
+				buffer[idx] = static_cast<data_t>((location + idx) % 251);
+			}
+		};
+	}
+};
+
+void CheckContent(const vector<data_t> &buffer, idx_t location) {
+	for (idx_t idx = 0; idx < buffer.size(); ++idx) {
+		REQUIRE(buffer[idx] == static_cast<data_t>((location + idx) % 251));
+	}
+}
+} // namespace
+
+TEST_CASE("Test sequential read-ahead prefetches and grows window", "[read_ahead]") {
+	FetchRecorder recorder;
+	SequentialReadAhead read_ahead(/*max_window_bytes_p=*/4 * MB, /*file_size_p=*/16 * MB,
+	                               /*concurrent_fetches_p=*/false, recorder.GetFetchFunction());
+	vector<data_t> buffer(MB / 2);
+
+	// First read fetches a whole window in the foreground, prefetch starts after the second sequential read.
+	REQUIRE(read_ahead.Read(buffer.data(), buffer.size()) == buffer.size());
+	CheckContent(buffer, 0);
+	REQUIRE(read_ahead.Read(buffer.data(), buffer.size()) == buffer.size());
+	CheckContent(buffer, MB / 2);
+	read_ahead.WaitForPrefetch();
+	REQUIRE(recorder.fetches.size() == 2);
+	REQUIRE(recorder.fetches[1] == std::make_pair(MB, MB));
+
+	// Consuming the prefetched window doubles the next one.
+	REQUIRE(read_ahead.Read(buffer.data(), buffer.size()) == buffer.size());
+	CheckContent(buffer, MB);
+	read_ahead.WaitForPrefetch();
+	REQUIRE(read_ahead.GetWindowBytes() == 2 * MB);
+	REQUIRE(recorder.fetches.size() == 3);
+	REQUIRE(recorder.fetches[2] == std::make_pair(2 * MB, 2 * MB));
+	REQUIRE(read_ahead.GetPosition() == MB + MB / 2);
+
+	// Seek resets the window; a seek into the buffered window is still served from memory.
+	read_ahead.Seek(MB + 100);
+	REQUIRE(read_ahead.GetWindowBytes() == MB);
+	REQUIRE(read_ahead.Read(buffer.data(), 100) == 100);
+	buffer.resize(100);
+	CheckContent(buffer, MB + 100);
+	REQUIRE(recorder.fetches.size() == 3);
+}
+
+TEST_CASE("Test sequential read-ahead at end of file", "[read_ahead]") {
+	FetchRecorder recorder;
+	SequentialReadAhead read_ahead(/*max_window_bytes_p=*/MB, /*file_size_p=*/MB + 10, /*concurrent_fetches_p=*/false,
+	                               recorder.GetFetchFunction());
+	vector<data_t> buffer(2 * MB);
+
+	// Reads larger than the window go straight into the caller's buffer, and stop at end of file.
+	REQUIRE(read_ahead.Read(buffer.data(), buffer.size()) == MB + 10);
+	REQUIRE(recorder.fetches.size() == 1);
+	REQUIRE(recorder.fetches[0] == std::make_pair(idx_t(0), MB + 10));
+	REQUIRE(read_ahead.Read(buffer.data(), buffer.size()) == 0);
+	read_ahead.WaitForPrefetch();
+	REQUIRE(recorder.fetches.size() == 1);
+}
+
+TEST_CASE("Test sequential read-ahead recovers from failed prefetch", "[read_ahead]") {
+	FetchRecorder recorder;
+	SequentialReadAhead read_ahead(/*max_window_bytes_p=*/MB, /*file_size_p=*/4 * MB, /*concurrent_fetches_p=*/false,
+	                               recorder.GetFetchFunction());
+	vector<data_t> buffer(MB);
+	REQUIRE(read_ahead.Read(buffer.data(), MB / 2) == MB / 2);
+	{
+		lock_guard<mutex> lck(recorder.fetch_mutex);
+		recorder.fail = true;
+	}
+	REQUIRE(read_ahead.Read(buffer.data(), MB / 2) == MB / 2);
+	read_ahead.WaitForPrefetch();
+
+	// Failed prefetch is repeated in the foreground, which surfaces its own error.
+	REQUIRE_THROWS(read_ahead.Read(buffer.data(), MB));
+	{
+		lock_guard<mutex> lck(recorder.fetch_mutex);
+		recorder.fail = false;
+	}
+	REQUIRE(read_ahead.Read(buffer.data(), MB) == MB);
+	CheckContent(buffer, MB);
+}
+
+TEST_CASE("Test sequential read-ahead seek doesn't wait for stale prefetch", "[read_ahead]") {
+	FetchRecorder recorder;
+	recorder.hold = true;
+	recorder.held_location = MB;
+	SequentialReadAhead read_ahead(/*max_window_bytes_p=*/MB, /*file_size_p=*/16 * MB, /*concurrent_fetches_p=*/true,
+	                               recorder.GetFetchFunction());
+	vector<data_t> buffer(MB / 2);
+	REQUIRE(read_ahead.Read(buffer.data(), buffer.size()) == buffer.size());
+	REQUIRE(read_ahead.Read(buffer.data(), buffer.size()) == buffer.size());
+
+	// The prefetch of [MB, 2 MB) is held in flight, while the seek and the read after it go ahead.
+	read_ahead.Seek(8 * MB);
+	REQUIRE(read_ahead.Read(buffer.data(), buffer.size()) == buffer.size());
+	CheckContent(buffer, 8 * MB);
+
+	// The stale window is dropped once it completes, and the next prefetch follows the new position.
+	recorder.Release();
+	read_ahead.WaitForPrefetch();
+	REQUIRE(read_ahead.Read(buffer.data(), buffer.size()) == buffer.size());
+	CheckContent(buffer, 8 * MB + MB / 2);
+	read_ahead.WaitForPrefetch();
+	REQUIRE(recorder.fetches.back() == std::make_pair(9 * MB, MB));
+}
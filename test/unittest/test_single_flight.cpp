@@ -0,0 +1,161 @@
+#include "catch/catch.hpp"
+#include "single_flight.hpp"
+
+#include "duckdb/common/algorithm.hpp"
+#include "duckdb/common/atomic.hpp"
+#include "duckdb/common/vector.hpp"
+
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+using namespace duckdb;
+
+namespace {
+constexpr idx_t THREAD_COUNT = 8;
+
+// Wait until [count] callers have joined the in-flight call of [flight].
+template <class T>
+void WaitForInFlight(SingleFlight<T> &flight, const atomic<idx_t> &arrived, idx_t count) {
+	while (flight.GetInFlightCount() == 0 || arrived.load() < count) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	// Give the last caller time to block on the call.
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+}
+} // namespace
+
+TEST_CASE("Test single-flight shares result of concurrent calls", "[single_flight]") {
+	SingleFlight<idx_t> flight;
+	atomic<idx_t> calls {0};
+	atomic<idx_t> arrived {0};
+	atomic<bool> release {false};
+	vector<idx_t> results(THREAD_COUNT, 0);
+	vector<bool> shared(THREAD_COUNT, false);
+	vector<std::thread> threads;
+	for (idx_t idx = 0; idx < THREAD_COUNT; ++idx) {
+		threads.emplace_back([&, idx]() {
+			arrived.fetch_add(1);
+			bool call_shared = false;
+			results[idx] = flight.Do(
+			    "key",
+			    [&]() {
+				    calls.fetch_add(1);
+				    while (!release.load()) {
+					    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+				    }
+				    return static_cast<idx_t>(42);
+			    },
+			    call_shared);
+			shared[idx] = call_shared;
+		});
+	}
+	WaitForInFlight(flight, arrived, THREAD_COUNT);
+	release.store(true);
+	for (auto &thread : threads) {
+		thread.join();
+	}
+
+	REQUIRE(calls.load() == 1);
+	idx_t shared_count = 0;
+	for (idx_t idx = 0; idx < THREAD_COUNT; ++idx) {
+		REQUIRE(results[idx] == 42);
+		shared_count += shared[idx] ? 1 : 0;
+	}
+	REQUIRE(shared_count == THREAD_COUNT - 1);
+	REQUIRE(flight.GetInFlightCount() == 0);
+
+	// Completed calls are not kept.
+	bool call_shared = true;
+	REQUIRE(flight.Do("key", []() { return static_cast<idx_t>(7); }, call_shared) == 7);
+	REQUIRE_FALSE(call_shared);
+}
+
+TEST_CASE("Test single-flight shares error of concurrent calls", "[single_flight]") {
+	SingleFlight<idx_t> flight;
+	atomic<idx_t> arrived {0};
+	atomic<bool> release {false};
+	atomic<idx_t> failures {0};
+	vector<std::thread> threads;
+	for (idx_t idx = 0; idx < THREAD_COUNT; ++idx) {
+		threads.emplace_back([&]() {
+			arrived.fetch_add(1);
+			bool call_shared = false;
+			try {
+				flight.Do(
+				    "key",
+				    [&]() -> idx_t {
+					    while (!release.load()) {
+						    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+					    }
+					    throw std::runtime_error("injected failure");
+				    },
+				    call_shared);
+			} catch (std::runtime_error &) {
+				failures.fetch_add(1);
+			}
+		});
+	}
+	WaitForInFlight(flight, arrived, THREAD_COUNT);
+	release.store(true);
+	for (auto &thread : threads) {
+		thread.join();
+	}
+	REQUIRE(failures.load() == THREAD_COUNT);
+	REQUIRE(flight.GetInFlightCount() == 0);
+}
+
+TEST_CASE("Test single-flight keeps different keys apart", "[single_flight]") {
+	SingleFlight<string> flight;
+	bool shared = false;
+	REQUIRE(flight.Do("a", []() { return string("a"); }, shared) == "a");
+	REQUIRE(flight.Do("b", []() { return string("b"); }, shared) == "b");
+	REQUIRE_FALSE(shared);
+}
+
+TEST_CASE("Test single-flight shares result of the leader in place", "[single_flight]") {
+	SingleFlight<const_data_ptr_t> flight;
+	atomic<idx_t> calls {0};
+	atomic<idx_t> arrived {0};
+	atomic<bool> release {false};
+	// Each caller has a buffer of its own; the leader fills its buffer, followers copy from it.
+	vector<vector<data_t>> buffers(THREAD_COUNT, vector<data_t>(4, 0));
+	vector<bool> shared(THREAD_COUNT, false);
+	vector<std::thread> threads;
+	for (idx_t idx = 0; idx < THREAD_COUNT; ++idx) {
+		threads.emplace_back([&, idx]() {
+			arrived.fetch_add(1);
+			auto &buffer = buffers[idx];
+			bool call_shared = false;
+			flight.DoInPlace(
+			    "key",
+			    [&]() {
+				    calls.fetch_add(1);
+				    while (!release.load()) {
+					    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+				    }
+				    std::fill(buffer.begin(), buffer.end(), static_cast<data_t>(42));
+				    return static_cast<const_data_ptr_t>(buffer.data());
+			    },
+			    [&](const_data_ptr_t data) { std::copy(data, data + buffer.size(), buffer.begin()); }, call_shared);
+			// The leader's buffer is overwritten once it returns, which followers must not observe.
+			if (!call_shared) {
+				std::fill(buffer.begin(), buffer.end(), static_cast<data_t>(0));
+			}
+			shared[idx] = call_shared;
+		});
+	}
+	WaitForInFlight(flight, arrived, THREAD_COUNT);
+	release.store(true);
+	for (auto &thread : threads) {
+		thread.join();
+	}
+
+	REQUIRE(calls.load() == 1);
+	for (idx_t idx = 0; idx < THREAD_COUNT; ++idx) {
+		if (shared[idx]) {
+			REQUIRE(buffers[idx] == vector<data_t>(4, 42));
+		}
+	}
+	REQUIRE(flight.GetInFlightCount() == 0);
+}
@@ -0,0 +1,64 @@
+#include "catch/catch.hpp"
+#include "task_executor.hpp"
+
+#include "duckdb/common/atomic.hpp"
+#include "duckdb/common/mutex.hpp"
+
+#include <condition_variable>
+#include <thread>
+
+using namespace duckdb;
+
+TEST_CASE("Test task executor runs all tasks on bounded workers", "[task_executor]") {
+	constexpr idx_t TASK_COUNT = 100;
+	constexpr idx_t MAX_THREADS = 4;
+	atomic<idx_t> running_tasks {0};
+	atomic<idx_t> max_running_tasks {0};
+	mutex done_mutex;
+	std::condition_variable done_cv;
+	idx_t done_tasks = 0;
+	{
+		TaskExecutor executor(MAX_THREADS);
+		for (idx_t idx = 0; idx < TASK_COUNT; ++idx) {
+			executor.Schedule([&]() {
+				const auto running = ++running_tasks;
+				auto max_running = max_running_tasks.load();
+				while (running > max_running && !max_running_tasks.compare_exchange_weak(max_running, running)) {
+				}
+				--running_tasks;
+				lock_guard<mutex> lck(done_mutex);
+				++done_tasks;
+				done_cv.notify_all();
+			});
+		}
+		REQUIRE(executor.GetThreadCount() <= MAX_THREADS);
+		std::unique_lock<mutex> lck(done_mutex);
+		done_cv.wait(lck, [&]() { return done_tasks == TASK_COUNT; });
+	}
+	REQUIRE(max_running_tasks.load() <= MAX_THREADS);
+}
+
+TEST_CASE("Test task executor drains queued tasks after destruction", "[task_executor]") {
+	mutex gate_mutex;
+	std::condition_variable gate_cv;
+	bool gate_open = false;
+	atomic<idx_t> done_tasks {0};
+	{
+		TaskExecutor executor(/*max_threads_p=*/1);
+		executor.Schedule([&]() {
+			std::unique_lock<mutex> lck(gate_mutex);
+			gate_cv.wait(lck, [&]() { return gate_open; });
+			++done_tasks;
+		});
+		executor.Schedule([&]() { ++done_tasks; });
+	}
+	// The executor is gone while its worker still holds the first task, and the queued task runs after it.
+	{
+		lock_guard<mutex> lck(gate_mutex);
+		gate_open = true;
+		gate_cv.notify_all();
+	}
+	while (done_tasks.load() < 2) {
+		std::this_thread::yield();
+	}
+}
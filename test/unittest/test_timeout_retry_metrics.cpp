@@ -0,0 +1,95 @@
+#include "catch/catch.hpp"
+#include "duckdb/common/thread.hpp"
+#include "endpoint_util.hpp"
+#include "timeout_retry_metrics.hpp"
+
+using namespace duckdb;
+
+TEST_CASE("Test endpoint extraction", "[timeout_retry_metrics]") {
+	REQUIRE(GetEndpoint("https://raw.githubusercontent.com/dentiny/data.csv") == "https://raw.githubusercontent.com");
+	REQUIRE(GetEndpoint("HTTP://Example.com:8080?query") == "http://example.com:8080");
+	REQUIRE(GetEndpoint("s3://bucket/table/year=2024/file.parquet") == "s3://bucket");
+	REQUIRE(GetEndpoint("s3://bucket") == "s3://bucket");
+	REQUIRE(GetEndpoint("/local/file.parquet") == "");
+}
+
+TEST_CASE("Test operation metrics recording", "[timeout_retry_metrics]") {
+	OperationMetrics metrics(HttpfsOperationType::READ, "s3://bucket");
+	metrics.RecordSuccess(/*latency_us=*/100, /*bytes=*/10);
+	metrics.RecordSuccess(/*latency_us=*/200, /*bytes=*/20);
+	metrics.RecordError(/*latency_us=*/5000, /*is_timeout=*/true);
+	metrics.RecordError(/*latency_us=*/300, /*is_timeout=*/false);
+	metrics.RecordHedgedRequest();
+	metrics.RecordDeduplicatedRequest();
+	metrics.RecordQueueWait(/*wait_us=*/150);
+	metrics.RecordQueueWait(/*wait_us=*/50);
+	metrics.RecordRetry();
+	metrics.RecordRetry();
+	metrics.RecordRetryBudgetExhausted();
+	metrics.RecordCircuitBreakerRejected();
+
+	auto snapshot = metrics.GetSnapshot();
+	REQUIRE(snapshot.operation_type == HttpfsOperationType::READ);
+	REQUIRE(snapshot.endpoint == "s3://bucket");
+	REQUIRE(snapshot.requests == 4);
+	REQUIRE(snapshot.errors == 2);
+	REQUIRE(snapshot.timeouts == 1);
+	REQUIRE(snapshot.retries == 2);
+	REQUIRE(snapshot.retry_budget_exhausted == 1);
+	REQUIRE(snapshot.circuit_breaker_rejected == 1);
+	REQUIRE(snapshot.hedged_requests == 1);
+	REQUIRE(snapshot.deduplicated_requests == 1);
+	REQUIRE(snapshot.queued_requests == 2);
+	REQUIRE(snapshot.queue_wait_us == 200);
+	REQUIRE(snapshot.bytes == 30);
+	REQUIRE(snapshot.latency_max_us == 5000);
+	REQUIRE(snapshot.latency_p99_us == 5000);
+
+	metrics.Reset();
+	snapshot = metrics.GetSnapshot();
+	REQUIRE(snapshot.requests == 0);
+	REQUIRE(snapshot.retries == 0);
+	REQUIRE(snapshot.latency_max_us == 0);
+}
+
+TEST_CASE("Test operation metrics concurrent recording", "[timeout_retry_metrics]") {
+	constexpr idx_t THREAD_COUNT = 8;
+	constexpr idx_t REQUESTS_PER_THREAD = 1000;
+
+	OperationMetrics metrics(HttpfsOperationType::STAT, "https://example.com");
+	vector<thread> threads;
+	for (idx_t idx = 0; idx < THREAD_COUNT; ++idx) {
+		threads.emplace_back([&metrics]() {
+			for (idx_t req = 0; req < REQUESTS_PER_THREAD; ++req) {
+				metrics.RecordSuccess(/*latency_us=*/req, /*bytes=*/1);
+			}
+		});
+	}
+	for (auto &cur_thread : threads) {
+		cur_thread.join();
+	}
+
+	const auto snapshot = metrics.GetSnapshot();
+	REQUIRE(snapshot.requests == THREAD_COUNT * REQUESTS_PER_THREAD);
+	REQUIRE(snapshot.bytes == THREAD_COUNT * REQUESTS_PER_THREAD);
+	REQUIRE(snapshot.latency_max_us == REQUESTS_PER_THREAD - 1);
+}
+
+TEST_CASE("Test metrics registry", "[timeout_retry_metrics]") {
+	auto &registry = TimeoutRetryMetrics::GetInstance();
+	registry.Reset();
+
+	auto &metrics = registry.GetOperationMetrics(HttpfsOperationType::LIST, "s3://test-metrics-registry");
+	REQUIRE(&metrics == &registry.GetOperationMetrics(HttpfsOperationType::LIST, "s3://test-metrics-registry"));
+	REQUIRE(&metrics != &registry.GetOperationMetrics(HttpfsOperationType::STAT, "s3://test-metrics-registry"));
+	metrics.RecordSuccess(/*latency_us=*/10);
+
+	bool found = false;
+	for (const auto &snapshot : registry.GetSnapshots()) {
+		if (snapshot.endpoint == "s3://test-metrics-registry" && snapshot.operation_type == HttpfsOperationType::LIST) {
+			REQUIRE(snapshot.requests == 1);
+			found = true;
+		}
+	}
+	REQUIRE(found);
+}
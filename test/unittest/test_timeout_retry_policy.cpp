@@ -0,0 +1,242 @@
+#include "catch/catch.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/main/client_context_file_opener.hpp"
+#include "duckdb/main/connection.hpp"
+#include "duckdb/main/database.hpp"
+#include "duckdb/main/database_file_opener.hpp"
+#include "file_system_timeout_retry_wrapper.hpp"
+#include "test_helpers.hpp"
+#include "timeout_retry_policy.hpp"
+
+#include <chrono>
+
+using namespace duckdb;
+
+namespace {
+constexpr idx_t BENCHMARK_ITERATIONS = 100000;
+
+void RegisterExtensionOptions(DBConfig &db_config) {
+	db_config.AddExtensionOption("httpfs_timeout_file_operation_ms",
+	                             "Timeout for file operations (open/read/write) (in milliseconds)",
+	                             LogicalType {LogicalTypeId::UBIGINT}, Value());
+	db_config.AddExtensionOption("httpfs_timeout_list_ms", "Timeout for listing directories (in milliseconds)",
+	                             LogicalType {LogicalTypeId::UBIGINT}, Value());
+	db_config.AddExtensionOption("httpfs_timeout_stat_ms", "Timeout for stat/metadata operations (in milliseconds)",
+	                             LogicalType {LogicalTypeId::UBIGINT}, Value());
+	db_config.AddExtensionOption("httpfs_retries_file_operation",
+	                             "Maximum number of retries for file operations (open/read/write)",
+	                             LogicalType {LogicalTypeId::UBIGINT}, Value());
+	db_config.AddExtensionOption("httpfs_retries_list", "Maximum number of retries for listing directories",
+	                             LogicalType {LogicalTypeId::UBIGINT}, Value());
+	db_config.AddExtensionOption("httpfs_retry_wait_list_ms", "Initial retry wait for listing directories",
+	                             LogicalType {LogicalTypeId::UBIGINT}, Value());
+}
+
+// Average time of one call of [func], in nanoseconds.
+template <class FUNC>
+double MeasureNanosPerCall(FUNC &&func) {
+	const auto start = std::chrono::steady_clock::now();
+	for (idx_t idx = 0; idx < BENCHMARK_ITERATIONS; ++idx) {
+		func();
+	}
+	const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+	return elapsed.count() / static_cast<double>(BENCHMARK_ITERATIONS);
+}
+} // namespace
+
+TEST_CASE("Test policy snapshot resolves per-operation settings", "[timeout_retry_policy]") {
+	DBConfig config;
+	DuckDB db(nullptr, &config);
+	DatabaseInstance &db_instance = *db.instance;
+	auto &db_config = DBConfig::GetConfig(db_instance);
+
+	RegisterExtensionOptions(db_config);
+	db_config.SetOptionByName("http_timeout", Value::UBIGINT(20));
+	db_config.SetOptionByName("httpfs_timeout_list_ms", Value::UBIGINT(1500));
+	db_config.SetOptionByName("httpfs_retries_list", Value::UBIGINT(4));
+	db_config.SetOptionByName("httpfs_retry_wait_list_ms", Value::UBIGINT(250));
+	db_config.SetOptionByName("httpfs_timeout_file_operation_ms", Value::UBIGINT(8000));
+
+	DatabaseFileOpener opener(db_instance);
+	const auto policies = ResolveTimeoutRetryPolicies(opener);
+
+	const auto &list_policy = policies->GetOperationPolicy(HttpfsOperationType::LIST);
+	REQUIRE(list_policy.has_timeout);
+	REQUIRE(list_policy.timeout_ms == 1500);
+	REQUIRE(list_policy.has_retries);
+	REQUIRE(list_policy.retry.max_retries == 4);
+	REQUIRE(list_policy.retry.retry_wait_ms == 250);
+
+	// Stats fall back to http_timeout, reads to file operation settings.
+	const auto &stat_policy = policies->GetOperationPolicy(HttpfsOperationType::STAT);
+	REQUIRE(stat_policy.has_timeout);
+	REQUIRE(stat_policy.timeout_ms == 20000);
+	const auto &read_policy = policies->GetOperationPolicy(HttpfsOperationType::READ);
+	REQUIRE(read_policy.timeout_ms == 8000);
+
+	// Every operation matches what the opener looks up in settings.
+	for (const auto operation_type : {HttpfsOperationType::OPEN, HttpfsOperationType::LIST, HttpfsOperationType::DELETE,
+	                                  HttpfsOperationType::STAT, HttpfsOperationType::CREATE_DIR,
+	                                  HttpfsOperationType::READ, HttpfsOperationType::WRITE}) {
+		TimeoutRetryFileOpener timeout_retry_opener(opener, operation_type);
+		const auto &policy = policies->GetOperationPolicy(operation_type);
+		uint64_t timeout_ms = 0;
+		REQUIRE(timeout_retry_opener.TryGetTimeoutMs(timeout_ms) == policy.has_timeout);
+		REQUIRE(timeout_ms == policy.timeout_ms);
+		const auto retry_config = GetRetryConfig(timeout_retry_opener);
+		REQUIRE(retry_config.max_retries == policy.retry.max_retries);
+		REQUIRE(retry_config.retry_wait_ms == policy.retry.retry_wait_ms);
+		REQUIRE(retry_config.retry_backoff == policy.retry.retry_backoff);
+	}
+}
+
+TEST_CASE("Test policy snapshot resolves handle, upload and parallelism settings", "[timeout_retry_policy]") {
+	DBConfig config;
+	DuckDB db(nullptr, &config);
+	DatabaseInstance &db_instance = *db.instance;
+	auto &db_config = DBConfig::GetConfig(db_instance);
+
+	db_config.AddExtensionOption("httpfs_hedge_read_delay_ms", "Hedging delay", LogicalType {LogicalTypeId::UBIGINT},
+	                             Value());
+	db_config.AddExtensionOption("httpfs_upload_part_timeout_ms", "Part timeout", LogicalType {LogicalTypeId::UBIGINT},
+	                             Value());
+	db_config.AddExtensionOption("httpfs_glob_parallelism", "Glob parallelism", LogicalType {LogicalTypeId::UBIGINT},
+	                             Value());
+	db_config.SetOptionByName("httpfs_hedge_read_delay_ms", Value::UBIGINT(200));
+	db_config.SetOptionByName("httpfs_upload_part_timeout_ms", Value::UBIGINT(45000));
+	db_config.SetOptionByName("httpfs_glob_parallelism", Value::UBIGINT(16));
+
+	DatabaseFileOpener opener(db_instance);
+	const auto policies = ResolveTimeoutRetryPolicies(opener);
+	REQUIRE(policies->handle.hedge_read);
+	REQUIRE(policies->handle.hedge_delay_ms == 200);
+	REQUIRE(policies->upload.has_part_timeout);
+	REQUIRE(policies->upload.part_timeout_ms == 45000);
+	REQUIRE(!policies->upload.has_part_retries);
+	REQUIRE(policies->glob_parallelism == 16);
+	REQUIRE(policies->delete_parallelism == 0);
+	REQUIRE(!policies->block_cache.IsEnabled());
+
+	// Invalid values are reported when the snapshot is resolved.
+	db_config.SetOptionByName("httpfs_glob_parallelism", Value::UBIGINT(0));
+	REQUIRE_THROWS_WITH(ResolveTimeoutRetryPolicies(opener),
+	                    Catch::Contains("httpfs_glob_parallelism should be positive"));
+}
+
+TEST_CASE("Test opener reports settings from policy snapshot", "[timeout_retry_policy]") {
+	DBConfig config;
+	DuckDB db(nullptr, &config);
+	DatabaseInstance &db_instance = *db.instance;
+	auto &db_config = DBConfig::GetConfig(db_instance);
+
+	RegisterExtensionOptions(db_config);
+	db_config.SetOptionByName("httpfs_timeout_list_ms", Value::UBIGINT(1500));
+	db_config.SetOptionByName("httpfs_retries_list", Value::UBIGINT(4));
+
+	DatabaseFileOpener opener(db_instance);
+	const auto policies = ResolveTimeoutRetryPolicies(opener);
+	TimeoutRetryFileOpener timeout_retry_opener(opener, HttpfsOperationType::LIST, policies.get());
+
+	// The snapshot is not affected by later changes to settings.
+	db_config.SetOptionByName("httpfs_timeout_list_ms", Value::UBIGINT(9000));
+	Value value;
+	REQUIRE(static_cast<bool>(FileOpener::TryGetCurrentSetting(&timeout_retry_opener, "http_timeout", value)));
+	REQUIRE(value.GetValue<uint64_t>() == 2);
+	REQUIRE(static_cast<bool>(FileOpener::TryGetCurrentSetting(&timeout_retry_opener, "http_retries", value)));
+	REQUIRE(value.GetValue<uint64_t>() == 4);
+	REQUIRE(GetRetryConfig(timeout_retry_opener).max_retries == 4);
+
+	// Overrides still take precedence.
+	timeout_retry_opener.SetTimeoutOverrideMs(30000);
+	timeout_retry_opener.DisableInnerRetries();
+	REQUIRE(static_cast<bool>(FileOpener::TryGetCurrentSetting(&timeout_retry_opener, "http_timeout", value)));
+	REQUIRE(value.GetValue<uint64_t>() == 30);
+	REQUIRE(static_cast<bool>(FileOpener::TryGetCurrentSetting(&timeout_retry_opener, "http_retries", value)));
+	REQUIRE(value.GetValue<uint64_t>() == 0);
+}
+
+TEST_CASE("Test policy cache re-resolves after settings change", "[timeout_retry_policy]") {
+	DBConfig config;
+	DuckDB db(nullptr, &config);
+	DatabaseInstance &db_instance = *db.instance;
+	auto &db_config = DBConfig::GetConfig(db_instance);
+
+	RegisterExtensionOptions(db_config);
+	// Installed on all extension settings when the extension is loaded.
+	for (auto &entry : db_config.extension_parameters) {
+		entry.second.set_function = OnPolicySettingChanged;
+	}
+	Connection con(db);
+	ClientContextFileOpener opener(*con.context);
+	auto &cache = GetClientPolicyCache(*con.context);
+
+	REQUIRE(con.Query("SET httpfs_timeout_list_ms = 1500")->GetError().empty());
+	const auto first = cache.Get(opener);
+	REQUIRE(first->GetOperationPolicy(HttpfsOperationType::LIST).timeout_ms == 1500);
+	REQUIRE(cache.Get(opener).get() == first.get());
+
+	// Extension settings are versioned by setting callbacks, once the statement setting them completes.
+	REQUIRE(con.Query("SET httpfs_timeout_list_ms = 2500")->GetError().empty());
+	const auto second = cache.Get(opener);
+	REQUIRE(second.get() != first.get());
+	REQUIRE(second->GetOperationPolicy(HttpfsOperationType::LIST).timeout_ms == 2500);
+	REQUIRE(cache.Get(opener).get() == second.get());
+
+	// httpfs fallback settings are compared at the end of each query.
+	REQUIRE(con.Query("SET http_timeout = 50")->GetError().empty());
+	const auto third = cache.Get(opener);
+	REQUIRE(third.get() != second.get());
+	REQUIRE(third->GetOperationPolicy(HttpfsOperationType::STAT).timeout_ms == 50000);
+	REQUIRE(cache.Get(opener).get() == third.get());
+}
+
+TEST_CASE("Benchmark cached policy resolution", "[timeout_retry_policy][.benchmark]") {
+	DBConfig config;
+	DuckDB db(nullptr, &config);
+	DatabaseInstance &db_instance = *db.instance;
+	auto &db_config = DBConfig::GetConfig(db_instance);
+
+	RegisterExtensionOptions(db_config);
+	db_config.SetOptionByName("httpfs_timeout_list_ms", Value::UBIGINT(1500));
+	DatabaseFileOpener opener(db_instance);
+
+	// What every operation resolved before the snapshot: timeout and retry config from settings.
+	const auto uncached_ns = MeasureNanosPerCall([&]() {
+		TimeoutRetryFileOpener timeout_retry_opener(opener, HttpfsOperationType::STAT);
+		uint64_t timeout_ms = 0;
+		timeout_retry_opener.TryGetTimeoutMs(timeout_ms);
+		GetRetryConfig(timeout_retry_opener);
+	});
+	TimeoutRetryPolicyCache cache;
+	const auto cached_ns = MeasureNanosPerCall([&]() {
+		const auto policies = cache.Get(opener);
+		TimeoutRetryFileOpener timeout_retry_opener(opener, HttpfsOperationType::STAT, policies.get());
+		uint64_t timeout_ms = 0;
+		timeout_retry_opener.TryGetTimeoutMs(timeout_ms);
+		GetRetryConfig(timeout_retry_opener);
+	});
+	WARN(StringUtil::Format("Policy resolution: %.0f ns uncached, %.0f ns cached", uncached_ns, cached_ns));
+	REQUIRE(cached_ns < uncached_ns);
+}
+
+TEST_CASE("Benchmark wrapper overhead on metadata operations", "[timeout_retry_policy][.benchmark]") {
+	DBConfig config;
+	DuckDB db(nullptr, &config);
+	DatabaseInstance &db_instance = *db.instance;
+	RegisterExtensionOptions(DBConfig::GetConfig(db_instance));
+	Connection con(db);
+	ClientContextFileOpener context_opener(*con.context);
+
+	// Local files keep network latency out, so only the cost added by the wrapper is measured.
+	const auto path = TestCreatePath("policy_benchmark_missing_file");
+	auto raw_filesystem = FileSystem::CreateLocal();
+	FileSystemTimeoutRetryWrapper wrapper(FileSystem::CreateLocal(), db_instance);
+
+	const auto raw_ns = MeasureNanosPerCall([&]() { raw_filesystem->FileExists(path, &context_opener); });
+	const auto wrapped_ns = MeasureNanosPerCall([&]() { wrapper.FileExists(path, &context_opener); });
+	const auto wrapped_database_ns = MeasureNanosPerCall([&]() { wrapper.FileExists(path); });
+	WARN(StringUtil::Format("FileExists: %.0f ns raw, %.0f ns wrapped, %.0f ns wrapped without opener", raw_ns,
+	                        wrapped_ns, wrapped_database_ns));
+	REQUIRE(!wrapper.FileExists(path, &context_opener));
+}